@@ -0,0 +1,88 @@
+#ifndef SIGNAL_WAITER_HPP
+#define SIGNAL_WAITER_HPP
+
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+namespace cmd::details
+{
+
+/**
+ * @brief Receives signals through a signalfd instead of asynchronous handlers.
+ *
+ * The signals are blocked in the constructing thread and the threads it starts afterwards, so construct it first
+ * thing in main: they are then only ever read by wait, and whatever they trigger runs as ordinary code.
+ */
+class SignalWaiter
+{
+private:
+    int m_fd; ///< signalfd of the blocked signals
+
+public:
+    explicit SignalWaiter(std::initializer_list<int> signals)
+        : m_fd(-1)
+    {
+        sigset_t mask;
+        sigemptyset(&mask);
+        for (const auto signum : signals)
+        {
+            sigaddset(&mask, signum);
+        }
+
+        const auto error = pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+        if (error != 0)
+        {
+            throw std::runtime_error(fmt::format("Cannot block the signals: {}", std::strerror(error)));
+        }
+
+        m_fd = signalfd(-1, &mask, SFD_CLOEXEC);
+        if (m_fd < 0)
+        {
+            throw std::runtime_error(fmt::format("Cannot create the signalfd: {}", std::strerror(errno)));
+        }
+    }
+
+    ~SignalWaiter() { close(m_fd); }
+
+    SignalWaiter(const SignalWaiter&) = delete;
+    SignalWaiter& operator=(const SignalWaiter&) = delete;
+
+    /**
+     * @brief Wait for one of the signals.
+     *
+     * @param timeout Longest wait, a negative one waits until a signal arrives
+     * @return int The signal number, or 0 if none arrived in time
+     */
+    int wait(std::chrono::milliseconds timeout = std::chrono::milliseconds(-1))
+    {
+        pollfd fd {m_fd, POLLIN, 0};
+        const auto ready = poll(&fd, 1, timeout.count() < 0 ? -1 : static_cast<int>(timeout.count()));
+        if (ready <= 0)
+        {
+            return 0;
+        }
+
+        signalfd_siginfo info {};
+        if (read(m_fd, &info, sizeof(info)) != sizeof(info))
+        {
+            return 0;
+        }
+
+        return static_cast<int>(info.ssi_signo);
+    }
+};
+
+} // namespace cmd::details
+
+#endif // SIGNAL_WAITER_HPP
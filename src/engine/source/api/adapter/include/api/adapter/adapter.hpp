@@ -1,6 +1,8 @@
 #ifndef _API_ADAPTER_HPP
 #define _API_ADAPTER_HPP
 
+#include <string_view>
+#include <utility>
 #include <variant>
 
 #include <fmt/format.h>
@@ -12,6 +14,7 @@
 namespace api::adapter
 {
 using RouteHandler = std::function<void(const httplib::Request&, httplib::Response&)>;
+using StreamingRouteHandler = httplib::Server::HandlerWithContentReader;
 
 struct Error
 {
@@ -45,6 +48,15 @@ Res getRes(const ResOrErrorResp<Res>& res)
     return std::get<Res>(res);
 }
 
+/**
+ * @brief Take the result out of a response that is not used afterwards, without copying it.
+ */
+template <typename Res>
+Res getRes(ResOrErrorResp<Res>&& res)
+{
+    return std::get<Res>(std::move(res));
+}
+
 inline httplib::Response internalErrorResponse(const std::string& message)
 {
     json::Json json{};
@@ -55,7 +67,7 @@ inline httplib::Response internalErrorResponse(const std::string& message)
 
     httplib::Response response;
     response.status = httplib::StatusCode::InternalServerError_500;
-    response.set_content(json.toStrPretty(), "application/json");
+    response.set_content(json.toStr(), "application/json");
 
     return response;
 }
@@ -68,7 +80,7 @@ inline httplib::Response userResponse(const json::Json& res)
 
     httplib::Response response;
     response.status = httplib::StatusCode::OK_200;
-    response.set_content(res.toStrPretty(), "application/json");
+    response.set_content(res.toStr(), "application/json");
     return response;
 }
 
@@ -84,18 +96,18 @@ inline httplib::Response userErrorResponse(const std::string& message)
 
     httplib::Response response;
     response.status = httplib::StatusCode::BadRequest_400;
-    response.set_content(json.toStrPretty(), "application/json");
+    response.set_content(json.toStr(), "application/json");
 
     return response;
 }
 
-inline ResOrErrorResp<json::Json> parseRequest(const httplib::Request& req)
+inline ResOrErrorResp<json::Json> parseRequest(std::string_view body)
 {
-    if (req.body.empty()){
+    if (body.empty()){
         return json::Json{};
     }
 
-    json::Json reqJson{req.body.c_str()};
+    json::Json reqJson{body};
     auto errOpt = reqJson.getParseError();
 
     if (base::isError(errOpt))
@@ -109,9 +121,14 @@ inline ResOrErrorResp<json::Json> parseRequest(const httplib::Request& req)
         return Error{userErrorResponse(message)};
     }
 
-    return reqJson;
+    return std::move(reqJson);
 };
 
+inline ResOrErrorResp<json::Json> parseRequest(const httplib::Request& req)
+{
+    return parseRequest(std::string_view{req.body});
+}
+
 inline httplib::Request createRequest(const json::Json& req)
 {
 
@@ -169,7 +186,7 @@ ResOrErrorResp<ReqAndHandler<IHandler>> getReqAndHandler(const httplib::Request&
         return getError(jsonReq);
     }
 
-    return ReqAndHandler<IHandler>{handler, getRes(jsonReq)};
+    return ReqAndHandler<IHandler>{std::move(handler), getRes(std::move(jsonReq))};
 }
 
 } // namespace api::adapter
@@ -0,0 +1,155 @@
+#ifndef _API_ADAPTER_NDJSON_HPP
+#define _API_ADAPTER_NDJSON_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include <base/error.hpp>
+#include <base/json.hpp>
+
+namespace api::adapter
+{
+
+constexpr std::size_t NDJSON_MAX_RECORD_SIZE = 1024 * 1024; ///< Bytes of one line, buffered until it is complete
+
+/**
+ * @brief Incremental NDJSON parser, fed a request body in chunks as they are received.
+ *
+ * Each record is parsed and handed over as soon as its line is complete, so parsing overlaps receiving. Only the
+ * line being received is buffered, at most maxRecordSize bytes, the memory used does not depend on the size of the
+ * body. Blank lines are skipped and a trailing '\r' is ignored.
+ *
+ * The first error stops the reader: an invalid or oversized line, or an error returned by the record handler. Later
+ * calls return it again.
+ */
+class NdjsonReader
+{
+public:
+    /**
+     * @brief Called for each record, in order, returns an error to stop reading.
+     */
+    using RecordHandler = std::function<base::OptError(const json::Json& record)>;
+
+    explicit NdjsonReader(RecordHandler onRecord, std::size_t maxRecordSize = NDJSON_MAX_RECORD_SIZE)
+        : onRecord_ {std::move(onRecord)}
+        , maxRecordSize_ {maxRecordSize}
+    {
+    }
+
+    /**
+     * @brief Parse the records completed by chunk, and keep the rest of its last line.
+     */
+    base::OptError feed(std::string_view chunk)
+    {
+        while (!error_ && !chunk.empty())
+        {
+            const auto end = chunk.find('\n');
+            if (end == std::string_view::npos)
+            {
+                if (partial_.size() + chunk.size() > maxRecordSize_)
+                {
+                    fail(fmt::format("Line {} is longer than {} bytes", lines_ + 1, maxRecordSize_));
+                    break;
+                }
+
+                partial_.append(chunk);
+                break;
+            }
+
+            // Lines within the chunk are parsed in place, only the ones split across chunks are copied
+            if (partial_.empty())
+            {
+                parseLine(chunk.substr(0, end));
+            }
+            else
+            {
+                if (partial_.size() + end > maxRecordSize_)
+                {
+                    fail(fmt::format("Line {} is longer than {} bytes", lines_ + 1, maxRecordSize_));
+                    break;
+                }
+
+                partial_.append(chunk.substr(0, end));
+                parseLine(partial_);
+                partial_.clear();
+            }
+
+            chunk.remove_prefix(end + 1);
+        }
+
+        return error_;
+    }
+
+    /**
+     * @brief Parse the last line if the body does not end with a newline.
+     */
+    base::OptError finish()
+    {
+        if (!error_ && !partial_.empty())
+        {
+            parseLine(partial_);
+            partial_.clear();
+        }
+
+        return error_;
+    }
+
+    /**
+     * @brief Records handed over so far.
+     */
+    std::size_t records() const noexcept { return records_; }
+
+private:
+    void parseLine(std::string_view line)
+    {
+        ++lines_;
+
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+
+        if (line.find_first_not_of(" \t") == std::string_view::npos)
+        {
+            return;
+        }
+
+        if (line.size() > maxRecordSize_)
+        {
+            fail(fmt::format("Line {} is longer than {} bytes", lines_, maxRecordSize_));
+            return;
+        }
+
+        const json::Json record {line};
+        if (auto err = record.getParseError())
+        {
+            fail(fmt::format("Line {} is not valid JSON: {}", lines_, err->message));
+            return;
+        }
+
+        if (auto err = onRecord_(record))
+        {
+            fail(fmt::format("Line {}: {}", lines_, err->message));
+            return;
+        }
+
+        ++records_;
+    }
+
+    void fail(std::string message) { error_ = base::Error {std::move(message)}; }
+
+    RecordHandler onRecord_;
+    std::size_t maxRecordSize_;
+    std::string partial_; ///< Start of the line being received
+    std::size_t lines_ {0};
+    std::size_t records_ {0};
+    base::OptError error_;
+};
+
+} // namespace api::adapter
+
+#endif // _API_ADAPTER_NDJSON_HPP
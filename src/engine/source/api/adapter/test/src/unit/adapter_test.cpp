@@ -135,6 +135,20 @@ TEST(ApiAdapterTest, ParseRequest)
     ASSERT_NO_THROW(parseResponse(error));
 }
 
+TEST(ApiAdapterTest, ParseRequestView)
+{
+    // Only the view is parsed, not what follows it
+    const std::string body {R"({"content": "test"}trailing)"};
+
+    auto res = parseRequest(std::string_view {body}.substr(0, body.find("trailing")));
+
+    ASSERT_FALSE(isError(res));
+    ASSERT_EQ(getRes(std::move(res)).getString("/content").value(), "test");
+
+    ASSERT_TRUE(isError(parseRequest(std::string_view {body})));
+    ASSERT_EQ(getRes(parseRequest(std::string_view {})).toStr(), "null");
+}
+
 TEST(ApiAdapterTest, CreateRequest)
 {
     json::Json jsonReq{};
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <api/adapter/ndjson.hpp>
+
+using namespace api::adapter;
+
+namespace
+{
+
+struct Collector
+{
+    std::vector<std::string> records;
+
+    NdjsonReader::RecordHandler handler()
+    {
+        return [this](const json::Json& record) -> base::OptError
+        {
+            records.push_back(record.toStr());
+            return base::noError();
+        };
+    }
+};
+
+} // namespace
+
+TEST(NdjsonReaderTest, WholeBody)
+{
+    Collector collector;
+    NdjsonReader reader(collector.handler());
+
+    ASSERT_FALSE(base::isError(reader.feed("{\"a\":1}\n{\"b\":2}\n")));
+    ASSERT_FALSE(base::isError(reader.finish()));
+
+    EXPECT_EQ(collector.records, (std::vector<std::string> {R"({"a":1})", R"({"b":2})"}));
+    EXPECT_EQ(reader.records(), 2);
+}
+
+TEST(NdjsonReaderTest, SplitAcrossChunks)
+{
+    const std::string body = "{\"key\":\"k1\",\"value\":[1,2]}\r\n\n  \n{\"key\":\"k2\",\"value\":\"v\"}";
+
+    // Every split point, byte by byte included
+    for (std::size_t size = 1; size <= body.size(); ++size)
+    {
+        Collector collector;
+        NdjsonReader reader(collector.handler());
+
+        for (std::size_t offset = 0; offset < body.size(); offset += size)
+        {
+            ASSERT_FALSE(base::isError(reader.feed(std::string_view {body}.substr(offset, size)))) << size;
+        }
+        ASSERT_FALSE(base::isError(reader.finish())) << size;
+
+        EXPECT_EQ(collector.records,
+                  (std::vector<std::string> {R"({"key":"k1","value":[1,2]})", R"({"key":"k2","value":"v"})"}))
+            << size;
+    }
+}
+
+TEST(NdjsonReaderTest, InvalidLine)
+{
+    Collector collector;
+    NdjsonReader reader(collector.handler());
+
+    auto error = reader.feed("{\"a\":1}\n{\"b\":\n{\"c\":3}\n");
+    ASSERT_TRUE(base::isError(error));
+    EXPECT_EQ(base::getError(error).message.rfind("Line 2 is not valid JSON", 0), 0) << base::getError(error).message;
+
+    // Stopped at the error
+    EXPECT_EQ(collector.records, (std::vector<std::string> {R"({"a":1})"}));
+    EXPECT_TRUE(base::isError(reader.feed("{\"d\":4}\n")));
+    EXPECT_TRUE(base::isError(reader.finish()));
+    EXPECT_EQ(reader.records(), 1);
+}
+
+TEST(NdjsonReaderTest, LineTooLong)
+{
+    Collector collector;
+    NdjsonReader reader(collector.handler(), 16);
+
+    ASSERT_FALSE(base::isError(reader.feed("{\"a\":1}\n{\"long\":")));
+    auto error = reader.feed("\"0123456789\"}\n");
+    ASSERT_TRUE(base::isError(error));
+    EXPECT_EQ(base::getError(error).message, "Line 2 is longer than 16 bytes");
+
+    NdjsonReader inChunk(collector.handler(), 16);
+    EXPECT_TRUE(base::isError(inChunk.feed("{\"long\":\"0123456789\"}\n")));
+}
+
+TEST(NdjsonReaderTest, HandlerError)
+{
+    NdjsonReader reader([](const json::Json& record) -> base::OptError
+                        { return record.exists("/key") ? base::noError() : base::Error {"Missing /key"}; });
+
+    ASSERT_FALSE(base::isError(reader.feed("{\"key\":1}\n")));
+    auto error = reader.feed("{\"value\":1}\n");
+    ASSERT_TRUE(base::isError(error));
+    EXPECT_EQ(base::getError(error).message, "Line 2: Missing /key");
+    EXPECT_EQ(reader.records(), 1);
+}
+
+TEST(NdjsonReaderTest, Empty)
+{
+    Collector collector;
+    NdjsonReader reader(collector.handler());
+
+    ASSERT_FALSE(base::isError(reader.feed("")));
+    ASSERT_FALSE(base::isError(reader.finish()));
+    EXPECT_EQ(reader.records(), 0);
+}
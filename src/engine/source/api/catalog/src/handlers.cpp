@@ -18,7 +18,7 @@ adapter::RouteHandler resourcePost(const std::shared_ptr<ICatalog>& catalog)
             return;
         }
 
-        auto [catalog, jsonReq] = adapter::getRes(result);
+        auto [catalog, jsonReq] = adapter::getRes(std::move(result));
         
         if (auto err = jsonReq.validate(schemas::catalog::getResourcePostRequestSchema()))
         {
@@ -95,7 +95,7 @@ adapter::RouteHandler resourceGet(const std::shared_ptr<ICatalog>& catalog)
             return;
         }
 
-        auto [catalog, jsonReq] = adapter::getRes(result);
+        auto [catalog, jsonReq] = adapter::getRes(std::move(result));
         
         if (auto err = jsonReq.validate(schemas::catalog::getResourceGetRequestSchema()))
         {
@@ -170,7 +170,7 @@ adapter::RouteHandler resourceDelete(const std::shared_ptr<ICatalog>& catalog)
             return;
         }
 
-        auto [catalog, jsonReq] = adapter::getRes(result);
+        auto [catalog, jsonReq] = adapter::getRes(std::move(result));
         
         if (auto err = jsonReq.validate(schemas::catalog::getResourceDeleteRequestSchema()))
         {
@@ -241,7 +241,7 @@ adapter::RouteHandler resourcePut(const std::shared_ptr<ICatalog>& catalog)
             return;
         }
 
-        auto [catalog, jsonReq] = adapter::getRes(result);
+        auto [catalog, jsonReq] = adapter::getRes(std::move(result));
         
         if (auto err = jsonReq.validate(schemas::catalog::getResourcePutRequestSchema()))
         {
@@ -315,7 +315,7 @@ adapter::RouteHandler resourceValidate(const std::shared_ptr<ICatalog>& catalog)
             return;
         }
 
-        auto [catalog, jsonReq] = adapter::getRes(result);
+        auto [catalog, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::catalog::getResourceValidateSchema()))
         {
@@ -389,7 +389,7 @@ adapter::RouteHandler getNamespaces(const std::shared_ptr<ICatalog>& catalog)
             return;
         }
 
-        auto [catalog, jsonReq] = adapter::getRes(result);
+        auto [catalog, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::catalog::getResourceGetNamespaceRequestSchema()))
         {
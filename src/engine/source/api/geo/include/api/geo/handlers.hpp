@@ -11,6 +11,7 @@ adapter::RouteHandler addDb(const std::shared_ptr<::geo::IManager>& geoManager);
 adapter::RouteHandler delDb(const std::shared_ptr<::geo::IManager>& geoManager);
 adapter::RouteHandler listDb(const std::shared_ptr<::geo::IManager>& geoManager);
 adapter::RouteHandler remoteUpsertDb(const std::shared_ptr<::geo::IManager>& geoManager);
+adapter::RouteHandler loadCidrTable(const std::shared_ptr<::geo::IManager>& geoManager);
 
 void registerHandlers(const std::shared_ptr<::geo::IManager>& geoManager,
                       const std::shared_ptr<httpserver::Server>& server);
@@ -22,7 +22,7 @@ adapter::RouteHandler addDb(const std::shared_ptr<::geo::IManager>& geoManager)
             return;
         }
 
-        auto [geoManager, jsonReq] = adapter::getRes(result);
+        auto [geoManager, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::geo::getDBPostRequestSchema()))
         {
@@ -81,7 +81,7 @@ adapter::RouteHandler delDb(const std::shared_ptr<::geo::IManager>& geoManager)
             return;
         }
 
-        auto [geoManager, jsonReq] = adapter::getRes(result);
+        auto [geoManager, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::geo::getDBDeleteRequestSchema()))
         {
@@ -129,7 +129,7 @@ adapter::RouteHandler listDb(const std::shared_ptr<::geo::IManager>& geoManager)
             return;
         }
 
-        auto [geoManager, jsonReq] = adapter::getRes(result);
+        auto [geoManager, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::geo::getDBListRequestSchema()))
         {
@@ -175,7 +175,7 @@ adapter::RouteHandler remoteUpsertDb(const std::shared_ptr<::geo::IManager>& geo
             return;
         }
 
-        auto [geoManager, jsonReq] = adapter::getRes(result);
+        auto [geoManager, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::geo::getDBRemoteUpsertRequestSchema()))
         {
@@ -236,6 +236,60 @@ adapter::RouteHandler remoteUpsertDb(const std::shared_ptr<::geo::IManager>& geo
     };
 }
 
+adapter::RouteHandler loadCidrTable(const std::shared_ptr<::geo::IManager>& geoManager)
+{
+    return [weakGeoManager = std::weak_ptr<::geo::IManager>(geoManager)](const auto& req, auto& res)
+    {
+        auto result = adapter::getReqAndHandler<::geo::IManager>(req, weakGeoManager);
+
+        if (adapter::isError(result))
+        {
+            res = adapter::getErrorResp(result);
+            return;
+        }
+
+        auto [geoManager, jsonReq] = adapter::getRes(std::move(result));
+
+        if (auto err = jsonReq.validate(schemas::geo::getCidrLoadRequestSchema()))
+        {
+            res = adapter::userErrorResponse(
+                err->message
+            );
+            return;
+        }
+
+        base::Name name;
+
+        try
+        {
+            name = base::Name(jsonReq.getString("/name").value());
+        }
+        catch (const std::exception& e)
+        {
+            res = adapter::userErrorResponse(
+                fmt::format("Invalid CIDR table name: {}", e.what())
+            );
+            return;
+        }
+
+        const auto invalid = geoManager->loadCidrTable(name);
+
+        if (base::isError(invalid))
+        {
+            res = adapter::userErrorResponse(
+                base::getError(invalid).message
+            );
+            return;
+        }
+
+        json::Json jsonRes{
+            {"/status", schemas::engine::ReturnStatus::OK}
+        };
+
+        res = adapter::userResponse(jsonRes);
+    };
+}
+
 void registerHandlers(const std::shared_ptr<::geo::IManager>& geoManager,
                       const std::shared_ptr<httpserver::Server>& server)
 {
@@ -243,6 +297,7 @@ void registerHandlers(const std::shared_ptr<::geo::IManager>& geoManager,
     server->addRoute(httpserver::Method::POST, "/geo/db/del", delDb(geoManager));
     server->addRoute(httpserver::Method::POST, "/geo/db/list", listDb(geoManager));
     server->addRoute(httpserver::Method::POST, "/geo/db/remoteUpsert", remoteUpsertDb(geoManager));
+    server->addRoute(httpserver::Method::POST, "/geo/cidr/load", loadCidrTable(geoManager));
 }
 
 } // namespace api::geo::handlers
@@ -494,6 +494,86 @@ INSTANTIATE_TEST_SUITE_P(
             },
             [](auto&)
             {}
+        ),
+
+        /**************
+         * LOAD CIDR TABLE
+         *************/
+        // Success - test 17
+        HandlerT(
+            []()
+            {
+                return createRequest(
+                    json::Json{{
+                        {"/name", "geo-cidr/ranges"}
+                    }}
+                );
+            },
+            [](const std::shared_ptr<::geo::IManager>& geoManager)
+            {
+                return loadCidrTable(geoManager);
+            },
+            []()
+            {
+                return userResponse(
+                    json::Json{{
+                        {"/status", schemas::engine::ReturnStatus::OK}
+                    }}
+                );
+            },
+            [](auto& mock)
+            {
+                EXPECT_CALL(mock, loadCidrTable(base::Name("geo-cidr/ranges")))
+                    .WillOnce(testing::Return(base::noError()));
+            }
+        ),
+        // Handler Error - test 18
+        HandlerT(
+            []()
+            {
+                return createRequest(
+                    json::Json{{
+                        {"/name", "geo-cidr/ranges"}
+                    }}
+                );
+            },
+            [](const std::shared_ptr<::geo::IManager>& geoManager)
+            {
+                return loadCidrTable(geoManager);
+            },
+            []()
+            {
+                return userErrorResponse(
+                    "error"
+                );
+            },
+            [](auto& mock)
+            {
+                EXPECT_CALL(mock, loadCidrTable(testing::_)).WillOnce(testing::Return(base::Error{"error"}));
+            }
+        ),
+        // Invalid Name - test 19
+        HandlerT(
+            []()
+            {
+                return createRequest(
+                    json::Json{{
+                        {"/name", ""}
+                    }}
+                );
+            },
+            [](const std::shared_ptr<::geo::IManager>& geoManager)
+            {
+                return loadCidrTable(geoManager);
+            },
+            []()
+            {
+                return userErrorResponse(
+                    "Invalid CIDR table name: Name cannot be empty."
+                );
+            },
+            [](auto&)
+            {}
         )
     )
 );
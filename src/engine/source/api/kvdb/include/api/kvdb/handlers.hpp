@@ -12,6 +12,7 @@ namespace api::kvdb::handlers
 
 const uint32_t DEFAULT_HANDLER_PAGE = 1;
 const uint32_t DEFAULT_HANDLER_RECORDS = 50;
+const std::size_t EXPORT_CHUNK_SIZE = 64 * 1024; ///< Bytes buffered before each chunk of an export is sent
 
 adapter::RouteHandler managerGet(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager);
 adapter::RouteHandler managerPost(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager);
@@ -19,6 +20,20 @@ adapter::RouteHandler managerDelete(std::shared_ptr<kvdbManager::IKVDBManager> k
 adapter::RouteHandler managerDump(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
                                   const std::string& kvdbScopeName);
 
+adapter::RouteHandler managerStats(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager);
+
+adapter::RouteHandler managerExport(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
+                                    const std::string& kvdbScopeName);
+
+/**
+ * @brief Import the entries of an export into the DB named by the name query parameter, as the body is received.
+ *
+ * The body has one {"key": key, "value": value} object per line, it is parsed line by line and never held whole.
+ * The import stops at the first invalid line, the entries before it are kept.
+ */
+adapter::StreamingRouteHandler managerImport(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
+                                             const std::string& kvdbScopeName);
+
 adapter::RouteHandler dbGet(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
                             const std::string& kvdbScopeName);
 adapter::RouteHandler dbDelete(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
@@ -26,6 +41,8 @@ adapter::RouteHandler dbDelete(std::shared_ptr<kvdbManager::IKVDBManager> kvdbMa
 
 adapter::RouteHandler dbPut(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
                             const std::string& kvdbScopeName);
+adapter::RouteHandler dbMerge(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
+                              const std::string& kvdbScopeName);
 adapter::RouteHandler dbSearch(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
                                const std::string& kvdbScopeName);
 
@@ -1,8 +1,12 @@
+#include <chrono>
 #include <exception>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <api/kvdb/handlers.hpp>
 #include <api/adapter/helpers.hpp>
+#include <api/adapter/ndjson.hpp>
 #include <base/json.hpp>
 #include <base/utils/stringUtils.hpp>
 
@@ -11,12 +15,67 @@
 
 #include <fmt/format.h>
 
+#include <rapidjson/document.h>
+#include <rapidjson/writer.h>
+
+#include <base/logger.hpp>
+
 namespace api::kvdb::handlers
 {
 
+namespace
+{
+
+/**
+ * @brief Minimal rapidjson output stream appending to a std::string.
+ */
+struct StringOutputStream
+{
+    using Ch = char;
+
+    std::string& out;
+
+    void Put(char c) { out.push_back(c); }
+    void Flush() {}
+};
+
+/**
+ * @brief Append an export line {"key": key, "value": value} to buffer.
+ *
+ * Values are stored as JSON, anything else (e.g. the empty value of add()) is exported as a string.
+ */
+void appendExportLine(std::string& buffer, std::string_view key, std::string_view value)
+{
+    StringOutputStream stream{buffer};
+    rapidjson::Writer<StringOutputStream> writer(stream);
+
+    writer.StartObject();
+    writer.Key("key");
+    writer.String(key.data(), static_cast<rapidjson::SizeType>(key.size()));
+    writer.Key("value");
+
+    rapidjson::Document valueDoc;
+    valueDoc.Parse(value.data(), value.size());
+
+    if (valueDoc.HasParseError())
+    {
+        writer.String(value.data(), static_cast<rapidjson::SizeType>(value.size()));
+    }
+    else
+    {
+        valueDoc.Accept(writer);
+    }
+
+    writer.EndObject();
+    buffer.push_back('\n');
+}
+
+} // namespace
+
 constexpr auto MESSAGE_DB_NOT_EXISTS = "The KVDB '{}' does not exist.";
 constexpr auto MESSAGE_NAME_EMPTY = "Field /name is empty";
 constexpr auto MESSAGE_KEY_EMPTY = "Field /key is empty";
+constexpr auto MESSAGE_NAME_PARAM_EMPTY = "Parameter name is empty";
 
 adapter::RouteHandler managerGet(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager)
 {
@@ -29,7 +88,7 @@ adapter::RouteHandler managerGet(std::shared_ptr<kvdbManager::IKVDBManager> kvdb
             return;
         }
 
-        auto [kvdb, jsonReq] = adapter::getRes(result);
+        auto [kvdb, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::kvdb::getManagerGetRequestSchema()))
         {
@@ -73,7 +132,7 @@ adapter::RouteHandler managerPost(std::shared_ptr<kvdbManager::IKVDBManager> kvd
             return;
         }
 
-        auto [kvdb, jsonReq] = adapter::getRes(result);
+        auto [kvdb, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::kvdb::getManagerPostRequestSchema()))
         {
@@ -113,15 +172,18 @@ adapter::RouteHandler managerPost(std::shared_ptr<kvdbManager::IKVDBManager> kvd
             return;
         }
 
+        const std::chrono::seconds ttl {jsonReq.getInt64("/ttl").value_or(0)};
+
+        // A file is loaded at creation, its entries need the TTL of the DB before that
         base::OptError resultCreate{};
 
         if (!path.empty())
         {
-            resultCreate = kvdb->createDB(name, path); 
+            resultCreate = kvdb->createDB(name, path, ttl);
         }
         else
         {
-            resultCreate = kvdb->createDB(name); 
+            resultCreate = kvdb->createDB(name);
         }
 
         if (base::isError(resultCreate))
@@ -136,6 +198,45 @@ adapter::RouteHandler managerPost(std::shared_ptr<kvdbManager::IKVDBManager> kvd
              return;
         }
 
+        // A DB missing the requested settings is not left behind
+        const auto rollback = [&kvdb = kvdb, &name, &res](std::string_view step, const base::Error& error)
+        {
+            if (const auto resultDelete = kvdb->deleteDB(name))
+            {
+                LOG_WARNING("Could not remove the DB '{}' after a failed creation: {}", name, resultDelete->message);
+            }
+
+            res = adapter::userErrorResponse(
+                fmt::format(
+                    "The Database could not be created, {}. Error: {}.",
+                    step,
+                    error.message
+                )
+            );
+        };
+
+        if (path.empty() && ttl.count() != 0)
+        {
+            const auto resultTTL = kvdb->setDBTTL(name, ttl);
+
+            if (base::isError(resultTTL))
+            {
+                rollback("its TTL could not be set", resultTTL.value());
+                return;
+            }
+        }
+
+        if (jsonReq.getBool("/static").value_or(false))
+        {
+            const auto resultStatic = kvdb->setStaticMode(name, true);
+
+            if (base::isError(resultStatic))
+            {
+                rollback("it could not be made static", resultStatic.value());
+                return;
+            }
+        }
+
         json::Json resJson{{
             {"/status", schemas::engine::ReturnStatus::OK}
         }};
@@ -155,7 +256,7 @@ adapter::RouteHandler managerDelete(std::shared_ptr<kvdbManager::IKVDBManager> k
             return;
         }
 
-        auto [kvdb, jsonReq] = adapter::getRes(result);
+        auto [kvdb, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::kvdb::getManagerDeleteRequestSchema()))
         {
@@ -231,7 +332,7 @@ adapter::RouteHandler managerDump(std::shared_ptr<kvdbManager::IKVDBManager> kvd
             return;
         }
 
-        auto [kvdb, jsonReq] = adapter::getRes(result);
+        auto [kvdb, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::kvdb::getManagerDumpRequestSchema()))
         {
@@ -354,6 +455,284 @@ adapter::RouteHandler managerDump(std::shared_ptr<kvdbManager::IKVDBManager> kvd
     };
 }
 
+adapter::RouteHandler managerExport(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
+                                    const std::string& kvdbScopeName)
+{
+    return [wKvdb = std::weak_ptr<::kvdbManager::IKVDBManager>(kvdbManager), kvdbScopeName](const auto& req, auto& res)
+    {
+        auto result = adapter::getReqAndHandler<::kvdbManager::IKVDBManager>(req, wKvdb);
+        if (adapter::isError(result))
+        {
+            res = adapter::getErrorResp(result);
+            return;
+        }
+
+        auto [kvdb, jsonReq] = adapter::getRes(std::move(result));
+
+        if (auto err = jsonReq.validate(schemas::kvdb::getManagerExportRequestSchema()))
+        {
+            res = adapter::userErrorResponse(
+                err->message
+            );
+
+            return;
+        }
+
+        const auto name = jsonReq.getString("/name").value();
+
+        if (name.empty())
+        {
+            res = adapter::userErrorResponse(MESSAGE_NAME_EMPTY);
+            return;
+        }
+
+        if (!kvdb->existsDB(name))
+        {
+            res = adapter::userErrorResponse(
+                fmt::format(
+                    MESSAGE_DB_NOT_EXISTS,
+                    name
+                )
+            );
+
+            return;
+        }
+
+        auto resultHandler = kvdb->getKVDBHandler(name, kvdbScopeName);
+
+        if (base::isError(resultHandler))
+        {
+            res = adapter::userErrorResponse(
+                base::getError(resultHandler).message
+            );
+            return;
+        }
+
+        auto handler = std::move(base::getResponse(resultHandler));
+
+        // The whole export runs in a single provider call: entries are streamed from the snapshot in chunks
+        // of EXPORT_CHUNK_SIZE, so the response never holds more than one chunk in memory.
+        res.set_chunked_content_provider(
+            "application/x-ndjson",
+            [handler, name](size_t /*offset*/, httplib::DataSink& sink)
+            {
+                std::string buffer;
+                buffer.reserve(EXPORT_CHUNK_SIZE);
+                bool writable {true};
+
+                const auto exportError = handler->exportEntries(
+                    [&buffer, &writable, &sink](std::string_view key, std::string_view value)
+                    {
+                        appendExportLine(buffer, key, value);
+
+                        if (buffer.size() >= EXPORT_CHUNK_SIZE)
+                        {
+                            writable = sink.write(buffer.data(), buffer.size());
+                            buffer.clear();
+                        }
+
+                        return writable;
+                    });
+
+                if (!writable)
+                {
+                    LOG_DEBUG("Export of KVDB '{}' aborted, the client is gone", name);
+                    return false;
+                }
+
+                if (base::isError(exportError))
+                {
+                    // The status line is already sent, aborting the stream is the only way to report it
+                    LOG_WARNING("Export of KVDB '{}' failed: {}", name, base::getError(exportError).message);
+                    return false;
+                }
+
+                if (!buffer.empty() && !sink.write(buffer.data(), buffer.size()))
+                {
+                    return false;
+                }
+
+                sink.done();
+                return true;
+            });
+    };
+}
+
+adapter::RouteHandler managerStats(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager)
+{
+    return [wKvdb = std::weak_ptr<::kvdbManager::IKVDBManager>(kvdbManager)](const auto& req, auto& res)
+    {
+        auto result = adapter::getReqAndHandler<::kvdbManager::IKVDBManager>(req, wKvdb);
+        if (adapter::isError(result))
+        {
+            res = adapter::getErrorResp(result);
+            return;
+        }
+
+        auto [kvdb, jsonReq] = adapter::getRes(std::move(result));
+
+        if (auto err = jsonReq.validate(schemas::kvdb::getManagerStatsRequestSchema()))
+        {
+            res = adapter::userErrorResponse(
+                err->message
+            );
+
+            return;
+        }
+
+        json::Json resJson{{
+            {"/status", schemas::engine::ReturnStatus::OK}
+        }};
+
+        const auto stats = kvdb->getStats();
+        resJson.set("/rocksdb", stats.getJson("/rocksdb").value());
+        resJson.set("/dbs", stats.getJson("/dbs").value());
+
+        res = adapter::userResponse(resJson);
+    };
+}
+
+adapter::StreamingRouteHandler managerImport(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
+                                             const std::string& kvdbScopeName)
+{
+    return [wKvdb = std::weak_ptr<::kvdbManager::IKVDBManager>(kvdbManager), kvdbScopeName](
+               const httplib::Request& req, httplib::Response& res, const httplib::ContentReader& content)
+    {
+        auto kvdb = wKvdb.lock();
+        if (!kvdb)
+        {
+            res = adapter::internalErrorResponse("Error: Handler is not initialized");
+            return;
+        }
+
+        // The body is the entries, the DB is named in the query
+        const auto name = req.get_param_value("name");
+
+        if (name.empty())
+        {
+            res = adapter::userErrorResponse(MESSAGE_NAME_PARAM_EMPTY);
+            return;
+        }
+
+        if (!kvdb->existsDB(name))
+        {
+            res = adapter::userErrorResponse(
+                fmt::format(
+                    MESSAGE_DB_NOT_EXISTS,
+                    name
+                )
+            );
+
+            return;
+        }
+
+        auto resultHandler = kvdb->getKVDBHandler(name, kvdbScopeName);
+
+        if (base::isError(resultHandler))
+        {
+            res = adapter::userErrorResponse(
+                base::getError(resultHandler).message
+            );
+            return;
+        }
+
+        auto handler = std::move(base::getResponse(resultHandler));
+
+        std::vector<std::pair<std::string, std::string>> batch;
+        std::size_t imported {0};
+
+        adapter::NdjsonReader reader(
+            [&batch](const json::Json& record) -> base::OptError
+            {
+                const auto key = record.getString("/key");
+                if (!key)
+                {
+                    return base::Error {"Missing /key"};
+                }
+
+                if (key->empty())
+                {
+                    return base::Error {MESSAGE_KEY_EMPTY};
+                }
+
+                // Stored as JSON, as put does
+                const auto value = record.toStr("/value");
+                if (!value)
+                {
+                    return base::Error {"Missing /value"};
+                }
+
+                batch.emplace_back(key.value(), value.value());
+                return base::noError();
+            });
+
+        // The records completed by a chunk are written at once, including the ones before an invalid line
+        auto write = [&batch, &imported, &handler]() -> base::OptError
+        {
+            if (batch.empty())
+            {
+                return base::noError();
+            }
+
+            if (auto error = handler->setBatch(batch))
+            {
+                return error;
+            }
+
+            imported += batch.size();
+            batch.clear();
+
+            return base::noError();
+        };
+
+        base::OptError importError;
+        const auto received = content(
+            [&reader, &importError, &write](const char* data, size_t size)
+            {
+                importError = reader.feed(std::string_view {data, size});
+
+                const auto writeError = write();
+                if (!base::isError(importError))
+                {
+                    importError = writeError;
+                }
+
+                return !base::isError(importError);
+            });
+
+        if (!base::isError(importError))
+        {
+            importError = received ? reader.finish() : base::Error {"The request body could not be read"};
+
+            const auto writeError = write();
+            if (!base::isError(importError))
+            {
+                importError = writeError;
+            }
+        }
+
+        if (base::isError(importError))
+        {
+            res = adapter::userErrorResponse(fmt::format("Import of KVDB '{}' stopped after {} entries: {}",
+                                                         name,
+                                                         imported,
+                                                         base::getError(importError).message));
+
+            // The rest of the body is not read, the connection cannot serve another request
+            if (!received)
+            {
+                res.set_header("Connection", "close");
+            }
+            return;
+        }
+
+        json::Json resJson {{{"/status", schemas::engine::ReturnStatus::OK}}};
+        resJson.setType("/imported", static_cast<int64_t>(imported));
+
+        res = adapter::userResponse(resJson);
+    };
+}
+
 adapter::RouteHandler dbGet(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
                             const std::string& kvdbScopeName)
 {
@@ -367,7 +746,7 @@ adapter::RouteHandler dbGet(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManag
             return;
         }
 
-        auto [kvdb, jsonReq] = adapter::getRes(result);
+        auto [kvdb, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::kvdb::getDBGetRequestSchema()))
         {
@@ -471,7 +850,7 @@ adapter::RouteHandler dbDelete(std::shared_ptr<kvdbManager::IKVDBManager> kvdbMa
             return;
         }
 
-        auto [kvdb, jsonReq] = adapter::getRes(result);
+        auto [kvdb, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::kvdb::getDBDeleteRequestSchema()))
         {
@@ -559,7 +938,7 @@ adapter::RouteHandler dbPut(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManag
             return;
         }
 
-        auto [kvdb, jsonReq] = adapter::getRes(result);
+        auto [kvdb, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::kvdb::getDBPutRequestSchema()))
         {
@@ -648,7 +1027,10 @@ adapter::RouteHandler dbPut(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManag
 
         auto handler = std::move(base::getResponse(resultHandler));
 
-        const auto setError = handler->set(entryKey, entryValue);
+        // An explicit ttl wins over the default of the DB, so 0 stores an entry that never expires
+        const auto setError = jsonReq.exists("/ttl")
+            ? handler->set(entryKey, entryValue, std::chrono::seconds{jsonReq.getInt64("/ttl").value()})
+            : handler->set(entryKey, entryValue);
 
         if (base::isError(setError))
         {
@@ -664,6 +1046,105 @@ adapter::RouteHandler dbPut(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManag
     };
 }
 
+adapter::RouteHandler dbMerge(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
+                              const std::string& kvdbScopeName)
+{
+    return [wKvdb = std::weak_ptr<::kvdbManager::IKVDBManager>(kvdbManager), kvdbScopeName](const auto& req, auto& res)
+    {
+        auto result = adapter::getReqAndHandler<::kvdbManager::IKVDBManager>(req, wKvdb);
+
+        if (adapter::isError(result))
+        {
+            res = adapter::getErrorResp(result);
+            return;
+        }
+
+        auto [kvdb, jsonReq] = adapter::getRes(std::move(result));
+
+        if (auto err = jsonReq.validate(schemas::kvdb::getDBMergeRequestSchema()))
+        {
+            res = adapter::userErrorResponse(
+                err->message
+            );
+
+            return;
+        }
+
+        std::string name{};
+        std::string key{};
+        const auto op = jsonReq.getString("/op").value();
+
+        try
+        {
+            name = jsonReq.getString("/name").value();
+            if (name.empty())
+            {
+                throw std::runtime_error(MESSAGE_NAME_EMPTY);
+            }
+            key = jsonReq.getString("/key").value();
+            if (key.empty())
+            {
+                throw std::runtime_error(MESSAGE_KEY_EMPTY);
+            }
+            if (op == "increment" && jsonReq.exists("/value") && !jsonReq.getInt64("/value"))
+            {
+                throw std::runtime_error("Field /value must be an integer for op 'increment'");
+            }
+            if (op == "append" && !jsonReq.getString("/value"))
+            {
+                throw std::runtime_error("Field /value must be a string for op 'append'");
+            }
+        }
+        catch (const std::exception& e)
+        {
+            res = adapter::userErrorResponse(e.what());
+            return;
+        }
+
+        if (!kvdb->existsDB(name))
+        {
+            res = adapter::userErrorResponse(
+                fmt::format(
+                    MESSAGE_DB_NOT_EXISTS,
+                    name
+                )
+            );
+
+            return;
+        }
+
+        auto resultHandler = kvdb->getKVDBHandler(name, kvdbScopeName);
+
+        if (base::isError(resultHandler))
+        {
+            res = adapter::userErrorResponse(
+                base::getError(resultHandler).message
+            );
+            return;
+        }
+
+        auto handler = std::move(base::getResponse(resultHandler));
+
+        const auto mergeError = op == "increment"
+            ? handler->increment(key, jsonReq.exists("/value") ? jsonReq.getInt64("/value").value() : 1)
+            : handler->appendToSet(key, jsonReq.getString("/value").value());
+
+        if (base::isError(mergeError))
+        {
+            res = adapter::userErrorResponse(
+                base::getError(mergeError).message
+            );
+            return;
+        }
+
+        res = adapter::userResponse(
+            json::Json{{
+                {"/status", schemas::engine::ReturnStatus::OK}
+            }}
+        );
+    };
+}
+
 adapter::RouteHandler dbSearch(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
                                const std::string& kvdbScopeName)
 {
@@ -677,7 +1158,7 @@ adapter::RouteHandler dbSearch(std::shared_ptr<kvdbManager::IKVDBManager> kvdbMa
             return;
         }
 
-        auto [kvdb, jsonReq] = adapter::getRes(result);
+        auto [kvdb, jsonReq] = adapter::getRes(std::move(result));
 
         if (auto err = jsonReq.validate(schemas::kvdb::getDBSearchRequestSchema()))
         {
@@ -785,10 +1266,14 @@ void registerHandlers(std::shared_ptr<kvdbManager::IKVDBManager> kvdbManager,
     server->addRoute(httpserver::Method::POST, "/kvdb/manager/post", managerPost(kvdbManager));
     server->addRoute(httpserver::Method::POST, "/kvdb/manager/delete", managerDelete(kvdbManager));
     server->addRoute(httpserver::Method::POST, "/kvdb/manager/dump", managerDump(kvdbManager, "kvdb"));
+    server->addRoute(httpserver::Method::POST, "/kvdb/manager/export", managerExport(kvdbManager, "kvdb"));
+    server->addRoute(httpserver::Method::POST, "/kvdb/manager/stats", managerStats(kvdbManager));
+    server->addStreamingRoute(httpserver::Method::POST, "/kvdb/manager/import", managerImport(kvdbManager, "kvdb"));
 
     server->addRoute(httpserver::Method::POST, "/kvdb/db/get", dbGet(kvdbManager, "kvdb"));
     server->addRoute(httpserver::Method::POST, "/kvdb/db/delete", dbDelete(kvdbManager, "kvdb"));
     server->addRoute(httpserver::Method::POST, "/kvdb/db/put", dbPut(kvdbManager, "kvdb"));
+    server->addRoute(httpserver::Method::POST, "/kvdb/db/merge", dbMerge(kvdbManager, "kvdb"));
     server->addRoute(httpserver::Method::POST, "/kvdb/db/search", dbSearch(kvdbManager, "kvdb"));
 }
 
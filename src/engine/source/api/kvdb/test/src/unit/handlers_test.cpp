@@ -925,7 +925,632 @@ INSTANTIATE_TEST_SUITE_P(
                 EXPECT_CALL(*mockKvdbHandler, search(testing::_, testing::_, testing::_))
                     .WillOnce(testing::Return(mockList));
             }
+        ),
+        /* ******************
+        * TTL
+        * ******************/
+        // Manager post with TTL
+        HandlerT( // test 33
+            []() // reqGetter
+            {
+                return createRequest(json::Json{{ {"/name", "name"}, {"/ttl", 60} }});
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return managerPost(kvdb);
+            },
+            []() // resGetter
+            {
+                json::Json resJson{{
+                    {"/status", schemas::engine::ReturnStatus::OK}
+                }};
+
+                return userResponse(resJson);
+            },
+            [](auto& mock) // Mocker
+            {
+                EXPECT_CALL(mock, existsDB(testing::_)).WillOnce(testing::Return(false));
+                EXPECT_CALL(mock, createDB(testing::_)).WillOnce(testing::Return(base::noError()));
+                EXPECT_CALL(mock, setDBTTL("name", std::chrono::seconds(60))).WillOnce(testing::Return(base::noError()));
+            }
+        ),
+        // Manager post failure setting TTL
+        HandlerT( // test 34
+            []() // reqGetter
+            {
+                return createRequest(json::Json{{ {"/name", "name"}, {"/ttl", 60} }});
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return managerPost(kvdb);
+            },
+            []() // resGetter
+            {
+                return userErrorResponse("The Database could not be created, its TTL could not be set. Error: error.");
+            },
+            [](auto& mock) // Mocker
+            {
+                EXPECT_CALL(mock, existsDB(testing::_)).WillOnce(testing::Return(false));
+                EXPECT_CALL(mock, createDB(testing::_)).WillOnce(testing::Return(base::noError()));
+                EXPECT_CALL(mock, setDBTTL(testing::_, testing::_)).WillOnce(testing::Return(base::Error{"error"}));
+                EXPECT_CALL(mock, deleteDB("name")).WillOnce(testing::Return(base::noError()));
+            }
+        ),
+        // Put with TTL
+        HandlerT( // test 35
+            []() // reqGetter
+            {
+                return createRequest(
+                    json::Json{{
+                        {"/name", "name"},
+                        {"/entry/key", "key1"},
+                        {"/entry/value", 1},
+                        {"/ttl", 30}
+                    }}
+                );
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return dbPut(kvdb, "any_scope");
+            },
+            []() // resGetter
+            {
+                return userResponse(
+                    json::Json{{
+                        {"/status", schemas::engine::ReturnStatus::OK}
+                    }}
+                );
+            },
+            [](auto& mock) // Mocker
+            {
+                auto mockKvdbHandler = std::make_shared<MockKVDBHandler>();
+                EXPECT_CALL(mock, existsDB(testing::_)).WillOnce(testing::Return(true));
+                EXPECT_CALL(mock, getKVDBHandler(testing::_, testing::_)).WillOnce(testing::Return(mockKvdbHandler));
+                EXPECT_CALL(*mockKvdbHandler, set("key1", "1", std::chrono::seconds(30))).WillOnce(testing::Return(base::noError()));
+            }
+        ),
+        // Put with negative TTL
+        HandlerT( // test 36
+            []() // reqGetter
+            {
+                return createRequest(
+                    json::Json{{
+                        {"/name", "name"},
+                        {"/entry/key", "key1"},
+                        {"/entry/value", 1},
+                        {"/ttl", -1}
+                    }}
+                );
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return dbPut(kvdb, "any_scope");
+            },
+            []() // resGetter
+            {
+                return userErrorResponse(
+                    "Schema validation failed: Invalid schema Keyword: 'minimum'. Schema path: '#/properties/ttl', Document path: '#/ttl'\n"
+                );
+            },
+            [](auto& mock) // Mocker
+            {}
+        ),
+        /* ******************
+        * DB MERGE
+        * ******************/
+        // Increment with default delta
+        HandlerT( // test 37
+            []() // reqGetter
+            {
+                return createRequest(
+                    json::Json{{
+                        {"/name", "name"},
+                        {"/key", "counter"},
+                        {"/op", "increment"}
+                    }}
+                );
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return dbMerge(kvdb, "any_scope");
+            },
+            []() // resGetter
+            {
+                return userResponse(
+                    json::Json{{
+                        {"/status", schemas::engine::ReturnStatus::OK}
+                    }}
+                );
+            },
+            [](auto& mock) // Mocker
+            {
+                auto mockKvdbHandler = std::make_shared<MockKVDBHandler>();
+                EXPECT_CALL(mock, existsDB(testing::_)).WillOnce(testing::Return(true));
+                EXPECT_CALL(mock, getKVDBHandler(testing::_, testing::_)).WillOnce(testing::Return(mockKvdbHandler));
+                EXPECT_CALL(*mockKvdbHandler, increment("counter", 1)).WillOnce(testing::Return(base::noError()));
+            }
+        ),
+        // Increment with delta
+        HandlerT( // test 38
+            []() // reqGetter
+            {
+                return createRequest(
+                    json::Json{{
+                        {"/name", "name"},
+                        {"/key", "counter"},
+                        {"/op", "increment"},
+                        {"/value", -5}
+                    }}
+                );
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return dbMerge(kvdb, "any_scope");
+            },
+            []() // resGetter
+            {
+                return userResponse(
+                    json::Json{{
+                        {"/status", schemas::engine::ReturnStatus::OK}
+                    }}
+                );
+            },
+            [](auto& mock) // Mocker
+            {
+                auto mockKvdbHandler = std::make_shared<MockKVDBHandler>();
+                EXPECT_CALL(mock, existsDB(testing::_)).WillOnce(testing::Return(true));
+                EXPECT_CALL(mock, getKVDBHandler(testing::_, testing::_)).WillOnce(testing::Return(mockKvdbHandler));
+                EXPECT_CALL(*mockKvdbHandler, increment("counter", -5)).WillOnce(testing::Return(base::noError()));
+            }
+        ),
+        // Append to set
+        HandlerT( // test 39
+            []() // reqGetter
+            {
+                return createRequest(
+                    json::Json{{
+                        {"/name", "name"},
+                        {"/key", "ips"},
+                        {"/op", "append"},
+                        {"/value", "1.2.3.4"}
+                    }}
+                );
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return dbMerge(kvdb, "any_scope");
+            },
+            []() // resGetter
+            {
+                return userResponse(
+                    json::Json{{
+                        {"/status", schemas::engine::ReturnStatus::OK}
+                    }}
+                );
+            },
+            [](auto& mock) // Mocker
+            {
+                auto mockKvdbHandler = std::make_shared<MockKVDBHandler>();
+                EXPECT_CALL(mock, existsDB(testing::_)).WillOnce(testing::Return(true));
+                EXPECT_CALL(mock, getKVDBHandler(testing::_, testing::_)).WillOnce(testing::Return(mockKvdbHandler));
+                EXPECT_CALL(*mockKvdbHandler, appendToSet("ips", "1.2.3.4")).WillOnce(testing::Return(base::noError()));
+            }
+        ),
+        // Append without value
+        HandlerT( // test 40
+            []() // reqGetter
+            {
+                return createRequest(
+                    json::Json{{
+                        {"/name", "name"},
+                        {"/key", "ips"},
+                        {"/op", "append"}
+                    }}
+                );
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return dbMerge(kvdb, "any_scope");
+            },
+            []() // resGetter
+            {
+                return userErrorResponse("Field /value must be a string for op 'append'");
+            },
+            [](auto& mock) // Mocker
+            {}
+        ),
+        // Unknown op
+        HandlerT( // test 41
+            []() // reqGetter
+            {
+                return createRequest(
+                    json::Json{{
+                        {"/name", "name"},
+                        {"/key", "ips"},
+                        {"/op", "replace"}
+                    }}
+                );
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return dbMerge(kvdb, "any_scope");
+            },
+            []() // resGetter
+            {
+                return userErrorResponse(
+                    "Schema validation failed: Invalid schema Keyword: 'enum'. Schema path: '#/properties/op', Document path: '#/op'\n"
+                );
+            },
+            [](auto& mock) // Mocker
+            {}
+        ),
+        // Error merging
+        HandlerT( // test 42
+            []() // reqGetter
+            {
+                return createRequest(
+                    json::Json{{
+                        {"/name", "name"},
+                        {"/key", "counter"},
+                        {"/op", "increment"},
+                        {"/value", 2}
+                    }}
+                );
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return dbMerge(kvdb, "any_scope");
+            },
+            []() // resGetter
+            {
+                return userErrorResponse("error");
+            },
+            [](auto& mock) // Mocker
+            {
+                auto mockKvdbHandler = std::make_shared<MockKVDBHandler>();
+                EXPECT_CALL(mock, existsDB(testing::_)).WillOnce(testing::Return(true));
+                EXPECT_CALL(mock, getKVDBHandler(testing::_, testing::_)).WillOnce(testing::Return(mockKvdbHandler));
+                EXPECT_CALL(*mockKvdbHandler, increment("counter", 2)).WillOnce(testing::Return(base::Error{"error"}));
+            }
+        ),
+        /* ******************
+        * STATIC
+        * ******************/
+        // Manager post static DB from file
+        HandlerT( // test 43
+            []() // reqGetter
+            {
+                return createRequest(json::Json{{ {"/name", "name"}, {"/path", "path"}, {"/static", true} }});
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return managerPost(kvdb);
+            },
+            []() // resGetter
+            {
+                json::Json resJson{{
+                    {"/status", schemas::engine::ReturnStatus::OK}
+                }};
+
+                return userResponse(resJson);
+            },
+            [](auto& mock) // Mocker
+            {
+                EXPECT_CALL(mock, existsDB(testing::_)).WillOnce(testing::Return(false));
+                EXPECT_CALL(mock, createDB("name", "path", std::chrono::seconds(0))).WillOnce(testing::Return(base::noError()));
+                EXPECT_CALL(mock, setStaticMode("name", true)).WillOnce(testing::Return(base::noError()));
+            }
+        ),
+        // Manager post failure making the DB static
+        HandlerT( // test 44
+            []() // reqGetter
+            {
+                return createRequest(json::Json{{ {"/name", "name"}, {"/static", true} }});
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return managerPost(kvdb);
+            },
+            []() // resGetter
+            {
+                return userErrorResponse("The Database could not be created, it could not be made static. Error: error.");
+            },
+            [](auto& mock) // Mocker
+            {
+                EXPECT_CALL(mock, existsDB(testing::_)).WillOnce(testing::Return(false));
+                EXPECT_CALL(mock, createDB(testing::_)).WillOnce(testing::Return(base::noError()));
+                EXPECT_CALL(mock, setStaticMode(testing::_, testing::_)).WillOnce(testing::Return(base::Error{"error"}));
+                EXPECT_CALL(mock, deleteDB("name")).WillOnce(testing::Return(base::noError()));
+            }
+        ),
+        /* ******************
+        * MANAGER STATS
+        * ******************/
+        // Manager stats
+        HandlerT( // test 45
+            []() // reqGetter
+            {
+                return createRequest(json::Json{"{}"});
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return managerStats(kvdb);
+            },
+            []() // resGetter
+            {
+                json::Json resJson{{
+                    {"/status", schemas::engine::ReturnStatus::OK},
+                    {"/rocksdb/block_cache_hit_rate", 0.5},
+                    {"/dbs/name/ops/get/count", uint64_t{2}}
+                }};
+
+                return userResponse(resJson);
+            },
+            [](auto& mock) // Mocker
+            {
+                json::Json stats{{
+                    {"/rocksdb/block_cache_hit_rate", 0.5},
+                    {"/dbs/name/ops/get/count", uint64_t{2}}
+                }};
+                EXPECT_CALL(mock, getStats()).WillOnce(testing::Return(stats));
+            }
+        ),
+        // Manager post from file with TTL, set before the file is loaded
+        HandlerT( // test 46
+            []() // reqGetter
+            {
+                return createRequest(json::Json{{ {"/name", "name"}, {"/path", "path"}, {"/ttl", 60} }});
+            },
+            [](const std::shared_ptr<::kvdbManager::IKVDBManager>& kvdb) // handlerGetter
+            {
+                return managerPost(kvdb);
+            },
+            []() // resGetter
+            {
+                json::Json resJson{{
+                    {"/status", schemas::engine::ReturnStatus::OK}
+                }};
+
+                return userResponse(resJson);
+            },
+            [](auto& mock) // Mocker
+            {
+                EXPECT_CALL(mock, existsDB(testing::_)).WillOnce(testing::Return(false));
+                EXPECT_CALL(mock, createDB("name", "path", std::chrono::seconds(60)))
+                    .WillOnce(testing::Return(base::noError()));
+                EXPECT_CALL(mock, setDBTTL(testing::_, testing::_)).Times(0);
+            }
         )
 
     )
 );
+
+/* ******************
+ * MANAGER EXPORT
+ * ******************/
+namespace
+{
+std::string readChunked(httplib::Response& res, bool& done)
+{
+    std::string body;
+    httplib::DataSink sink;
+    sink.write = [&body](const char* data, size_t size)
+    {
+        body.append(data, size);
+        return true;
+    };
+    sink.is_writable = []()
+    {
+        return true;
+    };
+    sink.done = [&done]()
+    {
+        done = true;
+    };
+
+    EXPECT_TRUE(res.is_chunked_content_provider_);
+    EXPECT_TRUE(res.content_provider_(0, 0, sink));
+
+    return body;
+}
+} // namespace
+
+TEST(KvdbExportTest, StreamsNdjson)
+{
+    auto mockKvdb = std::make_shared<MockKVDBManager>();
+    auto mockKvdbHandler = std::make_shared<MockKVDBHandler>();
+
+    EXPECT_CALL(*mockKvdb, existsDB("name")).WillOnce(testing::Return(true));
+    EXPECT_CALL(*mockKvdb, getKVDBHandler("name", "any_scope")).WillOnce(testing::Return(mockKvdbHandler));
+    EXPECT_CALL(*mockKvdbHandler, exportEntries(testing::_))
+        .WillOnce(testing::Invoke(
+            [](const ::kvdbManager::EntryVisitor& visitor) -> base::OptError
+            {
+                visitor("key1", R"({"a":1})");
+                visitor("key2", "");
+                visitor("key\"3", "not json");
+                return base::noError();
+            }));
+
+    httplib::Response res;
+    managerExport(mockKvdb, "any_scope")(createRequest(json::Json{{{"/name", "name"}}}), res);
+
+    bool done {false};
+    const auto body = readChunked(res, done);
+
+    ASSERT_TRUE(done);
+    ASSERT_EQ(body,
+              "{\"key\":\"key1\",\"value\":{\"a\":1}}\n"
+              "{\"key\":\"key2\",\"value\":\"\"}\n"
+              "{\"key\":\"key\\\"3\",\"value\":\"not json\"}\n");
+}
+
+TEST(KvdbExportTest, AbortsOnError)
+{
+    auto mockKvdb = std::make_shared<MockKVDBManager>();
+    auto mockKvdbHandler = std::make_shared<MockKVDBHandler>();
+
+    EXPECT_CALL(*mockKvdb, existsDB("name")).WillOnce(testing::Return(true));
+    EXPECT_CALL(*mockKvdb, getKVDBHandler("name", "any_scope")).WillOnce(testing::Return(mockKvdbHandler));
+    EXPECT_CALL(*mockKvdbHandler, exportEntries(testing::_)).WillOnce(testing::Return(base::Error {"error"}));
+
+    httplib::Response res;
+    managerExport(mockKvdb, "any_scope")(createRequest(json::Json{{{"/name", "name"}}}), res);
+
+    httplib::DataSink sink;
+    sink.write = [](const char*, size_t)
+    {
+        return true;
+    };
+    bool done {false};
+    sink.done = [&done]()
+    {
+        done = true;
+    };
+
+    ASSERT_FALSE(res.content_provider_(0, 0, sink));
+    ASSERT_FALSE(done);
+}
+
+TEST(KvdbExportTest, DBNotExists)
+{
+    auto mockKvdb = std::make_shared<MockKVDBManager>();
+    EXPECT_CALL(*mockKvdb, existsDB("name")).WillOnce(testing::Return(false));
+
+    httplib::Response res;
+    managerExport(mockKvdb, "any_scope")(createRequest(json::Json{{{"/name", "name"}}}), res);
+
+    const auto expected = userErrorResponse("The KVDB 'name' does not exist.");
+    ASSERT_EQ(res.status, expected.status);
+    ASSERT_EQ(res.body, expected.body);
+    ASSERT_FALSE(res.content_provider_);
+}
+
+namespace
+{
+/**
+ * @brief A content reader handing over the body in the given chunks, as httplib does while receiving it.
+ */
+httplib::ContentReader chunkedReader(std::vector<std::string> chunks)
+{
+    return httplib::ContentReader(
+        [chunks = std::move(chunks)](httplib::ContentReceiver receiver)
+        {
+            for (const auto& chunk : chunks)
+            {
+                if (!receiver(chunk.data(), chunk.size()))
+                {
+                    return false;
+                }
+            }
+            return true;
+        },
+        [](httplib::MultipartContentHeader, httplib::ContentReceiver) { return false; });
+}
+
+httplib::Request importRequest(const std::string& name)
+{
+    httplib::Request req;
+    req.params.emplace("name", name);
+    return req;
+}
+} // namespace
+
+TEST(KvdbImportTest, ImportsNdjsonChunks)
+{
+    auto mockKvdb = std::make_shared<MockKVDBManager>();
+    auto mockKvdbHandler = std::make_shared<MockKVDBHandler>();
+
+    EXPECT_CALL(*mockKvdb, existsDB("name")).WillOnce(testing::Return(true));
+    EXPECT_CALL(*mockKvdb, getKVDBHandler("name", "any_scope")).WillOnce(testing::Return(mockKvdbHandler));
+
+    // One write per chunk completing records, the last record is completed by the end of the body
+    using Batch = std::vector<std::pair<std::string, std::string>>;
+    testing::InSequence sequence;
+    EXPECT_CALL(*mockKvdbHandler, setBatch(Batch {{"key1", R"({"a":1})"}, {"key2", "3"}}))
+        .WillOnce(testing::Return(base::noError()));
+    EXPECT_CALL(*mockKvdbHandler, setBatch(Batch {{"key3", R"("")"}})).WillOnce(testing::Return(base::noError()));
+
+    httplib::Response res;
+    managerImport(mockKvdb, "any_scope")(
+        importRequest("name"),
+        res,
+        chunkedReader({R"({"key":"key1","va)",
+                       R"(lue":{"a":1}})" "\n{\"key\":\"key2\",\"value\":3}\n{\"key\":",
+                       R"("key3","value":""})"}));
+
+    json::Json expected {{{"/status", schemas::engine::ReturnStatus::OK}}};
+    expected.setType("/imported", static_cast<int64_t>(3));
+
+    ASSERT_EQ(res.status, httplib::StatusCode::OK_200);
+    ASSERT_EQ(res.body, userResponse(expected).body);
+}
+
+TEST(KvdbImportTest, StopsAtInvalidLine)
+{
+    auto mockKvdb = std::make_shared<MockKVDBManager>();
+    auto mockKvdbHandler = std::make_shared<MockKVDBHandler>();
+
+    EXPECT_CALL(*mockKvdb, existsDB("name")).WillOnce(testing::Return(true));
+    EXPECT_CALL(*mockKvdb, getKVDBHandler("name", "any_scope")).WillOnce(testing::Return(mockKvdbHandler));
+    EXPECT_CALL(*mockKvdbHandler, setBatch(std::vector<std::pair<std::string, std::string>> {{"key1", "1"}}))
+        .WillOnce(testing::Return(base::noError()));
+
+    httplib::Response res;
+    managerImport(mockKvdb, "any_scope")(
+        importRequest("name"),
+        res,
+        chunkedReader({"{\"key\":\"key1\",\"value\":1}\n{\"value\":2}\n", "{\"key\":\"key3\",\"value\":3}\n"}));
+
+    const auto expected = userErrorResponse("Import of KVDB 'name' stopped after 1 entries: Line 2: Missing /key");
+    ASSERT_EQ(res.status, expected.status);
+    ASSERT_EQ(res.body, expected.body);
+    ASSERT_EQ(res.get_header_value("Connection"), "close");
+}
+
+TEST(KvdbImportTest, StopsAtFailedWrite)
+{
+    auto mockKvdb = std::make_shared<MockKVDBManager>();
+    auto mockKvdbHandler = std::make_shared<MockKVDBHandler>();
+
+    EXPECT_CALL(*mockKvdb, existsDB("name")).WillOnce(testing::Return(true));
+    EXPECT_CALL(*mockKvdb, getKVDBHandler("name", "any_scope")).WillOnce(testing::Return(mockKvdbHandler));
+    EXPECT_CALL(*mockKvdbHandler, setBatch(testing::SizeIs(2))).WillOnce(testing::Return(base::Error {"error"}));
+
+    httplib::Response res;
+    managerImport(mockKvdb, "any_scope")(
+        importRequest("name"),
+        res,
+        chunkedReader({"{\"key\":\"key1\",\"value\":1}\n{\"key\":\"key2\",\"value\":2}\n",
+                       "{\"key\":\"key3\",\"value\":3}\n"}));
+
+    const auto expected = userErrorResponse("Import of KVDB 'name' stopped after 0 entries: error");
+    ASSERT_EQ(res.status, expected.status);
+    ASSERT_EQ(res.body, expected.body);
+    ASSERT_EQ(res.get_header_value("Connection"), "close");
+}
+
+TEST(KvdbImportTest, MissingName)
+{
+    auto mockKvdb = std::make_shared<MockKVDBManager>();
+
+    httplib::Response res;
+    managerImport(mockKvdb, "any_scope")(httplib::Request {}, res, chunkedReader({}));
+
+    const auto expected = userErrorResponse("Parameter name is empty");
+    ASSERT_EQ(res.status, expected.status);
+    ASSERT_EQ(res.body, expected.body);
+}
+
+TEST(KvdbImportTest, DBNotExists)
+{
+    auto mockKvdb = std::make_shared<MockKVDBManager>();
+    EXPECT_CALL(*mockKvdb, existsDB("name")).WillOnce(testing::Return(false));
+
+    httplib::Response res;
+    managerImport(mockKvdb, "any_scope")(importRequest("name"), res, chunkedReader({"{}\n"}));
+
+    const auto expected = userErrorResponse("The KVDB 'name' does not exist.");
+    ASSERT_EQ(res.status, expected.status);
+    ASSERT_EQ(res.body, expected.body);
+}
@@ -19,7 +19,8 @@ JsonDOM::JsonDOM(rapidjson::Document&& document)
 JsonDOM::JsonDOM(std::string_view json)
     : document_{}
 {
-    document_.Parse(json.data());
+    // Views are not null terminated
+    document_.Parse(json.data(), json.size());
 }
 
 JsonDOM::JsonDOM(const char* json)
@@ -18,6 +18,33 @@ constexpr std::string_view STORE_PATH = "/engine/store/path";
 // SERVER
 constexpr std::string_view SERVER_API_SOCKET = "/engine/server/api_socket";
 constexpr std::string_view SERVER_EVENT_SOCKET = "/engine/server/event_socket";
+constexpr std::string_view SERVER_EVENT_PROTOCOL = "/engine/server/event_protocol";
+constexpr std::string_view SERVER_EVENT_BACKEND = "/engine/server/event_backend";
+constexpr std::string_view SERVER_DATAGRAM_SOCKET = "/engine/server/datagram_socket";
+constexpr std::string_view SERVER_DATAGRAM_MAX_SIZE = "/engine/server/datagram_max_size";
+constexpr std::string_view SERVER_DATAGRAM_BATCH_SIZE = "/engine/server/datagram_batch_size";
+constexpr std::string_view SERVER_DATAGRAM_RECEIVE_BUFFER = "/engine/server/datagram_receive_buffer";
+constexpr std::string_view SERVER_SHUTDOWN_TIMEOUT = "/engine/server/shutdown_timeout";
+constexpr std::string_view SERVER_HANDOFF_SOCKET = "/engine/server/handoff_socket";
+
+constexpr std::string_view SERVER_API_THREADS = "/engine/server/api_threads";
+constexpr std::string_view SERVER_API_QUEUE_SIZE = "/engine/server/api_queue_size";
+constexpr std::string_view SERVER_API_KEEP_ALIVE_MAX_COUNT = "/engine/server/api_keep_alive_max_count";
+constexpr std::string_view SERVER_API_KEEP_ALIVE_TIMEOUT = "/engine/server/api_keep_alive_timeout";
+constexpr std::string_view SERVER_API_READ_TIMEOUT = "/engine/server/api_read_timeout";
+constexpr std::string_view SERVER_API_WRITE_TIMEOUT = "/engine/server/api_write_timeout";
+constexpr std::string_view SERVER_API_PAYLOAD_MAX_SIZE = "/engine/server/api_payload_max_size";
+constexpr std::string_view SERVER_API_STREAMING_PAYLOAD_MAX_SIZE = "/engine/server/api_streaming_payload_max_size";
+constexpr std::string_view SERVER_API_COMPRESSION = "/engine/server/api_compression";
+constexpr std::string_view SERVER_API_COMPRESSION_MIN_SIZE = "/engine/server/api_compression_min_size";
+
+constexpr std::string_view SERVER_EVENT_THREADS = "/engine/server/event_threads";
+constexpr std::string_view SERVER_EVENT_QUEUE_SIZE = "/engine/server/event_queue_size";
+constexpr std::string_view SERVER_EVENT_KEEP_ALIVE_MAX_COUNT = "/engine/server/event_keep_alive_max_count";
+constexpr std::string_view SERVER_EVENT_KEEP_ALIVE_TIMEOUT = "/engine/server/event_keep_alive_timeout";
+constexpr std::string_view SERVER_EVENT_READ_TIMEOUT = "/engine/server/event_read_timeout";
+constexpr std::string_view SERVER_EVENT_WRITE_TIMEOUT = "/engine/server/event_write_timeout";
+constexpr std::string_view SERVER_EVENT_PAYLOAD_MAX_SIZE = "/engine/server/event_payload_max_size";
 } // namespace conf::key
 
 #endif // _CONF_KEYS_HPP
@@ -48,6 +48,44 @@ Conf::Conf(std::shared_ptr<IConfLoader> confLoader)
         "/tmp/distro_defender_event.sock"
     );
 
+    // "http", or a framed stream listener: "newline" or "length_prefixed"
+    addUnit<std::string>(key::SERVER_EVENT_PROTOCOL, "DD_SERVER_EVENT_PROTOCOL", "http");
+    // Framed stream listener only: "epoll", or "io_uring" which falls back to epoll when unavailable
+    addUnit<std::string>(key::SERVER_EVENT_BACKEND, "DD_SERVER_EVENT_BACKEND", "epoll");
+
+    // Datagram ingest, disabled while the socket path is empty
+    addUnit<std::string>(key::SERVER_DATAGRAM_SOCKET, "DD_SERVER_DATAGRAM_SOCKET", "");
+    addUnit<int>(key::SERVER_DATAGRAM_MAX_SIZE, "DD_SERVER_DATAGRAM_MAX_SIZE", 65536);
+    addUnit<int>(key::SERVER_DATAGRAM_BATCH_SIZE, "DD_SERVER_DATAGRAM_BATCH_SIZE", 64);
+    addUnit<int>(key::SERVER_DATAGRAM_RECEIVE_BUFFER, "DD_SERVER_DATAGRAM_RECEIVE_BUFFER", 0);
+
+    // Seconds the drain on shutdown may take before the process exits anyway
+    addUnit<int>(key::SERVER_SHUTDOWN_TIMEOUT, "DD_SERVER_SHUTDOWN_TIMEOUT", 10);
+
+    // Hot restart: a new engine takes the listening sockets of the one serving here. Disabled while empty, and only
+    // with a framed event protocol since the "http" event server cannot listen on a received socket
+    addUnit<std::string>(key::SERVER_HANDOFF_SOCKET, "DD_SERVER_HANDOFF_SOCKET", "");
+
+    addUnit<int>(key::SERVER_API_THREADS, "DD_SERVER_API_THREADS", 8);
+    addUnit<int>(key::SERVER_API_QUEUE_SIZE, "DD_SERVER_API_QUEUE_SIZE", 0);
+    addUnit<int>(key::SERVER_API_KEEP_ALIVE_MAX_COUNT, "DD_SERVER_API_KEEP_ALIVE_MAX_COUNT", 5);
+    addUnit<int>(key::SERVER_API_KEEP_ALIVE_TIMEOUT, "DD_SERVER_API_KEEP_ALIVE_TIMEOUT", 5);
+    addUnit<int>(key::SERVER_API_READ_TIMEOUT, "DD_SERVER_API_READ_TIMEOUT", 5);
+    addUnit<int>(key::SERVER_API_WRITE_TIMEOUT, "DD_SERVER_API_WRITE_TIMEOUT", 5);
+    addUnit<int64_t>(key::SERVER_API_PAYLOAD_MAX_SIZE, "DD_SERVER_API_PAYLOAD_MAX_SIZE", 104857600);
+    // Bodies read as they arrive (imports), 0 unbounded
+    addUnit<int64_t>(key::SERVER_API_STREAMING_PAYLOAD_MAX_SIZE, "DD_SERVER_API_STREAMING_PAYLOAD_MAX_SIZE", 0);
+    addUnit<bool>(key::SERVER_API_COMPRESSION, "DD_SERVER_API_COMPRESSION", true);
+    addUnit<int>(key::SERVER_API_COMPRESSION_MIN_SIZE, "DD_SERVER_API_COMPRESSION_MIN_SIZE", 1024);
+
+    addUnit<int>(key::SERVER_EVENT_THREADS, "DD_SERVER_EVENT_THREADS", 8);
+    addUnit<int>(key::SERVER_EVENT_QUEUE_SIZE, "DD_SERVER_EVENT_QUEUE_SIZE", 0);
+    addUnit<int>(key::SERVER_EVENT_KEEP_ALIVE_MAX_COUNT, "DD_SERVER_EVENT_KEEP_ALIVE_MAX_COUNT", 5);
+    addUnit<int>(key::SERVER_EVENT_KEEP_ALIVE_TIMEOUT, "DD_SERVER_EVENT_KEEP_ALIVE_TIMEOUT", 5);
+    addUnit<int>(key::SERVER_EVENT_READ_TIMEOUT, "DD_SERVER_EVENT_READ_TIMEOUT", 5);
+    addUnit<int>(key::SERVER_EVENT_WRITE_TIMEOUT, "DD_SERVER_EVENT_WRITE_TIMEOUT", 5);
+    addUnit<int64_t>(key::SERVER_EVENT_PAYLOAD_MAX_SIZE, "DD_SERVER_EVENT_PAYLOAD_MAX_SIZE", 104857600);
+
     addUnit<std::string>(
         key::STORE_PATH,
         "DD_STORE_PATH",
@@ -0,0 +1,324 @@
+#include <benchmark/benchmark.h>
+#include <gmock/gmock.h>
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <base/logger.hpp>
+#include <geo/manager.hpp>
+#include <geo/mockDownloader.hpp>
+#include <store/mockStore.hpp>
+
+using namespace geo;
+
+namespace
+{
+
+const std::string g_maxmindDbPath {MMDB_PATH_TEST};
+const DotPath g_path {"test_map.test_str1"};
+constexpr std::string_view g_ipFullData {"1.2.3.4"};
+
+constexpr std::size_t HOT_IPS {1024};       ///< Fits in the lookup cache of a database
+constexpr std::size_t COLD_IPS {1 << 18};   ///< Far larger than the lookup cache of a database
+
+/**
+ * @brief IPv4 addresses drawn uniformly, with a fixed seed so runs are comparable.
+ */
+std::vector<std::string> randomIps(std::size_t count, uint32_t seed)
+{
+    std::mt19937 rng {seed};
+    std::vector<std::string> ips;
+    ips.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto value = rng();
+        ips.emplace_back(
+            fmt::format("{}.{}.{}.{}", value >> 24, (value >> 16) & 0xFF, (value >> 8) & 0xFF, value & 0xFF));
+    }
+
+    return ips;
+}
+
+const std::vector<std::string>& hotIps()
+{
+    static const auto ips = randomIps(HOT_IPS, 1);
+    return ips;
+}
+
+const std::vector<std::string>& coldIps()
+{
+    static const auto ips = randomIps(COLD_IPS, 2);
+    return ips;
+}
+
+/**
+ * @brief Manager over a copy of the test database, with a mocked store and downloader.
+ *
+ * The downloader "downloads" the test database again with a new hash on every remoteUpsertDb, so each call swaps
+ * the database in.
+ */
+struct GeoEnv
+{
+    std::string dbPath;
+    std::string content;
+    std::shared_ptr<testing::NiceMock<store::mocks::MockStoreInternal>> store;
+    std::shared_ptr<testing::NiceMock<mocks::MockDownloader>> downloader;
+    std::shared_ptr<Manager> manager;
+    std::atomic<uint64_t> version {0};
+
+    GeoEnv()
+    {
+        dbPath = (std::filesystem::temp_directory_path() / fmt::format("geo_bench_{}.mmdb", getpid())).string();
+        std::filesystem::copy_file(g_maxmindDbPath, dbPath, std::filesystem::copy_options::overwrite_existing);
+
+        std::ifstream ifs(dbPath, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+
+        store = std::make_shared<testing::NiceMock<store::mocks::MockStoreInternal>>();
+        downloader = std::make_shared<testing::NiceMock<mocks::MockDownloader>>();
+
+        ON_CALL(*store, readInternalCol(testing::_))
+            .WillByDefault(testing::Return(base::RespOrError<store::Col>(store::Col {})));
+        ON_CALL(*store, readInternalDoc(testing::_))
+            .WillByDefault(testing::Return(base::RespOrError<store::Doc>(json::Json {R"({"hash": "stored"})"})));
+        ON_CALL(*downloader, computeMD5(testing::_))
+            .WillByDefault(testing::Return(base::RespOrError<std::string>(std::string {"stored"})));
+        ON_CALL(*downloader, downloadMD5(testing::_))
+            .WillByDefault(testing::Invoke(
+                [this](std::string_view) -> base::RespOrError<std::string>
+                { return fmt::format("hash{}", ++version); }));
+        ON_CALL(*downloader, downloadHTTPSToFile(testing::_, testing::_))
+            .WillByDefault(testing::Invoke(
+                [this](std::string_view, const std::filesystem::path& path) -> base::RespOrError<std::string>
+                {
+                    std::ofstream(path, std::ios::binary) << content;
+                    return fmt::format("hash{}", version.load());
+                }));
+
+        manager = std::make_shared<Manager>(store, downloader);
+
+        auto error = manager->addDb(dbPath, Type::CITY);
+        if (base::isError(error))
+        {
+            throw std::runtime_error(base::getError(error).message);
+        }
+    }
+
+    ~GeoEnv()
+    {
+        manager.reset();
+        std::filesystem::remove(dbPath);
+    }
+
+    std::shared_ptr<ILocator> locator() const
+    {
+        return base::getResponse<std::shared_ptr<ILocator>>(manager->getLocator(Type::CITY));
+    }
+};
+
+GeoEnv& env()
+{
+    static GeoEnv geoEnv;
+    return geoEnv;
+}
+
+/**
+ * @brief Background remoteUpsertDb loop, started and stopped around the swap benchmarks.
+ */
+struct Swapper
+{
+    std::atomic<bool> stop {false};
+    std::atomic<uint64_t> swaps {0};
+    std::thread thread;
+
+    void start()
+    {
+        stop = false;
+        thread = std::thread(
+            [this]()
+            {
+                while (!stop.load())
+                {
+                    auto error = env().manager->remoteUpsertDb(env().dbPath, Type::CITY, "dbUrl", "hashUrl");
+                    if (!base::isError(error))
+                    {
+                        ++swaps;
+                    }
+                }
+            });
+    }
+
+    void join()
+    {
+        stop = true;
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+};
+
+Swapper g_swapper;
+
+void startSwapper(const benchmark::State&)
+{
+    env();
+    g_swapper.start();
+}
+
+void stopSwapper(const benchmark::State&)
+{
+    g_swapper.join();
+}
+
+/**
+ * @brief Look up the addresses in order, looping over them, with one locator per thread.
+ */
+template<typename Get>
+void runLookups(benchmark::State& state, const std::vector<std::string>& ips, Get get)
+{
+    auto locator = env().locator();
+    // Threads start at different offsets so they do not walk the same cache shards in lockstep
+    std::size_t i = (ips.size() / 7) * static_cast<std::size_t>(state.thread_index());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(get(*locator, ips[i]));
+        if (++i == ips.size())
+        {
+            i = 0;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+auto getString = [](ILocator& locator, const std::string& ip) { return locator.getString(ip, g_path); };
+auto getAsJson = [](ILocator& locator, const std::string& ip) { return locator.getAsJson(ip, g_path); };
+
+/**
+ * @brief Same address every time, answered by the result kept in the locator.
+ */
+void BM_GetStringSameIp(benchmark::State& state)
+{
+    static const std::vector<std::string> ips {std::string {g_ipFullData}};
+    runLookups(state, ips, getString);
+}
+
+/**
+ * @brief Same pre-parsed address every time, without the text parsing cost.
+ */
+void BM_GetStringSameParsedIp(benchmark::State& state)
+{
+    auto locator = env().locator();
+    const auto ip = IpAddress::parse(g_ipFullData).value();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(locator->getString(ip, g_path));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Small working set cycled over, answered by the lookup cache of the database.
+ */
+void BM_GetStringHotSet(benchmark::State& state)
+{
+    runLookups(state, hotIps(), getString);
+}
+
+/**
+ * @brief Working set larger than the lookup cache, nearly every call looks up the database.
+ */
+void BM_GetStringColdSet(benchmark::State& state)
+{
+    runLookups(state, coldIps(), getString);
+}
+
+/**
+ * @brief Private addresses, answered without looking up the database.
+ */
+void BM_GetStringPrivate(benchmark::State& state)
+{
+    static const auto ips = []()
+    {
+        auto ips = randomIps(HOT_IPS, 3);
+        for (auto& ip : ips)
+        {
+            ip.replace(0, ip.find('.'), "10");
+        }
+        return ips;
+    }();
+
+    runLookups(state, ips, getString);
+}
+
+void BM_GetAsJsonSameIp(benchmark::State& state)
+{
+    static const std::vector<std::string> ips {std::string {g_ipFullData}};
+    runLookups(state, ips, getAsJson);
+}
+
+void BM_GetAsJsonColdSet(benchmark::State& state)
+{
+    runLookups(state, coldIps(), getAsJson);
+}
+
+/**
+ * @brief Hot set while another thread swaps the database in a loop, every swap empties the caches.
+ */
+void BM_GetStringHotSetDuringSwap(benchmark::State& state)
+{
+    const auto swapsBefore = g_swapper.swaps.load();
+    runLookups(state, hotIps(), getString);
+
+    if (state.thread_index() == 0)
+    {
+        state.counters["swaps"] = static_cast<double>(g_swapper.swaps.load() - swapsBefore);
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_GetStringSameIp)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_GetStringSameParsedIp);
+BENCHMARK(BM_GetStringHotSet)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_GetStringColdSet)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_GetStringPrivate);
+BENCHMARK(BM_GetAsJsonSameIp);
+BENCHMARK(BM_GetAsJsonColdSet);
+BENCHMARK(BM_GetStringHotSetDuringSwap)
+    ->Setup(startSwapper)
+    ->Teardown(stopSwapper)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+int main(int argc, char** argv)
+{
+    logger::testInit();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
@@ -1,18 +1,30 @@
 #ifndef _GEO_DBENTRY_HPP
 #define _GEO_DBENTRY_HPP
 
+#include <cstdint>
 #include <memory>
-#include <shared_mutex>
+#include <string>
+#include <utility>
 
 #include <maxminddb.h>
 
+#include <geo/cidrTrie.hpp>
 #include <geo/imanager.hpp>
+#include <geo/ipAddress.hpp>
+#include <geo/lruCache.hpp>
+#include <geo/reservedRanges.hpp>
 
 namespace geo
 {
 
+constexpr std::size_t LOOKUP_CACHE_SIZE {16384}; ///< IPs whose lookup result is cached per database
+constexpr std::size_t FIELD_CACHE_SIZE {65536};  ///< IP and path pairs whose data is cached per database
+
 /**
- * @brief Class to hold the needed information for a database.
+ * @brief Class to hold the needed information for an open database.
+ *
+ * An entry is never modified once opened, an update opens a new entry and publishes it through the DbHandle. The
+ * caches hold pointers into the mapped database so they live and die with it.
  */
 class DbEntry
 {
@@ -20,9 +32,12 @@ class DbEntry
 public:
     std::string path;                  ///< The path to the database.
     Type type;                         ///< The type of database.
-    mutable std::shared_mutex rwMutex; ///< Read-Write mutex for thread safety access to the MMDB database.
     std::unique_ptr<MMDB_s> mmdb;      ///< The MMDB database.
 
+    ShardedLRU<IpAddress, MMDB_lookup_result_s, IpAddress::Hash> lookupCache {LOOKUP_CACHE_SIZE}; ///< IP to result.
+    ShardedLRU<std::string, MMDB_entry_data_s> fieldCache {FIELD_CACHE_SIZE}; ///< IP bytes + path to data.
+    CidrTrie<std::string_view> emptyReserved; ///< Kind of the reserved ranges without any data, never looked up.
+
     DbEntry() = delete;
 
     DbEntry(std::string_view path, Type type)
@@ -32,6 +47,47 @@ public:
         mmdb = std::make_unique<MMDB_s>();
     }
 
+    /**
+     * @brief Open the database file and find the reserved ranges it has no data for.
+     *
+     * @param file Path of the file, may differ from path while the file is being swapped in.
+     * @return int The MMDB_open status.
+     */
+    int open(const std::string& file)
+    {
+        int status = MMDB_open(file.c_str(), MMDB_MODE_MMAP, mmdb.get());
+        if (MMDB_SUCCESS != status)
+        {
+            return status;
+        }
+
+        for (const auto& [range, kind] : RESERVED_RANGES)
+        {
+            const auto cidr = Cidr::parse(range).value();
+
+            sockaddr_storage address {};
+            cidr.address.toSockaddr(address);
+
+            int mmdbError {0};
+            auto result = MMDB_lookup_sockaddr(mmdb.get(), reinterpret_cast<const sockaddr*>(&address), &mmdbError);
+
+            // The netmask of a miss is the size of the empty network around the address. It counts the 96 bits of
+            // the IPv4 subtree for IPv4 lookups in IPv6 databases.
+            unsigned netmask = result.netmask;
+            if (cidr.address.family() == IpAddress::Family::V4 && mmdb->metadata.ip_version == 6)
+            {
+                netmask = netmask >= 96 ? netmask - 96 : 0;
+            }
+
+            if (MMDB_SUCCESS == mmdbError && !result.found_entry && netmask <= cidr.prefix)
+            {
+                emptyReserved.insert(cidr, kind);
+            }
+        }
+
+        return status;
+    }
+
     DbEntry(const DbEntry&) = delete;
     DbEntry& operator=(const DbEntry&) = delete;
     DbEntry(DbEntry&&) = delete;
@@ -45,6 +101,55 @@ public:
         }
     }
 };
+
+/**
+ * @brief Stable handle of a database, the entry behind it is replaced atomically on updates.
+ *
+ * Readers take the current entry with load() and never block: a replaced entry stays open until its last reader
+ * releases it.
+ */
+class DbHandle
+{
+private:
+    std::shared_ptr<DbEntry> entry_; ///< Only accessed with std::atomic_load/store.
+
+public:
+    explicit DbHandle(std::shared_ptr<DbEntry> entry)
+        : entry_(std::move(entry))
+    {
+    }
+
+    DbHandle(const DbHandle&) = delete;
+    DbHandle& operator=(const DbHandle&) = delete;
+
+    std::shared_ptr<DbEntry> load() const { return std::atomic_load(&entry_); }
+
+    void store(std::shared_ptr<DbEntry> entry) { std::atomic_store(&entry_, std::move(entry)); }
+};
+
+/**
+ * @brief Stable handle of the custom CIDR table, shared by the manager and its locators.
+ *
+ * Like DbHandle, a reload replaces the table atomically and readers keep the one they loaded.
+ */
+class CidrTableHandle
+{
+private:
+    std::shared_ptr<const CidrTable> table_; ///< Only accessed with std::atomic_load/store.
+
+public:
+    CidrTableHandle()
+        : table_(std::make_shared<const CidrTable>())
+    {
+    }
+
+    CidrTableHandle(const CidrTableHandle&) = delete;
+    CidrTableHandle& operator=(const CidrTableHandle&) = delete;
+
+    std::shared_ptr<const CidrTable> load() const { return std::atomic_load(&table_); }
+
+    void store(std::shared_ptr<const CidrTable> table) { std::atomic_store(&table_, std::move(table)); }
+};
 } // namespace geo
 
 #endif // _GEO_DBENTRY_HPP
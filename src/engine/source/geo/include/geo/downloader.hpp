@@ -16,6 +16,8 @@ public:
     base::RespOrError<std::string> downloadHTTPS(std::string_view url) const override;
     base::RespOrError<std::string> computeMD5(std::string_view data) const override;
     base::RespOrError<std::string> downloadMD5(std::string_view url) const override;
+    base::RespOrError<std::string> downloadHTTPSToFile(std::string_view url,
+                                                      const std::filesystem::path& path) const override;
 };
 
 } // namespace geo
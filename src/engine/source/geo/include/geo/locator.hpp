@@ -1,7 +1,10 @@
 #ifndef _GEO_LOCATOR_HPP
 #define _GEO_LOCATOR_HPP
 
+#include <optional>
+
 #include <geo/ilocator.hpp>
+#include <geo/imanager.hpp>
 
 #include <maxminddb.h>
 
@@ -9,32 +12,58 @@ namespace geo
 {
 
 class DbEntry;
+class DbHandle;
+class CidrTableHandle;
 
 class Locator : public ILocator
 {
 
 private:
-    std::weak_ptr<DbEntry> weakDbEntry_; ///< The weak pointer to the database entry.
+    std::weak_ptr<DbHandle> weakDbHandle_; ///< The weak pointer to the database handle.
 
-    std::string cachedIp_;              ///< The cached IP address.
+    IpAddress cachedIp_;                ///< The cached IP address.
     MMDB_lookup_result_s cachedResult_; ///< The cached lookup result.
+    std::weak_ptr<DbEntry> cachedEntry_; ///< The database entry the cached result belongs to.
+    std::string_view cachedReserved_;   ///< Kind of the empty reserved range of the cached IP, if it is in one.
+
+    std::shared_ptr<const CidrTableHandle> cidrTableHandle_; ///< Custom networks, null if there are none.
+    std::shared_ptr<const CidrTable> cachedCidrTable_;       ///< Table the cached match belongs to.
+    const json::Json* cachedCidr_ {nullptr};                 ///< Data of the custom network of the cached IP.
 
     /**
-     * @brief Retrieves the entry data for a given dot path.
+     * @brief Get the current entry of the database, without locking.
+     *
+     * @return The entry, kept open until released even if the database is updated meanwhile, or an error if the
+     * database was removed.
+     */
+    base::RespOrError<std::shared_ptr<DbEntry>> acquireEntry() const;
+
+    /**
+     * @brief Retrieves the entry data for a given dot path of the cached IP address.
      *
      * @param path The dot path to retrieve the entry data for.
+     * @param dbEntry The database entry whose field cache is used.
      * @return A base::RespOrError object containing the entry data or an error message.
      */
-    base::RespOrError<MMDB_entry_data_s> getEData(const DotPath& path);
+    base::RespOrError<MMDB_entry_data_s> getEData(const DotPath& path, const std::shared_ptr<DbEntry>& dbEntry);
 
     /**
-     * @brief Looks up the given IP address in the database if it is not already cached.
+     * @brief Looks up the given IP address in the database if it is not already cached, either by this locator or
+     * in the shared cache of the database entry.
      *
      * @param ip The IP address to look up.
      * @param dbEntry The database entry to use for the lookup.
      * @return A base::OptError object containing an error message if the lookup failed.
      */
-    base::OptError lookup(std::string_view ip, const std::shared_ptr<DbEntry>& dbEntry);
+    base::OptError lookup(const IpAddress& ip, const std::shared_ptr<DbEntry>& dbEntry);
+
+    /**
+     * @brief Retrieves the value at the given dot path of the custom network of the cached IP address.
+     *
+     * @param path The dot path of the value.
+     * @return The value, or nullopt if the IP address is in no custom network or its data has no such path.
+     */
+    std::optional<json::Json> getCidrValue(const DotPath& path) const;
 
 public:
     virtual ~Locator() = default;
@@ -44,12 +73,14 @@ public:
     /**
      * @brief Construct a new Locator object
      *
-     * @param dbEntry The database entry to use for the locator.
+     * @param dbHandle The database handle to use for the locator.
+     * @param cidrTableHandle The custom networks matched before the database, may be null.
      */
-    Locator(const std::shared_ptr<DbEntry>& dbEntry)
-        : weakDbEntry_(dbEntry)
+    Locator(const std::shared_ptr<DbHandle>& dbHandle, std::shared_ptr<const CidrTableHandle> cidrTableHandle = nullptr)
+        : weakDbHandle_(dbHandle)
+        , cidrTableHandle_(std::move(cidrTableHandle))
     {
-        if (weakDbEntry_.expired())
+        if (weakDbHandle_.expired())
         {
             throw std::runtime_error("Cannot build a maxmind locator with an expired db entry");
         }
@@ -75,12 +106,42 @@ public:
      */
     base::RespOrError<json::Json> getAsJson(std::string_view ip, const DotPath& path) override;
 
+    /**
+     * @copydoc ILocator::getString(const IpAddress&, const DotPath&)
+     */
+    base::RespOrError<std::string> getString(const IpAddress& ip, const DotPath& path) override;
+
+    /**
+     * @copydoc ILocator::getUint32(const IpAddress&, const DotPath&)
+     */
+    base::RespOrError<uint32_t> getUint32(const IpAddress& ip, const DotPath& path) override;
+
+    /**
+     * @copydoc ILocator::getDouble(const IpAddress&, const DotPath&)
+     */
+    base::RespOrError<double> getDouble(const IpAddress& ip, const DotPath& path) override;
+
+    /**
+     * @copydoc ILocator::getAsJson(const IpAddress&, const DotPath&)
+     */
+    base::RespOrError<json::Json> getAsJson(const IpAddress& ip, const DotPath& path) override;
+
+    /**
+     * @copydoc ILocator::getFields(std::string_view, const LocatorQuery&, json::Json&)
+     */
+    base::OptError getFields(std::string_view ip, const LocatorQuery& query, json::Json& output) override;
+
+    /**
+     * @copydoc ILocator::getFields(const IpAddress&, const LocatorQuery&, json::Json&)
+     */
+    base::OptError getFields(const IpAddress& ip, const LocatorQuery& query, json::Json& output) override;
+
     /**
      * @brief Retrieves the cached IP address.
      *
-     * @return The cached IP address.
+     * @return The cached IP address in text form, empty if nothing was looked up yet.
      */
-    inline const std::string& getCachedIp() const { return cachedIp_; }
+    inline std::string getCachedIp() const { return cachedIp_.str(); }
 
     /**
      * @brief Retrieves the cached lookup result.
@@ -0,0 +1,169 @@
+#ifndef _GEO_LRU_CACHE_HPP
+#define _GEO_LRU_CACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace geo
+{
+
+/**
+ * @brief Thread safe LRU cache split in independently locked shards.
+ *
+ * Each key always maps to the same shard, which holds at most capacity / shards entries and evicts its own least
+ * recently used one when full. Threads working on different shards never contend, so with a few more shards than
+ * worker threads a lookup rarely waits on a lock.
+ *
+ * @tparam Key Key type, must be hashable with Hash and equality comparable.
+ * @tparam Value Value type, copied out on hits.
+ * @tparam Hash Hash function of Key.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedLRU
+{
+private:
+    using Item = std::pair<Key, Value>;
+    using ItemList = std::list<Item>;
+
+    struct Shard
+    {
+        std::mutex mutex;
+        ItemList items; ///< Most recently used first
+        std::unordered_map<Key, typename ItemList::iterator, Hash> index;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::size_t shardCapacity_;
+    Hash hash_;
+
+    Shard& shardFor(const Key& key)
+    {
+        auto h = hash_(key);
+        // std::hash of integers is the identity in libstdc++, fold the high bits into the shard index
+        h ^= h >> 17;
+        return *shards_[h % shards_.size()];
+    }
+
+public:
+    static constexpr std::size_t DEFAULT_SHARDS {16};
+
+    /**
+     * @brief Construct a new cache.
+     *
+     * @param capacity Maximum number of entries, split evenly between the shards.
+     * @param shards Number of shards.
+     * @throws std::runtime_error if capacity or shards is 0.
+     */
+    explicit ShardedLRU(std::size_t capacity, std::size_t shards = DEFAULT_SHARDS)
+    {
+        if (capacity == 0 || shards == 0)
+        {
+            throw std::runtime_error("The LRU cache needs a non-zero capacity and number of shards");
+        }
+
+        shards_.reserve(shards);
+        for (std::size_t i = 0; i < shards; ++i)
+        {
+            shards_.emplace_back(std::make_unique<Shard>());
+        }
+
+        shardCapacity_ = (capacity + shards - 1) / shards;
+    }
+
+    ShardedLRU(const ShardedLRU&) = delete;
+    ShardedLRU& operator=(const ShardedLRU&) = delete;
+
+    /**
+     * @brief Get a copy of the value of key and mark it as the most recently used.
+     *
+     * @return std::optional<Value> The value, or nullopt if the key is not cached.
+     */
+    std::optional<Value> get(const Key& key)
+    {
+        auto& shard = shardFor(key);
+        std::lock_guard lock {shard.mutex};
+
+        auto it = shard.index.find(key);
+        if (it == shard.index.end())
+        {
+            return std::nullopt;
+        }
+
+        shard.items.splice(shard.items.begin(), shard.items, it->second);
+
+        return it->second->second;
+    }
+
+    /**
+     * @brief Insert or replace the value of key, evicting the least recently used entry of its shard if full.
+     */
+    void put(const Key& key, Value value)
+    {
+        auto& shard = shardFor(key);
+        std::lock_guard lock {shard.mutex};
+
+        auto it = shard.index.find(key);
+        if (it != shard.index.end())
+        {
+            it->second->second = std::move(value);
+            shard.items.splice(shard.items.begin(), shard.items, it->second);
+            return;
+        }
+
+        if (shard.index.size() >= shardCapacity_)
+        {
+            // Reuse the evicted node instead of freeing it and allocating a new one
+            auto last = std::prev(shard.items.end());
+            shard.index.erase(last->first);
+            last->first = key;
+            last->second = std::move(value);
+            shard.items.splice(shard.items.begin(), shard.items, last);
+        }
+        else
+        {
+            shard.items.emplace_front(key, std::move(value));
+        }
+
+        shard.index.emplace(key, shard.items.begin());
+    }
+
+    /**
+     * @brief Remove every entry.
+     */
+    void clear()
+    {
+        for (auto& shard : shards_)
+        {
+            std::lock_guard lock {shard->mutex};
+            shard->index.clear();
+            shard->items.clear();
+        }
+    }
+
+    /**
+     * @brief Number of cached entries. Only a snapshot while other threads write.
+     */
+    std::size_t size() const
+    {
+        std::size_t total {0};
+        for (const auto& shard : shards_)
+        {
+            std::lock_guard lock {shard->mutex};
+            total += shard->index.size();
+        }
+
+        return total;
+    }
+};
+
+} // namespace geo
+
+#endif // _GEO_LRU_CACHE_HPP
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <string>
 #include <string_view>
@@ -17,7 +18,8 @@ namespace geo
 /**
  * @brief Class to hold the needed information for a database.
  */
-class DbEntry;
+class DbHandle;
+class CidrTableHandle;
 
 auto constexpr MAX_RETRIES = 3;
 constexpr std::string_view INTERNAL_NAME = "geo";
@@ -28,12 +30,14 @@ constexpr std::string_view TYPE_PATH = "/type";
 class Manager final : public IManager
 {
 private:
-    std::map<std::string, std::shared_ptr<DbEntry>> dbs_; ///< The databases that have been added.
+    std::map<std::string, std::shared_ptr<DbHandle>> dbs_; ///< The databases that have been added.
     std::map<Type, std::string> dbTypes_;  ///< Map by Types for quick access to the db name. (only one db per type)
     mutable std::shared_mutex rwMapMutex_; ///< Mutex to avoid simultaneous updates on the db map
+    std::mutex upsertMutex_;               ///< Serializes the remote upserts, held while downloading
 
     std::shared_ptr<store::IStoreInternal> store_; ///< The store used to store the MMDB hash.
     std::shared_ptr<IDownloader> downloader_;      ///< The downloader used to download the MMDB database.
+    std::shared_ptr<CidrTableHandle> cidrTable_;   ///< Custom networks, matched by the locators before the DBs.
 
     /**
      * @brief Upsert the internal store entry for a database.
@@ -43,6 +47,15 @@ private:
      */
     base::OptError upsertStoreEntry(std::string_view path);
 
+    /**
+     * @brief Upsert the internal store entry for a database whose hash is already known.
+     *
+     * @param path The path to the database.
+     * @param hash The MD5 hash of the database.
+     * @return base::OptError An error if the store entry could not be upserted.
+     */
+    base::OptError upsertStoreEntry(std::string_view path, const std::string& hash);
+
     /**
      * @brief Remove the internal store entry for a database.
      *
@@ -70,13 +83,27 @@ private:
     base::OptError removeDbUnsafe(std::string_view path);
 
     /**
-     * @brief Write the MMDB database to the filesystem.
+     * @brief Check that a remote upsert does not give a type a second database, without any thread safety checks.
      *
-     * @param path Path to store the database.
-     * @param content The content of the database.
-     * @return base::OptError An error if the database could not be written.
+     * @param name Name of the database.
+     * @param type Type of the database.
+     * @return base::OptError An error if the type already has a database with another name.
      */
-    base::OptError writeDb(std::string_view path, std::string_view content);
+    base::OptError checkUpsertTypeUnsafe(const std::string& name, Type type) const;
+
+    /**
+     * @brief Replace the database behind a handle without blocking its readers.
+     *
+     * The downloaded file, next to path, is opened while the current database keeps serving lookups. Only then is it
+     * renamed over path and the new entry published. The old entry is closed by its last reader.
+     *
+     * @param handle The handle of the database.
+     * @param path Path of the database.
+     * @param type Type of the database.
+     * @param downloadPath Path of the verified download, removed if it cannot be opened.
+     * @return base::OptError An error if the new database could not be opened or renamed, the old one is kept.
+     */
+    base::OptError swapDb(DbHandle& handle, std::string_view path, Type type, const std::string& downloadPath);
 
 public:
     ~Manager() override = default;
@@ -115,6 +142,16 @@ public:
      * @copydoc IManager::getLocator
      */
     base::RespOrError<std::shared_ptr<ILocator>> getLocator(Type type) const override;
+
+    /**
+     * @copydoc IManager::loadCidrTable
+     */
+    base::OptError loadCidrTable(const base::Name& name) override;
+
+    /**
+     * @copydoc IManager::getCidrTable
+     */
+    std::shared_ptr<const CidrTable> getCidrTable() const override;
 };
 
 } // namespace geo
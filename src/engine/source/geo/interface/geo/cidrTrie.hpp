@@ -0,0 +1,304 @@
+#ifndef _GEO_CIDR_TRIE_HPP
+#define _GEO_CIDR_TRIE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <geo/ipAddress.hpp>
+
+namespace geo
+{
+
+/**
+ * @brief Network prefix, an address and the number of leading bits that identify the network.
+ */
+struct Cidr
+{
+    IpAddress address;
+    uint8_t prefix {0}; ///< Prefix length in bits of the address family, up to 32 or 128
+
+    /**
+     * @brief Parse "address/prefix", a bare address is a single host prefix.
+     *
+     * Host bits set after the prefix are accepted and ignored, "10.1.2.3/8" is the 10.0.0.0/8 network.
+     *
+     * @return std::optional<Cidr> The prefix, or nullopt if str is not a valid one.
+     */
+    static std::optional<Cidr> parse(std::string_view str) noexcept
+    {
+        const auto slash = str.find('/');
+        auto address = IpAddress::parse(str.substr(0, slash));
+        if (!address)
+        {
+            return std::nullopt;
+        }
+
+        const auto maxPrefix = address->size() * 8;
+        if (slash == std::string_view::npos)
+        {
+            return Cidr {address.value(), static_cast<uint8_t>(maxPrefix)};
+        }
+
+        const auto digits = str.substr(slash + 1);
+        if (digits.empty() || digits.size() > 3 || (digits.size() > 1 && digits[0] == '0'))
+        {
+            return std::nullopt;
+        }
+
+        std::size_t prefix {0};
+        for (const auto c : digits)
+        {
+            if (c < '0' || c > '9')
+            {
+                return std::nullopt;
+            }
+            prefix = prefix * 10 + static_cast<std::size_t>(c - '0');
+        }
+
+        if (prefix > maxPrefix)
+        {
+            return std::nullopt;
+        }
+
+        return Cidr {address.value(), static_cast<uint8_t>(prefix)};
+    }
+};
+
+/**
+ * @brief Longest prefix match table of IPv4 and IPv6 networks.
+ *
+ * A Patricia trie over 128-bit keys: chains of nodes with a single child are collapsed into one node, so a lookup
+ * visits at most one node per stored prefix on its path instead of one per bit. IPv4 networks are stored as IPv4
+ * mapped IPv6 ones (::ffff:0:0/96), so an IPv4 mapped IPv6 address matches them too.
+ *
+ * Not thread safe to modify, build it once and share it read-only.
+ *
+ * @tparam Value Value attached to each prefix.
+ */
+template<typename Value>
+class CidrTrie
+{
+private:
+    struct Key
+    {
+        uint64_t high;
+        uint64_t low;
+    };
+
+    struct Node
+    {
+        Key key;             ///< Bits after length are zero
+        uint8_t length;      ///< Number of meaningful bits of key, 0 to 128
+        uint32_t child[2];   ///< Node index for the next bit, 0 if none (the root is never a child)
+        int32_t value;       ///< Index in values_, -1 for the nodes only splitting two branches
+    };
+
+    std::vector<Node> nodes_ {Node {{0, 0}, 0, {0, 0}, -1}};
+    std::vector<Value> values_;
+
+    static constexpr uint64_t V4_MAPPED {0x0000FFFF00000000ULL};
+    static constexpr unsigned V4_OFFSET {96};
+
+    static Key toKey(const IpAddress& address) noexcept
+    {
+        const auto* bytes = address.data();
+        uint64_t high {0};
+        uint64_t low {0};
+
+        if (address.family() == IpAddress::Family::V4)
+        {
+            low = V4_MAPPED | (uint64_t {bytes[0]} << 24) | (uint64_t {bytes[1]} << 16) | (uint64_t {bytes[2]} << 8)
+                  | uint64_t {bytes[3]};
+        }
+        else
+        {
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                high = (high << 8) | bytes[i];
+                low = (low << 8) | bytes[8 + i];
+            }
+        }
+
+        return {high, low};
+    }
+
+    static Key mask(const Key& key, unsigned length) noexcept
+    {
+        if (length == 0)
+        {
+            return {0, 0};
+        }
+        if (length <= 64)
+        {
+            return {key.high & (~uint64_t {0} << (64 - length)), 0};
+        }
+
+        return {key.high, key.low & (~uint64_t {0} << (128 - length))};
+    }
+
+    static unsigned bit(const Key& key, unsigned index) noexcept
+    {
+        return index < 64 ? (key.high >> (63 - index)) & 1 : (key.low >> (127 - index)) & 1;
+    }
+
+    /**
+     * @brief Number of leading bits shared by both keys, at most max.
+     */
+    static unsigned commonLength(const Key& lhs, const Key& rhs, unsigned max) noexcept
+    {
+        unsigned common {128};
+
+        if (const auto diff = lhs.high ^ rhs.high; diff != 0)
+        {
+            common = static_cast<unsigned>(__builtin_clzll(diff));
+        }
+        else if (const auto diff = lhs.low ^ rhs.low; diff != 0)
+        {
+            common = 64 + static_cast<unsigned>(__builtin_clzll(diff));
+        }
+
+        return std::min(common, max);
+    }
+
+    uint32_t addNode(const Key& key, unsigned length, int32_t value)
+    {
+        nodes_.push_back(Node {mask(key, length), static_cast<uint8_t>(length), {0, 0}, value});
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    int32_t addValue(Value value)
+    {
+        values_.push_back(std::move(value));
+        return static_cast<int32_t>(values_.size() - 1);
+    }
+
+public:
+    CidrTrie() = default;
+
+    /**
+     * @brief Insert a network, replacing the value of an equal one.
+     */
+    void insert(const Cidr& cidr, Value value)
+    {
+        const auto key = toKey(cidr.address);
+        const unsigned length = cidr.prefix + (cidr.address.family() == IpAddress::Family::V4 ? V4_OFFSET : 0);
+
+        // Nodes are referenced by index, addNode may reallocate
+        uint32_t current {0};
+        while (true)
+        {
+            if (nodes_[current].length == length)
+            {
+                if (nodes_[current].value < 0)
+                {
+                    nodes_[current].value = addValue(std::move(value));
+                }
+                else
+                {
+                    values_[nodes_[current].value] = std::move(value);
+                }
+                return;
+            }
+
+            const auto branch = bit(key, nodes_[current].length);
+            const auto next = nodes_[current].child[branch];
+
+            if (next == 0)
+            {
+                const auto leaf = addNode(key, length, addValue(std::move(value)));
+                nodes_[current].child[branch] = leaf;
+                return;
+            }
+
+            const auto nextLength = nodes_[next].length;
+            const auto common = commonLength(nodes_[next].key, key, std::min<unsigned>(nextLength, length));
+
+            if (common == nextLength)
+            {
+                current = next;
+                continue;
+            }
+
+            if (common == length)
+            {
+                // The new network contains the child
+                const auto parent = addNode(key, length, addValue(std::move(value)));
+                nodes_[parent].child[bit(nodes_[next].key, length)] = next;
+                nodes_[current].child[branch] = parent;
+                return;
+            }
+
+            // Both diverge after common bits, join them under a node without value
+            const auto split = addNode(key, common, -1);
+            const auto leaf = addNode(key, length, addValue(std::move(value)));
+            nodes_[split].child[bit(nodes_[next].key, common)] = next;
+            nodes_[split].child[bit(key, common)] = leaf;
+            nodes_[current].child[branch] = split;
+            return;
+        }
+    }
+
+    /**
+     * @brief Value of the most specific network containing the address.
+     *
+     * @return const Value* The value, or nullptr if no network contains it. Valid until the trie is modified.
+     */
+    const Value* match(const IpAddress& address) const noexcept
+    {
+        if (address.empty() || values_.empty())
+        {
+            return nullptr;
+        }
+
+        const auto key = toKey(address);
+        int32_t best {-1};
+        uint32_t current {0};
+
+        while (true)
+        {
+            const auto& node = nodes_[current];
+
+            // Collapsed nodes skip bits, check them before accepting the node
+            if (commonLength(node.key, key, node.length) < node.length)
+            {
+                break;
+            }
+
+            if (node.value >= 0)
+            {
+                best = node.value;
+            }
+
+            if (node.length == 128)
+            {
+                break;
+            }
+
+            const auto next = node.child[bit(key, node.length)];
+            if (next == 0)
+            {
+                break;
+            }
+
+            current = next;
+        }
+
+        return best < 0 ? nullptr : &values_[best];
+    }
+
+    /**
+     * @brief Number of networks.
+     */
+    std::size_t size() const noexcept { return values_.size(); }
+
+    bool empty() const noexcept { return values_.empty(); }
+};
+
+} // namespace geo
+
+#endif // _GEO_CIDR_TRIE_HPP
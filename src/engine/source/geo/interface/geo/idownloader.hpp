@@ -1,6 +1,8 @@
 #ifndef _GEO_IDOWNLOADER_HPP
 #define _GEO_IDOWNLOADER_HPP
 
+#include <filesystem>
+#include <string>
 #include <string_view>
 
 #include <base/error.hpp>
@@ -16,6 +18,20 @@ public:
     virtual base::RespOrError<std::string> downloadHTTPS(std::string_view url) const = 0;
     virtual base::RespOrError<std::string> computeMD5(std::string_view data) const = 0;
     virtual base::RespOrError<std::string> downloadMD5(std::string_view url) const = 0;
+
+    /**
+     * @brief Stream a download into a file, hashing it on the fly.
+     *
+     * If the file already holds the beginning of the download (e.g. from a failed attempt) only the rest is
+     * requested with a Range header. The server may ignore the range, the file is then rewritten from the start.
+     *
+     * @param url The url to download.
+     * @param path The file to write, created if it does not exist.
+     * @return base::RespOrError<std::string> The MD5 hash of the whole file, or an error. The file is kept on errors
+     * so a later call can resume it.
+     */
+    virtual base::RespOrError<std::string> downloadHTTPSToFile(std::string_view url,
+                                                              const std::filesystem::path& path) const = 0;
 };
 
 } // namespace geo
@@ -6,6 +6,9 @@
 #include <base/json.hpp>
 #include <base/dotPath.hpp>
 
+#include <geo/ipAddress.hpp>
+#include <geo/locatorQuery.hpp>
+
 namespace geo
 {
 
@@ -49,10 +52,73 @@ public:
      * @param path The path to the data.
      * @return base::RespOrError<json::Json>  Either the data as a json object or an error if the data could not be
      * retrieved.
-     * @note this method not supported array or object type.
+     * @note Maps and arrays are returned whole, e.g. the path "city" returns the full city object.
      */
     virtual base::RespOrError<json::Json> getAsJson(std::string_view ip, const DotPath& path) = 0;
 
+    /**
+     * @brief Get the string data at the given path for an already parsed address.
+     *
+     * The IpAddress overloads let callers parse an address once and reuse it across several locators.
+     *
+     * @param ip Target ip to query
+     * @param path The path to the data.
+     * @return Either the data as a string or an error if the data could not be retrieved.
+     */
+    virtual base::RespOrError<std::string> getString(const IpAddress& ip, const DotPath& path) = 0;
+
+    /**
+     * @brief Get the Uint32 data at the given path for an already parsed address.
+     *
+     * @param ip Target ip to query
+     * @param path The path to the data.
+     * @return base::RespOrError<uint32_t> Either the data as a uint32_t or an error if the data could not be retrieved.
+     */
+    virtual base::RespOrError<uint32_t> getUint32(const IpAddress& ip, const DotPath& path) = 0;
+
+    /**
+     * @brief Get the Double data at the given path for an already parsed address.
+     *
+     * @param ip Target ip to query
+     * @param path The path to the data.
+     * @return base::RespOrError<double>  Either the data as a double or an error if the data could not be retrieved.
+     */
+    virtual base::RespOrError<double> getDouble(const IpAddress& ip, const DotPath& path) = 0;
+
+    /**
+     * @brief Get the data at the given path as a json object for an already parsed address.
+     *
+     * @param ip Target ip to query
+     * @param path The path to the data.
+     * @return base::RespOrError<json::Json>  Either the data as a json object or an error if the data could not be
+     * retrieved.
+     * @note Maps and arrays are returned whole, e.g. the path "city" returns the full city object.
+     */
+    virtual base::RespOrError<json::Json> getAsJson(const IpAddress& ip, const DotPath& path) = 0;
+
+    /**
+     * @brief Read every field of a compiled query in a single lookup.
+     *
+     * Each field found is written into output at its target, maps and arrays included. Fields missing from the
+     * record are skipped.
+     *
+     * @param ip Target ip to query
+     * @param query The compiled fields to read.
+     * @param output Where the fields are written.
+     * @return base::OptError An error if the database is not available or the IP could not be looked up or found.
+     */
+    virtual base::OptError getFields(std::string_view ip, const LocatorQuery& query, json::Json& output) = 0;
+
+    /**
+     * @brief Read every field of a compiled query in a single lookup for an already parsed address.
+     *
+     * @param ip Target ip to query
+     * @param query The compiled fields to read.
+     * @param output Where the fields are written.
+     * @return base::OptError An error if the database is not available or the IP could not be looked up or found.
+     */
+    virtual base::OptError getFields(const IpAddress& ip, const LocatorQuery& query, json::Json& output) = 0;
+
 };
 
 } // namespace geo
@@ -7,7 +7,10 @@
 #include <string_view>
 
 #include <base/error.hpp>
+#include <base/json.hpp>
+#include <base/name.hpp>
 
+#include <geo/cidrTrie.hpp>
 #include <geo/ilocator.hpp>
 
 namespace geo
@@ -81,6 +84,11 @@ inline auto validTypeNames()
     return fmt::format("{}, {}", typeName(Type::CITY), typeName(Type::ASN));
 }
 
+/**
+ * @brief Custom networks (internal sites, owners...) and the data attached to each of them.
+ */
+using CidrTable = CidrTrie<json::Json>;
+
 /**
  * @brief Manages geo databases and allows getting locators for querying the databases.
  *
@@ -135,6 +143,28 @@ public:
      * locator could not be retrieved.
      */
     virtual base::RespOrError<std::shared_ptr<ILocator>> getLocator(Type type) const = 0;
+
+    /**
+     * @brief Load the custom CIDR table from a store document, replacing the current one.
+     *
+     * The document is an object of networks to their data, e.g. {"10.1.0.0/16": {"site": "hq", "owner": "it"}}.
+     * The locators match addresses against the table before their database, the fields of a matching network
+     * (e.g. "site") are returned instead of the database ones.
+     *
+     * @param name Name of the internal store document.
+     * @return base::OptError An error if the document could not be read or is not a valid table, the current table
+     * is kept.
+     */
+    virtual base::OptError loadCidrTable(const base::Name& name) = 0;
+
+    /**
+     * @brief Get the current custom CIDR table, empty until one is loaded.
+     *
+     * The table is immutable, a reload publishes a new one and never changes the tables already handed out.
+     *
+     * @return std::shared_ptr<const CidrTable>
+     */
+    virtual std::shared_ptr<const CidrTable> getCidrTable() const = 0;
 };
 
 } // namespace geo
@@ -0,0 +1,365 @@
+#ifndef _GEO_IP_ADDRESS_HPP
+#define _GEO_IP_ADDRESS_HPP
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace geo
+{
+
+/**
+ * @brief Binary IPv4 or IPv6 address.
+ *
+ * Parsing is done by hand, without getaddrinfo or inet_pton, so it never depends on the locale or NSS and an address
+ * can be parsed once and reused across lookups in several databases.
+ */
+class IpAddress
+{
+public:
+    enum class Family : uint8_t
+    {
+        NONE = 0,
+        V4 = 4,
+        V6 = 6,
+    };
+
+private:
+    std::array<uint8_t, 16> bytes_ {}; ///< Network order, IPv4 addresses use the first 4 bytes
+    Family family_ {Family::NONE};
+
+    static int hexValue(char c) noexcept
+    {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f')
+        {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F')
+        {
+            return c - 'A' + 10;
+        }
+
+        return -1;
+    }
+
+    /**
+     * @brief Parse a strict dotted decimal IPv4 address (4 parts, no leading zeros).
+     */
+    static bool parseV4(std::string_view str, uint8_t* out) noexcept
+    {
+        std::size_t part {0};
+        std::size_t i {0};
+
+        while (part < 4)
+        {
+            const auto start = i;
+            unsigned value {0};
+
+            while (i < str.size() && str[i] >= '0' && str[i] <= '9' && i - start < 3)
+            {
+                value = value * 10 + static_cast<unsigned>(str[i] - '0');
+                ++i;
+            }
+
+            const auto digits = i - start;
+            // Leading zeros are octal for inet_aton, reject them instead of guessing
+            if (digits == 0 || value > 255 || (digits > 1 && str[start] == '0'))
+            {
+                return false;
+            }
+
+            out[part++] = static_cast<uint8_t>(value);
+
+            if (part < 4)
+            {
+                if (i >= str.size() || str[i] != '.')
+                {
+                    return false;
+                }
+                ++i;
+            }
+        }
+
+        return i == str.size();
+    }
+
+    /**
+     * @brief Parse an IPv6 address (RFC 4291 text form, with optional "::" and trailing dotted IPv4).
+     */
+    static bool parseV6(std::string_view str, uint8_t* out) noexcept
+    {
+        std::array<uint16_t, 8> head {};
+        std::array<uint16_t, 8> tail {};
+        std::size_t headCount {0};
+        std::size_t tailCount {0};
+        bool compressed {false};
+
+        auto push = [&](uint16_t group) -> bool
+        {
+            if (headCount + tailCount >= 8)
+            {
+                return false;
+            }
+
+            if (compressed)
+            {
+                tail[tailCount++] = group;
+            }
+            else
+            {
+                head[headCount++] = group;
+            }
+
+            return true;
+        };
+
+        std::size_t i {0};
+
+        if (str.size() >= 2 && str[0] == ':' && str[1] == ':')
+        {
+            compressed = true;
+            i = 2;
+        }
+        else if (!str.empty() && str[0] == ':')
+        {
+            return false;
+        }
+
+        while (i < str.size())
+        {
+            auto end = str.find(':', i);
+            if (end == std::string_view::npos)
+            {
+                end = str.size();
+            }
+
+            const auto token = str.substr(i, end - i);
+
+            if (token.find('.') != std::string_view::npos)
+            {
+                // Embedded IPv4, only allowed as the last two groups
+                uint8_t v4[4];
+                if (end != str.size() || !parseV4(token, v4)
+                    || !push(static_cast<uint16_t>((v4[0] << 8) | v4[1]))
+                    || !push(static_cast<uint16_t>((v4[2] << 8) | v4[3])))
+                {
+                    return false;
+                }
+
+                break;
+            }
+
+            if (token.empty() || token.size() > 4)
+            {
+                return false;
+            }
+
+            unsigned group {0};
+            for (const auto c : token)
+            {
+                const auto value = hexValue(c);
+                if (value < 0)
+                {
+                    return false;
+                }
+                group = (group << 4) | static_cast<unsigned>(value);
+            }
+
+            if (!push(static_cast<uint16_t>(group)))
+            {
+                return false;
+            }
+
+            if (end == str.size())
+            {
+                break;
+            }
+
+            if (end + 1 < str.size() && str[end + 1] == ':')
+            {
+                if (compressed)
+                {
+                    return false;
+                }
+
+                compressed = true;
+                i = end + 2;
+            }
+            else
+            {
+                i = end + 1;
+
+                // Trailing single colon
+                if (i == str.size())
+                {
+                    return false;
+                }
+            }
+        }
+
+        const auto groups = headCount + tailCount;
+        if ((compressed && groups > 7) || (!compressed && groups != 8))
+        {
+            return false;
+        }
+
+        std::array<uint16_t, 8> all {};
+        for (std::size_t g = 0; g < headCount; ++g)
+        {
+            all[g] = head[g];
+        }
+        for (std::size_t g = 0; g < tailCount; ++g)
+        {
+            all[8 - tailCount + g] = tail[g];
+        }
+
+        for (std::size_t g = 0; g < 8; ++g)
+        {
+            out[2 * g] = static_cast<uint8_t>(all[g] >> 8);
+            out[2 * g + 1] = static_cast<uint8_t>(all[g] & 0xFF);
+        }
+
+        return true;
+    }
+
+public:
+    /**
+     * @brief Hash of an address, to use it as an unordered container key.
+     */
+    struct Hash
+    {
+        std::size_t operator()(const IpAddress& address) const noexcept
+        {
+            uint64_t high;
+            uint64_t low;
+            std::memcpy(&high, address.bytes_.data(), sizeof(high));
+            std::memcpy(&low, address.bytes_.data() + sizeof(high), sizeof(low));
+
+            auto h = (high ^ (low * 0x9E3779B97F4A7C15ULL)) + static_cast<uint64_t>(address.family_);
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 33;
+
+            return static_cast<std::size_t>(h);
+        }
+    };
+
+    IpAddress() = default;
+
+    /**
+     * @brief Parse an IPv4 or IPv6 address.
+     *
+     * IPv4 addresses must be in strict dotted decimal form. IPv6 addresses may use "::" and a trailing dotted IPv4,
+     * zone identifiers ("%eth0") are not supported.
+     *
+     * @param str Address text.
+     * @return std::optional<IpAddress> The address, or nullopt if str is not a valid address.
+     */
+    static std::optional<IpAddress> parse(std::string_view str) noexcept
+    {
+        IpAddress address;
+
+        if (str.find(':') != std::string_view::npos)
+        {
+            if (!parseV6(str, address.bytes_.data()))
+            {
+                return std::nullopt;
+            }
+            address.family_ = Family::V6;
+        }
+        else
+        {
+            if (!parseV4(str, address.bytes_.data()))
+            {
+                return std::nullopt;
+            }
+            address.family_ = Family::V4;
+        }
+
+        return address;
+    }
+
+    Family family() const noexcept { return family_; }
+
+    bool empty() const noexcept { return family_ == Family::NONE; }
+
+    /**
+     * @brief Number of meaningful bytes: 4, 16, or 0 for an empty address.
+     */
+    std::size_t size() const noexcept
+    {
+        return family_ == Family::V4 ? 4 : family_ == Family::V6 ? 16 : 0;
+    }
+
+    /**
+     * @brief Address bytes in network order, size() of them are meaningful.
+     */
+    const uint8_t* data() const noexcept { return bytes_.data(); }
+
+    /**
+     * @brief Fill a socket address for the address, with port 0.
+     *
+     * @param storage Storage to fill, large enough for both families.
+     * @return socklen_t Length of the filled address, 0 for an empty address.
+     */
+    socklen_t toSockaddr(sockaddr_storage& storage) const noexcept
+    {
+        std::memset(&storage, 0, sizeof(storage));
+
+        if (family_ == Family::V4)
+        {
+            auto& sin = reinterpret_cast<sockaddr_in&>(storage);
+            sin.sin_family = AF_INET;
+            std::memcpy(&sin.sin_addr, bytes_.data(), 4);
+            return sizeof(sockaddr_in);
+        }
+
+        if (family_ == Family::V6)
+        {
+            auto& sin6 = reinterpret_cast<sockaddr_in6&>(storage);
+            sin6.sin6_family = AF_INET6;
+            std::memcpy(&sin6.sin6_addr, bytes_.data(), 16);
+            return sizeof(sockaddr_in6);
+        }
+
+        return 0;
+    }
+
+    /**
+     * @brief Text form of the address, empty for an empty address. Not meant for hot paths.
+     */
+    std::string str() const
+    {
+        if (empty())
+        {
+            return {};
+        }
+
+        char buffer[INET6_ADDRSTRLEN] {};
+        inet_ntop(family_ == Family::V4 ? AF_INET : AF_INET6, bytes_.data(), buffer, sizeof(buffer));
+
+        return buffer;
+    }
+
+    friend bool operator==(const IpAddress& lhs, const IpAddress& rhs) noexcept
+    {
+        return lhs.family_ == rhs.family_ && lhs.bytes_ == rhs.bytes_;
+    }
+
+    friend bool operator!=(const IpAddress& lhs, const IpAddress& rhs) noexcept { return !(lhs == rhs); }
+};
+
+} // namespace geo
+
+#endif // _GEO_IP_ADDRESS_HPP
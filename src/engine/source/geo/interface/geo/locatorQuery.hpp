@@ -0,0 +1,107 @@
+#ifndef _GEO_LOCATOR_QUERY_HPP
+#define _GEO_LOCATOR_QUERY_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <base/dotPath.hpp>
+
+namespace geo
+{
+
+/**
+ * @brief Set of database paths to read in a single lookup, compiled once and reused for every IP.
+ *
+ * The source paths are merged into a trie so a locator can walk the decoded record once and, at each map key or
+ * array index, know in constant time whether anything below it was requested.
+ */
+class LocatorQuery
+{
+public:
+    /**
+     * @brief Trie node, the root is nodes()[0].
+     */
+    struct Node
+    {
+        std::vector<std::pair<std::string, uint32_t>> children; ///< Path part (map key or array index) to node index
+        std::vector<std::string> targets; ///< JSON pointers where the value at this node is written
+
+        /**
+         * @brief Index of the child for the given path part, 0 if there is none (the root is never a child).
+         */
+        uint32_t child(std::string_view part) const
+        {
+            for (const auto& [name, index] : children)
+            {
+                if (name == part)
+                {
+                    return index;
+                }
+            }
+
+            return 0;
+        }
+    };
+
+private:
+    std::vector<Node> nodes_;
+    std::size_t size_ {0};
+
+public:
+    /**
+     * @brief Compile a query.
+     *
+     * @param fields Pairs of database path (e.g. "city.names.en" or "subdivisions.0.iso_code") and JSON pointer of the
+     * output where its value is written. Several fields may share a path.
+     * @throws std::runtime_error if a path is the root or a target is not a JSON pointer.
+     */
+    explicit LocatorQuery(const std::vector<std::pair<DotPath, std::string>>& fields)
+        : nodes_(1)
+    {
+        for (const auto& [path, target] : fields)
+        {
+            if (path.isRoot())
+            {
+                throw std::runtime_error("A locator query cannot read the root of the database record");
+            }
+
+            if (target.empty() || target.front() != '/')
+            {
+                throw std::runtime_error(
+                    "The target of the locator query path '" + path.str() + "' must be a JSON pointer");
+            }
+
+            uint32_t current {0};
+            for (const auto& part : path.parts())
+            {
+                auto next = nodes_[current].child(part);
+                if (next == 0)
+                {
+                    next = static_cast<uint32_t>(nodes_.size());
+                    nodes_[current].children.emplace_back(part, next);
+                    nodes_.emplace_back();
+                }
+
+                current = next;
+            }
+
+            nodes_[current].targets.emplace_back(target);
+            ++size_;
+        }
+    }
+
+    const std::vector<Node>& nodes() const { return nodes_; }
+
+    /**
+     * @brief Number of fields of the query.
+     */
+    std::size_t size() const { return size_; }
+};
+
+} // namespace geo
+
+#endif // _GEO_LOCATOR_QUERY_HPP
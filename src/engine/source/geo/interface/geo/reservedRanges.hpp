@@ -0,0 +1,43 @@
+#ifndef _GEO_RESERVED_RANGES_HPP
+#define _GEO_RESERVED_RANGES_HPP
+
+#include <array>
+#include <string_view>
+#include <utility>
+
+namespace geo
+{
+
+/**
+ * @brief Special purpose networks (IANA IPv4 and IPv6 special-purpose address registries) and their kind.
+ *
+ * Public geolocation databases have no data for them.
+ */
+constexpr std::array<std::pair<std::string_view, std::string_view>, 22> RESERVED_RANGES {{
+    {"0.0.0.0/8", "this-network"},
+    {"10.0.0.0/8", "private"},
+    {"100.64.0.0/10", "shared"},
+    {"127.0.0.0/8", "loopback"},
+    {"169.254.0.0/16", "link-local"},
+    {"172.16.0.0/12", "private"},
+    {"192.0.0.0/24", "protocol-assignments"},
+    {"192.0.2.0/24", "documentation"},
+    {"192.168.0.0/16", "private"},
+    {"198.18.0.0/15", "benchmarking"},
+    {"198.51.100.0/24", "documentation"},
+    {"203.0.113.0/24", "documentation"},
+    {"224.0.0.0/4", "multicast"},
+    {"240.0.0.0/4", "reserved"},
+    {"::/128", "unspecified"},
+    {"::1/128", "loopback"},
+    {"64:ff9b:1::/48", "private"},
+    {"100::/64", "discard"},
+    {"2001:db8::/32", "documentation"},
+    {"fc00::/7", "private"},
+    {"fe80::/10", "link-local"},
+    {"ff00::/8", "multicast"},
+}};
+
+} // namespace geo
+
+#endif // _GEO_RESERVED_RANGES_HPP
@@ -1,7 +1,10 @@
 #include <geo/downloader.hpp>
 
 #include <algorithm>
+#include <cstdio>
+#include <filesystem>
 #include <iomanip>
+#include <memory>
 
 #include <openssl/evp.h>
 #include <cpr/cpr.h>
@@ -9,6 +12,8 @@
 #include <fmt/format.h>
 
 #include <sstream>
+#include <system_error>
+#include <vector>
 namespace
 {
 [[maybe_unused]] std::size_t writeCallback(void* contents, std::size_t size, std::size_t nmemb, std::string* userp)
@@ -22,6 +27,80 @@ bool isMD5Hash(const std::string_view str)
 {
     return str.size() == 32 && std::all_of(str.cbegin(), str.cend(), ::isxdigit);
 }
+
+/**
+ * @brief Incremental MD5 digest.
+ */
+class MD5Stream
+{
+private:
+    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx_ {EVP_MD_CTX_new(), &EVP_MD_CTX_free};
+    bool ok_ {false};
+
+public:
+    MD5Stream() { reset(); }
+
+    void reset() { ok_ = ctx_ && EVP_DigestInit_ex(ctx_.get(), EVP_md5(), nullptr) == 1; }
+
+    void update(const void* data, std::size_t size)
+    {
+        ok_ = ok_ && EVP_DigestUpdate(ctx_.get(), data, size) == 1;
+    }
+
+    bool ok() const { return ok_; }
+
+    /**
+     * @brief Hex digest of everything fed so far.
+     */
+    std::string hex()
+    {
+        unsigned char digest[EVP_MAX_MD_SIZE] = {0};
+        unsigned int digestLen {0};
+
+        if (!ok_ || EVP_DigestFinal_ex(ctx_.get(), digest, &digestLen) != 1)
+        {
+            ok_ = false;
+            return {};
+        }
+
+        std::stringstream ss;
+        for (unsigned int i = 0; i < digestLen; ++i)
+        {
+            ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(digest[i]);
+        }
+
+        return ss.str();
+    }
+};
+
+/**
+ * @brief Parse the status code of a "HTTP/x.y CODE reason" header line, -1 if it is another header.
+ */
+long parseStatusLine(std::string_view header)
+{
+    if (header.substr(0, 5) != "HTTP/")
+    {
+        return -1;
+    }
+
+    const auto space = header.find(' ');
+    if (space == std::string_view::npos || header.size() < space + 4)
+    {
+        return -1;
+    }
+
+    long code {0};
+    for (std::size_t i = space + 1; i < space + 4; ++i)
+    {
+        if (header[i] < '0' || header[i] > '9')
+        {
+            return -1;
+        }
+        code = code * 10 + (header[i] - '0');
+    }
+
+    return code;
+}
 } // namespace
 
 
@@ -89,6 +168,143 @@ base::RespOrError<std::string> Downloader::computeMD5(std::string_view data) con
     return ss.str();
 }
 
+base::RespOrError<std::string> Downloader::downloadHTTPSToFile(std::string_view url,
+                                                                const std::filesystem::path& path) const
+{
+    constexpr std::size_t READ_CHUNK_SIZE {64 * 1024};
+    constexpr long HTTP_PARTIAL_CONTENT {206};
+    constexpr long HTTP_RANGE_NOT_SATISFIABLE {416};
+
+    std::unique_ptr<FILE, decltype(&std::fclose)> file {std::fopen(path.c_str(), "a+b"), &std::fclose};
+
+    if (!file)
+    {
+        return base::Error{
+            fmt::format(
+                "Cannot open file '{}'",
+                path.string()
+            )
+        };
+    }
+
+    // Hash what a previous attempt already wrote, the download resumes after it
+    MD5Stream md5;
+    std::size_t offset {0};
+    std::vector<char> buffer(READ_CHUNK_SIZE);
+
+    std::rewind(file.get());
+    for (std::size_t read; (read = std::fread(buffer.data(), 1, buffer.size(), file.get())) > 0;)
+    {
+        md5.update(buffer.data(), read);
+        offset += read;
+    }
+
+    long status {0};
+    bool bodyStarted {false};
+    bool writeError {false};
+
+    cpr::Header header{};
+    if (offset > 0)
+    {
+        header.emplace("Range", fmt::format("bytes={}-", offset));
+    }
+
+    cpr::Response response = cpr::Get(
+        cpr::Url{std::string{url}},
+        header,
+        cpr::HeaderCallback{[&status](std::string_view line, intptr_t)
+        {
+            // Redirects send several status lines, the last one is the one of the body
+            if (const auto code = parseStatusLine(line); code != -1)
+            {
+                status = code;
+            }
+
+            return true;
+        }},
+        cpr::WriteCallback{[&](std::string_view data, intptr_t)
+        {
+            if (status < 200 || status >= 300)
+            {
+                // Error bodies are not part of the file
+                return true;
+            }
+
+            if (!bodyStarted)
+            {
+                bodyStarted = true;
+
+                // The server ignored the range and sends everything again
+                if (status != HTTP_PARTIAL_CONTENT && offset > 0)
+                {
+                    // Throwing out of the callback would unwind through curl, abort the transfer instead
+                    std::error_code ec;
+                    if (std::fflush(file.get()) == 0)
+                    {
+                        std::filesystem::resize_file(path, 0, ec);
+                    }
+
+                    if (std::ferror(file.get()) || ec)
+                    {
+                        writeError = true;
+                        return false;
+                    }
+
+                    md5.reset();
+                    offset = 0;
+                }
+            }
+
+            if (std::fwrite(data.data(), 1, data.size(), file.get()) != data.size())
+            {
+                writeError = true;
+                return false;
+            }
+
+            md5.update(data.data(), data.size());
+
+            return true;
+        }}
+    );
+
+    if (std::fflush(file.get()) != 0 || writeError)
+    {
+        return base::Error{
+            fmt::format(
+                "Cannot write file '{}'",
+                path.string()
+            )
+        };
+    }
+
+    // Everything was already there
+    if (status == HTTP_RANGE_NOT_SATISFIABLE && offset > 0)
+    {
+        status = HTTP_PARTIAL_CONTENT;
+    }
+
+    if (response.error || status < 200 || status >= 300)
+    {
+        return base::Error{
+            fmt::format(
+                "Failed to download file from '{}'. error {}, status code: {}.",
+                url, response.error.message, status
+            )
+        };
+    }
+
+    auto hash = md5.hex();
+
+    if (!md5.ok())
+    {
+        return base::Error{
+            "Failed to compute the MD5 of the download"
+        };
+    }
+
+    return hash;
+}
+
 base::RespOrError<std::string> Downloader::downloadMD5(std::string_view url) const
 {
     auto response = downloadHTTPS(url);
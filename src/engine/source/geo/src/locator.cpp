@@ -4,7 +4,6 @@
 #include <cstdint>
 #include <iomanip>
 #include <iostream>
-#include <shared_mutex>
 #include <sstream>
 
 #include <fmt/format.h>
@@ -78,181 +77,371 @@ std::string bytesToHexString(const uint8_t* bytes, size_t length)
     return ss.str();
 }
 
-MMDB_entry_data_list_s*
-dumpEntryDataList(MMDB_entry_data_list_s* eDataList, json::Json& jDump, const std::string& path);
+using JsonAllocator = rapidjson::Document::AllocatorType;
 
 /**
- * @brief Dumps the contents of a map entry in the MMDB database to a JSON object.
+ * @brief Converts a scalar entry data to a JSON value.
  *
- * This function takes a linked list of MMDB entry data representing a map entry in the
- * MMDB database, and dumps its contents to a JSON object. The dumped data is stored in
- * the provided JSON object `jDump` under the specified `path`.
+ * Bytes and 128-bit integers become hexadecimal strings, and 64-bit unsigned integers become decimal strings.
  *
- * @param eDataList The linked list of MMDB entry data representing the map entry.
- * @param jDump The JSON object to store the dumped data.
- * @param path The path where the dumped data should be stored in the JSON object.
- * @return The next node in the linked list after the map entry has been dumped.
- * @throws std::runtime_error if the provided entry data list is null or the entry data type is not MMDB_DATA_TYPE_MAP.
- * @throws std::runtime_error if an error occurs while dumping the map entry data.
+ * @param eData The entry data to convert.
+ * @param value The JSON value to set.
+ * @param allocator The allocator of the document owning value.
+ * @throws std::runtime_error if the entry data is a map, an array or of an unknown type.
  */
-MMDB_entry_data_list_s* dumpMap(MMDB_entry_data_list_s* eDataList, json::Json& jDump, const std::string& path)
+void setScalarValue(const MMDB_entry_data_s& eData, rapidjson::Value& value, JsonAllocator& allocator)
 {
-    if (eDataList == nullptr || eDataList->entry_data.type != MMDB_DATA_TYPE_MAP)
+    switch (eData.type)
     {
-        throw std::runtime_error {"Error dumping map"};
+        case MMDB_DATA_TYPE_UTF8_STRING:
+            value.SetString(eData.utf8_string, static_cast<rapidjson::SizeType>(eData.data_size), allocator);
+            break;
+        case MMDB_DATA_TYPE_BYTES:
+        {
+            const auto hex = bytesToHexString(eData.bytes, eData.data_size);
+            value.SetString(hex.c_str(), static_cast<rapidjson::SizeType>(hex.size()), allocator);
+            break;
+        }
+        case MMDB_DATA_TYPE_DOUBLE: value.SetDouble(eData.double_value); break;
+        case MMDB_DATA_TYPE_FLOAT: value.SetFloat(eData.float_value); break;
+        case MMDB_DATA_TYPE_UINT16: value.SetUint(eData.uint16); break;
+        case MMDB_DATA_TYPE_UINT32: value.SetUint(eData.uint32); break;
+        case MMDB_DATA_TYPE_BOOLEAN: value.SetBool(eData.boolean); break;
+        case MMDB_DATA_TYPE_UINT64:
+        {
+            const auto str = std::to_string(eData.uint64);
+            value.SetString(str.c_str(), static_cast<rapidjson::SizeType>(str.size()), allocator);
+            break;
+        }
+        case MMDB_DATA_TYPE_UINT128:
+        {
+            const auto hex = uint128toHexString(eData.uint128);
+            value.SetString(hex.c_str(), static_cast<rapidjson::SizeType>(hex.size()), allocator);
+            break;
+        }
+        case MMDB_DATA_TYPE_INT32: value.SetInt(eData.int32); break;
+        default:
+            throw std::runtime_error {
+                fmt::format("Error dumping entry data list: {}", MMDB_strerror(MMDB_INVALID_DATA_ERROR))};
     }
+}
 
-    jDump.setObject(path);
+/**
+ * @brief Builds the JSON value of a node of the entry data list, with all its children if it is a map or an array.
+ *
+ * The list is walked once and the value is built in place, so no JSON pointer is parsed and the cost is linear in
+ * the number of nodes whatever the depth.
+ *
+ * @param eDataList The first node of the value.
+ * @param value The JSON value to set.
+ * @param allocator The allocator of the document owning value.
+ * @return The node after the value.
+ * @throws std::runtime_error if the entry data list is truncated or has invalid data.
+ */
+MMDB_entry_data_list_s* buildValue(MMDB_entry_data_list_s* eDataList, rapidjson::Value& value, JsonAllocator& allocator)
+{
+    if (eDataList == nullptr)
+    {
+        throw std::runtime_error {
+            fmt::format("Error dumping entry data list: {}", MMDB_strerror(MMDB_INVALID_DATA_ERROR))};
+    }
 
+    const auto type = eDataList->entry_data.type;
     uint32_t size = eDataList->entry_data.data_size;
-    for (eDataList = eDataList->next; size && eDataList; size--)
+
+    if (MMDB_DATA_TYPE_MAP == type)
     {
+        value.SetObject();
 
-        if (MMDB_DATA_TYPE_UTF8_STRING != eDataList->entry_data.type)
+        for (eDataList = eDataList->next; size && eDataList; size--)
         {
-            throw std::runtime_error {fmt::format("Error dumping map: {}", MMDB_strerror(MMDB_INVALID_DATA_ERROR))};
+            if (MMDB_DATA_TYPE_UTF8_STRING != eDataList->entry_data.type)
+            {
+                throw std::runtime_error {fmt::format("Error dumping map: {}", MMDB_strerror(MMDB_INVALID_DATA_ERROR))};
+            }
+
+            rapidjson::Value key {eDataList->entry_data.utf8_string,
+                                  static_cast<rapidjson::SizeType>(eDataList->entry_data.data_size),
+                                  allocator};
+            rapidjson::Value child;
+            eDataList = buildValue(eDataList->next, child, allocator);
+
+            value.AddMember(key, child, allocator);
         }
-        std::string fullKey =
-            path + "/" + std::string(eDataList->entry_data.utf8_string, eDataList->entry_data.data_size);
 
-        eDataList = eDataList->next;
-        eDataList = dumpEntryDataList(eDataList, jDump, fullKey);
+        return eDataList;
     }
 
-    return eDataList;
+    if (MMDB_DATA_TYPE_ARRAY == type)
+    {
+        value.SetArray();
+        value.Reserve(size, allocator);
+
+        for (eDataList = eDataList->next; size && eDataList; size--)
+        {
+            rapidjson::Value child;
+            eDataList = buildValue(eDataList, child, allocator);
+
+            value.PushBack(child, allocator);
+        }
+
+        return eDataList;
+    }
+
+    setScalarValue(eDataList->entry_data, value, allocator);
+
+    return eDataList->next;
 }
 
 /**
- * @brief Dumps the array data from MMDB_entry_data_list_s to a JSON object.
+ * @brief Dumps a node of the entry data list, with all its children, to a JSON document.
  *
- * This function dumps the array data from the given MMDB_entry_data_list_s
- * to a JSON object specified by the provided path. It iterates through the
- * linked list and recursively calls dumpEntryDataList to dump each entry data.
+ * @param eDataList The first node of the value.
+ * @return json::Json The value.
+ * @throws std::runtime_error if the entry data list is truncated or has invalid data.
+ */
+json::Json dumpEntryDataList(MMDB_entry_data_list_s* eDataList)
+{
+    rapidjson::Document document;
+    buildValue(eDataList, document, document.GetAllocator());
+
+    return json::Json {std::move(document)};
+}
+
+/**
+ * @brief Skips a value of the entry data list, with all its children if it is a map or an array.
  *
- * @param eDataList The MMDB_entry_data_list_s to dump.
- * @param jDump The JSON object to dump the array data into.
- * @param path The path to the array in the JSON object.
- * @return The next MMDB_entry_data_list_s node after the dumped array.
- * @throws std::runtime_error if the provided eDataList is nullptr or the entry data type is not MMDB_DATA_TYPE_ARRAY.
+ * @param eDataList The first node of the value.
+ * @return The node after the value.
  */
-MMDB_entry_data_list_s* dumpArray(MMDB_entry_data_list_s* eDataList, json::Json& jDump, const std::string& path)
+MMDB_entry_data_list_s* skipEntryData(MMDB_entry_data_list_s* eDataList)
 {
-    if (eDataList == nullptr || eDataList->entry_data.type != MMDB_DATA_TYPE_ARRAY)
+    if (eDataList == nullptr)
     {
-        throw std::runtime_error {fmt::format("Error dumping array: {}", MMDB_strerror(MMDB_INVALID_DATA_ERROR))};
+        return nullptr;
     }
 
-    jDump.setArray(path);
-
+    const auto type = eDataList->entry_data.type;
     uint32_t size = eDataList->entry_data.data_size;
-    uint32_t index = 0;
-    for (eDataList = eDataList->next; size && eDataList; size--)
+    eDataList = eDataList->next;
+
+    if (MMDB_DATA_TYPE_MAP == type)
     {
-        std::string fullKey = path + "/" + std::to_string(index++);
-        eDataList = dumpEntryDataList(eDataList, jDump, fullKey);
+        for (; size && eDataList; size--)
+        {
+            eDataList = skipEntryData(eDataList->next); // Key, then value
+        }
+    }
+    else if (MMDB_DATA_TYPE_ARRAY == type)
+    {
+        for (; size && eDataList; size--)
+        {
+            eDataList = skipEntryData(eDataList);
+        }
     }
 
     return eDataList;
 }
 
 /**
- * @brief Dumps the MMDB entry data list to a JSON object.
+ * @brief Writes the requested fields of a value of the entry data list.
  *
- * This function iterates over the MMDB entry data list and converts each data type
- * to its corresponding JSON representation. The resulting JSON object is stored in
- * the provided `jDump` object at the specified `path`.
- *
- * @param eDataList The MMDB entry data list to be dumped.
- * @param jDump The JSON object to store the dumped data.
- * @param path The path within the JSON object to store the dumped data.
- * @return The updated MMDB entry data list after dumping the current node.
- * @throws std::runtime_error if an error occurs while dumping the entry data list.
+ * @param eDataList The first node of the value.
+ * @param query The compiled query.
+ * @param node The query node matching the path of the value.
+ * @param output Where the fields are written.
+ * @return The node after the value.
  */
-MMDB_entry_data_list_s* dumpEntryDataList(MMDB_entry_data_list_s* eDataList, json::Json& jDump, const std::string& path)
+MMDB_entry_data_list_s* queryEntryData(MMDB_entry_data_list_s* eDataList,
+                                       const geo::LocatorQuery& query,
+                                       const geo::LocatorQuery::Node& node,
+                                       json::Json& output)
 {
-    switch (eDataList->entry_data.type)
+    if (eDataList == nullptr)
     {
-        case MMDB_DATA_TYPE_MAP: eDataList = dumpMap(eDataList, jDump, path); break;
-        case MMDB_DATA_TYPE_ARRAY: eDataList = dumpArray(eDataList, jDump, path); break;
-        case MMDB_DATA_TYPE_UTF8_STRING:
-            jDump.setType(path, std::string(eDataList->entry_data.utf8_string, eDataList->entry_data.data_size));
-            eDataList = eDataList->next;
-            break;
-        case MMDB_DATA_TYPE_BYTES:
-            jDump.setType(path, bytesToHexString(eDataList->entry_data.bytes, eDataList->entry_data.data_size));
-            eDataList = eDataList->next;
-            break;
-        case MMDB_DATA_TYPE_DOUBLE:
-            jDump.setType(path, eDataList->entry_data.double_value);
-            eDataList = eDataList->next;
-            break;
-        case MMDB_DATA_TYPE_FLOAT:
-            jDump.setType(path, eDataList->entry_data.float_value);
-            eDataList = eDataList->next;
-            break;
-        case MMDB_DATA_TYPE_UINT16:
-            jDump.setType(path, eDataList->entry_data.uint16);
-            eDataList = eDataList->next;
-            break;
-        case MMDB_DATA_TYPE_UINT32:
-            jDump.setType(path, eDataList->entry_data.uint32);
-            eDataList = eDataList->next;
-            break;
-        case MMDB_DATA_TYPE_BOOLEAN:
-            jDump.setType(path, eDataList->entry_data.boolean);
-            eDataList = eDataList->next;
-            break;
-        case MMDB_DATA_TYPE_UINT64:
-            jDump.setType(path, std::to_string(eDataList->entry_data.uint64));
-            eDataList = eDataList->next;
-            break;
-        case MMDB_DATA_TYPE_UINT128:
-            jDump.setType(path, uint128toHexString(eDataList->entry_data.uint128));
-            eDataList = eDataList->next;
-            break;
-        case MMDB_DATA_TYPE_INT32:
-            jDump.setType(path, eDataList->entry_data.int32);
+        return nullptr;
+    }
+
+    if (!node.targets.empty())
+    {
+        const auto value = dumpEntryDataList(eDataList);
+        for (const auto& target : node.targets)
+        {
+            output.set(target, value);
+        }
+    }
+
+    const auto type = eDataList->entry_data.type;
+
+    if (node.children.empty() || (MMDB_DATA_TYPE_MAP != type && MMDB_DATA_TYPE_ARRAY != type))
+    {
+        return skipEntryData(eDataList);
+    }
+
+    uint32_t size = eDataList->entry_data.data_size;
+    eDataList = eDataList->next;
+
+    if (MMDB_DATA_TYPE_MAP == type)
+    {
+        for (; size && eDataList; size--)
+        {
+            if (MMDB_DATA_TYPE_UTF8_STRING != eDataList->entry_data.type)
+            {
+                throw std::runtime_error {fmt::format("Error querying map: {}", MMDB_strerror(MMDB_INVALID_DATA_ERROR))};
+            }
+
+            const auto child = node.child({eDataList->entry_data.utf8_string, eDataList->entry_data.data_size});
             eDataList = eDataList->next;
-            break;
-        default:
-            throw std::runtime_error {
-                fmt::format("Error dumping entry data list: {}", MMDB_strerror(MMDB_INVALID_DATA_ERROR))};
+
+            eDataList = child != 0 ? queryEntryData(eDataList, query, query.nodes()[child], output)
+                                   : skipEntryData(eDataList);
+        }
+    }
+    else
+    {
+        for (uint32_t index = 0; size && eDataList; size--, index++)
+        {
+            const auto child = node.child(std::to_string(index));
+
+            eDataList = child != 0 ? queryEntryData(eDataList, query, query.nodes()[child], output)
+                                   : skipEntryData(eDataList);
+        }
     }
 
     return eDataList;
 }
 
+/**
+ * @brief JSON pointer of the given path parts.
+ */
+std::string jsonPointer(const std::vector<std::string>& parts)
+{
+    std::string pointer;
+    for (const auto& part : parts)
+    {
+        pointer.push_back('/');
+        for (const auto c : part)
+        {
+            if (c == '~')
+            {
+                pointer.append("~0");
+            }
+            else if (c == '/')
+            {
+                pointer.append("~1");
+            }
+            else
+            {
+                pointer.push_back(c);
+            }
+        }
+    }
+
+    return pointer;
+}
+
+/**
+ * @brief Writes the requested fields of the data of a custom network.
+ *
+ * @param value The value matching the path of the node.
+ * @param node The query node.
+ * @param query The compiled query.
+ * @param output Where the fields are written.
+ */
+void queryCidrData(const json::Json& value,
+                   const geo::LocatorQuery& query,
+                   const geo::LocatorQuery::Node& node,
+                   json::Json& output)
+{
+    for (const auto& target : node.targets)
+    {
+        output.set(target, value);
+    }
+
+    for (const auto& [part, child] : node.children)
+    {
+        if (auto childValue = value.getJson(jsonPointer({part})))
+        {
+            queryCidrData(childValue.value(), query, query.nodes()[child], output);
+        }
+    }
+}
+
 } // namespace
 
 namespace geo
 {
 
-base::OptError Locator::lookup(std::string_view ip, const std::shared_ptr<DbEntry>& entry)
+base::RespOrError<std::shared_ptr<DbEntry>> Locator::acquireEntry() const
 {
+    auto handle = weakDbHandle_.lock();
+    if (nullptr == handle)
+    {
+        return base::Error{"Database is not available"};
+    }
 
-    if (ip == cachedIp_)
+    // Check liveness again; if count == 1 the manager already dropped the database
+    if (1 >= handle.use_count())
+    {
+        return base::Error{"Database is not available"};
+    }
+
+    auto entry = handle->load();
+    if (nullptr == entry)
+    {
+        return base::Error{"Database is not available"};
+    }
+
+    return entry;
+}
+
+base::OptError Locator::lookup(const IpAddress& ip, const std::shared_ptr<DbEntry>& entry)
+{
+    // Custom networks are matched before the database, a reload is seen by the next lookup
+    if (cidrTableHandle_)
+    {
+        cachedCidrTable_ = cidrTableHandle_->load();
+        cachedCidr_ = cachedCidrTable_->match(ip);
+    }
+
+    // The owner comparison cannot mistake a new entry for a released one that had the same address
+    const bool sameEntry = !cachedEntry_.owner_before(entry) && !entry.owner_before(cachedEntry_);
+
+    if (sameEntry && ip == cachedIp_)
     {
         return base::noError();
     }
 
-    // Lookup the IP address in the db
-    int gai_error{0}, mmdb_error{0};
-    MMDB_lookup_result_s result =
-        MMDB_lookup_string(entry->mmdb.get(), ip.data(), &gai_error, &mmdb_error);
-    
-    if (0 != gai_error)
+    // Private and reserved addresses the database has no data for fail without a lookup
+    if (const auto* kind = entry->emptyReserved.match(ip))
     {
-        return base::Error{
-            fmt::format(
-                "{} {}: {}",
-                TRANSLATE_ERROR,
-                ip,
-                gai_strerror(gai_error)
+        cachedIp_ = ip;
+        cachedResult_ = MMDB_lookup_result_s {};
+        cachedEntry_ = entry;
+        cachedReserved_ = *kind;
 
-            )
-        };
+        return base::noError();
+    }
+
+    cachedReserved_ = {};
+
+    if (auto cached = entry->lookupCache.get(ip))
+    {
+        cachedIp_ = ip;
+        cachedResult_ = cached.value();
+        cachedEntry_ = entry;
+
+        return base::noError();
     }
 
+    // Lookup the IP address in the db
+    sockaddr_storage address{};
+    ip.toSockaddr(address);
+
+    int mmdb_error{0};
+    MMDB_lookup_result_s result =
+        MMDB_lookup_sockaddr(entry->mmdb.get(), reinterpret_cast<const sockaddr*>(&address), &mmdb_error);
+
     if (MMDB_SUCCESS != mmdb_error)
     {
         return base::Error{
@@ -264,20 +453,55 @@ base::OptError Locator::lookup(std::string_view ip, const std::shared_ptr<DbEntr
         };
     }
 
+    entry->lookupCache.put(ip, result);
+
     cachedIp_ = ip;
     cachedResult_ = result;
+    cachedEntry_ = entry;
 
     return base::noError();
 }
 
 
-base::RespOrError<MMDB_entry_data_s> Locator::getEData(const DotPath& path)
+std::optional<json::Json> Locator::getCidrValue(const DotPath& path) const
+{
+    if (cachedCidr_ == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    return cachedCidr_->getJson(jsonPointer(path.parts()));
+}
+
+base::RespOrError<MMDB_entry_data_s> Locator::getEData(const DotPath& path, const std::shared_ptr<DbEntry>& entry)
 {
     if (!cachedResult_.found_entry)
     {
+        if (!cachedReserved_.empty())
+        {
+            return base::Error{
+                fmt::format(
+                    "No data found for the IP address: {} range",
+                    cachedReserved_
+                )
+            };
+        }
+
         return base::Error{"No data found for the IP address"};
     }
 
+    // Fixed size address prefix, so no separator is needed before the path
+    std::string fieldKey;
+    fieldKey.reserve(1 + cachedIp_.size() + path.str().size());
+    fieldKey.push_back(static_cast<char>(cachedIp_.family()));
+    fieldKey.append(reinterpret_cast<const char*>(cachedIp_.data()), cachedIp_.size());
+    fieldKey.append(path.str());
+
+    if (auto cached = entry->fieldCache.get(fieldKey))
+    {
+        return cached.value();
+    }
+
     MMDB_entry_data_s eData;
     auto pathCStrVec = getPathCStrVec(path);
 
@@ -297,32 +521,56 @@ base::RespOrError<MMDB_entry_data_s> Locator::getEData(const DotPath& path)
         };
     }
 
+    entry->fieldCache.put(fieldKey, eData);
+
     return eData;
 }
 
 base::RespOrError<std::string> Locator::getString(std::string_view ip, const DotPath& path)
 {
-    auto entry = weakDbEntry_.lock();
-    if (nullptr == entry)
+    auto address = IpAddress::parse(ip);
+    if (!address)
     {
-        return base::Error{"Database is not available"};
+        return base::Error{
+            fmt::format(
+                "{} {}",
+                TRANSLATE_ERROR,
+                ip
+            )
+        };
     }
 
-    std::shared_lock lock(entry->rwMutex);
+    return getString(address.value(), path);
+}
 
-    // Check liveness again; if count == 1 we could be in shutdown or invalid state
-    if (1 >= entry.use_count())
+base::RespOrError<std::string> Locator::getString(const IpAddress& ip, const DotPath& path)
+{
+    auto entryResp = acquireEntry();
+    if (base::isError(entryResp))
     {
-        return base::Error{"Database is not available"};
+        return base::getError(entryResp);
     }
 
+    const auto& entry = base::getResponse(entryResp);
+
     auto lookError = lookup(ip, entry);
     if (base::isError(lookError))
     {
         return base::getError(lookError);
     }
 
-    auto eDataResp = getEData(path);
+    if (auto value = getCidrValue(path))
+    {
+        auto str = value->getString("");
+        if (!str)
+        {
+            return base::Error{"Data is not a string"};
+        }
+
+        return str.value();
+    }
+
+    auto eDataResp = getEData(path, entry);
     if (base::isError(eDataResp))
     {
         return base::getError(eDataResp);
@@ -340,27 +588,49 @@ base::RespOrError<std::string> Locator::getString(std::string_view ip, const Dot
 
 base::RespOrError<std::uint32_t> Locator::getUint32(std::string_view ip, const DotPath& path)
 {
-    auto entry = weakDbEntry_.lock();
-    if (nullptr == entry)
+    auto address = IpAddress::parse(ip);
+    if (!address)
     {
-        return base::Error{"Database is not available"};
+        return base::Error{
+            fmt::format(
+                "{} {}",
+                TRANSLATE_ERROR,
+                ip
+            )
+        };
     }
 
-    std::shared_lock lock(entry->rwMutex);
+    return getUint32(address.value(), path);
+}
 
-    // Check liveness again; if count == 1 we could be in shutdown or invalid state
-    if (1 >= entry.use_count())
+base::RespOrError<std::uint32_t> Locator::getUint32(const IpAddress& ip, const DotPath& path)
+{
+    auto entryResp = acquireEntry();
+    if (base::isError(entryResp))
     {
-        return base::Error{"Database is not available"};
+        return base::getError(entryResp);
     }
 
+    const auto& entry = base::getResponse(entryResp);
+
     auto lookError = lookup(ip, entry);
     if (base::isError(lookError))
     {
         return base::getError(lookError);
     }
 
-    auto eDataResp = getEData(path);
+    if (auto value = getCidrValue(path))
+    {
+        auto number = value->getUint32("");
+        if (!number)
+        {
+            return base::Error{"Data is not a uint32_t"};
+        }
+
+        return number.value();
+    }
+
+    auto eDataResp = getEData(path, entry);
     if (base::isError(eDataResp))
     {
         return base::getError(eDataResp);
@@ -378,27 +648,49 @@ base::RespOrError<std::uint32_t> Locator::getUint32(std::string_view ip, const D
 
 base::RespOrError<double> Locator::getDouble(std::string_view ip, const DotPath& path)
 {
-    auto entry = weakDbEntry_.lock();
-    if (nullptr == entry)
+    auto address = IpAddress::parse(ip);
+    if (!address)
     {
-        return base::Error{"Database is not available"};
+        return base::Error{
+            fmt::format(
+                "{} {}",
+                TRANSLATE_ERROR,
+                ip
+            )
+        };
     }
 
-    std::shared_lock lock(entry->rwMutex);
+    return getDouble(address.value(), path);
+}
 
-    // Check liveness again; if count == 1 we could be in shutdown or invalid state
-    if (1 >= entry.use_count())
+base::RespOrError<double> Locator::getDouble(const IpAddress& ip, const DotPath& path)
+{
+    auto entryResp = acquireEntry();
+    if (base::isError(entryResp))
     {
-        return base::Error{"Database is not available"};
+        return base::getError(entryResp);
     }
 
+    const auto& entry = base::getResponse(entryResp);
+
     auto lookError = lookup(ip, entry);
     if (base::isError(lookError))
     {
         return base::getError(lookError);
     }
 
-    auto eDataResp = getEData(path);
+    if (auto value = getCidrValue(path))
+    {
+        auto number = value->getDouble("");
+        if (!number)
+        {
+            return base::Error{"Data is not a double"};
+        }
+
+        return number.value();
+    }
+
+    auto eDataResp = getEData(path, entry);
     if (base::isError(eDataResp))
     {
         return base::getError(eDataResp);
@@ -414,30 +706,123 @@ base::RespOrError<double> Locator::getDouble(std::string_view ip, const DotPath&
     return eData.double_value;
 }
 
-base::RespOrError<json::Json> Locator::getAsJson(std::string_view ip, const DotPath& path)
+base::OptError Locator::getFields(std::string_view ip, const LocatorQuery& query, json::Json& output)
 {
-    auto entry = weakDbEntry_.lock();
+    auto address = IpAddress::parse(ip);
+    if (!address)
+    {
+        return base::Error{
+            fmt::format(
+                "{} {}",
+                TRANSLATE_ERROR,
+                ip
+            )
+        };
+    }
 
-    if (nullptr == entry)
+    return getFields(address.value(), query, output);
+}
+
+base::OptError Locator::getFields(const IpAddress& ip, const LocatorQuery& query, json::Json& output)
+{
+    auto entryResp = acquireEntry();
+    if (base::isError(entryResp))
     {
-        return base::Error{"Database is not available"};
+        return base::getError(entryResp);
     }
 
-    std::shared_lock lock(entry->rwMutex);
+    const auto& entry = base::getResponse(entryResp);
 
-    // Check liveness again; if count == 1 we could be in shutdown or invalid state
-    if (1 >= entry.use_count())
+    auto lookError = lookup(ip, entry);
+    if (base::isError(lookError))
     {
-        return base::Error{"Database is not available"};
+        return base::getError(lookError);
+    }
+
+    if (!cachedResult_.found_entry && cachedCidr_ == nullptr)
+    {
+        return base::Error{"No data found for the IP address"};
+    }
+
+    if (cachedResult_.found_entry)
+    {
+        // Decode the whole record once, then walk it following the query trie
+        MMDB_entry_data_list_s* eDataList{nullptr};
+        int status = MMDB_get_entry_data_list(&cachedResult_.entry, &eDataList);
+
+        std::unique_ptr<MMDB_entry_data_list_s, decltype(&MMDB_free_entry_data_list)> guard{
+            eDataList,
+            &MMDB_free_entry_data_list
+        };
+
+        if (MMDB_SUCCESS != status)
+        {
+            return base::Error{
+                fmt::format(
+                    "Error getting entry data list: {}",
+                    MMDB_strerror(status)
+                )
+            };
+        }
+
+        try
+        {
+            queryEntryData(eDataList, query, query.nodes().front(), output);
+        }
+        catch (const std::exception& e)
+        {
+            return base::Error{e.what()};
+        }
+    }
+
+    // Written last, the fields of a custom network take precedence over the database ones
+    if (cachedCidr_ != nullptr)
+    {
+        queryCidrData(*cachedCidr_, query, query.nodes().front(), output);
+    }
+
+    return base::noError();
+}
+
+base::RespOrError<json::Json> Locator::getAsJson(std::string_view ip, const DotPath& path)
+{
+    auto address = IpAddress::parse(ip);
+    if (!address)
+    {
+        return base::Error{
+            fmt::format(
+                "{} {}",
+                TRANSLATE_ERROR,
+                ip
+            )
+        };
+    }
+
+    return getAsJson(address.value(), path);
+}
+
+base::RespOrError<json::Json> Locator::getAsJson(const IpAddress& ip, const DotPath& path)
+{
+    auto entryResp = acquireEntry();
+    if (base::isError(entryResp))
+    {
+        return base::getError(entryResp);
     }
 
+    const auto& entry = base::getResponse(entryResp);
+
     auto lookError = lookup(ip, entry);
     if (base::isError(lookError))
     {
         return base::getError(lookError);
     }
 
-    auto eDataResp = getEData(path);
+    if (auto value = getCidrValue(path))
+    {
+        return std::move(value.value());
+    }
+
+    auto eDataResp = getEData(path, entry);
     if (base::isError(eDataResp))
     {
         return base::getError(eDataResp);
@@ -445,48 +830,50 @@ base::RespOrError<json::Json> Locator::getAsJson(std::string_view ip, const DotP
 
     auto& eData = base::getResponse(eDataResp);
 
-    json::Json result{};
+    if (MMDB_DATA_TYPE_MAP != eData.type && MMDB_DATA_TYPE_ARRAY != eData.type)
+    {
+        rapidjson::Document document;
 
-    switch (eData.type)
+        try
+        {
+            setScalarValue(eData, document, document.GetAllocator());
+        }
+        catch (const std::exception& e)
+        {
+            return base::Error{e.what()};
+        }
+
+        return json::Json{std::move(document)};
+    }
+
+    // Decode only the subtree at the path, the offset of the data is where it starts
+    MMDB_entry_s subtree{entry->mmdb.get(), eData.offset};
+    MMDB_entry_data_list_s* eDataList{nullptr};
+    int status = MMDB_get_entry_data_list(&subtree, &eDataList);
+
+    std::unique_ptr<MMDB_entry_data_list_s, decltype(&MMDB_free_entry_data_list)> guard{
+        eDataList,
+        &MMDB_free_entry_data_list
+    };
+
+    if (MMDB_SUCCESS != status)
     {
-        case MMDB_DATA_TYPE_MAP:
-        case MMDB_DATA_TYPE_ARRAY:
-            return base::Error{"MMDB_DATA_TYPE is not a supported type"};
-        case MMDB_DATA_TYPE_UTF8_STRING:
-            result.setType("", std::string{eData.utf8_string, eData.data_size});
-            break;
-        case MMDB_DATA_TYPE_BYTES:
-            result.setType("", bytesToHexString(eData.bytes, eData.data_size));
-            break;
-        case MMDB_DATA_TYPE_DOUBLE:
-            result.setType("", eData.double_value);
-            break;
-        case MMDB_DATA_TYPE_FLOAT:
-            result.setType("", eData.float_value);
-            break;
-        case MMDB_DATA_TYPE_UINT16:
-            result.setType("", eData.uint16);
-            break;
-        case MMDB_DATA_TYPE_UINT32:
-            result.setType("", eData.uint32);
-            break;
-        case MMDB_DATA_TYPE_BOOLEAN:
-            result.setType("", eData.boolean);
-            break;
-        case MMDB_DATA_TYPE_UINT64:
-            result.setType("", std::to_string(eData.uint64));
-            break;
-        case MMDB_DATA_TYPE_UINT128:
-            result.setType("", uint128toHexString(eData.uint128));
-            break;
-        case MMDB_DATA_TYPE_INT32:
-            result.setType("", eData.int32);
-            break;
-        default:
-            break;
+        return base::Error{
+            fmt::format(
+                "Error getting entry data list: {}",
+                MMDB_strerror(status)
+            )
+        };
     }
 
-    return result;
+    try
+    {
+        return dumpEntryDataList(eDataList);
+    }
+    catch (const std::exception& e)
+    {
+        return base::Error{e.what()};
+    }
 }
 
 } // namespace geo
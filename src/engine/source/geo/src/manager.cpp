@@ -16,12 +16,50 @@
 namespace geo
 {
 
+namespace
+{
+/**
+ * @brief Build a CIDR table from an object of networks to their data.
+ */
+base::RespOrError<std::shared_ptr<const CidrTable>> buildCidrTable(const json::Json& doc)
+{
+    auto ranges = doc.getObject();
+    if (!ranges)
+    {
+        return base::Error{
+            "The CIDR table must be an object of networks to their data"
+        };
+    }
+
+    auto table = std::make_shared<CidrTable>();
+
+    for (auto& [range, data] : ranges.value())
+    {
+        auto cidr = Cidr::parse(range);
+        if (!cidr)
+        {
+            return base::Error{
+                fmt::format(
+                    "Invalid network '{}' in the CIDR table",
+                    range
+                )
+            };
+        }
+
+        table->insert(cidr.value(), std::move(data));
+    }
+
+    return table;
+}
+} // namespace
+
 Manager::Manager(const std::shared_ptr<store::IStoreInternal>& store, const std::shared_ptr<IDownloader>& downloader)
     : dbs_{}
     , dbTypes_{}
     , rwMapMutex_{}
     , store_{store}
     , downloader_{downloader}
+    , cidrTable_{std::make_shared<CidrTableHandle>()}
 {
     if (store_ == nullptr)
     {
@@ -142,7 +180,12 @@ base::OptError Manager::upsertStoreEntry(std::string_view path)
         };
     }
 
-    auto hash = base::getResponse(hashResp);
+    return upsertStoreEntry(path, base::getResponse(hashResp));
+}
+
+base::OptError Manager::upsertStoreEntry(std::string_view path, const std::string& hash)
+{
+    std::filesystem::path dbPath{path};
 
     auto internalName =
         base::Name( std::vector<std::string>( {std::string(INTERNAL_NAME), dbPath.filename().string()} ) );
@@ -151,7 +194,7 @@ base::OptError Manager::upsertStoreEntry(std::string_view path)
     
     doc.setType(PATH_PATH, path);
     doc.setType(HASH_PATH, hash);
-    doc.setType(TYPE_PATH, typeName(dbs_.at(dbPath.filename().string())->type));
+    doc.setType(TYPE_PATH, typeName(dbs_.at(dbPath.filename().string())->load()->type));
 
     return store_->upsertInternalDoc(internalName, doc);
 }
@@ -196,7 +239,7 @@ base::OptError Manager::addDbUnsafe(std::string_view path, Type type, bool upser
     }
 
     auto entry = std::make_shared<DbEntry>(path, type);
-    int status = MMDB_open(path.data(), MMDB_MODE_MMAP, entry->mmdb.get());
+    int status = entry->open(std::string(path));
 
     if (MMDB_SUCCESS != status)
     {
@@ -209,7 +252,7 @@ base::OptError Manager::addDbUnsafe(std::string_view path, Type type, bool upser
         };
     }
 
-    dbs_.emplace(name, std::move(entry));
+    dbs_.emplace(name, std::make_shared<DbHandle>(std::move(entry)));
     dbTypes_.emplace(type, name);
 
     if (upsertStore)
@@ -232,39 +275,19 @@ base::OptError Manager::removeDbUnsafe(std::string_view path)
 {
     auto name = std::filesystem::path(path).filename().string();
     
-    std::shared_ptr<DbEntry> entry;
-
-    {
-        auto it = dbs_.find(name);
-        if (it == dbs_.end())
-        {
-            return base::Error{
-                fmt::format(
-                    "Database '{}' not found",
-                    name
-                )
-            };
-        }
-        
-        entry = it->second;
-    }
-
-    if (!entry)
+    auto it = dbs_.find(name);
+    if (it == dbs_.end())
     {
         return base::Error{
             fmt::format(
-                "Entry for database '{}' is null", name
+                "Database '{}' not found",
+                name
             )
         };
     }
 
-    std::unique_lock<std::shared_mutex> lockEntry(entry->rwMutex);
-
-    dbs_.erase(name);
-
-    lockEntry.unlock();
-
-    entry.reset();
+    // Locators fail from now on, the lookups already running keep their entry open until they finish
+    dbs_.erase(it);
 
     for (auto it = dbTypes_.begin(); it != dbTypes_.end(); ++it)
     {
@@ -278,52 +301,46 @@ base::OptError Manager::removeDbUnsafe(std::string_view path)
     return removeInternalEntry(path);
 }
 
-base::OptError Manager::writeDb(std::string_view path, std::string_view content)
+base::OptError Manager::swapDb(DbHandle& handle, std::string_view path, Type type, const std::string& downloadPath)
 {
-    auto filePath = std::filesystem::path(path);
+    // Never rewrite the mapped file in place, readers of the old database would see it change under them
+    auto entry = std::make_shared<DbEntry>(path, type);
+    int status = entry->open(downloadPath);
 
-    try
-    {
-    std::filesystem::create_directories(filePath.parent_path());
-    }
-    catch (const std::exception& e)
+    if (MMDB_SUCCESS != status)
     {
+        std::error_code ec;
+        std::filesystem::remove(downloadPath, ec);
+
         return base::Error{
             fmt::format(
-                "Cannot create directories for '{}': {}",
+                "Cannot open database '{}': {}",
                 path,
-                e.what()
+                MMDB_strerror(status)
             )
         };
     }
 
-    std::ofstream file(path, std::ios::binary);
+    // The mapping follows the inode, so the new entry stays valid after the rename and the old one keeps the
+    // replaced file alive until it is closed
+    std::error_code ec;
+    std::filesystem::rename(downloadPath, path, ec);
 
-    if (!file.is_open())
+    if (ec)
     {
-        return base::Error{
-            fmt::format(
-                "Cannot open file '{}'",
-                path
-            )
-        };
-    }
+        std::filesystem::remove(downloadPath, ec);
 
-    try
-    {
-        file.write(content.data(), content.size());
-    }
-    catch (const std::exception& e)
-    {
         return base::Error{
             fmt::format(
-                "Cannot write to file '{}': {}",
+                "Cannot replace database '{}': {}",
                 path,
-                e.what()
+                ec.message()
             )
         };
     }
 
+    handle.store(std::move(entry));
+
     return base::noError();
 }
 
@@ -345,13 +362,8 @@ base::OptError Manager::removeDb(std::string_view path)
     return resp;
 }
 
-base::OptError
-Manager::remoteUpsertDb(std::string_view path, Type type, std::string_view dbUrl, std::string_view hashUrl)
+base::OptError Manager::checkUpsertTypeUnsafe(const std::string& name, Type type) const
 {
-    auto name = std::filesystem::path(path).filename().string();
-
-    std::unique_lock<std::shared_mutex> lock(rwMapMutex_);
-
     if (dbTypes_.find(type) != dbTypes_.end() && dbTypes_.at(type) != name)
     {
         return base::Error{
@@ -365,6 +377,30 @@ Manager::remoteUpsertDb(std::string_view path, Type type, std::string_view dbUrl
         };
     }
 
+    return base::noError();
+}
+
+base::OptError
+Manager::remoteUpsertDb(std::string_view path, Type type, std::string_view dbUrl, std::string_view hashUrl)
+{
+    auto name = std::filesystem::path(path).filename().string();
+
+    // Upserts share the download file, but only the publication below blocks the readers of the map
+    std::lock_guard<std::mutex> upsertLock(upsertMutex_);
+
+    bool exists {false};
+    {
+        std::shared_lock lock {rwMapMutex_};
+
+        auto typeError = checkUpsertTypeUnsafe(name, type);
+        if (base::isError(typeError))
+        {
+            return typeError;
+        }
+
+        exists = dbs_.find(name) != dbs_.end();
+    }
+
     auto hashResp = downloader_->downloadMD5(hashUrl);
     if (base::isError(hashResp))
     {
@@ -379,8 +415,7 @@ Manager::remoteUpsertDb(std::string_view path, Type type, std::string_view dbUrl
 
     auto hash = base::getResponse(hashResp);
 
-    auto entry = dbs_.find(name);
-    if (entry != dbs_.end())
+    if (exists)
     {
         auto internalResp = store_->readInternalDoc(
                                 base::Name{
@@ -402,12 +437,29 @@ Manager::remoteUpsertDb(std::string_view path, Type type, std::string_view dbUrl
         }
     }
 
-    std::string content{};
+    // Stream the download next to the database, a failed attempt leaves its bytes there for the next one to resume
+    const auto downloadPath = fmt::format("{}.download", path);
+
+    try
+    {
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+    }
+    catch (const std::exception& e)
+    {
+        return base::Error{
+            fmt::format(
+                "Cannot create directories for '{}': {}",
+                path,
+                e.what()
+            )
+        };
+    }
+
     base::OptError error;
 
     for (int i = 0; i < MAX_RETRIES; ++i)
     {
-        auto dbResp = downloader_->downloadHTTPS(dbUrl);
+        auto dbResp = downloader_->downloadHTTPSToFile(dbUrl, downloadPath);
 
         if (base::isError(dbResp))
         {
@@ -421,72 +473,73 @@ Manager::remoteUpsertDb(std::string_view path, Type type, std::string_view dbUrl
             continue;
         }
 
-        content = base::getResponse(dbResp);
-        auto computedHashResp = downloader_->computeMD5(content);
-
-        if (base::isError(computedHashResp))
-        {
-            error = base::Error{
-                fmt::format(
-                    "Cannot compute hash from database downloaded at '{}' : {}",
-                    dbUrl,
-                    base::getError(computedHashResp).message
-                )
-            };
-        }
-
-        auto computedHash = base::getResponse(computedHashResp);
-
-        if (computedHash == hash)
+        if (base::getResponse(dbResp) == hash)
         {
             error = base::noError();
             break;
         }
+
+        error = base::Error{
+            fmt::format(
+                "The hash of the database downloaded from '{}' does not match '{}'",
+                dbUrl,
+                hash
+            )
+        };
+
+        // Resuming a corrupted file would keep it corrupted, start over
+        std::error_code ec;
+        std::filesystem::remove(downloadPath, ec);
     }
 
     if (base::isError(error))
     {
+        std::error_code ec;
+        std::filesystem::remove(downloadPath, ec);
+
         return base::getError(error);
     }
 
-    entry = dbs_.find(name);
+    std::unique_lock<std::shared_mutex> lock(rwMapMutex_);
+
+    // The map may have changed while downloading
+    auto typeError = checkUpsertTypeUnsafe(name, type);
+    if (base::isError(typeError))
+    {
+        std::error_code ec;
+        std::filesystem::remove(downloadPath, ec);
+
+        return typeError;
+    }
+
+    auto entry = dbs_.find(name);
 
     if (entry != dbs_.end())
     {
-        std::unique_lock<std::shared_mutex> lockEntry(entry->second->rwMutex);
-        auto writeResp = writeDb(path, content);
-        if (base::isError(writeResp))
+        auto swapResp = swapDb(*entry->second, path, type, downloadPath);
+        if (base::isError(swapResp))
         {
-            return base::getError(writeResp);
+            return base::getError(swapResp);
         }
+    }
+    else
+    {
+        std::error_code ec;
+        std::filesystem::rename(downloadPath, path, ec);
 
-        MMDB_close(entry->second->mmdb.get());
-
-        int status = MMDB_open(path.data(), MMDB_MODE_MMAP, entry->second->mmdb.get());
-
-        if (MMDB_SUCCESS != status)
+        if (ec)
         {
-            lockEntry.unlock();
-            removeDbUnsafe(path);
+            std::filesystem::remove(downloadPath, ec);
 
             return base::Error{
                 fmt::format(
-                    "Cannot add database '{}': {}",
+                    "Cannot move database to '{}': {}",
                     path,
-                    MMDB_strerror(status)
+                    ec.message()
                 )
             };
         }
 
-    }
-    else
-    {
-        auto writeResp = writeDb(path, content);
-        if (base::isError(writeResp))
-        {
-            return base::getError(writeResp);
-        }
-
         auto addResp = addDbUnsafe(path, type, false);
         if (base::isError(addResp))
         {
@@ -494,7 +547,8 @@ Manager::remoteUpsertDb(std::string_view path, Type type, std::string_view dbUrl
         }
     }
 
-    auto internalResp = upsertStoreEntry(path);
+    // The download was hashed while streamed, no need to read it again
+    auto internalResp = upsertStoreEntry(path, hash);
     if (base::isError(internalResp))
     {
         LOG_WARNING(
@@ -521,21 +575,53 @@ base::RespOrError<std::shared_ptr<ILocator>> Manager::getLocator(Type type) cons
         };
     }
 
-    auto entry = dbs_.at(dbTypes_.at(type));
+    auto handle = dbs_.at(dbTypes_.at(type));
 
-    auto locator = std::make_shared<Locator>(entry);
+    auto locator = std::make_shared<Locator>(handle, cidrTable_);
 
     return locator;
 }
 
+base::OptError Manager::loadCidrTable(const base::Name& name)
+{
+    auto docResp = store_->readInternalDoc(name);
+    if (base::isError(docResp))
+    {
+        return base::Error{
+            fmt::format(
+                "Cannot read CIDR table '{}': {}",
+                name.toStr(),
+                base::getError(docResp).message
+            )
+        };
+    }
+
+    auto tableResp = buildCidrTable(base::getResponse(docResp));
+    if (base::isError(tableResp))
+    {
+        return base::getError(tableResp);
+    }
+
+    // Lookups in flight keep the previous table until they release it
+    cidrTable_->store(base::getResponse(tableResp));
+
+    return base::noError();
+}
+
+std::shared_ptr<const CidrTable> Manager::getCidrTable() const
+{
+    return cidrTable_->load();
+}
+
 std::vector<DbInfo> Manager::listDbs() const
 {
     std::shared_lock lock{rwMapMutex_};
 
     std::vector<DbInfo> dbs;
 
-    for (const auto& [name, entry] : dbs_)
+    for (const auto& [name, handle] : dbs_)
     {
+        auto entry = handle->load();
         dbs.emplace_back( DbInfo{name, entry->path, entry->type} ); 
     }
 
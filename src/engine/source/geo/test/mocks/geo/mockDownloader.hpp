@@ -14,6 +14,10 @@ public:
     MOCK_METHOD((base::RespOrError<std::string>), downloadHTTPS, (std::string_view url), (const override));
     MOCK_METHOD(base::RespOrError<std::string>, computeMD5, (std::string_view data), (const override));
     MOCK_METHOD(base::RespOrError<std::string>, downloadMD5, (std::string_view url), (const override));
+    MOCK_METHOD(base::RespOrError<std::string>,
+                downloadHTTPSToFile,
+                (std::string_view url, const std::filesystem::path& path),
+                (const override));
 };
 } // namespace geo::mocks
 #endif // _GEO_MOCK_DOWNLOADER_HPP
@@ -14,6 +14,18 @@ public:
     MOCK_METHOD(base::RespOrError<uint32_t>, getUint32, (std::string_view ip, const DotPath& path), (override));
     MOCK_METHOD(base::RespOrError<double>, getDouble, (std::string_view ip, const DotPath& path), (override));
     MOCK_METHOD(base::RespOrError<json::Json>, getAsJson, (std::string_view ip, const DotPath& path), (override));
+    MOCK_METHOD(base::RespOrError<std::string>, getString, (const IpAddress& ip, const DotPath& path), (override));
+    MOCK_METHOD(base::RespOrError<uint32_t>, getUint32, (const IpAddress& ip, const DotPath& path), (override));
+    MOCK_METHOD(base::RespOrError<double>, getDouble, (const IpAddress& ip, const DotPath& path), (override));
+    MOCK_METHOD(base::RespOrError<json::Json>, getAsJson, (const IpAddress& ip, const DotPath& path), (override));
+    MOCK_METHOD(base::OptError,
+                getFields,
+                (std::string_view ip, const LocatorQuery& query, json::Json& output),
+                (override));
+    MOCK_METHOD(base::OptError,
+                getFields,
+                (const IpAddress& ip, const LocatorQuery& query, json::Json& output),
+                (override));
 };
 } // namespace geo::mocks
 #endif // _GEO_MOCK_LOCATOR_HPP
@@ -19,6 +19,8 @@ public:
                 (override));
     MOCK_METHOD(std::vector<DbInfo>, listDbs, (), (const, override));
     MOCK_METHOD(base::RespOrError<std::shared_ptr<ILocator>>, getLocator, (Type type), (const, override));
+    MOCK_METHOD(base::OptError, loadCidrTable, (const base::Name& name), (override));
+    MOCK_METHOD(std::shared_ptr<const CidrTable>, getCidrTable, (), (const, override));
 };
 } // namespace geo::mocks
 #endif // _GEO_MOCK_MANAGER_HPP
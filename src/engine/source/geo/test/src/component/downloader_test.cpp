@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <fmt/format.h>
+#include <httplib.h>
+
+#include <base/logger.hpp>
+#include <geo/downloader.hpp>
+
+using namespace geo;
+
+namespace geoctest
+{
+
+/**
+ * @brief Local HTTP stand-in of the database server.
+ */
+class DownloaderTest : public ::testing::Test
+{
+protected:
+    httplib::Server server;
+    std::thread serverThread;
+    int port {0};
+
+    std::string content;
+    std::mutex rangesMutex;
+    std::vector<std::string> ranges; ///< Range header of each request, empty if none
+
+    std::filesystem::path file;
+    Downloader downloader;
+
+    void SetUp() override
+    {
+        logger::testInit();
+
+        // Large enough to arrive in several write callbacks
+        content.reserve(1024 * 1024);
+        for (std::size_t i = 0; content.size() < 1024 * 1024; ++i)
+        {
+            content += fmt::format("{:08x}", i * 2654435761u);
+        }
+
+        server.Get("/db",
+                   [this](const httplib::Request& req, httplib::Response& res)
+                   {
+                       {
+                           std::lock_guard lock {rangesMutex};
+                           ranges.emplace_back(req.get_header_value("Range"));
+                       }
+                       // httplib answers ranged requests with 206 and the requested slice
+                       res.set_content(content, "application/octet-stream");
+                   });
+
+        port = server.bind_to_any_port("127.0.0.1");
+        serverThread = std::thread([this]() { server.listen_after_bind(); });
+        server.wait_until_ready();
+
+        file = std::filesystem::temp_directory_path() / fmt::format("geo_download_{}.mmdb", port);
+        std::filesystem::remove(file);
+    }
+
+    void TearDown() override
+    {
+        server.stop();
+        serverThread.join();
+        std::filesystem::remove(file);
+    }
+
+    std::string url(std::string_view path) const { return fmt::format("http://127.0.0.1:{}{}", port, path); }
+
+    std::string readFile() const
+    {
+        std::ifstream ifs(file, std::ios::binary);
+        return std::string {std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+    }
+};
+
+TEST_F(DownloaderTest, DownloadToFile)
+{
+    auto resp = downloader.downloadHTTPSToFile(url("/db"), file);
+
+    ASSERT_FALSE(base::isError(resp)) << base::getError(resp).message;
+    ASSERT_EQ(base::getResponse(resp), base::getResponse(downloader.computeMD5(content)));
+    ASSERT_EQ(readFile(), content);
+    ASSERT_EQ(ranges.size(), 1);
+    ASSERT_TRUE(ranges[0].empty());
+}
+
+TEST_F(DownloaderTest, ResumePartialFile)
+{
+    const auto half = content.size() / 2;
+    std::ofstream(file, std::ios::binary) << content.substr(0, half);
+
+    auto resp = downloader.downloadHTTPSToFile(url("/db"), file);
+
+    ASSERT_FALSE(base::isError(resp)) << base::getError(resp).message;
+    // The hash covers the bytes already on disk too
+    ASSERT_EQ(base::getResponse(resp), base::getResponse(downloader.computeMD5(content)));
+    ASSERT_EQ(readFile(), content);
+    ASSERT_EQ(ranges.size(), 1);
+    ASSERT_EQ(ranges[0], fmt::format("bytes={}-", half));
+}
+
+TEST_F(DownloaderTest, NotFoundKeepsFile)
+{
+    const auto partial = content.substr(0, 100);
+    std::ofstream(file, std::ios::binary) << partial;
+
+    auto resp = downloader.downloadHTTPSToFile(url("/missing"), file);
+
+    ASSERT_TRUE(base::isError(resp));
+    // The error body is not written, the partial file is left for a retry
+    ASSERT_EQ(readFile(), partial);
+}
+
+TEST_F(DownloaderTest, ConnectionRefused)
+{
+    auto resp = downloader.downloadHTTPSToFile("http://127.0.0.1:1/db", file);
+
+    ASSERT_TRUE(base::isError(resp));
+}
+
+} // namespace geoctest
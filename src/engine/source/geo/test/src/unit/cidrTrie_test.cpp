@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <geo/cidrTrie.hpp>
+#include <geo/reservedRanges.hpp>
+
+using namespace geo;
+
+namespace
+{
+Cidr cidr(std::string_view str)
+{
+    auto parsed = Cidr::parse(str);
+    if (!parsed)
+    {
+        throw std::runtime_error("Invalid test CIDR " + std::string {str});
+    }
+
+    return parsed.value();
+}
+
+IpAddress ip(std::string_view str)
+{
+    return IpAddress::parse(str).value();
+}
+} // namespace
+
+TEST(CidrTest, Parse)
+{
+    for (const auto* str : {"10.0.0.0/8", "0.0.0.0/0", "1.2.3.4/32", "1.2.3.4", "::/0", "2001:db8::/32", "::1/128"})
+    {
+        EXPECT_TRUE(Cidr::parse(str).has_value()) << str;
+    }
+
+    for (const auto* str : {"", "/8", "10.0.0.0/", "10.0.0.0/33", "10.0.0.0/08", "10.0.0.0/8/8", "::/129", "::/-1",
+                            "10.0.0.0/a", "host/8"})
+    {
+        EXPECT_FALSE(Cidr::parse(str).has_value()) << str;
+    }
+
+    EXPECT_EQ(cidr("1.2.3.4").prefix, 32);
+    EXPECT_EQ(cidr("::1").prefix, 128);
+    EXPECT_EQ(cidr("10.1.2.3/8").prefix, 8);
+}
+
+TEST(CidrTrieTest, LongestPrefixMatch)
+{
+    CidrTrie<std::string> trie;
+    trie.insert(cidr("10.0.0.0/8"), "corp");
+    trie.insert(cidr("10.1.0.0/16"), "site-a");
+    trie.insert(cidr("10.1.2.0/24"), "lab");
+    trie.insert(cidr("10.2.0.0/16"), "site-b");
+    trie.insert(cidr("2001:db8::/32"), "v6");
+    trie.insert(cidr("2001:db8:1::/48"), "v6-site");
+
+    EXPECT_EQ(trie.size(), 6);
+
+    EXPECT_EQ(*trie.match(ip("10.9.9.9")), "corp");
+    EXPECT_EQ(*trie.match(ip("10.1.9.9")), "site-a");
+    EXPECT_EQ(*trie.match(ip("10.1.2.3")), "lab");
+    EXPECT_EQ(*trie.match(ip("10.2.0.1")), "site-b");
+    EXPECT_EQ(*trie.match(ip("2001:db8:2::1")), "v6");
+    EXPECT_EQ(*trie.match(ip("2001:db8:1:ffff::1")), "v6-site");
+
+    EXPECT_EQ(trie.match(ip("11.0.0.1")), nullptr);
+    EXPECT_EQ(trie.match(ip("2001:db9::1")), nullptr);
+    EXPECT_EQ(trie.match(IpAddress {}), nullptr);
+
+    // IPv4 mapped IPv6 addresses are the same hosts
+    EXPECT_EQ(*trie.match(ip("::ffff:10.1.2.3")), "lab");
+}
+
+TEST(CidrTrieTest, InsertOrderAndReplace)
+{
+    CidrTrie<int> trie;
+    // Most specific first, so the wider networks have to split existing nodes
+    trie.insert(cidr("192.168.1.128/25"), 3);
+    trie.insert(cidr("192.168.1.0/24"), 2);
+    trie.insert(cidr("192.168.0.0/16"), 1);
+    trie.insert(cidr("192.168.1.0/24"), 20);
+    trie.insert(cidr("192.168.1.200/24"), 21);
+
+    EXPECT_EQ(trie.size(), 3);
+    EXPECT_EQ(*trie.match(ip("192.168.1.200")), 3);
+    EXPECT_EQ(*trie.match(ip("192.168.1.1")), 21);
+    EXPECT_EQ(*trie.match(ip("192.168.7.1")), 1);
+}
+
+TEST(CidrTrieTest, DefaultRoutesAndHosts)
+{
+    CidrTrie<int> trie;
+    trie.insert(cidr("0.0.0.0/0"), 4);
+    trie.insert(cidr("::/0"), 6);
+    trie.insert(cidr("1.2.3.4"), 32);
+    trie.insert(cidr("::"), 128);
+
+    EXPECT_EQ(*trie.match(ip("8.8.8.8")), 4);
+    EXPECT_EQ(*trie.match(ip("1.2.3.4")), 32);
+    EXPECT_EQ(*trie.match(ip("2606:4700::1111")), 6);
+    EXPECT_EQ(*trie.match(ip("::")), 128);
+    EXPECT_EQ(*trie.match(ip("::1")), 6);
+}
+
+TEST(CidrTrieTest, MatchesLinearScan)
+{
+    std::mt19937 rng {42};
+    std::vector<std::pair<Cidr, int>> networks;
+    CidrTrie<int> trie;
+
+    auto randomV4 = [&rng]()
+    {
+        // Few distinct leading bits so the networks nest and share paths
+        const auto value = (rng() & 0xC3FF00FFu) | 0x0A000000u;
+        return fmt::format("{}.{}.{}.{}", value >> 24, (value >> 16) & 0xFF, (value >> 8) & 0xFF, value & 0xFF);
+    };
+
+    for (int i = 0; i < 500; ++i)
+    {
+        auto network = cidr(fmt::format("{}/{}", randomV4(), rng() % 33));
+        trie.insert(network, i);
+        networks.emplace_back(network, i);
+    }
+
+    auto contains = [](const Cidr& network, const IpAddress& address)
+    {
+        for (unsigned bit = 0; bit < network.prefix; ++bit)
+        {
+            const auto byte = bit / 8;
+            const auto mask = 0x80 >> (bit % 8);
+            if ((network.address.data()[byte] & mask) != (address.data()[byte] & mask))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        const auto address = ip(randomV4());
+
+        const std::pair<Cidr, int>* expected {nullptr};
+        for (const auto& network : networks)
+        {
+            // Later inserts of the same network replace the value
+            if (contains(network.first, address)
+                && (expected == nullptr || network.first.prefix >= expected->first.prefix))
+            {
+                expected = &network;
+            }
+        }
+
+        const auto* value = trie.match(address);
+        if (expected == nullptr)
+        {
+            EXPECT_EQ(value, nullptr) << address.str();
+        }
+        else
+        {
+            ASSERT_NE(value, nullptr) << address.str();
+            EXPECT_EQ(*value, expected->second) << address.str();
+        }
+    }
+}
+
+TEST(ReservedRangesTest, AllParse)
+{
+    // DbEntry::open probes every range, they must all be valid networks
+    CidrTrie<std::string_view> reserved;
+    for (const auto& [range, kind] : RESERVED_RANGES)
+    {
+        const auto cidr = Cidr::parse(range);
+        ASSERT_TRUE(cidr.has_value()) << range;
+        reserved.insert(cidr.value(), kind);
+    }
+
+    EXPECT_EQ(reserved.size(), RESERVED_RANGES.size());
+    EXPECT_EQ(*reserved.match(ip("10.20.30.40")), "private");
+    EXPECT_EQ(*reserved.match(ip("fe80::1")), "link-local");
+    EXPECT_EQ(reserved.match(ip("1.2.3.4")), nullptr);
+}
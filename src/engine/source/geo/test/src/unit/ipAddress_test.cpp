@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+#include <geo/ipAddress.hpp>
+
+using namespace geo;
+
+namespace
+{
+
+/**
+ * @brief Check the parser against inet_pton, the reference for the text forms it accepts.
+ */
+void expectSameAsInetPton(const std::string& str)
+{
+    const auto parsed = IpAddress::parse(str);
+    uint8_t expected[16] {};
+
+    if (str.find(':') != std::string::npos)
+    {
+        const bool valid = inet_pton(AF_INET6, str.c_str(), expected) == 1;
+        ASSERT_EQ(parsed.has_value(), valid) << str;
+        if (valid)
+        {
+            ASSERT_EQ(parsed->family(), IpAddress::Family::V6) << str;
+            ASSERT_EQ(std::memcmp(parsed->data(), expected, 16), 0) << str;
+        }
+    }
+    else
+    {
+        const bool valid = inet_pton(AF_INET, str.c_str(), expected) == 1;
+        ASSERT_EQ(parsed.has_value(), valid) << str;
+        if (valid)
+        {
+            ASSERT_EQ(parsed->family(), IpAddress::Family::V4) << str;
+            ASSERT_EQ(std::memcmp(parsed->data(), expected, 4), 0) << str;
+        }
+    }
+}
+
+} // namespace
+
+TEST(IpAddressTest, ParseIPv4)
+{
+    for (const auto* str : {"0.0.0.0", "1.2.3.4", "255.255.255.255", "192.168.0.1", "10.0.0.255", "1.2.3.256",
+                            "1.2.3", "1.2.3.4.5", "1..2.3", "1.2.3.", ".1.2.3", "01.2.3.4", "1.2.3.04", "1.2.3.4 ",
+                            " 1.2.3.4", "1.2.3.a", "1234.1.1.1", "", "a", "1.2.3.-4"})
+    {
+        expectSameAsInetPton(str);
+    }
+}
+
+TEST(IpAddressTest, ParseIPv6)
+{
+    for (const auto* str : {"::", "::1", "1::", "1::2", "2001:db8::8a2e:370:7334", "2001:0db8:0000:0000:0000:ff00:0042:8329",
+                            "fe80::1:2:3:4:5:6", "1:2:3:4:5:6:7:8", "1:2:3:4:5:6:7::", "::2:3:4:5:6:7:8",
+                            "::ffff:1.2.3.4", "::1.2.3.4", "1:2:3:4:5:6:1.2.3.4", "ABCD:EF01::", "1:2:3:4:5:6:7:8:9",
+                            ":::", "1:::2", "1::2::3", ":1::", "1:", ":1", "1:2", "12345::", "g::", "::1.2.3",
+                            "::1.2.3.4:5", "1.2.3.4::", "fe80::1%eth0", "1:2:3:4:5:6:7:1.2.3.4", "::ffff:01.2.3.4"})
+    {
+        expectSameAsInetPton(str);
+    }
+}
+
+TEST(IpAddressTest, RandomRoundTrip)
+{
+    std::mt19937_64 rng {42};
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        uint8_t bytes[16];
+        for (auto& byte : bytes)
+        {
+            // Plenty of zero groups to exercise "::"
+            byte = (rng() % 3 == 0) ? static_cast<uint8_t>(rng()) : 0;
+        }
+
+        char buffer[INET6_ADDRSTRLEN];
+        const bool v4 = i % 2 == 0;
+        inet_ntop(v4 ? AF_INET : AF_INET6, bytes, buffer, sizeof(buffer));
+
+        const auto parsed = IpAddress::parse(buffer);
+        ASSERT_TRUE(parsed.has_value()) << buffer;
+        ASSERT_EQ(std::memcmp(parsed->data(), bytes, v4 ? 4 : 16), 0) << buffer;
+        ASSERT_EQ(parsed->str(), buffer);
+    }
+}
+
+TEST(IpAddressTest, Sockaddr)
+{
+    sockaddr_storage storage;
+
+    ASSERT_EQ(IpAddress {}.toSockaddr(storage), 0);
+    ASSERT_TRUE(IpAddress {}.empty());
+    ASSERT_EQ(IpAddress {}.str(), "");
+
+    auto v4 = IpAddress::parse("1.2.3.4").value();
+    ASSERT_EQ(v4.toSockaddr(storage), sizeof(sockaddr_in));
+    const auto& sin = reinterpret_cast<const sockaddr_in&>(storage);
+    ASSERT_EQ(sin.sin_family, AF_INET);
+    ASSERT_EQ(ntohl(sin.sin_addr.s_addr), 0x01020304u);
+
+    auto v6 = IpAddress::parse("2001:db8::1").value();
+    ASSERT_EQ(v6.toSockaddr(storage), sizeof(sockaddr_in6));
+    ASSERT_EQ(reinterpret_cast<const sockaddr_in6&>(storage).sin6_family, AF_INET6);
+}
+
+TEST(IpAddressTest, EqualityAndHash)
+{
+    const auto a = IpAddress::parse("::1").value();
+    const auto b = IpAddress::parse("0:0:0:0:0:0:0:1").value();
+    const auto c = IpAddress::parse("0.0.0.1").value();
+
+    ASSERT_EQ(a, b);
+    ASSERT_EQ(IpAddress::Hash {}(a), IpAddress::Hash {}(b));
+    ASSERT_NE(a, c);
+}
@@ -1,10 +1,12 @@
 #include <gtest/gtest.h>
 
 #include <base/json.hpp>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <string_view>
+#include <thread>
 
 #include <fmt/format.h>
 
@@ -151,16 +153,16 @@ protected:
 
     void testAllGetBehavesEqual(std::string_view ip, bool success)
     {
-        decltype(locator->getString({}, {})) resStr;
+        base::RespOrError<std::string> resStr;
         ASSERT_NO_THROW(resStr = locator->getString(ip, "test_map.test_str1"sv));
 
-        decltype(locator->getUint32({}, {})) resUint;
+        base::RespOrError<uint32_t> resUint;
         ASSERT_NO_THROW(resUint = locator->getUint32(ip, "test_uint32"sv));
 
-        decltype(locator->getDouble({}, {})) resDouble;
+        base::RespOrError<double> resDouble;
         ASSERT_NO_THROW(resDouble = locator->getDouble(ip, "test_double"sv));
 
-        decltype(locator->getAsJson({}, {})) resJson;
+        base::RespOrError<json::Json> resJson;
         ASSERT_NO_THROW(resJson = locator->getAsJson(ip, "test_map.test_str1"sv));
 
         if (success)
@@ -189,8 +191,8 @@ protected:
 
 TEST(LocatorInitTest, Initialize)
 {
-    auto dbEntry = std::make_shared<DbEntry>("path", Type::CITY);
-    ASSERT_NO_THROW(Locator {dbEntry});
+    auto dbHandle = std::make_shared<DbHandle>(std::make_shared<DbEntry>("path", Type::CITY));
+    ASSERT_NO_THROW(Locator {dbHandle});
 }
 
 TEST(LocatorInitTest, InitializeExpired)
@@ -208,6 +210,15 @@ TEST_F(LocatorTest, GetNotFound)
     testAllGetBehavesEqual(g_ipNotFound, false);
 }
 
+TEST_F(LocatorTest, GetReservedNotFound)
+{
+    testAllGetBehavesEqual("10.0.0.1", false);
+
+    // A database miss reports the size of the empty network, reserved ranges are answered before the lookup
+    ASSERT_EQ(locator->getCachedResult().netmask, 0);
+    ASSERT_FALSE(locator->getCachedResult().found_entry);
+}
+
 TEST_F(LocatorTest, GetInvalidIp)
 {
     testAllGetBehavesEqual("1.2.3.256", false);
@@ -259,12 +270,183 @@ TEST_F(LocatorTest, GetUpdatesCache)
     ASSERT_EQ(locator->getCachedIp(), g_ipNotFound);
 }
 
+TEST_F(LocatorTest, GetWithParsedAddress)
+{
+    const auto address = IpAddress::parse(g_ipFullData).value();
+
+    auto resStr = locator->getString(address, "test_map.test_str1"sv);
+    ASSERT_FALSE(base::isError(resStr)) << base::getError(resStr).message;
+    ASSERT_EQ(base::getResponse<std::string>(resStr), "DistroDefender");
+
+    auto resUint = locator->getUint32(address, "test_uint32"sv);
+    ASSERT_FALSE(base::isError(resUint)) << base::getError(resUint).message;
+    ASSERT_EQ(base::getResponse<uint32_t>(resUint), 94043);
+
+    auto resDouble = locator->getDouble(address, "test_double"sv);
+    ASSERT_FALSE(base::isError(resDouble)) << base::getError(resDouble).message;
+    ASSERT_EQ(base::getResponse<double>(resDouble), 37.386);
+
+    auto resJson = locator->getAsJson(address, "test_map.test_str1"sv);
+    ASSERT_FALSE(base::isError(resJson)) << base::getError(resJson).message;
+    ASSERT_EQ(json::Json(R"("DistroDefender")"), base::getResponse<json::Json>(resJson));
+
+    ASSERT_EQ(locator->getCachedIp(), g_ipFullData);
+    ASSERT_TRUE(base::isError(locator->getString(IpAddress::parse(g_ipNotFound).value(), "test_map.test_str1"sv)));
+}
+
+TEST_F(LocatorTest, GetFields)
+{
+    const LocatorQuery query {{
+        {DotPath {"test_map.test_str1"}, "/city/name"},
+        {DotPath {"test_uint32"}, "/postal"},
+        {DotPath {"test_double"}, "/location/lat"},
+        {DotPath {"test_array.1"}, "/second"},
+        {DotPath {"test_array"}, "/all"},
+        {DotPath {"test_map"}, "/map"},
+        {DotPath {"not_found"}, "/missing"},
+        {DotPath {"test_map.not_found"}, "/missing2"},
+    }};
+    ASSERT_EQ(query.size(), 8);
+
+    json::Json output;
+    auto error = locator->getFields(g_ipFullData, query, output);
+    ASSERT_FALSE(base::isError(error)) << base::getError(error).message;
+
+    json::Json expected {R"({
+        "city": {"name": "DistroDefender"},
+        "postal": 94043,
+        "location": {"lat": 37.386},
+        "second": "b",
+        "all": ["a", "b", "c"],
+        "map": {"test_str1": "DistroDefender", "test_str2": "DistroDefender2"}
+    })"};
+    ASSERT_EQ(expected, output) << output.toStrPretty();
+
+    // Only the fields of the second record are written
+    json::Json output2;
+    ASSERT_FALSE(base::isError(locator->getFields(IpAddress::parse(g_ipFullData2).value(), query, output2)));
+    ASSERT_EQ(json::Json {R"({"city": {"name": "Missing values"}, "map": {"test_str1": "Missing values"}})"}, output2);
+
+    json::Json output3;
+    ASSERT_TRUE(base::isError(locator->getFields(g_ipNotFound, query, output3)));
+    ASSERT_TRUE(base::isError(locator->getFields("1.2.3.256", query, output3)));
+}
+
+TEST(LocatorQueryTest, InvalidFields)
+{
+    ASSERT_THROW(LocatorQuery({{DotPath {"a"}, "a"}}), std::runtime_error);
+    ASSERT_THROW(LocatorQuery({{DotPath {"a"}, ""}}), std::runtime_error);
+    ASSERT_NO_THROW(LocatorQuery(std::vector<std::pair<DotPath, std::string>> {}));
+}
+
+TEST_F(LocatorTest, SharedCacheBetweenLocators)
+{
+    auto openEntry = [this]()
+    {
+        auto entry = std::make_shared<DbEntry>(tmpFiles.front(), Type::CITY);
+        EXPECT_EQ(MMDB_open(tmpFiles.front().c_str(), MMDB_MODE_MMAP, entry->mmdb.get()), MMDB_SUCCESS);
+        return entry;
+    };
+
+    auto entry = openEntry();
+    auto handle = std::make_shared<DbHandle>(entry);
+
+    Locator first {handle};
+    ASSERT_FALSE(base::isError(first.getString(g_ipFullData, "test_map.test_str1"sv)));
+    ASSERT_EQ(entry->lookupCache.size(), 1);
+    ASSERT_EQ(entry->fieldCache.size(), 1);
+
+    // A new locator reuses the lookup and the decoded field
+    Locator second {handle};
+    auto res = second.getString(g_ipFullData, "test_map.test_str1"sv);
+    ASSERT_FALSE(base::isError(res));
+    ASSERT_EQ(base::getResponse<std::string>(res), "DistroDefender");
+    ASSERT_TRUE(compareLookupResult(first.getCachedResult(), second.getCachedResult()));
+    ASSERT_EQ(entry->lookupCache.size(), 1);
+    ASSERT_EQ(entry->fieldCache.size(), 1);
+
+    // Invalid IPs are not cached
+    ASSERT_TRUE(base::isError(second.getString("invalid", "test_map.test_str1"sv)));
+    ASSERT_EQ(entry->lookupCache.size(), 1);
+
+    // Once the database is swapped the locators look the IP up again in the new entry
+    auto newEntry = openEntry();
+    handle->store(newEntry);
+
+    ASSERT_FALSE(base::isError(first.getString(g_ipFullData, "test_map.test_str1"sv)));
+    ASSERT_EQ(first.getCachedResult().entry.mmdb, newEntry->mmdb.get());
+    ASSERT_EQ(newEntry->lookupCache.size(), 1);
+    ASSERT_EQ(newEntry->fieldCache.size(), 1);
+}
+
+TEST_F(LocatorTest, SwapWhileLookingUp)
+{
+    std::atomic<bool> stop {false};
+    std::atomic<int> errors {0};
+    std::vector<std::thread> readers;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back(
+            [&, localLocator = std::static_pointer_cast<Locator>(
+                    base::getResponse<std::shared_ptr<ILocator>>(manager->getLocator(Type::CITY)))]()
+            {
+                while (!stop.load())
+                {
+                    auto res = localLocator->getString(g_ipFullData, "test_map.test_str1"sv);
+                    if (base::isError(res) || base::getResponse<std::string>(res) != "DistroDefender")
+                    {
+                        errors++;
+                    }
+                }
+            });
+    }
+
+    const auto path = tmpFiles.front();
+    const auto content = [&path]()
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        return std::string {std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>()};
+    }();
+
+    const auto internalName =
+        base::Name(fmt::format("{}/{}", INTERNAL_NAME, std::filesystem::path(path).filename().string()));
+
+    EXPECT_CALL(*mockDownloader, downloadMD5(testing::_))
+        .WillRepeatedly(testing::Return(base::RespOrError<std::string>(std::string {"new_hash"})));
+    EXPECT_CALL(*mockStore, readInternalDoc(internalName))
+        .WillRepeatedly(testing::Return(storeReadDocResp(json::Json {R"({"hash": "old_hash"})"})));
+    EXPECT_CALL(*mockDownloader, downloadHTTPSToFile(testing::_, testing::_))
+        .WillRepeatedly(testing::Invoke(
+            [&content](std::string_view, const std::filesystem::path& file) -> base::RespOrError<std::string>
+            {
+                std::ofstream(file, std::ios::binary) << content;
+                return std::string {"new_hash"};
+            }));
+    EXPECT_CALL(*mockStore, upsertInternalDoc(internalName, testing::_)).WillRepeatedly(testing::Return(storeOk()));
+
+    for (int i = 0; i < 20; ++i)
+    {
+        auto error = manager->remoteUpsertDb(path, Type::CITY, "dbUrl", "hashUrl");
+        ASSERT_FALSE(base::isError(error)) << base::getError(error).message;
+    }
+
+    stop.store(true);
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    ASSERT_EQ(errors.load(), 0);
+    ASSERT_FALSE(std::filesystem::exists(path + ".download"));
+}
+
 /************************************************************
  * Test each get method use cases
  ************************************************************/
 TEST_F(LocatorTest, GetString)
 {
-    decltype(locator->getString({}, {})) res;
+    base::RespOrError<std::string> res;
     ASSERT_NO_THROW(res = locator->getString(g_ipFullData, "not_found"sv));
     ASSERT_TRUE(base::isError(res));
 
@@ -274,7 +456,7 @@ TEST_F(LocatorTest, GetString)
 
 TEST_F(LocatorTest, GetUint32)
 {
-    decltype(locator->getUint32({}, {})) res;
+    base::RespOrError<uint32_t> res;
     ASSERT_NO_THROW(res = locator->getUint32(g_ipFullData, "not_found"sv));
     ASSERT_TRUE(base::isError(res));
 
@@ -284,7 +466,7 @@ TEST_F(LocatorTest, GetUint32)
 
 TEST_F(LocatorTest, GetDouble)
 {
-    decltype(locator->getDouble({}, {})) res;
+    base::RespOrError<double> res;
     ASSERT_NO_THROW(res = locator->getDouble(g_ipFullData, "not_found"sv));
     ASSERT_TRUE(base::isError(res));
 
@@ -297,7 +479,7 @@ TEST_F(LocatorTest, GetDouble)
 
 TEST_F(LocatorTest, GetAsJson)
 {
-    decltype(locator->getAsJson({}, {})) res;
+    base::RespOrError<json::Json> res;
     json::Json expected;
 
     ASSERT_NO_THROW(res = locator->getAsJson(g_ipFullData, "not_found"sv));
@@ -309,10 +491,18 @@ TEST_F(LocatorTest, GetAsJson)
     ASSERT_EQ(expected, base::getResponse<json::Json>(res));
 
     ASSERT_NO_THROW(res = locator->getAsJson(g_ipFullData, "test_map"sv)); // Complex type
-    ASSERT_TRUE(base::isError(res));
+    ASSERT_FALSE(base::isError(res)) << base::getError(res).message;
+    ASSERT_EQ(json::Json {R"({"test_str1": "DistroDefender", "test_str2": "DistroDefender2"})"},
+              base::getResponse<json::Json>(res));
 
     ASSERT_NO_THROW(res = locator->getAsJson(g_ipFullData, "test_array"sv)); // Complex type
-    ASSERT_TRUE(base::isError(res));
+    ASSERT_FALSE(base::isError(res)) << base::getError(res).message;
+    ASSERT_EQ(json::Json {R"(["a", "b", "c"])"}, base::getResponse<json::Json>(res));
+
+    // Only the subtree is decoded, the rest of the record is not part of the result
+    ASSERT_NO_THROW(res = locator->getAsJson(g_ipFullData2, "test_map"sv));
+    ASSERT_FALSE(base::isError(res)) << base::getError(res).message;
+    ASSERT_EQ(json::Json {R"({"test_str1": "Missing values"})"}, base::getResponse<json::Json>(res));
 
     ASSERT_NO_THROW(res = locator->getAsJson(g_ipFullData, "test_uint32"sv));
     ASSERT_FALSE(base::isError(res));
@@ -355,3 +545,41 @@ TEST_F(LocatorTest, GetAsJson)
     expected.setType("", true);
     ASSERT_EQ(expected, base::getResponse<json::Json>(res));
 }
+
+TEST_F(LocatorTest, CidrTableTakesPrecedence)
+{
+    auto tableName = base::Name("geo-cidr/ranges");
+    json::Json table {R"({
+        "1.2.3.4/32": {"site": "hq", "test_uint32": 7, "owner": {"team": "it"}},
+        "10.0.0.0/8": {"site": "corp"}
+    })"};
+    EXPECT_CALL(*mockStore, readInternalDoc(tableName)).WillOnce(testing::Return(storeReadDocResp(table)));
+    ASSERT_FALSE(base::isError(manager->loadCidrTable(tableName)));
+
+    // Fields of the network win, the others still come from the database
+    auto resStr = locator->getString(g_ipFullData, "site"sv);
+    ASSERT_FALSE(base::isError(resStr)) << base::getError(resStr).message;
+    ASSERT_EQ("hq", base::getResponse<std::string>(resStr));
+
+    auto resOwner = locator->getString(g_ipFullData, "owner.team"sv);
+    ASSERT_FALSE(base::isError(resOwner)) << base::getError(resOwner).message;
+    ASSERT_EQ("it", base::getResponse<std::string>(resOwner));
+
+    auto resUint = locator->getUint32(g_ipFullData, "test_uint32"sv);
+    ASSERT_FALSE(base::isError(resUint)) << base::getError(resUint).message;
+    ASSERT_EQ(7, base::getResponse<uint32_t>(resUint));
+
+    auto resDouble = locator->getDouble(g_ipFullData, "test_double"sv);
+    ASSERT_FALSE(base::isError(resDouble)) << base::getError(resDouble).message;
+    ASSERT_EQ(37.386, base::getResponse<double>(resDouble));
+
+    ASSERT_TRUE(base::isError(locator->getUint32(g_ipFullData, "site"sv)));
+
+    // Private networks the database has no data for are only answered by the table
+    auto resCorp = locator->getString("10.1.2.3", "site"sv);
+    ASSERT_FALSE(base::isError(resCorp)) << base::getError(resCorp).message;
+    ASSERT_EQ("corp", base::getResponse<std::string>(resCorp));
+
+    auto resReserved = locator->getString("192.168.1.1", "site"sv);
+    ASSERT_TRUE(base::isError(resReserved));
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <geo/lruCache.hpp>
+
+using namespace geo;
+
+TEST(ShardedLRUTest, InvalidCapacity)
+{
+    ASSERT_THROW((ShardedLRU<int, int>(0)), std::runtime_error);
+    ASSERT_THROW((ShardedLRU<int, int>(10, 0)), std::runtime_error);
+}
+
+TEST(ShardedLRUTest, GetAndPut)
+{
+    ShardedLRU<std::string, int> cache {8, 1};
+
+    ASSERT_FALSE(cache.get("a").has_value());
+
+    cache.put("a", 1);
+    cache.put("b", 2);
+    ASSERT_EQ(cache.get("a").value(), 1);
+    ASSERT_EQ(cache.get("b").value(), 2);
+    ASSERT_EQ(cache.size(), 2);
+
+    cache.put("a", 3);
+    ASSERT_EQ(cache.get("a").value(), 3);
+    ASSERT_EQ(cache.size(), 2);
+}
+
+TEST(ShardedLRUTest, EvictsLeastRecentlyUsed)
+{
+    ShardedLRU<int, int> cache {3, 1};
+
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);
+
+    // 1 becomes the most recently used, 2 is evicted
+    ASSERT_TRUE(cache.get(1).has_value());
+    cache.put(4, 4);
+
+    ASSERT_EQ(cache.size(), 3);
+    ASSERT_FALSE(cache.get(2).has_value());
+    ASSERT_TRUE(cache.get(1).has_value());
+    ASSERT_TRUE(cache.get(3).has_value());
+    ASSERT_TRUE(cache.get(4).has_value());
+}
+
+TEST(ShardedLRUTest, Clear)
+{
+    ShardedLRU<int, int> cache {64};
+
+    for (int i = 0; i < 32; ++i)
+    {
+        cache.put(i, i);
+    }
+
+    cache.clear();
+    ASSERT_EQ(cache.size(), 0);
+    ASSERT_FALSE(cache.get(0).has_value());
+}
+
+TEST(ShardedLRUTest, ConcurrentAccess)
+{
+    constexpr int THREADS = 4;
+    constexpr int KEYS = 1000;
+
+    ShardedLRU<int, int> cache {256};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back(
+            [&cache]()
+            {
+                for (int i = 0; i < KEYS; ++i)
+                {
+                    cache.put(i, i * 2);
+                    auto value = cache.get(i);
+                    if (value.has_value())
+                    {
+                        ASSERT_EQ(value.value(), i * 2);
+                    }
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_LE(cache.size(), 256);
+}
@@ -4,6 +4,7 @@
 #include <cerrno>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <string_view>
 
@@ -22,6 +23,19 @@ using ::testing::Eq;
 namespace
 {
 const std::string g_maxmindDbPath {MMDB_PATH_TEST};
+
+/**
+ * @brief Action of downloadHTTPSToFile writing content to the requested file and returning hash.
+ */
+auto downloadTo(const std::string& content, const std::string& hash)
+{
+    return testing::Invoke(
+        [content, hash](std::string_view, const std::filesystem::path& path) -> base::RespOrError<std::string>
+        {
+            std::ofstream(path, std::ios::binary) << content;
+            return hash;
+        });
+}
 } // namespace
 
 
@@ -422,9 +436,8 @@ TEST_F(GeoManagerTest, RemoteUpsertDb)
     auto internalName = base::Name(INTERNAL_NAME) + base::Name(std::filesystem::path(dbFile).filename().string());
 
     EXPECT_CALL(*mockDownloader, downloadMD5(Eq(hashUrl))).WillOnce(testing::Return(base::RespOrError<std::string>(std::string{hash})));
-    EXPECT_CALL(*mockDownloader, downloadHTTPS(Eq(dbUrl)))
-        .WillOnce(testing::Return(base::RespOrError<std::string>(content)));
-    EXPECT_CALL(*mockDownloader, computeMD5(Eq(content))).WillOnce(testing::Return(std::string{hash})).WillOnce(testing::Return(std::string{hash}));
+    EXPECT_CALL(*mockDownloader, downloadHTTPSToFile(Eq(dbUrl), testing::_))
+        .WillOnce(downloadTo(content, std::string{hash}));
     EXPECT_CALL(*mockStore, upsertInternalDoc(internalName, testing::_)).WillOnce(testing::Return(storeOk()));
 
     base::OptError error;
@@ -501,10 +514,9 @@ TEST_F(GeoManagerTest, RemoteUpsertDbFailOneDownload)
     auto internalName = base::Name(INTERNAL_NAME) + base::Name(std::filesystem::path(dbFile).filename().string());
 
     EXPECT_CALL(*mockDownloader, downloadMD5(Eq(hashUrl))).WillOnce(testing::Return(base::RespOrError<std::string>(std::string{hash})));
-    EXPECT_CALL(*mockDownloader, downloadHTTPS(Eq(dbUrl)))
+    EXPECT_CALL(*mockDownloader, downloadHTTPSToFile(Eq(dbUrl), testing::_))
         .WillOnce(testing::Return(base::Error {"error"}))
-        .WillOnce(testing::Return(base::RespOrError<std::string>(content)));
-    EXPECT_CALL(*mockDownloader, computeMD5(Eq(content))).WillOnce(testing::Return(std::string{hash})).WillOnce(testing::Return(std::string{hash}));
+        .WillOnce(downloadTo(content, std::string{hash}));
     EXPECT_CALL(*mockStore, upsertInternalDoc(internalName, testing::_)).WillOnce(testing::Return(storeOk()));
 
     base::OptError error;
@@ -529,13 +541,9 @@ TEST_F(GeoManagerTest, RemoteUpsertDbFailOneHash)
     auto internalName = base::Name(INTERNAL_NAME) + base::Name(std::filesystem::path(dbFile).filename().string());
 
     EXPECT_CALL(*mockDownloader, downloadMD5(Eq(hashUrl))).WillOnce(testing::Return(base::RespOrError<std::string>(std::string{hash})));
-    EXPECT_CALL(*mockDownloader, downloadHTTPS(Eq(dbUrl)))
-        .WillOnce(testing::Return(base::RespOrError<std::string>(content)))
-        .WillOnce(testing::Return(base::RespOrError<std::string>(content)));
-    EXPECT_CALL(*mockDownloader, computeMD5(Eq(content)))
-        .WillOnce(testing::Return("other_hash"))
-        .WillOnce(testing::Return(std::string{hash}))
-        .WillOnce(testing::Return(std::string{hash}));
+    EXPECT_CALL(*mockDownloader, downloadHTTPSToFile(Eq(dbUrl), testing::_))
+        .WillOnce(downloadTo(content, "other_hash"))
+        .WillOnce(downloadTo(content, std::string{hash}));
     EXPECT_CALL(*mockStore, upsertInternalDoc(internalName, testing::_)).WillOnce(testing::Return(storeOk()));
 
     base::OptError error;
@@ -550,19 +558,15 @@ TEST_F(GeoManagerTest, RemoteUpsertDbErrorWriting)
 {
     auto manager = getEmptyManager();
 
-    auto dbFile = getTmpDb();
     auto dbType = Type::ASN;
     std::string_view dbPath = "non_existent_file";
     std::string_view hash = "hash";
     std::string_view dbUrl = "dbUrl";
     auto hashUrl = "hashUrl";
-    auto content = getContentDb(dbFile);
-    auto internalName = base::Name(INTERNAL_NAME) + base::Name(std::filesystem::path(dbFile).filename().string());
 
+    // The directory of the download cannot be created, nothing is downloaded
     EXPECT_CALL(*mockDownloader, downloadMD5(Eq(hashUrl))).WillOnce(testing::Return(base::RespOrError<std::string>(std::string{hash})));
-    EXPECT_CALL(*mockDownloader, downloadHTTPS(Eq(dbUrl)))
-        .WillOnce(testing::Return(base::RespOrError<std::string>(content)));
-    EXPECT_CALL(*mockDownloader, computeMD5(Eq(content))).WillOnce(testing::Return(std::string{hash}));
+    EXPECT_CALL(*mockDownloader, downloadHTTPSToFile(testing::_, testing::_)).Times(0);
 
     base::OptError error;
     ASSERT_NO_THROW(error = manager.remoteUpsertDb(dbPath, dbType, dbUrl, hashUrl));
@@ -584,9 +588,8 @@ TEST_F(GeoManagerTest, RemoteUpsertDbFailInternalStore)
     auto internalName = base::Name(INTERNAL_NAME) + base::Name(std::filesystem::path(dbFile).filename().string());
 
     EXPECT_CALL(*mockDownloader, downloadMD5(Eq(hashUrl))).WillOnce(testing::Return(base::RespOrError<std::string>(std::string{hash})));
-    EXPECT_CALL(*mockDownloader, downloadHTTPS(Eq(dbUrl)))
-        .WillOnce(testing::Return(base::RespOrError<std::string>(content)));
-    EXPECT_CALL(*mockDownloader, computeMD5(Eq(content))).WillOnce(testing::Return(std::string{hash})).WillOnce(testing::Return(std::string{hash}));
+    EXPECT_CALL(*mockDownloader, downloadHTTPSToFile(Eq(dbUrl), testing::_))
+        .WillOnce(downloadTo(content, std::string{hash}));
     EXPECT_CALL(*mockStore, upsertInternalDoc(internalName, testing::_)).WillOnce(testing::Return(storeError()));
 
     base::OptError error;
@@ -597,3 +600,158 @@ TEST_F(GeoManagerTest, RemoteUpsertDbFailInternalStore)
     ASSERT_EQ(manager.listDbs()[0].type, dbType);
 }
 
+TEST_F(GeoManagerTest, RemoteUpsertDbResumesPartialDownload)
+{
+    auto manager = getEmptyManager();
+
+    auto dbFile = getTmpDb();
+    auto dbType = Type::ASN;
+    auto dbPath = std::filesystem::path(dbFile).string();
+    std::string_view hash = "hash";
+    std::string_view dbUrl = "dbUrl";
+    std::string_view hashUrl = "hashUrl";
+    auto content = getContentDb(dbFile);
+    auto half = content.substr(0, content.size() / 2);
+    auto internalName = base::Name(INTERNAL_NAME) + base::Name(std::filesystem::path(dbFile).filename().string());
+
+    EXPECT_CALL(*mockDownloader, downloadMD5(Eq(hashUrl))).WillOnce(testing::Return(base::RespOrError<std::string>(std::string{hash})));
+    EXPECT_CALL(*mockDownloader, downloadHTTPSToFile(Eq(dbUrl), testing::_))
+        .WillOnce(testing::Invoke(
+            [&half](std::string_view, const std::filesystem::path& path) -> base::RespOrError<std::string>
+            {
+                std::ofstream(path, std::ios::binary) << half;
+                return base::Error {"connection reset"};
+            }))
+        .WillOnce(testing::Invoke(
+            [&half, &content, &hash](std::string_view, const std::filesystem::path& path) -> base::RespOrError<std::string>
+            {
+                // The retry finds the bytes of the failed attempt to resume from
+                EXPECT_EQ(std::filesystem::file_size(path), half.size());
+                std::ofstream(path, std::ios::binary | std::ios::app) << content.substr(half.size());
+                return std::string{hash};
+            }));
+    EXPECT_CALL(*mockStore, upsertInternalDoc(internalName, testing::_)).WillOnce(testing::Return(storeOk()));
+
+    base::OptError error;
+    ASSERT_NO_THROW(error = manager.remoteUpsertDb(dbPath, dbType, dbUrl, hashUrl));
+    ASSERT_FALSE(base::isError(error));
+    ASSERT_EQ(manager.listDbs().size(), 1);
+    ASSERT_EQ(getContentDb(dbFile), content);
+    ASSERT_FALSE(std::filesystem::exists(dbPath + ".download"));
+}
+
+TEST_F(GeoManagerTest, RemoteUpsertDbHashNeverMatches)
+{
+    auto manager = getEmptyManager();
+
+    auto dbFile = getTmpDb();
+    auto dbPath = std::filesystem::path(dbFile).string();
+    std::string_view dbUrl = "dbUrl";
+    std::string_view hashUrl = "hashUrl";
+    auto content = getContentDb(dbFile);
+
+    EXPECT_CALL(*mockDownloader, downloadMD5(Eq(hashUrl))).WillOnce(testing::Return(base::RespOrError<std::string>(std::string{"hash"})));
+    EXPECT_CALL(*mockDownloader, downloadHTTPSToFile(Eq(dbUrl), testing::_))
+        .Times(MAX_RETRIES)
+        .WillRepeatedly(downloadTo(content, "other_hash"));
+
+    base::OptError error;
+    ASSERT_NO_THROW(error = manager.remoteUpsertDb(dbPath, Type::ASN, dbUrl, hashUrl));
+    ASSERT_TRUE(base::isError(error));
+    ASSERT_EQ(manager.listDbs().size(), 0);
+    ASSERT_FALSE(std::filesystem::exists(dbPath + ".download"));
+}
+
+TEST_F(GeoManagerTest, RemoteUpsertDbDownloadDoesNotBlockReaders)
+{
+    auto manager = getEmptyManager();
+
+    auto dbFile = getTmpDb();
+    auto otherFile = getTmpDb();
+    auto dbPath = std::filesystem::path(dbFile).string();
+    std::string_view dbUrl = "dbUrl";
+    std::string_view hashUrl = "hashUrl";
+    auto content = getContentDb(dbFile);
+    auto otherName = base::Name(INTERNAL_NAME) + base::Name(std::filesystem::path(otherFile).filename().string());
+
+    EXPECT_CALL(*mockDownloader, downloadMD5(Eq(hashUrl))).WillOnce(testing::Return(base::RespOrError<std::string>(std::string{"hash"})));
+    EXPECT_CALL(*mockDownloader, computeMD5(testing::_)).WillOnce(testing::Return("other_hash"));
+    EXPECT_CALL(*mockStore, upsertInternalDoc(otherName, testing::_)).WillOnce(testing::Return(storeOk()));
+    EXPECT_CALL(*mockDownloader, downloadHTTPSToFile(Eq(dbUrl), testing::_))
+        .WillOnce(testing::Invoke(
+            [&](std::string_view, const std::filesystem::path& path) -> base::RespOrError<std::string>
+            {
+                std::ofstream(path, std::ios::binary) << content;
+
+                // The map is not locked while downloading, the type is taken in the meantime
+                auto reader = std::async(std::launch::async,
+                                         [&]()
+                                         {
+                                             EXPECT_TRUE(base::isError(manager.getLocator(Type::ASN)));
+                                             EXPECT_FALSE(base::isError(manager.addDb(otherFile, Type::ASN)));
+                                         });
+                EXPECT_EQ(reader.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+                return std::string{"hash"};
+            }));
+
+    base::OptError error;
+    ASSERT_NO_THROW(error = manager.remoteUpsertDb(dbPath, Type::ASN, dbUrl, hashUrl));
+    ASSERT_TRUE(base::isError(error));
+    ASSERT_EQ(manager.listDbs().size(), 1);
+    ASSERT_EQ(manager.listDbs()[0].name, std::filesystem::path(otherFile).filename().string());
+    ASSERT_FALSE(std::filesystem::exists(dbPath + ".download"));
+}
+
+TEST_F(GeoManagerTest, LoadCidrTable)
+{
+    auto manager = getEmptyManager();
+    auto tableName = base::Name("geo-cidr/ranges");
+
+    ASSERT_TRUE(manager.getCidrTable()->empty());
+
+    json::Json table {R"({
+        "10.0.0.0/8": {"site": "corp"},
+        "10.1.0.0/16": {"site": "hq", "owner": "it"},
+        "fd00:1::/32": {"site": "lab"}
+    })"};
+    EXPECT_CALL(*mockStore, readInternalDoc(tableName)).WillOnce(testing::Return(storeReadDocResp(table)));
+
+    base::OptError error;
+    ASSERT_NO_THROW(error = manager.loadCidrTable(tableName));
+    ASSERT_FALSE(base::isError(error));
+
+    auto cidrTable = manager.getCidrTable();
+    ASSERT_EQ(cidrTable->size(), 3);
+
+    const auto* data = cidrTable->match(IpAddress::parse("10.1.2.3").value());
+    ASSERT_NE(data, nullptr);
+    ASSERT_EQ(data->getString("/site").value(), "hq");
+    ASSERT_EQ(cidrTable->match(IpAddress::parse("10.2.0.1").value())->getString("/site").value(), "corp");
+    ASSERT_EQ(cidrTable->match(IpAddress::parse("fd00:1::1").value())->getString("/site").value(), "lab");
+    ASSERT_EQ(cidrTable->match(IpAddress::parse("1.2.3.4").value()), nullptr);
+}
+
+TEST_F(GeoManagerTest, LoadCidrTableInvalidKeepsCurrent)
+{
+    auto manager = getEmptyManager();
+    auto tableName = base::Name("geo-cidr/ranges");
+
+    json::Json valid {R"({"10.0.0.0/8": {"site": "corp"}})"};
+    json::Json invalidRange {R"({"10.0.0.0/8": {}, "10.0.0.0/40": {}})"};
+    json::Json notObject {R"(["10.0.0.0/8"])"};
+
+    EXPECT_CALL(*mockStore, readInternalDoc(tableName))
+        .WillOnce(testing::Return(storeReadDocResp(valid)))
+        .WillOnce(testing::Return(storeReadDocResp(invalidRange)))
+        .WillOnce(testing::Return(storeReadDocResp(notObject)))
+        .WillOnce(testing::Return(storeReadError<store::Doc>()));
+
+    ASSERT_FALSE(base::isError(manager.loadCidrTable(tableName)));
+    auto loaded = manager.getCidrTable();
+
+    ASSERT_TRUE(base::isError(manager.loadCidrTable(tableName)));
+    ASSERT_TRUE(base::isError(manager.loadCidrTable(tableName)));
+    ASSERT_TRUE(base::isError(manager.loadCidrTable(tableName)));
+    ASSERT_EQ(manager.getCidrTable(), loaded);
+}
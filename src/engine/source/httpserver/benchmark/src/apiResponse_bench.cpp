@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+
+#include <fmt/format.h>
+
+#include <httpserver/server.hpp>
+
+using namespace httpserver;
+
+namespace
+{
+
+enum class Variant
+{
+    COMPACT = 0,
+    PRETTY,
+    GZIP,
+    ZSTD
+};
+
+/**
+ * @brief A catalog listing like body, compact JSON of the given number of entries.
+ */
+std::string largeBody(int64_t entries)
+{
+    std::string body {R"({"status":"OK","content":[)"};
+    for (int64_t i = 0; i < entries; ++i)
+    {
+        if (i > 0)
+        {
+            body += ',';
+        }
+        body += fmt::format(
+            R"({{"name":"decoder/example_{}/0","type":"decoder","enabled":true,"parents":["decoder/root/0"],)"
+            R"("check":[{{"event.module":"example"}}],"normalize":[{{"map":{{"event.dataset":"example.{}"}}}}]}})",
+            i,
+            i);
+    }
+    body += "]}";
+
+    return body;
+}
+
+/**
+ * @brief Request to response latency of a large JSON response through the API server, over the Unix socket.
+ *
+ * The client keeps the connection alive and does not decompress, wire_bytes is the size of the body it received.
+ */
+void BM_ApiResponse(benchmark::State& state)
+{
+    const auto variant = static_cast<Variant>(state.range(0));
+    const auto body = largeBody(state.range(1));
+
+    const auto socketPath =
+        std::filesystem::temp_directory_path() / fmt::format("dd_api_bench_{}.sock", getpid());
+
+    Server server("bench");
+    server.addRoute(Method::GET,
+                    "/bench/large",
+                    [&body](const httplib::Request&, httplib::Response& res)
+                    { res.set_content(body, "application/json"); });
+    server.start(socketPath);
+
+    httplib::Client client(socketPath.string());
+    client.set_address_family(AF_UNIX);
+    client.set_keep_alive(true);
+    client.set_decompress(false);
+
+    const auto path = variant == Variant::PRETTY ? "/bench/large?pretty" : "/bench/large";
+
+    httplib::Headers headers;
+    if (variant == Variant::GZIP)
+    {
+        headers.emplace("Accept-Encoding", "gzip");
+    }
+    else if (variant == Variant::ZSTD)
+    {
+        headers.emplace("Accept-Encoding", "zstd");
+    }
+
+    std::size_t wireBytes {0};
+    for (auto _ : state)
+    {
+        auto result = client.Get(path, headers);
+        if (!result || result->status != httplib::StatusCode::OK_200)
+        {
+            state.SkipWithError("request failed");
+            break;
+        }
+
+        wireBytes = result->body.size();
+        benchmark::DoNotOptimize(result->body.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+    state.counters["body_bytes"] = static_cast<double>(body.size());
+    state.counters["wire_bytes"] = static_cast<double>(wireBytes);
+
+    client.stop();
+    server.stop();
+}
+
+} // namespace
+
+BENCHMARK(BM_ApiResponse)
+    ->ArgNames({"variant", "entries"})
+    ->ArgsProduct({{static_cast<int64_t>(Variant::COMPACT),
+                    static_cast<int64_t>(Variant::PRETTY),
+                    static_cast<int64_t>(Variant::GZIP),
+                    static_cast<int64_t>(Variant::ZSTD)},
+                   {100, 1000, 10000}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
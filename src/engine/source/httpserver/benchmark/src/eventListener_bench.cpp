@@ -0,0 +1,183 @@
+#include <benchmark/benchmark.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <base/logger.hpp>
+#include <httpserver/eventListener.hpp>
+
+using namespace httpserver;
+
+namespace
+{
+
+constexpr int EVENTS_PER_SEND {8};
+constexpr int SENDS_PER_CONNECTION {32};
+
+int64_t threadCpuNs()
+{
+    timespec ts {};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+int connectTo(const std::filesystem::path& path)
+{
+    const auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Cannot connect to " + path.string());
+    }
+
+    return fd;
+}
+
+void sendAll(int fd, std::string_view data)
+{
+    while (!data.empty())
+    {
+        const auto n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (n <= 0)
+        {
+            throw std::runtime_error("Cannot send to the event listener");
+        }
+        data.remove_prefix(static_cast<std::size_t>(n));
+    }
+}
+
+/**
+ * @brief Counts the events and samples the CPU time of the loop thread when the awaited one arrives.
+ */
+struct Sink
+{
+    std::atomic<uint64_t> received {0};
+    std::atomic<uint64_t> awaited {0};
+    std::atomic<int64_t> loopCpuNs {0};
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    void operator()(std::string_view event)
+    {
+        benchmark::DoNotOptimize(event.data());
+
+        if (++received == awaited.load(std::memory_order_relaxed))
+        {
+            loopCpuNs = threadCpuNs();
+            std::lock_guard lock {mutex};
+            cv.notify_all();
+        }
+    }
+
+    void wait(uint64_t count)
+    {
+        std::unique_lock lock {mutex};
+        cv.wait(lock, [this, count]() { return received.load() >= count; });
+    }
+};
+
+/**
+ * @brief Events per second and CPU of the loop per event, small newline framed events over many connections.
+ *
+ * Each iteration every connection sends SENDS_PER_CONNECTION writes of EVENTS_PER_SEND events.
+ */
+void BM_EventListener(benchmark::State& state)
+{
+    const auto backend = static_cast<Backend>(state.range(0));
+    const auto connections = static_cast<int>(state.range(1));
+
+    const auto socketPath = std::filesystem::temp_directory_path() / fmt::format("dd_event_bench_{}.sock", getpid());
+
+    Sink sink;
+    EventListener listener(
+        "bench", [&sink](std::string_view event) { sink(event); }, {Framing::NEWLINE, 4096, backend});
+    listener.start(socketPath);
+
+    if (backend == Backend::IO_URING && listener.backend() != Backend::IO_URING)
+    {
+        state.SkipWithError("io_uring unavailable");
+        return;
+    }
+
+    std::vector<int> fds;
+    for (int i = 0; i < connections; ++i)
+    {
+        fds.push_back(connectTo(socketPath));
+    }
+
+    // A typical small event, about 100 bytes
+    std::string batch;
+    for (int i = 0; i < EVENTS_PER_SEND; ++i)
+    {
+        batch += R"({"agent":"host-01","type":"process","pid":4242,"path":"/usr/bin/example","action":"exec"})";
+        batch += '\n';
+    }
+
+    const uint64_t perIteration = static_cast<uint64_t>(connections) * SENDS_PER_CONNECTION * EVENTS_PER_SEND;
+
+    // Warm up, and the first CPU sample
+    sink.awaited = perIteration;
+    for (int send = 0; send < SENDS_PER_CONNECTION; ++send)
+    {
+        for (const auto fd : fds)
+        {
+            sendAll(fd, batch);
+        }
+    }
+    sink.wait(perIteration);
+
+    const auto cpuStart = sink.loopCpuNs.load();
+    uint64_t events {0};
+
+    for (auto _ : state)
+    {
+        const auto target = sink.received.load() + perIteration;
+        sink.awaited = target;
+
+        for (int send = 0; send < SENDS_PER_CONNECTION; ++send)
+        {
+            for (const auto fd : fds)
+            {
+                sendAll(fd, batch);
+            }
+        }
+
+        sink.wait(target);
+        events += perIteration;
+    }
+
+    const auto cpuNs = sink.loopCpuNs.load() - cpuStart;
+
+    state.SetItemsProcessed(static_cast<int64_t>(events));
+    state.counters["loop_cpu_ns_per_event"] = events == 0 ? 0.0 : static_cast<double>(cpuNs) / events;
+
+    for (const auto fd : fds)
+    {
+        ::close(fd);
+    }
+    listener.stop();
+}
+
+} // namespace
+
+BENCHMARK(BM_EventListener)
+    ->ArgNames({"backend", "connections"})
+    ->ArgsProduct({{static_cast<int64_t>(Backend::EPOLL), static_cast<int64_t>(Backend::IO_URING)}, {1, 16, 256}})
+    ->UseRealTime();
@@ -0,0 +1,19 @@
+#include <benchmark/benchmark.h>
+
+#include <base/logger.hpp>
+
+int main(int argc, char** argv)
+{
+    logger::testInit();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
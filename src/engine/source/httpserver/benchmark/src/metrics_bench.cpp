@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+
+#include <httpserver/metrics.hpp>
+
+using namespace httpserver;
+
+namespace
+{
+
+/**
+ * @brief Cost of recording a request on the request path, shared by the worker threads of a server.
+ */
+void BM_RouteMetricsRecord(benchmark::State& state)
+{
+    static RouteMetrics metrics;
+
+    int64_t i {0};
+    for (auto _ : state)
+    {
+        metrics.record(200, 128, 1024, std::chrono::microseconds(i++ & 0xFFF));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Cost of merging the shards, paid by each scrape of the metrics route.
+ */
+void BM_RouteMetricsSnapshot(benchmark::State& state)
+{
+    RouteMetrics metrics;
+    for (int i = 0; i < 1000; ++i)
+    {
+        metrics.record(200, 128, 1024, std::chrono::microseconds(i));
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(metrics.snapshot());
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_RouteMetricsRecord)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_RouteMetricsSnapshot);
@@ -0,0 +1,43 @@
+#ifndef _COMPRESSION_HPP
+#define _COMPRESSION_HPP
+
+#include <string>
+#include <string_view>
+
+#include <base/error.hpp>
+
+namespace httpserver
+{
+
+enum class Encoding
+{
+    IDENTITY = 0,
+    GZIP,
+    ZSTD
+};
+
+/**
+ * @brief Content-Encoding token of the encoding, empty for IDENTITY.
+ */
+std::string_view encodingName(Encoding encoding) noexcept;
+
+/**
+ * @brief Pick the response encoding from an Accept-Encoding header value.
+ *
+ * The supported encoding with the highest quality wins, zstd over gzip on a tie. "*" stands for any of them and
+ * q=0 refuses one.
+ *
+ * @return Encoding The encoding, IDENTITY if the client accepts none of the supported ones.
+ */
+Encoding negotiateEncoding(std::string_view acceptEncoding) noexcept;
+
+/**
+ * @brief Compress data, gzip at the zlib default level and zstd at its default level.
+ *
+ * @return The compressed bytes, or an error if the compressor failed. IDENTITY returns data as is.
+ */
+base::RespOrError<std::string> compress(std::string_view data, Encoding encoding);
+
+} // namespace httpserver
+
+#endif // _COMPRESSION_HPP
@@ -0,0 +1,114 @@
+#ifndef _DATAGRAM_LISTENER_HPP
+#define _DATAGRAM_LISTENER_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace httpserver
+{
+
+namespace internal
+{
+class SocketLoop;
+} // namespace internal
+
+struct DatagramListenerOptions
+{
+    std::size_t maxDatagramSize {64 * 1024}; ///< Larger datagrams are dropped
+    std::size_t batchSize {64};              ///< Datagrams received per recvmmsg call
+    int receiveBufferSize {0};               ///< SO_RCVBUF of the socket, 0 keeps the system default
+};
+
+/**
+ * @brief One message per datagram listener on a Unix datagram socket.
+ *
+ * For local sources that cannot speak HTTP or keep a connection, and tolerate loss: datagrams sent while the
+ * socket buffer is full are dropped by the kernel. Datagrams are received in batches by recvmmsg into buffers
+ * allocated once at start, and handed to the handler as views into them on the loop thread. Has the same start and
+ * stop lifecycle as Server.
+ */
+class DatagramListener
+{
+public:
+    /**
+     * @brief Called with each datagram. The view is only valid during the call, copy it to keep it.
+     */
+    using Handler = std::function<void(std::string_view)>;
+
+    DatagramListener(std::string id, Handler handler, DatagramListenerOptions options = {});
+
+    ~DatagramListener();
+
+    DatagramListener(const DatagramListener&) = delete;
+    DatagramListener& operator=(const DatagramListener&) = delete;
+
+    void start(const std::filesystem::path& socketPath, bool useThread = true);
+
+    /**
+     * @brief Start on a socket handed over by a previous process, see handoff.
+     *
+     * The socket file is left as is. Takes ownership of socketFd, closed if the start fails.
+     */
+    void start(int socketFd, bool useThread = true);
+
+    /**
+     * @brief Stop receiving, hand over the datagrams already queued on the socket and stop.
+     */
+    void stop();
+
+    bool isRunning() const noexcept;
+
+    /**
+     * @brief Bound socket, to hand over to a new process while running.
+     */
+    int socketFd() const noexcept;
+
+    /**
+     * @brief Leave the socket to the process it was handed over to.
+     *
+     * The next stop leaves the queued datagrams to the new process, and does not remove the socket file.
+     */
+    void handOff() noexcept;
+
+private:
+    /**
+     * @brief Allocate the buffer pool for socketFd_ and run the loop.
+     */
+    void startLoop(bool useThread);
+
+    [[noreturn]] void fail(std::string_view what);
+
+    void run();
+
+    /**
+     * @brief Receive and hand over datagrams until none is pending.
+     */
+    void drain();
+
+    void closeSocket();
+
+    std::string id_;
+    Handler handler_;
+    DatagramListenerOptions options_;
+
+    int socketFd_;
+
+    // Buffer pool, batchSize buffers of maxDatagramSize bytes and their recvmmsg headers
+    std::vector<char> buffers_;
+    std::vector<iovec> iovecs_;
+    std::vector<mmsghdr> headers_;
+
+    std::unique_ptr<internal::SocketLoop> loop_;
+};
+
+} // namespace httpserver
+
+#endif // _DATAGRAM_LISTENER_HPP
@@ -0,0 +1,191 @@
+#ifndef _EVENT_LISTENER_HPP
+#define _EVENT_LISTENER_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace httpserver
+{
+
+/**
+ * @brief How messages are delimited on a stream connection.
+ */
+enum class Framing
+{
+    NEWLINE = 0,    ///< One message per line, a trailing '\r' is dropped and empty lines are skipped
+    LENGTH_PREFIXED ///< 4-byte big-endian payload length followed by the payload
+};
+
+/**
+ * @brief How the listener waits for connections and data.
+ */
+enum class Backend
+{
+    EPOLL = 0, ///< Edge-triggered epoll and non-blocking reads
+    IO_URING   ///< Multishot accept and receive into provided buffers, falls back to EPOLL if unavailable
+};
+
+struct EventListenerOptions
+{
+    Framing framing {Framing::NEWLINE};
+    std::size_t maxFrameSize {1024 * 1024}; ///< Larger messages close their connection
+    Backend backend {Backend::EPOLL};
+};
+
+namespace internal
+{
+class Uring;
+class SocketLoop;
+} // namespace internal
+
+/**
+ * @brief Framed message listener on a Unix stream socket, served by a single event loop thread.
+ *
+ * An alternative to Server for the event socket: no HTTP parsing and no thread per connection. Messages are handed
+ * to the handler as views into the received data, in arrival order per connection, on the loop thread. Only the
+ * tail of a message split across reads is copied, into a buffer of its connection. Has the same start and stop
+ * lifecycle as Server.
+ */
+class EventListener
+{
+public:
+    /**
+     * @brief Called with each message. The view is only valid during the call, copy it to keep it.
+     */
+    using Handler = std::function<void(std::string_view)>;
+
+    EventListener(std::string id, Handler handler, EventListenerOptions options = {});
+
+    ~EventListener();
+
+    EventListener(const EventListener&) = delete;
+    EventListener& operator=(const EventListener&) = delete;
+
+    void start(const std::filesystem::path& socketPath, bool useThread = true);
+
+    /**
+     * @brief Start on a listening socket handed over by a previous process, see handoff.
+     *
+     * The socket file is left as is. Takes ownership of listenFd, closed if the start fails.
+     */
+    void start(int listenFd, bool useThread = true);
+
+    /**
+     * @brief Stop accepting connections, hand over the messages received so far and stop.
+     *
+     * The receiving side of every connection is shut down, so peers get EPIPE on their next send, and everything
+     * they sent before that is read and handed over before the loop ends. An incomplete trailing message is dropped.
+     */
+    void stop();
+
+    bool isRunning() const noexcept;
+
+    /**
+     * @brief Listening socket, to hand over to a new process while running.
+     */
+    int socketFd() const noexcept;
+
+    /**
+     * @brief Leave the socket to the process it was handed over to.
+     *
+     * The next stop drains the accepted connections only, the queued ones are left to the new process, and the
+     * socket file is not removed.
+     */
+    void handOff() noexcept;
+
+    /**
+     * @brief Backend of the running loop, or of the last one, EPOLL if the IO_URING one fell back.
+     */
+    Backend backend() const noexcept;
+
+private:
+    struct Connection
+    {
+        std::vector<char> buffer; ///< Bytes received and not handed over yet, starting at a message boundary
+        std::size_t size {0};     ///< Used bytes of buffer
+        std::size_t scanned {0};  ///< Bytes already searched for a newline
+        bool closing {false};     ///< Shut down, closed once its pending receive completes
+    };
+
+    /**
+     * @brief Set up the backend on listenFd_ and run the loop.
+     */
+    void startLoop(bool useThread);
+
+    [[noreturn]] void fail(std::string_view what);
+
+    void run();
+
+    void runEpoll();
+
+    void runUring();
+
+    void accept();
+
+    /**
+     * @brief Accept one pending connection and close it, when the process is out of file descriptors.
+     *
+     * The spare descriptor is given up for the time of the accept, so the listening socket is drained instead of
+     * staying readable and waking the loop again.
+     *
+     * @return false if there was no connection to drop.
+     */
+    bool shed();
+
+    /**
+     * @brief Read everything available on the connection and hand over its complete messages.
+     *
+     * @return false if the connection has to be closed.
+     */
+    bool read(int fd, Connection& connection);
+
+    /**
+     * @brief Hand over the complete messages of data received on the connection, keep the incomplete tail.
+     *
+     * @return false if the connection has to be closed.
+     */
+    bool receive(int fd, Connection& connection, std::string_view data);
+
+    /**
+     * @brief Hand over the complete messages of the connection buffer and drop them from it.
+     *
+     * @return false on a message over the size limit.
+     */
+    bool dispatchBuffered(int fd, Connection& connection);
+
+    /**
+     * @brief Hand over the complete messages at the start of data.
+     *
+     * @param scanned Bytes of data already searched for a newline.
+     * @return Bytes handed over, or nullopt on a message over the size limit.
+     */
+    std::optional<std::size_t> dispatch(int fd, const char* data, std::size_t size, std::size_t scanned);
+
+    void close(int fd);
+
+    void closeAll();
+
+    std::string id_;
+    Handler handler_;
+    EventListenerOptions options_;
+
+    int listenFd_;
+    int epollFd_;
+    int reserveFd_; ///< Spare descriptor released by shed(), -1 while it cannot be reopened
+    std::unique_ptr<internal::Uring> uring_;
+    Backend backend_;
+    std::unordered_map<int, Connection> connections_;
+
+    std::unique_ptr<internal::SocketLoop> loop_;
+};
+
+} // namespace httpserver
+
+#endif // _EVENT_LISTENER_HPP
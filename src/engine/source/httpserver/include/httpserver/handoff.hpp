@@ -0,0 +1,137 @@
+#ifndef _HANDOFF_HPP
+#define _HANDOFF_HPP
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <base/error.hpp>
+
+/**
+ * @brief Hot restart: the listening sockets of a running process are passed to its replacement with SCM_RIGHTS.
+ *
+ * The running process serves a Provider on a handoff socket. The new one calls request on it, starts its listeners
+ * on the sockets it received, then calls Inherited::ready: the previous process stops reading from the shared
+ * sockets, drains its connections and exits, while the new one is already accepting on the same sockets. The
+ * socket files are never unlinked in between, so no connection is refused. If the new process fails before ready,
+ * the previous one keeps serving.
+ */
+namespace httpserver::internal
+{
+class SocketLoop;
+} // namespace httpserver::internal
+
+namespace httpserver::handoff
+{
+
+/**
+ * @brief Listening sockets received from the previous process, by the path they are bound to.
+ */
+class Inherited
+{
+public:
+    /**
+     * @brief Nothing inherited.
+     */
+    Inherited();
+
+    /**
+     * @brief Closes the sockets not taken. Without ready, the previous process keeps serving.
+     */
+    ~Inherited();
+
+    Inherited(Inherited&& other) noexcept;
+    Inherited& operator=(Inherited&& other) noexcept;
+
+    Inherited(const Inherited&) = delete;
+    Inherited& operator=(const Inherited&) = delete;
+
+    /**
+     * @brief Take ownership of the socket bound to path, if one of that type was received.
+     *
+     * @param type SOCK_STREAM or SOCK_DGRAM.
+     * @return int The descriptor, -1 if there is none.
+     */
+    int take(const std::filesystem::path& path, int type);
+
+    /**
+     * @brief Tell the previous process its sockets are served, it then drains and exits.
+     */
+    void ready();
+
+private:
+    friend base::RespOrError<Inherited> request(const std::filesystem::path&, std::chrono::milliseconds);
+
+    int connectionFd_;                            ///< Connection to the previous process
+    std::unordered_map<std::string, int> sockets_; ///< Descriptors not taken yet
+};
+
+/**
+ * @brief Ask the process serving a Provider on path for its listening sockets.
+ *
+ * @return The sockets, or an error if no process of the same user answers on path within the timeout.
+ */
+base::RespOrError<Inherited> request(const std::filesystem::path& path, std::chrono::milliseconds timeout);
+
+/**
+ * @brief Hands the listening sockets of the process over to the next process that asks for them.
+ *
+ * Only processes of the same user are answered, and the socket file is only accessible to its owner.
+ */
+class Provider
+{
+public:
+    /**
+     * @brief Returns the listening sockets to hand over, called for each request.
+     */
+    using Sockets = std::function<std::vector<int>()>;
+
+    /**
+     * @brief Called once the new process reported ready, the provider has stopped by then.
+     */
+    using HandedOff = std::function<void()>;
+
+    Provider(std::string id, Sockets sockets, HandedOff handedOff);
+
+    ~Provider();
+
+    Provider(const Provider&) = delete;
+    Provider& operator=(const Provider&) = delete;
+
+    /**
+     * @brief Serve on socketPath, in its own thread.
+     *
+     * The socket is bound under a temporary name and renamed over socketPath, so a previous provider there keeps
+     * answering until this one does.
+     */
+    void start(const std::filesystem::path& socketPath);
+
+    void stop();
+
+    bool isRunning() const noexcept;
+
+private:
+    void run();
+
+    /**
+     * @brief Send the sockets on an accepted connection and wait for the new process to be ready.
+     *
+     * @return true if it reported ready.
+     */
+    bool handOff(int fd);
+
+    std::string id_;
+    Sockets sockets_;
+    HandedOff handedOff_;
+
+    int listenFd_;
+    std::unique_ptr<internal::SocketLoop> loop_;
+};
+
+} // namespace httpserver::handoff
+
+#endif // _HANDOFF_HPP
@@ -1,12 +1,23 @@
 #ifndef _SERVER_HPP
 #define _SERVER_HPP
 
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <memory>
+#include <regex>
+#include <string>
 #include <thread>
 #include <filesystem>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <httplib.h>
 
+#include <httpserver/metrics.hpp>
+
 namespace httpserver
 {
 
@@ -42,26 +53,132 @@ namespace
 
 } // namespace
 
+/**
+ * @brief Tuning of a server, the defaults are the ones of httplib.
+ */
+struct ServerOptions
+{
+    std::size_t threads {CPPHTTPLIB_THREAD_POOL_COUNT}; ///< Workers serving connections
+    std::size_t queueSize {0};                          ///< Connections waiting for a worker before 503, 0 unbounded
+    std::size_t keepAliveMaxCount {CPPHTTPLIB_KEEPALIVE_MAX_COUNT};
+    std::chrono::seconds keepAliveTimeout {CPPHTTPLIB_KEEPALIVE_TIMEOUT_SECOND};
+    std::chrono::seconds readTimeout {CPPHTTPLIB_READ_TIMEOUT_SECOND};
+    std::chrono::seconds writeTimeout {CPPHTTPLIB_WRITE_TIMEOUT_SECOND};
+    std::size_t payloadMaxSize {CPPHTTPLIB_PAYLOAD_MAX_LENGTH}; ///< Bytes of a request body
+    std::size_t streamingPayloadMaxSize {0}; ///< Bytes of a request body on streaming routes, 0 unbounded
+    bool compression {true};               ///< Compress responses with an encoding the client accepts
+    std::size_t compressionMinSize {1024}; ///< Bytes of a response body below which it is sent as is
+};
+
 class Server
 {
 public:
-    Server(std::string id);
+    Server(std::string id, ServerOptions options = {});
 
     ~Server();
 
     void start(const std::filesystem::path& socketPath, bool useThread = true);
 
+    /**
+     * @brief Stop accepting connections, let the requests being served complete and stop.
+     */
     void stop();
 
+    /**
+     * @brief Add or replace the handler of a route.
+     *
+     * Routes without regex special characters are matched exactly through a hash table, the others as a regex over
+     * the whole path, in the order they were added, if no exact route matches. Requests without a body are served
+     * from the hash table before httplib routes them. Add routes before start.
+     *
+     * The requests a route serves are counted by status, with their body sizes and latency, see metrics. Replacing
+     * the handler keeps the counts.
+     */
     void addRoute(Method method, const std::string& route, httplib::Server::Handler handler);
 
+    /**
+     * @brief Add a route that reads the request body as it arrives, through the content reader, instead of from
+     * req.body.
+     *
+     * The body is never buffered by the server, so its size only bounds the memory of the route if the handler
+     * buffers it. The streaming payload limit applies instead of the payload one. Requests without a body get a
+     * reader with nothing to read. Only methods with a body: POST, PUT and DELETE. Add routes before start.
+     */
+    void addStreamingRoute(Method method, const std::string& route, httplib::Server::HandlerWithContentReader handler);
+
+    /**
+     * @brief Serve the metrics of the routes on a GET route, in the Prometheus text format.
+     */
+    void addMetricsRoute(const std::string& route = "/metrics");
+
+    /**
+     * @brief The metrics of the routes in the Prometheus text format, in the order of the routes.
+     */
+    std::string metrics() const;
+
     bool isRunning() const noexcept;
 
 private:
-    
+    struct Route
+    {
+        httplib::Server::Handler handler;
+        std::shared_ptr<RouteMetrics> metrics;
+        bool streaming {false}; ///< Added by addStreamingRoute, its bodies are read by httplib content readers
+    };
+
+    struct Routes
+    {
+        std::unordered_map<std::string, Route> exact;
+        std::vector<std::pair<std::regex, Route>> patterns;
+    };
+
+    /**
+     * @brief The route of a path, the exact one if any, else the first pattern matching it. Null if none.
+     */
+    static const Route* findRoute(const Routes& routes, const std::string& path);
+
+    /**
+     * @brief The routes of a request method, null for methods without routes.
+     */
+    const Routes* methodRoutes(const std::string& method) const;
+
+    /**
+     * @brief Whether the declared body of the request is over the payload limit of its route.
+     *
+     * httplib has a single limit for every route, set to the larger one so it only bounds the streaming routes.
+     */
+    bool payloadTooLarge(const httplib::Request& req) const;
+
+    /**
+     * @brief Run the handler of the request path, 404 if there is none, then encode the response for the client.
+     */
+    void dispatch(const Routes& routes, const httplib::Request& req, httplib::Response& res) const;
+
+    /**
+     * @brief Run the handler of a route on a request with its body already read, then encode the response.
+     */
+    void serveRoute(const Route& route, const httplib::Request& req, httplib::Response& res) const;
+
+    /**
+     * @brief Run handle, which answers the request and sets the bytes of its body it read, then encode the response.
+     * Both are recorded in metrics.
+     */
+    template<typename Handle>
+    void serve(RouteMetrics& metrics, const httplib::Request& req, httplib::Response& res, Handle&& handle) const;
+
+    /**
+     * @brief Pretty print a JSON body if the request has the pretty parameter, and compress it with the preferred
+     * encoding of the client when compression is enabled and the body is at least compressionMinSize bytes.
+     */
+    void encode(const httplib::Request& req, httplib::Response& res) const;
+
+    std::array<Routes, static_cast<std::size_t>(Method::ERROR_METHOD)> routes_;
+    std::map<std::pair<Method, std::string>, std::shared_ptr<RouteMetrics>> metrics_; ///< By route, also replaced ones
+
     std::shared_ptr<httplib::Server> server_;
     std::thread thread_;
     std::string id_;
+    ServerOptions options_;
 };
 
 } // namespace httpserver
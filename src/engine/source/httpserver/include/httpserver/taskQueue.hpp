@@ -0,0 +1,74 @@
+#ifndef _TASK_QUEUE_HPP
+#define _TASK_QUEUE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <httplib.h>
+
+namespace httpserver
+{
+
+/**
+ * @brief Fixed pool of workers over a queue with an upper bound on the pending connections.
+ *
+ * A connection accepted while the queue is full is not dropped: it is handed to a dedicated rejection thread that
+ * serves it with isRejecting() set, so the server answers it with 503 Service Unavailable instead of leaving the
+ * client waiting on a closed socket. The accepting thread never serves a connection itself, a client that sends
+ * nothing only holds the rejection thread, for the read timeout at most. Past MAX_REJECTED connections waiting for
+ * it, enqueue fails and httplib closes the connection without an answer.
+ */
+class BoundedTaskQueue : public httplib::TaskQueue
+{
+public:
+    static constexpr std::size_t MAX_REJECTED = 16; ///< Rejected connections waiting for the rejection thread
+
+    /**
+     * @brief Start the workers.
+     *
+     * @param threads Number of workers, at least one.
+     * @param maxQueued Pending connections accepted before rejecting, 0 for no bound.
+     */
+    BoundedTaskQueue(std::size_t threads, std::size_t maxQueued);
+
+    ~BoundedTaskQueue() override;
+
+    bool enqueue(std::function<void()> fn) override;
+
+    void shutdown() override;
+
+    /**
+     * @brief Whether the current thread is the rejection thread, serving a connection rejected because the queue
+     * was full.
+     */
+    static bool isRejecting() noexcept;
+
+    /**
+     * @brief Number of connections waiting for a worker.
+     */
+    std::size_t pending() const;
+
+private:
+    void work();
+
+    void reject();
+
+    std::size_t maxQueued_;
+    std::vector<std::thread> workers_;
+    std::thread rejecter_; ///< Only started with a bound
+    std::deque<std::function<void()>> queue_;
+    std::deque<std::function<void()>> rejected_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable rejectedCv_;
+    bool shutdown_;
+};
+
+} // namespace httpserver
+
+#endif // _TASK_QUEUE_HPP
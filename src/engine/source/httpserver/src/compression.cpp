@@ -0,0 +1,194 @@
+#include "compression.hpp"
+
+#include <cctype>
+#include <cstdlib>
+
+#include <fmt/format.h>
+#include <zlib.h>
+#include <zstd.h>
+
+namespace httpserver
+{
+
+namespace
+{
+
+std::string_view trim(std::string_view str)
+{
+    while (!str.empty() && std::isspace(static_cast<unsigned char>(str.front())))
+    {
+        str.remove_prefix(1);
+    }
+    while (!str.empty() && std::isspace(static_cast<unsigned char>(str.back())))
+    {
+        str.remove_suffix(1);
+    }
+    return str;
+}
+
+bool equalsIgnoreCase(std::string_view lhs, std::string_view rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        if (std::tolower(static_cast<unsigned char>(lhs[i])) != std::tolower(static_cast<unsigned char>(rhs[i])))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Quality of an Accept-Encoding entry parameters ("q=0.5"), 1 if absent or malformed.
+ */
+double quality(std::string_view params)
+{
+    while (!params.empty())
+    {
+        const auto semicolon = params.find(';');
+        const auto param = trim(params.substr(0, semicolon));
+        params = semicolon == std::string_view::npos ? std::string_view {} : params.substr(semicolon + 1);
+
+        if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=')
+        {
+            const std::string value {param.substr(2)};
+            char* end {nullptr};
+            const auto q = std::strtod(value.c_str(), &end);
+            if (end != value.c_str() && *end == '\0' && q >= 0 && q <= 1)
+            {
+                return q;
+            }
+        }
+    }
+
+    return 1;
+}
+
+base::RespOrError<std::string> gzip(std::string_view data)
+{
+    z_stream stream {};
+    // 15 window bits, plus 16 for the gzip wrapper
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return base::Error {"deflateInit2 failed"};
+    }
+
+    std::string out;
+    out.resize(deflateBound(&stream, static_cast<uLong>(data.size())));
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+
+    const auto result = deflate(&stream, Z_FINISH);
+    const auto size = stream.total_out;
+    deflateEnd(&stream);
+
+    if (result != Z_STREAM_END)
+    {
+        return base::Error {fmt::format("deflate failed: {}", result)};
+    }
+
+    out.resize(size);
+    return out;
+}
+
+base::RespOrError<std::string> zstd(std::string_view data)
+{
+    std::string out;
+    out.resize(ZSTD_compressBound(data.size()));
+
+    const auto size = ZSTD_compress(out.data(), out.size(), data.data(), data.size(), ZSTD_CLEVEL_DEFAULT);
+    if (ZSTD_isError(size))
+    {
+        return base::Error {fmt::format("ZSTD_compress failed: {}", ZSTD_getErrorName(size))};
+    }
+
+    out.resize(size);
+    return out;
+}
+
+} // namespace
+
+std::string_view encodingName(Encoding encoding) noexcept
+{
+    switch (encoding)
+    {
+        case Encoding::GZIP: return "gzip";
+        case Encoding::ZSTD: return "zstd";
+        default: return "";
+    }
+}
+
+Encoding negotiateEncoding(std::string_view acceptEncoding) noexcept
+{
+    double gzipQ {0};
+    double zstdQ {0};
+    double anyQ {0};
+    bool gzipListed {false};
+    bool zstdListed {false};
+
+    while (!acceptEncoding.empty())
+    {
+        const auto comma = acceptEncoding.find(',');
+        const auto entry = acceptEncoding.substr(0, comma);
+        acceptEncoding = comma == std::string_view::npos ? std::string_view {} : acceptEncoding.substr(comma + 1);
+
+        const auto semicolon = entry.find(';');
+        const auto name = trim(entry.substr(0, semicolon));
+        const auto q = semicolon == std::string_view::npos ? 1.0 : quality(entry.substr(semicolon + 1));
+
+        if (equalsIgnoreCase(name, "gzip") || equalsIgnoreCase(name, "x-gzip"))
+        {
+            gzipQ = q;
+            gzipListed = true;
+        }
+        else if (equalsIgnoreCase(name, "zstd"))
+        {
+            zstdQ = q;
+            zstdListed = true;
+        }
+        else if (name == "*")
+        {
+            anyQ = q;
+        }
+    }
+
+    // Listed encodings take their own quality, the others the one of "*"
+    if (!gzipListed)
+    {
+        gzipQ = anyQ;
+    }
+    if (!zstdListed)
+    {
+        zstdQ = anyQ;
+    }
+
+    if (zstdQ > 0 && zstdQ >= gzipQ)
+    {
+        return Encoding::ZSTD;
+    }
+    if (gzipQ > 0)
+    {
+        return Encoding::GZIP;
+    }
+    return Encoding::IDENTITY;
+}
+
+base::RespOrError<std::string> compress(std::string_view data, Encoding encoding)
+{
+    switch (encoding)
+    {
+        case Encoding::GZIP: return gzip(data);
+        case Encoding::ZSTD: return zstd(data);
+        default: return std::string {data};
+    }
+}
+
+} // namespace httpserver
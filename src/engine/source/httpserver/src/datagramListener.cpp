@@ -0,0 +1,289 @@
+#include "datagramListener.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <base/logger.hpp>
+
+#include "socketLoop.hpp"
+
+namespace httpserver
+{
+
+DatagramListener::DatagramListener(std::string id, Handler handler, DatagramListenerOptions options)
+    : id_{std::move(id)}
+    , handler_{std::move(handler)}
+    , options_{options}
+    , socketFd_{-1}
+{
+    if (!handler_)
+    {
+        throw std::invalid_argument(fmt::format("Datagram listener {} needs a handler", id_));
+    }
+
+    if (options_.maxDatagramSize == 0 || options_.batchSize == 0)
+    {
+        throw std::invalid_argument(
+            fmt::format("Datagram listener {} needs a datagram size and a batch size above zero", id_));
+    }
+
+    loop_ = std::make_unique<internal::SocketLoop>(fmt::format("Datagram listener {}", id_));
+}
+
+DatagramListener::~DatagramListener()
+{
+    stop();
+}
+
+void DatagramListener::start(const std::filesystem::path& socketPath, bool useThread)
+{
+    if (socketPath.empty())
+    {
+        throw std::runtime_error(fmt::format("Cannot start datagram listener {}: empty socket path!", id_));
+    }
+
+    if (loop_->isStarted())
+    {
+        throw std::runtime_error(fmt::format("Cannot start datagram listener {}: already running!", id_));
+    }
+
+    if (!std::filesystem::exists(socketPath.parent_path()))
+    {
+        throw std::runtime_error(
+            fmt::format(
+                "Cannot start datagram listener {}: parent directory {} does not exist!",
+                id_,
+                socketPath.parent_path().string()
+            )
+        );
+    }
+
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    if (socketPath.string().size() >= sizeof(addr.sun_path))
+    {
+        throw std::runtime_error(fmt::format(
+            "Cannot start datagram listener {}: socket path {} is too long!", id_, socketPath.string()));
+    }
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (std::filesystem::exists(socketPath))
+    {
+        std::filesystem::remove(socketPath);
+        LOG_TRACE("Datagram listener {} removed existing socket file {}", id_, socketPath.string());
+    }
+
+    socketFd_ = ::socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socketFd_ < 0)
+    {
+        fail("socket");
+    }
+
+    if (options_.receiveBufferSize > 0
+        && ::setsockopt(
+               socketFd_, SOL_SOCKET, SO_RCVBUF, &options_.receiveBufferSize, sizeof(options_.receiveBufferSize))
+               < 0)
+    {
+        fail("setsockopt SO_RCVBUF");
+    }
+
+    if (::bind(socketFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+        fail("bind");
+    }
+    loop_->own(socketPath);
+
+    startLoop(useThread);
+}
+
+void DatagramListener::start(int socketFd, bool useThread)
+{
+    if (loop_->isStarted())
+    {
+        ::close(socketFd);
+        throw std::runtime_error(fmt::format("Cannot start datagram listener {}: already running!", id_));
+    }
+
+    sockaddr_un addr {};
+    socklen_t size = sizeof(addr);
+    int type {0};
+    socklen_t typeSize = sizeof(type);
+    if (::getsockname(socketFd, reinterpret_cast<sockaddr*>(&addr), &size) < 0 || addr.sun_family != AF_UNIX
+        || ::getsockopt(socketFd, SOL_SOCKET, SO_TYPE, &type, &typeSize) < 0 || type != SOCK_DGRAM)
+    {
+        ::close(socketFd);
+        throw std::runtime_error(fmt::format(
+            "Cannot start datagram listener {}: descriptor {} is not a Unix datagram socket!", id_, socketFd));
+    }
+
+    socketFd_ = socketFd;
+    loop_->inherit(addr.sun_path);
+
+    const auto flags = ::fcntl(socketFd_, F_GETFL);
+    if (flags < 0 || ::fcntl(socketFd_, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        fail("fcntl");
+    }
+
+    startLoop(useThread);
+}
+
+int DatagramListener::socketFd() const noexcept
+{
+    return socketFd_;
+}
+
+void DatagramListener::handOff() noexcept
+{
+    loop_->handOff();
+}
+
+void DatagramListener::fail(std::string_view what)
+{
+    const auto error = std::strerror(errno);
+    closeSocket();
+    throw std::runtime_error(fmt::format("Cannot start datagram listener {}: {}: {}", id_, what, error));
+}
+
+void DatagramListener::startLoop(bool useThread)
+{
+    // The pool is allocated once, recvmmsg fills it in place
+    buffers_.resize(options_.batchSize * options_.maxDatagramSize);
+    iovecs_.resize(options_.batchSize);
+    headers_.resize(options_.batchSize);
+    for (std::size_t i = 0; i < options_.batchSize; ++i)
+    {
+        iovecs_[i].iov_base = buffers_.data() + i * options_.maxDatagramSize;
+        iovecs_[i].iov_len = options_.maxDatagramSize;
+    }
+
+    loop_->start([this]() { run(); }, useThread);
+}
+
+void DatagramListener::stop()
+{
+    loop_->stop();
+}
+
+bool DatagramListener::isRunning() const noexcept
+{
+    return loop_->isRunning();
+}
+
+void DatagramListener::run()
+{
+    pollfd fds[2] {{socketFd_, POLLIN, 0}, {loop_->wakeFd(), POLLIN, 0}};
+
+    while (true)
+    {
+        if (::poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            LOG_ERROR("Datagram listener {} poll failed: {}", id_, std::strerror(errno));
+            break;
+        }
+
+        if (fds[1].revents != 0)
+        {
+            // Senders get EPIPE from now on, the datagrams queued before are still handed over. A handed over
+            // socket is shared with the new process, which keeps receiving its queue.
+            if (!loop_->handedOff())
+            {
+                ::shutdown(socketFd_, SHUT_RD);
+                drain();
+            }
+            break;
+        }
+
+        if (fds[0].revents != 0)
+        {
+            drain();
+        }
+    }
+
+    closeSocket();
+    loop_->finish();
+}
+
+void DatagramListener::drain()
+{
+    while (true)
+    {
+        // recvmmsg writes the lengths and flags back, the rest is reset for each batch
+        for (std::size_t i = 0; i < headers_.size(); ++i)
+        {
+            headers_[i].msg_hdr = msghdr {};
+            headers_[i].msg_hdr.msg_iov = &iovecs_[i];
+            headers_[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        const auto count = ::recvmmsg(socketFd_, headers_.data(), static_cast<unsigned>(headers_.size()), 0, nullptr);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                LOG_WARNING("Datagram listener {} receive failed: {}", id_, std::strerror(errno));
+            }
+            return;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            const auto& header = headers_[i];
+
+            if ((header.msg_hdr.msg_flags & MSG_TRUNC) != 0)
+            {
+                LOG_DEBUG("Datagram listener {} dropped a datagram over {} bytes", id_, options_.maxDatagramSize);
+                continue;
+            }
+
+            if (header.msg_len == 0)
+            {
+                continue;
+            }
+
+            try
+            {
+                handler_(std::string_view {static_cast<const char*>(iovecs_[i].iov_base), header.msg_len});
+            }
+            catch (const std::exception& e)
+            {
+                LOG_ERROR("Datagram listener {} handler exception: {}", id_, e.what());
+            }
+        }
+
+        // A short batch means the socket is drained
+        if (static_cast<std::size_t>(count) < headers_.size())
+        {
+            return;
+        }
+    }
+}
+
+void DatagramListener::closeSocket()
+{
+    if (socketFd_ >= 0)
+    {
+        ::close(socketFd_);
+        socketFd_ = -1;
+    }
+
+    loop_->releaseSocketFile();
+}
+
+} // namespace httpserver
@@ -0,0 +1,758 @@
+#include "eventListener.hpp"
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <base/logger.hpp>
+
+#include "socketLoop.hpp"
+#include "uring.hpp"
+
+namespace httpserver
+{
+
+namespace
+{
+
+constexpr std::size_t READ_CHUNK {16 * 1024}; ///< Least free space of a connection buffer for a read
+constexpr int MAX_EVENTS {256};
+constexpr std::size_t LENGTH_PREFIX_SIZE {4};
+
+constexpr unsigned URING_ENTRIES {256};
+constexpr unsigned URING_BUFFERS {1024};
+constexpr std::size_t URING_BUFFER_SIZE {16 * 1024};
+
+// io_uring completions of the listening socket and of stop, the ones of the connections carry their descriptor
+constexpr uint64_t URING_ACCEPT {uint64_t {1} << 62};
+constexpr uint64_t URING_WAKE {uint64_t {2} << 62};
+constexpr uint64_t URING_CANCEL {uint64_t {3} << 62};
+
+uint32_t readLength(const char* data)
+{
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    return (uint32_t {bytes[0]} << 24) | (uint32_t {bytes[1]} << 16) | (uint32_t {bytes[2]} << 8)
+           | uint32_t {bytes[3]};
+}
+
+} // namespace
+
+EventListener::EventListener(std::string id, Handler handler, EventListenerOptions options)
+    : id_{std::move(id)}
+    , handler_{std::move(handler)}
+    , options_{options}
+    , listenFd_{-1}
+    , epollFd_{-1}
+    , reserveFd_{-1}
+    , backend_{Backend::EPOLL}
+{
+    if (!handler_)
+    {
+        throw std::invalid_argument(fmt::format("Event listener {} needs a handler", id_));
+    }
+
+    loop_ = std::make_unique<internal::SocketLoop>(fmt::format("Event listener {}", id_));
+
+    reserveFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+    if (reserveFd_ < 0)
+    {
+        throw std::runtime_error(
+            fmt::format("Event listener {} cannot open its spare descriptor: {}", id_, std::strerror(errno)));
+    }
+}
+
+EventListener::~EventListener()
+{
+    stop();
+    ::close(reserveFd_);
+}
+
+void EventListener::start(const std::filesystem::path& socketPath, bool useThread)
+{
+    if (socketPath.empty())
+    {
+        throw std::runtime_error(fmt::format("Cannot start event listener {}: empty socket path!", id_));
+    }
+
+    if (loop_->isStarted())
+    {
+        throw std::runtime_error(fmt::format("Cannot start event listener {}: already running!", id_));
+    }
+
+    if (!std::filesystem::exists(socketPath.parent_path()))
+    {
+        throw std::runtime_error(
+            fmt::format(
+                "Cannot start event listener {}: parent directory {} does not exist!",
+                id_,
+                socketPath.parent_path().string()
+            )
+        );
+    }
+
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    if (socketPath.string().size() >= sizeof(addr.sun_path))
+    {
+        throw std::runtime_error(
+            fmt::format("Cannot start event listener {}: socket path {} is too long!", id_, socketPath.string()));
+    }
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (std::filesystem::exists(socketPath))
+    {
+        std::filesystem::remove(socketPath);
+        LOG_TRACE("Event listener {} removed existing socket file {}", id_, socketPath.string());
+    }
+
+    // Non-blocking for both backends, the socket may be handed over to a process running the other one
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0)
+    {
+        fail("socket");
+    }
+
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+        fail("bind");
+    }
+    loop_->own(socketPath);
+
+    if (::listen(listenFd_, SOMAXCONN) < 0)
+    {
+        fail("listen");
+    }
+
+    startLoop(useThread);
+}
+
+void EventListener::start(int listenFd, bool useThread)
+{
+    if (loop_->isStarted())
+    {
+        ::close(listenFd);
+        throw std::runtime_error(fmt::format("Cannot start event listener {}: already running!", id_));
+    }
+
+    sockaddr_un addr {};
+    socklen_t size = sizeof(addr);
+    int accepting {0};
+    socklen_t acceptingSize = sizeof(accepting);
+    if (::getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &size) < 0 || addr.sun_family != AF_UNIX
+        || ::getsockopt(listenFd, SOL_SOCKET, SO_ACCEPTCONN, &accepting, &acceptingSize) < 0 || accepting == 0)
+    {
+        ::close(listenFd);
+        throw std::runtime_error(
+            fmt::format("Cannot start event listener {}: descriptor {} is not a listening Unix socket!", id_, listenFd));
+    }
+
+    listenFd_ = listenFd;
+    loop_->inherit(addr.sun_path);
+
+    const auto flags = ::fcntl(listenFd_, F_GETFL);
+    if (flags < 0 || ::fcntl(listenFd_, F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        fail("fcntl");
+    }
+
+    startLoop(useThread);
+}
+
+int EventListener::socketFd() const noexcept
+{
+    return listenFd_;
+}
+
+void EventListener::handOff() noexcept
+{
+    loop_->handOff();
+}
+
+void EventListener::fail(std::string_view what)
+{
+    const auto error = std::strerror(errno);
+    closeAll();
+    throw std::runtime_error(fmt::format("Cannot start event listener {}: {}: {}", id_, what, error));
+}
+
+void EventListener::startLoop(bool useThread)
+{
+    backend_ = Backend::EPOLL;
+    if (options_.backend == Backend::IO_URING)
+    {
+        auto uring = internal::Uring::create(URING_ENTRIES, URING_BUFFERS, URING_BUFFER_SIZE);
+        if (base::isError(uring))
+        {
+            LOG_WARNING("Event listener {} falling back to epoll, io_uring unavailable: {}",
+                        id_,
+                        base::getError(uring).message);
+        }
+        else
+        {
+            uring_ = std::move(std::get<std::unique_ptr<internal::Uring>>(uring));
+            backend_ = Backend::IO_URING;
+        }
+    }
+
+    if (backend_ == Backend::IO_URING)
+    {
+        if (!uring_->acceptMultishot(listenFd_, URING_ACCEPT) || !uring_->pollIn(loop_->wakeFd(), URING_WAKE))
+        {
+            fail("io_uring submission queue full");
+        }
+    }
+    else
+    {
+        epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd_ < 0)
+        {
+            fail("epoll_create1");
+        }
+
+        epoll_event event {};
+        // Level triggered, a connection left pending by a failed accept is signaled again
+        event.events = EPOLLIN;
+        event.data.fd = listenFd_;
+        if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &event) < 0)
+        {
+            fail("epoll_ctl");
+        }
+
+        event.events = EPOLLIN;
+        event.data.fd = loop_->wakeFd();
+        if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, loop_->wakeFd(), &event) < 0)
+        {
+            fail("epoll_ctl");
+        }
+    }
+
+    loop_->start([this]() { run(); }, useThread, backend_ == Backend::IO_URING ? " (io_uring)" : " (epoll)");
+}
+
+void EventListener::stop()
+{
+    loop_->stop();
+}
+
+bool EventListener::isRunning() const noexcept
+{
+    return loop_->isRunning();
+}
+
+Backend EventListener::backend() const noexcept
+{
+    return backend_;
+}
+
+void EventListener::run()
+{
+    if (backend_ == Backend::IO_URING)
+    {
+        runUring();
+    }
+    else
+    {
+        runEpoll();
+    }
+
+    closeAll();
+    loop_->finish();
+}
+
+void EventListener::runEpoll()
+{
+    epoll_event events[MAX_EVENTS];
+    bool stopping {false};
+
+    while (!stopping)
+    {
+        const auto count = ::epoll_wait(epollFd_, events, MAX_EVENTS, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            LOG_ERROR("Event listener {} epoll_wait failed: {}", id_, std::strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            const auto fd = events[i].data.fd;
+
+            if (fd == loop_->wakeFd())
+            {
+                stopping = true;
+            }
+            else if (fd == listenFd_)
+            {
+                accept();
+            }
+            else if (auto it = connections_.find(fd); it != connections_.end())
+            {
+                // Hang ups are read too, to hand over what was sent before closing
+                if (!read(fd, it->second))
+                {
+                    close(fd);
+                }
+            }
+        }
+    }
+
+    if (!stopping)
+    {
+        return;
+    }
+
+    // Drain: no new connections, the queued ones are taken too unless the socket was handed over, then every
+    // connection is read up to what its peer sent before the shutdown of its receiving side, which makes further
+    // sends fail
+    if (!loop_->handedOff())
+    {
+        loop_->releaseSocketFile();
+        accept();
+    }
+    ::close(listenFd_);
+    listenFd_ = -1;
+
+    const auto drained = connections_.size();
+    for (auto& [fd, connection] : connections_)
+    {
+        ::shutdown(fd, SHUT_RD);
+        read(fd, connection);
+    }
+
+    if (drained != 0)
+    {
+        LOG_DEBUG("Event listener {} drained {} connections", id_, drained);
+    }
+}
+
+void EventListener::runUring()
+{
+    bool stopping {false};
+
+    auto onAccept = [this, &stopping](int32_t res, uint32_t flags)
+    {
+        if (res >= 0)
+        {
+            connections_[res];
+            if (!uring_->recvMultishot(res, static_cast<uint64_t>(res)))
+            {
+                LOG_WARNING("Event listener {} cannot receive on a connection: submission queue full", id_);
+                close(res);
+            }
+            else if (stopping)
+            {
+                // Queued before the drain, received up to what was sent so far like the others
+                ::shutdown(res, SHUT_RD);
+            }
+        }
+        else if ((res == -EMFILE || res == -ENFILE) && shed())
+        {
+            LOG_WARNING("Event listener {} is out of file descriptors, dropped a connection", id_);
+        }
+        else if (res != -ECANCELED)
+        {
+            LOG_WARNING("Event listener {} cannot accept a connection: {}", id_, std::strerror(-res));
+        }
+
+        // The kernel ends a multishot request on errors, queue it again
+        if ((flags & IORING_CQE_F_MORE) == 0 && !stopping)
+        {
+            uring_->acceptMultishot(listenFd_, URING_ACCEPT);
+        }
+    };
+
+    auto onReceive = [this](int fd, int32_t res, uint32_t flags)
+    {
+        const auto more = (flags & IORING_CQE_F_MORE) != 0;
+        auto it = connections_.find(fd);
+        if (it == connections_.end())
+        {
+            uring_->recycle(flags);
+            return;
+        }
+
+        auto& connection = it->second;
+        bool keep {true};
+
+        if (connection.closing)
+        {
+            keep = false;
+        }
+        else if (res > 0)
+        {
+            keep = receive(fd, connection, uring_->buffer(res, flags));
+        }
+        else if (res == 0)
+        {
+            keep = false;
+        }
+        else if (res != -ENOBUFS)
+        {
+            // Out of provided buffers only stops the request, it is queued again below once they are recycled
+            LOG_DEBUG("Event listener {} connection receive failed: {}", id_, std::strerror(-res));
+            keep = false;
+        }
+
+        // Handed over, the buffer goes back to the kernel right away
+        uring_->recycle(flags);
+
+        if (keep)
+        {
+            if (!more && !uring_->recvMultishot(fd, static_cast<uint64_t>(fd)))
+            {
+                LOG_WARNING("Event listener {} cannot receive on a connection: submission queue full", id_);
+                close(fd);
+            }
+        }
+        else if (more)
+        {
+            // The pending receive holds the socket open, shutting it down ends the receive
+            connection.closing = true;
+            ::shutdown(fd, SHUT_RDWR);
+        }
+        else
+        {
+            close(fd);
+        }
+    };
+
+    // Drain: once stopping, the loop runs until the receives of the connections end
+    while (!stopping || !connections_.empty())
+    {
+        const auto error = uring_->submitAndWait();
+        if (error == -EINTR)
+        {
+            continue;
+        }
+        if (error < 0)
+        {
+            LOG_ERROR("Event listener {} io_uring_enter failed: {}", id_, std::strerror(-error));
+            break;
+        }
+
+        uring_->forEachCompletion(
+            [&](uint64_t userData, int32_t res, uint32_t flags)
+            {
+                if (userData == URING_WAKE)
+                {
+                    // No new connections, and peers cannot send past what they already did. A handed over socket
+                    // keeps its queued connections for the process it was handed to.
+                    stopping = true;
+                    if (loop_->handedOff())
+                    {
+                        uring_->cancel(URING_ACCEPT, URING_CANCEL);
+                    }
+                    loop_->releaseSocketFile();
+                    for (const auto& [fd, connection] : connections_)
+                    {
+                        ::shutdown(fd, SHUT_RD);
+                    }
+                }
+                else if (userData == URING_CANCEL)
+                {
+                }
+                else if (userData == URING_ACCEPT)
+                {
+                    onAccept(res, flags);
+                }
+                else
+                {
+                    onReceive(static_cast<int>(userData), res, flags);
+                }
+            });
+    }
+}
+
+void EventListener::accept()
+{
+    // Accept until there are no more pending connections
+    while (true)
+    {
+        const auto fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+
+            if ((errno == EMFILE || errno == ENFILE) && shed())
+            {
+                LOG_WARNING("Event listener {} is out of file descriptors, dropped a connection", id_);
+                continue;
+            }
+
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                LOG_WARNING("Event listener {} cannot accept a connection: {}", id_, std::strerror(errno));
+            }
+            return;
+        }
+
+        epoll_event event {};
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        event.data.fd = fd;
+        if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0)
+        {
+            LOG_WARNING("Event listener {} cannot watch a connection: {}", id_, std::strerror(errno));
+            ::close(fd);
+            continue;
+        }
+
+        connections_[fd];
+    }
+}
+
+bool EventListener::shed()
+{
+    if (reserveFd_ >= 0)
+    {
+        ::close(reserveFd_);
+    }
+
+    const auto fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+
+    reserveFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    return fd >= 0;
+}
+
+bool EventListener::read(int fd, Connection& connection)
+{
+    // Edge triggered, read until the socket is drained
+    while (true)
+    {
+        if (connection.buffer.size() - connection.size < READ_CHUNK)
+        {
+            connection.buffer.resize(std::max(connection.buffer.size() * 2, connection.size + READ_CHUNK));
+        }
+
+        const auto n =
+            ::read(fd, connection.buffer.data() + connection.size, connection.buffer.size() - connection.size);
+
+        if (n > 0)
+        {
+            connection.size += static_cast<std::size_t>(n);
+            if (!dispatchBuffered(fd, connection))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        if (n == 0)
+        {
+            if (connection.size != 0)
+            {
+                LOG_DEBUG("Event listener {} connection closed with {} bytes of an incomplete message",
+                          id_,
+                          connection.size);
+            }
+            return false;
+        }
+
+        if (errno == EINTR)
+        {
+            continue;
+        }
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return true;
+        }
+
+        LOG_DEBUG("Event listener {} connection read failed: {}", id_, std::strerror(errno));
+        return false;
+    }
+}
+
+bool EventListener::receive(int fd, Connection& connection, std::string_view data)
+{
+    auto append = [&connection](std::string_view bytes)
+    {
+        if (connection.buffer.size() - connection.size < bytes.size())
+        {
+            connection.buffer.resize(std::max(connection.buffer.size() * 2, connection.size + bytes.size()));
+        }
+        std::memcpy(connection.buffer.data() + connection.size, bytes.data(), bytes.size());
+        connection.size += bytes.size();
+    };
+
+    if (connection.size != 0)
+    {
+        append(data);
+        return dispatchBuffered(fd, connection);
+    }
+
+    // Nothing pending, the messages are handed over straight from the received data
+    const auto consumed = dispatch(fd, data.data(), data.size(), 0);
+    if (!consumed)
+    {
+        return false;
+    }
+
+    append(data.substr(consumed.value()));
+    connection.scanned = connection.size;
+
+    return true;
+}
+
+bool EventListener::dispatchBuffered(int fd, Connection& connection)
+{
+    const auto consumed = dispatch(fd, connection.buffer.data(), connection.size, connection.scanned);
+    if (!consumed)
+    {
+        return false;
+    }
+
+    if (consumed.value() != 0)
+    {
+        std::memmove(
+            connection.buffer.data(), connection.buffer.data() + consumed.value(), connection.size - consumed.value());
+        connection.size -= consumed.value();
+    }
+
+    // Whatever is left has no newline
+    connection.scanned = connection.size;
+
+    return true;
+}
+
+std::optional<std::size_t>
+EventListener::dispatch(int fd, const char* data, std::size_t size, std::size_t scanned)
+{
+    std::size_t offset {0};
+
+    auto handle = [this](std::string_view message)
+    {
+        try
+        {
+            handler_(message);
+        }
+        catch (const std::exception& e)
+        {
+            LOG_ERROR("Event listener {} handler exception: {}", id_, e.what());
+        }
+    };
+
+    auto oversized = [this, fd](std::size_t length)
+    {
+        LOG_WARNING("Event listener {} closing connection {}: message of {} bytes over {}",
+                    id_,
+                    fd,
+                    length,
+                    options_.maxFrameSize);
+        return std::nullopt;
+    };
+
+    if (options_.framing == Framing::NEWLINE)
+    {
+        auto scanFrom = scanned;
+
+        while (true)
+        {
+            const auto* end = static_cast<const char*>(std::memchr(data + scanFrom, '\n', size - scanFrom));
+            if (end == nullptr)
+            {
+                break;
+            }
+
+            auto length = static_cast<std::size_t>(end - (data + offset));
+            if (length > options_.maxFrameSize)
+            {
+                return oversized(length);
+            }
+
+            if (length != 0 && data[offset + length - 1] == '\r')
+            {
+                --length;
+            }
+
+            if (length != 0)
+            {
+                handle(std::string_view {data + offset, length});
+            }
+
+            offset = static_cast<std::size_t>(end - data) + 1;
+            scanFrom = offset;
+        }
+
+        if (size - offset > options_.maxFrameSize)
+        {
+            return oversized(size - offset);
+        }
+    }
+    else
+    {
+        while (size - offset >= LENGTH_PREFIX_SIZE)
+        {
+            const auto length = readLength(data + offset);
+            if (length > options_.maxFrameSize)
+            {
+                return oversized(length);
+            }
+
+            if (size - offset - LENGTH_PREFIX_SIZE < length)
+            {
+                break;
+            }
+
+            handle(std::string_view {data + offset + LENGTH_PREFIX_SIZE, length});
+            offset += LENGTH_PREFIX_SIZE + length;
+        }
+    }
+
+    return offset;
+}
+
+void EventListener::close(int fd)
+{
+    // Closing the descriptor removes it from the epoll set
+    ::close(fd);
+    connections_.erase(fd);
+}
+
+void EventListener::closeAll()
+{
+    // Closing the ring first cancels the requests holding the sockets
+    uring_.reset();
+
+    for (const auto& [fd, connection] : connections_)
+    {
+        ::close(fd);
+    }
+    connections_.clear();
+
+    if (epollFd_ >= 0)
+    {
+        ::close(epollFd_);
+        epollFd_ = -1;
+    }
+
+    if (listenFd_ >= 0)
+    {
+        ::close(listenFd_);
+        listenFd_ = -1;
+    }
+
+    loop_->releaseSocketFile();
+}
+
+} // namespace httpserver
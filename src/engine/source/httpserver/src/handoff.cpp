@@ -0,0 +1,453 @@
+#include "handoff.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include <base/logger.hpp>
+
+#include "socketLoop.hpp"
+
+namespace httpserver::handoff
+{
+
+namespace
+{
+
+constexpr std::size_t MAX_SOCKETS {16};
+constexpr char SOCKETS_MESSAGE {'S'};
+constexpr char READY_MESSAGE {'R'};
+constexpr int READY_TIMEOUT_MS {30 * 1000}; ///< Longest start of the new process, past it the handoff is abandoned
+
+/**
+ * @brief Whether the peer of the connection runs as the same user as this process.
+ */
+bool sameUser(int fd, pid_t* pid = nullptr)
+{
+    ucred cred {};
+    socklen_t size = sizeof(cred);
+    if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &size) < 0)
+    {
+        return false;
+    }
+
+    if (pid != nullptr)
+    {
+        *pid = cred.pid;
+    }
+
+    return cred.uid == ::geteuid();
+}
+
+/**
+ * @brief Path a Unix socket is bound to, empty if it is not bound to one.
+ */
+std::string boundPath(int fd)
+{
+    sockaddr_un addr {};
+    socklen_t size = sizeof(addr);
+    if (::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &size) < 0 || addr.sun_family != AF_UNIX
+        || size <= offsetof(sockaddr_un, sun_path) || addr.sun_path[0] == '\0')
+    {
+        return {};
+    }
+
+    return std::string {addr.sun_path, ::strnlen(addr.sun_path, sizeof(addr.sun_path))};
+}
+
+} // namespace
+
+Inherited::Inherited()
+    : connectionFd_{-1}
+{
+}
+
+Inherited::~Inherited()
+{
+    for (const auto& [path, fd] : sockets_)
+    {
+        ::close(fd);
+    }
+
+    if (connectionFd_ >= 0)
+    {
+        ::close(connectionFd_);
+    }
+}
+
+Inherited::Inherited(Inherited&& other) noexcept
+    : connectionFd_{other.connectionFd_}
+    , sockets_{std::move(other.sockets_)}
+{
+    other.connectionFd_ = -1;
+    other.sockets_.clear();
+}
+
+Inherited& Inherited::operator=(Inherited&& other) noexcept
+{
+    if (this != &other)
+    {
+        Inherited released {std::move(*this)};
+
+        connectionFd_ = other.connectionFd_;
+        sockets_ = std::move(other.sockets_);
+
+        other.connectionFd_ = -1;
+        other.sockets_.clear();
+    }
+
+    return *this;
+}
+
+int Inherited::take(const std::filesystem::path& path, int type)
+{
+    auto it = sockets_.find(path.string());
+    if (it == sockets_.end())
+    {
+        return -1;
+    }
+
+    int socketType {0};
+    socklen_t size = sizeof(socketType);
+    if (::getsockopt(it->second, SOL_SOCKET, SO_TYPE, &socketType, &size) < 0 || socketType != type)
+    {
+        return -1;
+    }
+
+    const auto fd = it->second;
+    sockets_.erase(it);
+
+    return fd;
+}
+
+void Inherited::ready()
+{
+    if (connectionFd_ < 0)
+    {
+        return;
+    }
+
+    if (::send(connectionFd_, &READY_MESSAGE, 1, MSG_NOSIGNAL) != 1)
+    {
+        LOG_WARNING("Handoff ready message not sent, the previous process keeps serving: {}", std::strerror(errno));
+    }
+
+    ::close(connectionFd_);
+    connectionFd_ = -1;
+}
+
+base::RespOrError<Inherited> request(const std::filesystem::path& path, std::chrono::milliseconds timeout)
+{
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    if (path.string().size() >= sizeof(addr.sun_path))
+    {
+        return base::Error {fmt::format("Handoff socket path {} is too long", path.string())};
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    Inherited inherited;
+
+    inherited.connectionFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (inherited.connectionFd_ < 0)
+    {
+        return base::Error {fmt::format("Handoff socket failed: {}", std::strerror(errno))};
+    }
+    const auto fd = inherited.connectionFd_;
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+        return base::Error {fmt::format("No process to take over at {}: {}", path.string(), std::strerror(errno))};
+    }
+
+    if (!sameUser(fd))
+    {
+        return base::Error {fmt::format("The process at {} runs as another user", path.string())};
+    }
+
+    pollfd pfd {fd, POLLIN, 0};
+    const auto ready = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
+    if (ready <= 0)
+    {
+        return base::Error {fmt::format("The process at {} did not answer in time", path.string())};
+    }
+
+    char message {0};
+    iovec iov {&message, 1};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_SOCKETS)] {};
+
+    msghdr header {};
+    header.msg_iov = &iov;
+    header.msg_iovlen = 1;
+    header.msg_control = control;
+    header.msg_controllen = sizeof(control);
+
+    const auto received = ::recvmsg(fd, &header, MSG_CMSG_CLOEXEC);
+
+    // Descriptors are installed even if the message is not the expected one, they must not leak
+    std::vector<int> fds;
+    for (auto* cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr; cmsg = CMSG_NXTHDR(&header, cmsg))
+    {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+        {
+            const auto count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const auto* data = reinterpret_cast<const int*>(CMSG_DATA(cmsg));
+            fds.insert(fds.end(), data, data + count);
+        }
+    }
+
+    if (received != 1 || message != SOCKETS_MESSAGE || (header.msg_flags & MSG_CTRUNC) != 0)
+    {
+        for (const auto socket : fds)
+        {
+            ::close(socket);
+        }
+        return base::Error {fmt::format("Invalid handoff message from the process at {}", path.string())};
+    }
+
+    for (const auto socket : fds)
+    {
+        auto bound = boundPath(socket);
+        if (bound.empty() || !inherited.sockets_.emplace(std::move(bound), socket).second)
+        {
+            ::close(socket);
+        }
+    }
+
+    return inherited;
+}
+
+Provider::Provider(std::string id, Sockets sockets, HandedOff handedOff)
+    : id_{std::move(id)}
+    , sockets_{std::move(sockets)}
+    , handedOff_{std::move(handedOff)}
+    , listenFd_{-1}
+{
+    if (!sockets_ || !handedOff_)
+    {
+        throw std::invalid_argument(fmt::format("Handoff provider {} needs its callbacks", id_));
+    }
+
+    loop_ = std::make_unique<internal::SocketLoop>(fmt::format("Handoff provider {}", id_));
+}
+
+Provider::~Provider()
+{
+    stop();
+}
+
+void Provider::start(const std::filesystem::path& socketPath)
+{
+    if (socketPath.empty())
+    {
+        throw std::runtime_error(fmt::format("Cannot start handoff provider {}: empty socket path!", id_));
+    }
+
+    if (loop_->isStarted())
+    {
+        throw std::runtime_error(fmt::format("Cannot start handoff provider {}: already running!", id_));
+    }
+
+    if (!std::filesystem::exists(socketPath.parent_path()))
+    {
+        throw std::runtime_error(
+            fmt::format(
+                "Cannot start handoff provider {}: parent directory {} does not exist!",
+                id_,
+                socketPath.parent_path().string()
+            )
+        );
+    }
+
+    const auto tmpPath = socketPath.string() + fmt::format(".{}.tmp", ::getpid());
+
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    if (tmpPath.size() >= sizeof(addr.sun_path))
+    {
+        throw std::runtime_error(fmt::format(
+            "Cannot start handoff provider {}: socket path {} is too long!", id_, socketPath.string()));
+    }
+    std::strncpy(addr.sun_path, tmpPath.c_str(), sizeof(addr.sun_path) - 1);
+
+    std::error_code ec;
+    std::filesystem::remove(tmpPath, ec);
+
+    auto fail = [this, &tmpPath](std::string_view what)
+    {
+        const auto error = std::strerror(errno);
+        if (listenFd_ >= 0)
+        {
+            ::close(listenFd_);
+            listenFd_ = -1;
+        }
+        std::error_code ec;
+        std::filesystem::remove(tmpPath, ec);
+        throw std::runtime_error(fmt::format("Cannot start handoff provider {}: {}: {}", id_, what, error));
+    };
+
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0)
+    {
+        fail("socket");
+    }
+
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+        fail("bind");
+    }
+
+    // Whoever connects gets the listening sockets
+    if (::chmod(tmpPath.c_str(), S_IRUSR | S_IWUSR) < 0)
+    {
+        fail("chmod");
+    }
+
+    if (::listen(listenFd_, 1) < 0)
+    {
+        fail("listen");
+    }
+
+    if (::rename(tmpPath.c_str(), socketPath.c_str()) < 0)
+    {
+        fail("rename");
+    }
+    loop_->own(socketPath);
+
+    loop_->start([this]() { run(); }, true);
+}
+
+void Provider::stop()
+{
+    loop_->stop();
+}
+
+bool Provider::isRunning() const noexcept
+{
+    return loop_->isRunning();
+}
+
+void Provider::run()
+{
+    pollfd fds[2] {{listenFd_, POLLIN, 0}, {loop_->wakeFd(), POLLIN, 0}};
+    bool handedOff {false};
+
+    while (!handedOff)
+    {
+        if (::poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            LOG_ERROR("Handoff provider {} poll failed: {}", id_, std::strerror(errno));
+            break;
+        }
+
+        if (fds[1].revents != 0)
+        {
+            break;
+        }
+
+        const auto fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            continue;
+        }
+
+        handedOff = handOff(fd);
+        ::close(fd);
+    }
+
+    ::close(listenFd_);
+    listenFd_ = -1;
+
+    // After a handoff the path is the socket of the new process
+    if (handedOff)
+    {
+        loop_->handOff();
+    }
+    loop_->releaseSocketFile();
+    loop_->finish();
+
+    if (handedOff)
+    {
+        handedOff_();
+    }
+}
+
+bool Provider::handOff(int fd)
+{
+    pid_t pid {0};
+    if (!sameUser(fd, &pid))
+    {
+        LOG_WARNING("Handoff provider {} refused process {} of another user", id_, pid);
+        return false;
+    }
+
+    const auto sockets = sockets_();
+    if (sockets.size() > MAX_SOCKETS)
+    {
+        LOG_ERROR("Handoff provider {} cannot hand over {} sockets, at most {}", id_, sockets.size(), MAX_SOCKETS);
+        return false;
+    }
+
+    char message {SOCKETS_MESSAGE};
+    iovec iov {&message, 1};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_SOCKETS)] {};
+
+    msghdr header {};
+    header.msg_iov = &iov;
+    header.msg_iovlen = 1;
+
+    if (!sockets.empty())
+    {
+        header.msg_control = control;
+        header.msg_controllen = CMSG_SPACE(sizeof(int) * sockets.size());
+
+        auto* cmsg = CMSG_FIRSTHDR(&header);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int) * sockets.size());
+        std::memcpy(CMSG_DATA(cmsg), sockets.data(), sizeof(int) * sockets.size());
+    }
+
+    if (::sendmsg(fd, &header, MSG_NOSIGNAL) != 1)
+    {
+        LOG_WARNING("Handoff provider {} cannot send the sockets to process {}: {}", id_, pid, std::strerror(errno));
+        return false;
+    }
+
+    LOG_INFO("Handoff provider {} sent {} sockets to process {}, waiting for it to be ready", id_, sockets.size(), pid);
+
+    // The wake descriptor is not read here, the loop sees it next
+    pollfd fds[2] {{fd, POLLIN, 0}, {loop_->wakeFd(), POLLIN, 0}};
+    while (::poll(fds, 2, READY_TIMEOUT_MS) < 0)
+    {
+        if (errno != EINTR)
+        {
+            return false;
+        }
+    }
+
+    char reply {0};
+    if (fds[1].revents != 0 || fds[0].revents == 0 || ::recv(fd, &reply, 1, 0) != 1 || reply != READY_MESSAGE)
+    {
+        LOG_WARNING("Handoff provider {}: process {} did not take over, still serving", id_, pid);
+        return false;
+    }
+
+    LOG_INFO("Handoff provider {}: process {} took over", id_, pid);
+    return true;
+}
+
+} // namespace httpserver::handoff
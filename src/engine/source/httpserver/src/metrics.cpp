@@ -0,0 +1,262 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <string_view>
+
+#include <fmt/format.h>
+
+namespace httpserver
+{
+
+namespace
+{
+
+constexpr std::size_t SUB_BITS = 5;
+constexpr std::uint64_t SUB_COUNT = 1 << SUB_BITS;   ///< Exact buckets, one per microsecond
+constexpr std::uint64_t HALF_COUNT = SUB_COUNT / 2;  ///< Buckets per power of two past them
+constexpr std::uint64_t MAX_LATENCY = (1ULL << 36) - 1;
+
+static_assert(SUB_COUNT + (36 - SUB_BITS) * HALF_COUNT == RouteMetrics::LATENCY_BUCKETS);
+
+constexpr std::array<double, 4> QUANTILES {0.5, 0.9, 0.99, 0.999};
+
+/**
+ * @brief Shard of the calling thread, threads are spread over the shards in the order they first record.
+ */
+std::size_t threadShard() noexcept
+{
+    static std::atomic<std::size_t> next {0};
+    thread_local const std::size_t shard = next.fetch_add(1, std::memory_order_relaxed) % RouteMetrics::SHARDS;
+
+    return shard;
+}
+
+std::string escapeLabel(std::string_view value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+
+    for (const auto c : value)
+    {
+        switch (c)
+        {
+            case '\\': escaped += "\\\\"; break;
+            case '"': escaped += "\\\""; break;
+            case '\n': escaped += "\\n"; break;
+            default: escaped += c;
+        }
+    }
+
+    return escaped;
+}
+
+std::string labels(const RouteLabels& route)
+{
+    return fmt::format(R"(server="{}",method="{}",route="{}")",
+                       escapeLabel(route.server),
+                       escapeLabel(route.method),
+                       escapeLabel(route.route));
+}
+
+} // namespace
+
+std::uint64_t RouteMetrics::Snapshot::count() const noexcept
+{
+    std::uint64_t total {otherStatuses};
+    for (const auto& [status, requests] : statuses)
+    {
+        total += requests;
+    }
+
+    return total;
+}
+
+std::chrono::microseconds RouteMetrics::Snapshot::quantile(double q) const noexcept
+{
+    std::uint64_t total {0};
+    for (const auto requests : latency)
+    {
+        total += requests;
+    }
+
+    if (total == 0)
+    {
+        return std::chrono::microseconds {0};
+    }
+
+    const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(q * total)));
+
+    std::uint64_t seen {0};
+    for (std::size_t bucket = 0; bucket < latency.size(); ++bucket)
+    {
+        seen += latency[bucket];
+        if (seen >= rank)
+        {
+            return std::chrono::microseconds {latencyUpperBound(bucket)};
+        }
+    }
+
+    return std::chrono::microseconds {MAX_LATENCY};
+}
+
+RouteMetrics::RouteMetrics()
+    : shards_ {}
+{
+}
+
+void RouteMetrics::record(int status,
+                          std::size_t requestBytes,
+                          std::size_t responseBytes,
+                          std::chrono::microseconds latency) noexcept
+{
+    auto& shard = shards_[threadShard()];
+
+    // A slot is claimed for a status the first time it is seen, and kept. 0 marks a free slot
+    bool counted {false};
+    for (auto it = shard.statuses.begin(); status > 0 && !counted && it != shard.statuses.end(); ++it)
+    {
+        auto slotStatus = it->status.load(std::memory_order_relaxed);
+        if (slotStatus == 0 && it->status.compare_exchange_strong(slotStatus, status, std::memory_order_relaxed))
+        {
+            slotStatus = status;
+        }
+
+        if (slotStatus == status)
+        {
+            it->count.fetch_add(1, std::memory_order_relaxed);
+            counted = true;
+        }
+    }
+
+    if (!counted)
+    {
+        shard.otherStatuses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const auto micros = static_cast<std::uint64_t>(std::max<std::chrono::microseconds::rep>(0, latency.count()));
+
+    shard.requestBytes.fetch_add(requestBytes, std::memory_order_relaxed);
+    shard.responseBytes.fetch_add(responseBytes, std::memory_order_relaxed);
+    shard.latencySum.fetch_add(micros, std::memory_order_relaxed);
+    shard.latency[latencyBucket(micros)].fetch_add(1, std::memory_order_relaxed);
+}
+
+RouteMetrics::Snapshot RouteMetrics::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.latency.assign(LATENCY_BUCKETS, 0);
+
+    for (const auto& shard : shards_)
+    {
+        for (const auto& slot : shard.statuses)
+        {
+            const auto status = slot.status.load(std::memory_order_relaxed);
+            if (status != 0)
+            {
+                snapshot.statuses[status] += slot.count.load(std::memory_order_relaxed);
+            }
+        }
+
+        snapshot.otherStatuses += shard.otherStatuses.load(std::memory_order_relaxed);
+        snapshot.requestBytes += shard.requestBytes.load(std::memory_order_relaxed);
+        snapshot.responseBytes += shard.responseBytes.load(std::memory_order_relaxed);
+        snapshot.latencySum += shard.latencySum.load(std::memory_order_relaxed);
+
+        for (std::size_t bucket = 0; bucket < LATENCY_BUCKETS; ++bucket)
+        {
+            snapshot.latency[bucket] += shard.latency[bucket].load(std::memory_order_relaxed);
+        }
+    }
+
+    return snapshot;
+}
+
+std::size_t RouteMetrics::latencyBucket(std::uint64_t micros) noexcept
+{
+    micros = std::min(micros, MAX_LATENCY);
+
+    if (micros < SUB_COUNT)
+    {
+        return static_cast<std::size_t>(micros);
+    }
+
+    // Keep the SUB_BITS most significant bits, the highest of them is always set
+    const auto width = 64 - static_cast<std::size_t>(__builtin_clzll(micros));
+    const auto shift = width - SUB_BITS;
+    const auto top = micros >> shift;
+
+    return static_cast<std::size_t>(SUB_COUNT + (shift - 1) * HALF_COUNT + (top - HALF_COUNT));
+}
+
+std::uint64_t RouteMetrics::latencyUpperBound(std::size_t bucket) noexcept
+{
+    if (bucket < SUB_COUNT)
+    {
+        return bucket;
+    }
+
+    const auto shift = (bucket - SUB_COUNT) / HALF_COUNT + 1;
+    const auto top = (bucket - SUB_COUNT) % HALF_COUNT + HALF_COUNT;
+
+    return ((top + 1) << shift) - 1;
+}
+
+std::string toPrometheus(const RouteSnapshots& routes)
+{
+    std::string out;
+    auto it = std::back_inserter(out);
+
+    out += "# HELP httpserver_requests_total Requests served by the route, by response status.\n"
+           "# TYPE httpserver_requests_total counter\n";
+    for (const auto& [route, snapshot] : routes)
+    {
+        const auto routeLabels = labels(route);
+        for (const auto& [status, requests] : snapshot.statuses)
+        {
+            fmt::format_to(it, "httpserver_requests_total{{{},code=\"{}\"}} {}\n", routeLabels, status, requests);
+        }
+        if (snapshot.otherStatuses != 0)
+        {
+            fmt::format_to(
+                it, "httpserver_requests_total{{{},code=\"other\"}} {}\n", routeLabels, snapshot.otherStatuses);
+        }
+    }
+
+    out += "# HELP httpserver_request_body_bytes_total Bytes of the request bodies received by the route.\n"
+           "# TYPE httpserver_request_body_bytes_total counter\n";
+    for (const auto& [route, snapshot] : routes)
+    {
+        fmt::format_to(it, "httpserver_request_body_bytes_total{{{}}} {}\n", labels(route), snapshot.requestBytes);
+    }
+
+    out += "# HELP httpserver_response_body_bytes_total Bytes of the response bodies sent by the route, encoded.\n"
+           "# TYPE httpserver_response_body_bytes_total counter\n";
+    for (const auto& [route, snapshot] : routes)
+    {
+        fmt::format_to(it, "httpserver_response_body_bytes_total{{{}}} {}\n", labels(route), snapshot.responseBytes);
+    }
+
+    out += "# HELP httpserver_request_duration_seconds Time the route took to handle and encode a request.\n"
+           "# TYPE httpserver_request_duration_seconds summary\n";
+    for (const auto& [route, snapshot] : routes)
+    {
+        const auto routeLabels = labels(route);
+        for (const auto q : QUANTILES)
+        {
+            fmt::format_to(it,
+                           "httpserver_request_duration_seconds{{{},quantile=\"{}\"}} {}\n",
+                           routeLabels,
+                           q,
+                           snapshot.quantile(q).count() / 1e6);
+        }
+        fmt::format_to(
+            it, "httpserver_request_duration_seconds_sum{{{}}} {}\n", routeLabels, snapshot.latencySum / 1e6);
+        fmt::format_to(it, "httpserver_request_duration_seconds_count{{{}}} {}\n", routeLabels, snapshot.count());
+    }
+
+    return out;
+}
+
+} // namespace httpserver
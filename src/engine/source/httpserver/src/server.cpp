@@ -1,19 +1,124 @@
 #include "server.hpp"
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include <base/json.hpp>
 #include <base/logger.hpp>
 
+#include "compression.hpp"
+#include "taskQueue.hpp"
+
 namespace httpserver
 {
 
 namespace
 {
 
+/**
+ * @brief Whether the route is a plain path, matched by equality.
+ */
+bool isExactRoute(const std::string& route)
+{
+    return route.find_first_of(".[](){}*+?^$|\\") == std::string::npos;
+}
+
+/**
+ * @brief Whether httplib has a body to read for the request before routing it.
+ */
+bool hasBody(const httplib::Request& req)
+{
+    if (req.has_header("Transfer-Encoding"))
+    {
+        return true;
+    }
+
+    const auto& length = req.get_header_value("Content-Length");
+    return !length.empty() && length.find_first_not_of('0') != std::string::npos;
+}
+
+httplib::ContentReader emptyContentReader()
+{
+    return httplib::ContentReader([](httplib::ContentReceiver) { return true; },
+                                  [](httplib::MultipartContentHeader, httplib::ContentReceiver) { return true; });
+}
+
 } // namespace
 
-Server::Server(std::string id)
+Server::Server(std::string id, ServerOptions options)
     : server_{std::make_shared<httplib::Server>()}
     , id_{std::move(id)}
+    , options_{options}
 {
+    server_->set_keep_alive_max_count(options_.keepAliveMaxCount);
+    server_->set_keep_alive_timeout(options_.keepAliveTimeout.count());
+    server_->set_read_timeout(options_.readTimeout);
+    server_->set_write_timeout(options_.writeTimeout);
+    server_->set_payload_max_length(options_.payloadMaxSize);
+
+    server_->new_task_queue = [threads = options_.threads, queueSize = options_.queueSize]()
+    {
+        return new BoundedTaskQueue(threads, queueSize);
+    };
+
+    server_->set_pre_routing_handler(
+        [this](const httplib::Request& req, httplib::Response& res)
+        {
+            // Connections accepted past the queue bound are served by the rejection thread of the queue, only to be
+            // turned away
+            if (BoundedTaskQueue::isRejecting())
+            {
+                res.status = httplib::StatusCode::ServiceUnavailable_503;
+                res.set_header("Connection", "close");
+                res.set_content("Service Unavailable", "text/plain");
+
+                return httplib::Server::HandlerResponse::Handled;
+            }
+
+            // Turned away before the body is read, the connection is closed with it unread
+            if (payloadTooLarge(req))
+            {
+                res.status = httplib::StatusCode::PayloadTooLarge_413;
+                res.set_header("Connection", "close");
+
+                return httplib::Server::HandlerResponse::Handled;
+            }
+
+            // Without a body there is nothing for httplib to read, so exact routes are served here instead of through
+            // its regex routing
+            if (!hasBody(req))
+            {
+                if (const auto* routes = methodRoutes(req.method))
+                {
+                    if (auto it = routes->exact.find(req.path); it != routes->exact.end())
+                    {
+                        serveRoute(it->second, req, res);
+                        return httplib::Server::HandlerResponse::Handled;
+                    }
+                }
+            }
+
+            return httplib::Server::HandlerResponse::Unhandled;
+        }
+    );
+
+    // Requests with a body, and the ones of pattern routes, go through the route tables from one match-all route
+    // per method
+    server_->Get(".*", [this](const httplib::Request& req, httplib::Response& res)
+                 { dispatch(routes_[static_cast<std::size_t>(Method::GET)], req, res); });
+    server_->Post(".*", [this](const httplib::Request& req, httplib::Response& res)
+                  { dispatch(routes_[static_cast<std::size_t>(Method::POST)], req, res); });
+    server_->Put(".*", [this](const httplib::Request& req, httplib::Response& res)
+                 { dispatch(routes_[static_cast<std::size_t>(Method::PUT)], req, res); });
+    server_->Delete(".*", [this](const httplib::Request& req, httplib::Response& res)
+                    { dispatch(routes_[static_cast<std::size_t>(Method::DELETE)], req, res); });
+
     // Set the exception handler for the server
     auto exceptFnName = fmt::format("Server::Server({})::set_exception_handler", id);
     server_->set_exception_handler(
@@ -94,18 +199,33 @@ void Server::start(const std::filesystem::path& socketPath, bool useThread)
 
     server_->set_address_family(AF_UNIX);
 
-    if (std::filesystem::exists(socketPath.string()))
+    // Bound under a temporary name and renamed over the socket path, so a previous server there keeps answering
+    // until this one does
+    const auto tmpPath = socketPath.string() + fmt::format(".{}.tmp", getpid());
+    if (std::filesystem::exists(tmpPath))
+    {
+        std::filesystem::remove(tmpPath);
+    }
+
+    if (!server_->bind_to_port(tmpPath, 0))
     {
-        std::filesystem::remove(socketPath);
-        LOG_TRACE("Server {} removed existing socket file {}", id_, socketPath.string());
+        throw std::runtime_error(fmt::format("Cannot start server {}: cannot bind to {}!", id_, tmpPath));
+    }
+
+    if (std::rename(tmpPath.c_str(), socketPath.c_str()) != 0)
+    {
+        const auto error = std::strerror(errno);
+        std::filesystem::remove(tmpPath);
+        throw std::runtime_error(
+            fmt::format("Cannot start server {}: cannot move the socket to {}: {}", id_, socketPath.string(), error));
     }
 
     if (useThread)
     {
         thread_ = std::thread(
-            [server = server_, socketPath]()
+            [server = server_]()
             {
-                server->listen(socketPath, true);
+                server->listen_after_bind();
             }
         );
 
@@ -122,7 +242,7 @@ void Server::start(const std::filesystem::path& socketPath, bool useThread)
     else
     {
         LOG_INFO("Server {} started at {}", id_, socketPath.string());
-        server_->listen(socketPath, true);
+        server_->listen_after_bind();
     }
 }
 
@@ -145,23 +265,308 @@ void Server::stop()
 
 void Server::addRoute(Method method, const std::string& route, httplib::Server::Handler handler)
 {
-    switch (method)
+    if (method != Method::GET && method != Method::POST && method != Method::PUT && method != Method::DELETE)
     {
-        case Method::GET:       server_->Get(route, handler); break;
-        case Method::POST:      server_->Post(route, handler); break;
-        case Method::PUT:       server_->Put(route, handler); break;
-        case Method::DELETE:    server_->Delete(route, handler); break;
-        default:
+        throw std::runtime_error(
+            fmt::format(
+                "Server {} failed to add route {} : {}", id_, route, "Invalid Method"
+            )
+        );
+    }
+
+    auto& routes = routes_[static_cast<std::size_t>(method)];
+
+    auto& metrics = metrics_[{method, route}];
+    if (!metrics)
+    {
+        metrics = std::make_shared<RouteMetrics>();
+    }
+
+    if (isExactRoute(route))
+    {
+        routes.exact[route] = Route {std::move(handler), metrics};
+    }
+    else
+    {
+        std::regex pattern;
+        try
+        {
+            pattern = std::regex(route);
+        }
+        catch (const std::regex_error& e)
+        {
             throw std::runtime_error(
                 fmt::format(
-                    "Server {} failed to add route {} : {}", id_, route, "Invalid Method"
+                    "Server {} failed to add route {} : {}", id_, route, e.what()
                 )
             );
+        }
+
+        routes.patterns.emplace_back(std::move(pattern), Route {std::move(handler), metrics});
     }
 
     LOG_DEBUG("Server {} added route {} {}", id_, route, methodToStr(method));
 }
 
+void Server::addStreamingRoute(Method method,
+                               const std::string& route,
+                               httplib::Server::HandlerWithContentReader handler)
+{
+    if (method != Method::POST && method != Method::PUT && method != Method::DELETE)
+    {
+        throw std::runtime_error(
+            fmt::format("Server {} failed to add streaming route {} : {}", id_, route, "Method without a body"));
+    }
+
+    // httplib only hands requests with a body to content reader routes, the others reach the route tables
+    addRoute(method,
+             route,
+             [handler](const httplib::Request& req, httplib::Response& res) { handler(req, res, emptyContentReader()); });
+
+    auto& routes = routes_[static_cast<std::size_t>(method)];
+    if (isExactRoute(route))
+    {
+        routes.exact.at(route).streaming = true;
+    }
+    else
+    {
+        routes.patterns.back().second.streaming = true;
+    }
+
+    // The limit of httplib is the only one enforced on bodies it streams, the buffered routes are checked here
+    const auto streamingMaxSize = options_.streamingPayloadMaxSize == 0 ? std::numeric_limits<std::size_t>::max()
+                                                                        : options_.streamingPayloadMaxSize;
+    server_->set_payload_max_length(std::max(options_.payloadMaxSize, streamingMaxSize));
+
+    httplib::Server::HandlerWithContentReader streamed =
+        [this, handler = std::move(handler), metrics = metrics_.at({method, route})](
+            const httplib::Request& req, httplib::Response& res, const httplib::ContentReader& content)
+    {
+        serve(*metrics,
+              req,
+              res,
+              [&](std::size_t& received)
+              {
+                  auto count = [&received](httplib::ContentReceiver receiver)
+                  {
+                      return [&received, receiver = std::move(receiver)](const char* data, std::size_t size)
+                      {
+                          received += size;
+                          return receiver(data, size);
+                      };
+                  };
+
+                  const httplib::ContentReader counted(
+                      [&](httplib::ContentReceiver receiver) { return content(count(std::move(receiver))); },
+                      [&](httplib::MultipartContentHeader header, httplib::ContentReceiver receiver)
+                      { return content(std::move(header), count(std::move(receiver))); });
+
+                  handler(req, res, counted);
+              });
+    };
+
+    // Plain routes have no regex special characters, they match themselves
+    switch (method)
+    {
+        case Method::POST: server_->Post(route, std::move(streamed)); break;
+        case Method::PUT: server_->Put(route, std::move(streamed)); break;
+        default: server_->Delete(route, std::move(streamed)); break;
+    }
+}
+
+void Server::addMetricsRoute(const std::string& route)
+{
+    addRoute(Method::GET,
+             route,
+             [this](const httplib::Request&, httplib::Response& res)
+             { res.set_content(metrics(), "text/plain; version=0.0.4; charset=utf-8"); });
+}
+
+std::string Server::metrics() const
+{
+    RouteSnapshots snapshots;
+    snapshots.reserve(metrics_.size());
+
+    for (const auto& [route, metrics] : metrics_)
+    {
+        snapshots.emplace_back(RouteLabels {id_, methodToStr(route.first), route.second}, metrics->snapshot());
+    }
+
+    return toPrometheus(snapshots);
+}
+
+const Server::Route* Server::findRoute(const Routes& routes, const std::string& path)
+{
+    if (auto it = routes.exact.find(path); it != routes.exact.end())
+    {
+        return &it->second;
+    }
+
+    for (const auto& [pattern, route] : routes.patterns)
+    {
+        if (std::regex_match(path, pattern))
+        {
+            return &route;
+        }
+    }
+
+    return nullptr;
+}
+
+const Server::Routes* Server::methodRoutes(const std::string& method) const
+{
+    // httplib serves HEAD requests with the GET routes
+    if (method == "GET" || method == "HEAD")
+    {
+        return &routes_[static_cast<std::size_t>(Method::GET)];
+    }
+    if (method == "POST")
+    {
+        return &routes_[static_cast<std::size_t>(Method::POST)];
+    }
+    if (method == "PUT")
+    {
+        return &routes_[static_cast<std::size_t>(Method::PUT)];
+    }
+    if (method == "DELETE")
+    {
+        return &routes_[static_cast<std::size_t>(Method::DELETE)];
+    }
+
+    return nullptr;
+}
+
+bool Server::payloadTooLarge(const httplib::Request& req) const
+{
+    const auto& length = req.get_header_value("Content-Length");
+    if (length.empty())
+    {
+        return false;
+    }
+
+    const auto size = std::strtoull(length.c_str(), nullptr, 10);
+
+    // Within both limits, the route does not matter
+    const auto streamingMaxSize = options_.streamingPayloadMaxSize == 0 ? std::numeric_limits<std::size_t>::max()
+                                                                        : options_.streamingPayloadMaxSize;
+    if (size <= std::min(options_.payloadMaxSize, streamingMaxSize))
+    {
+        return false;
+    }
+
+    const auto* routes = methodRoutes(req.method);
+    const auto* route = routes == nullptr ? nullptr : findRoute(*routes, req.path);
+
+    return size > (route != nullptr && route->streaming ? streamingMaxSize : options_.payloadMaxSize);
+}
+
+void Server::dispatch(const Routes& routes, const httplib::Request& req, httplib::Response& res) const
+{
+    // Chunked bodies declare no length, they are only checked once buffered
+    if (req.body.size() > options_.payloadMaxSize)
+    {
+        res.status = httplib::StatusCode::PayloadTooLarge_413;
+        return;
+    }
+
+    const auto* route = findRoute(routes, req.path);
+    if (route == nullptr)
+    {
+        res.status = httplib::StatusCode::NotFound_404;
+        return;
+    }
+
+    serveRoute(*route, req, res);
+}
+
+void Server::serveRoute(const Route& route, const httplib::Request& req, httplib::Response& res) const
+{
+    serve(*route.metrics,
+          req,
+          res,
+          [&](std::size_t& received)
+          {
+              received = req.body.size();
+              route.handler(req, res);
+          });
+}
+
+template<typename Handle>
+void Server::serve(RouteMetrics& metrics, const httplib::Request& req, httplib::Response& res, Handle&& handle) const
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&start]()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    };
+
+    std::size_t received {0};
+
+    try
+    {
+        handle(received);
+        encode(req, res);
+    }
+    catch (...)
+    {
+        // Answered by the exception handler
+        metrics.record(httplib::StatusCode::InternalServerError_500, received, 0, elapsed());
+        throw;
+    }
+
+    // httplib sends 200 when the handler leaves the status unset
+    const auto status = res.status == -1 ? httplib::StatusCode::OK_200 : res.status;
+    metrics.record(status, received, res.body.size(), elapsed());
+}
+
+void Server::encode(const httplib::Request& req, httplib::Response& res) const
+{
+    // Streamed bodies are produced after the handler returns and are left alone
+    if (res.body.empty() || res.has_header("Content-Encoding"))
+    {
+        return;
+    }
+
+    const auto contentType = res.get_header_value("Content-Type");
+
+    if (req.has_param("pretty") && contentType.rfind("application/json", 0) == 0)
+    {
+        json::Json body {std::string_view {res.body}};
+        if (!base::isError(body.getParseError()))
+        {
+            res.body = body.toStrPretty();
+        }
+    }
+
+    if (!options_.compression || res.body.size() < options_.compressionMinSize)
+    {
+        return;
+    }
+
+    const auto encoding = negotiateEncoding(req.get_header_value("Accept-Encoding"));
+    if (encoding == Encoding::IDENTITY)
+    {
+        return;
+    }
+
+    auto compressed = compress(res.body, encoding);
+    if (base::isError(compressed))
+    {
+        LOG_WARNING("Server {} sending an uncompressed response: {}", id_, base::getError(compressed).message);
+        return;
+    }
+
+    res.set_header("Vary", "Accept-Encoding");
+
+    // Incompressible bodies are cheaper to send as they are
+    auto& body = base::getResponse(compressed);
+    if (body.size() < res.body.size())
+    {
+        res.body = std::move(body);
+        res.set_header("Content-Encoding", std::string {encodingName(encoding)});
+    }
+}
+
 bool Server::isRunning() const noexcept
 {
     return server_->is_running();
@@ -0,0 +1,143 @@
+#include "socketLoop.hpp"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <base/logger.hpp>
+
+namespace httpserver::internal
+{
+
+SocketLoop::SocketLoop(std::string name)
+    : name_{std::move(name)}
+    , wakeFd_{-1}
+    , handedOff_{false}
+    , running_{false}
+{
+    wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0)
+    {
+        throw std::runtime_error(fmt::format("{} cannot create its eventfd: {}", name_, std::strerror(errno)));
+    }
+}
+
+SocketLoop::~SocketLoop()
+{
+    stop();
+    ::close(wakeFd_);
+}
+
+int SocketLoop::wakeFd() const noexcept
+{
+    return wakeFd_;
+}
+
+void SocketLoop::own(const std::filesystem::path& path)
+{
+    socketPath_ = path;
+    handedOff_ = false;
+}
+
+void SocketLoop::inherit(const std::filesystem::path& path)
+{
+    socketPath_ = path;
+    handedOff_ = true;
+}
+
+void SocketLoop::handOff() noexcept
+{
+    handedOff_ = true;
+}
+
+bool SocketLoop::handedOff() const noexcept
+{
+    return handedOff_.load();
+}
+
+const std::filesystem::path& SocketLoop::socketPath() const noexcept
+{
+    return socketPath_;
+}
+
+void SocketLoop::releaseSocketFile()
+{
+    if (!socketPath_.empty() && !handedOff_)
+    {
+        std::error_code ec;
+        std::filesystem::remove(socketPath_, ec);
+    }
+    socketPath_.clear();
+}
+
+void SocketLoop::start(std::function<void()> run, bool useThread, std::string_view detail)
+{
+    uint64_t ignored;
+    while (::read(wakeFd_, &ignored, sizeof(ignored)) > 0)
+    {
+    }
+
+    // From here the socket file is the owner's, whether it created the socket or inherited it
+    handedOff_ = false;
+    running_ = true;
+
+    const auto path = socketPath_.string();
+
+    if (useThread)
+    {
+        thread_ = std::thread(std::move(run));
+
+        std::stringstream ss;
+        ss << thread_.get_id();
+
+        LOG_INFO("{} started{} in thread {} at {}", name_, detail, ss.str(), path);
+    }
+    else
+    {
+        LOG_INFO("{} started{} at {}", name_, detail, path);
+        run();
+    }
+}
+
+void SocketLoop::stop()
+{
+    if (!isStarted())
+    {
+        return;
+    }
+
+    const uint64_t one {1};
+    if (::write(wakeFd_, &one, sizeof(one)) < 0 && errno != EAGAIN)
+    {
+        LOG_ERROR("{} error while stopping: {}", name_, std::strerror(errno));
+    }
+
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+
+    LOG_INFO("{} stopped", name_);
+}
+
+void SocketLoop::finish() noexcept
+{
+    running_ = false;
+}
+
+bool SocketLoop::isRunning() const noexcept
+{
+    return running_.load();
+}
+
+bool SocketLoop::isStarted() const noexcept
+{
+    return isRunning() || thread_.joinable();
+}
+
+} // namespace httpserver::internal
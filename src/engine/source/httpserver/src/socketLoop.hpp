@@ -0,0 +1,106 @@
+#ifndef _HTTPSERVER_SOCKET_LOOP_HPP
+#define _HTTPSERVER_SOCKET_LOOP_HPP
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace httpserver::internal
+{
+
+/**
+ * @brief Thread, wake descriptor and socket file of a loop serving a Unix socket, shared by the listeners and the
+ * handoff provider.
+ *
+ * The loop waits on its socket and on wakeFd, which stop writes to, and calls finish as its last step. The socket
+ * file is removed by releaseSocketFile unless it was handed over to another process.
+ */
+class SocketLoop
+{
+public:
+    /**
+     * @brief Creates the wake descriptor, which lives as long as the loop.
+     *
+     * @param name Name of the owner in messages, e.g. "Event listener EVENTS".
+     */
+    explicit SocketLoop(std::string name);
+
+    /**
+     * @brief Stops the loop. Owners stop it in their own destructor, as the loop uses their members.
+     */
+    ~SocketLoop();
+
+    SocketLoop(const SocketLoop&) = delete;
+    SocketLoop& operator=(const SocketLoop&) = delete;
+
+    /**
+     * @brief eventfd written by stop to wake the loop.
+     */
+    int wakeFd() const noexcept;
+
+    /**
+     * @brief The socket file at path was created by this process, it is removed when released.
+     */
+    void own(const std::filesystem::path& path);
+
+    /**
+     * @brief The socket file at path was handed over by a previous process, it stays its own until the loop starts,
+     * so a failed start does not remove it.
+     */
+    void inherit(const std::filesystem::path& path);
+
+    /**
+     * @brief Leave the socket file to the process the socket was handed over to.
+     */
+    void handOff() noexcept;
+
+    bool handedOff() const noexcept;
+
+    const std::filesystem::path& socketPath() const noexcept;
+
+    /**
+     * @brief Remove the socket file unless it was handed over, and forget it.
+     */
+    void releaseSocketFile();
+
+    /**
+     * @brief Take the socket file and run the loop, in its own thread or in the calling one.
+     *
+     * Wakes of a stop before this start are discarded, they must not end the new loop.
+     *
+     * @param detail Appended to the name in the started message, e.g. the backend.
+     */
+    void start(std::function<void()> run, bool useThread, std::string_view detail = {});
+
+    /**
+     * @brief Wake the loop and wait for it to end.
+     */
+    void stop();
+
+    /**
+     * @brief Called by the loop once it is done, before returning.
+     */
+    void finish() noexcept;
+
+    bool isRunning() const noexcept;
+
+    /**
+     * @brief Whether a loop started and was not stopped yet, even if it already ended.
+     */
+    bool isStarted() const noexcept;
+
+private:
+    std::string name_;
+    int wakeFd_;
+    std::filesystem::path socketPath_;
+    std::atomic<bool> handedOff_; ///< The socket file belongs to another process
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
+
+} // namespace httpserver::internal
+
+#endif // _HTTPSERVER_SOCKET_LOOP_HPP
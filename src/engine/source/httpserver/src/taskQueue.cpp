@@ -0,0 +1,158 @@
+#include "taskQueue.hpp"
+
+#include <algorithm>
+
+namespace httpserver
+{
+
+namespace
+{
+
+thread_local bool g_rejecting {false};
+
+} // namespace
+
+BoundedTaskQueue::BoundedTaskQueue(std::size_t threads, std::size_t maxQueued)
+    : maxQueued_{maxQueued}
+    , shutdown_{false}
+{
+    threads = std::max<std::size_t>(threads, 1);
+    workers_.reserve(threads);
+
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        workers_.emplace_back([this]() { work(); });
+    }
+
+    if (maxQueued_ != 0)
+    {
+        rejecter_ = std::thread([this]() { reject(); });
+    }
+}
+
+BoundedTaskQueue::~BoundedTaskQueue()
+{
+    shutdown();
+}
+
+bool BoundedTaskQueue::enqueue(std::function<void()> fn)
+{
+    {
+        std::unique_lock lock {mutex_};
+
+        if (shutdown_)
+        {
+            return false;
+        }
+
+        if (maxQueued_ == 0 || queue_.size() < maxQueued_)
+        {
+            queue_.push_back(std::move(fn));
+            lock.unlock();
+            cv_.notify_one();
+            return true;
+        }
+
+        // Full, the rejection thread answers it with 503, the accepting thread goes back to accept right away
+        if (rejected_.size() >= MAX_REJECTED)
+        {
+            return false;
+        }
+
+        rejected_.push_back(std::move(fn));
+    }
+
+    rejectedCv_.notify_one();
+
+    return true;
+}
+
+void BoundedTaskQueue::shutdown()
+{
+    {
+        std::lock_guard lock {mutex_};
+        if (shutdown_)
+        {
+            return;
+        }
+        shutdown_ = true;
+    }
+
+    cv_.notify_all();
+    rejectedCv_.notify_all();
+
+    for (auto& worker : workers_)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+
+    if (rejecter_.joinable())
+    {
+        rejecter_.join();
+    }
+}
+
+bool BoundedTaskQueue::isRejecting() noexcept
+{
+    return g_rejecting;
+}
+
+std::size_t BoundedTaskQueue::pending() const
+{
+    std::lock_guard lock {mutex_};
+    return queue_.size();
+}
+
+void BoundedTaskQueue::work()
+{
+    while (true)
+    {
+        std::function<void()> fn;
+
+        {
+            std::unique_lock lock {mutex_};
+            cv_.wait(lock, [this]() { return shutdown_ || !queue_.empty(); });
+
+            // Pending connections are still served on shutdown
+            if (queue_.empty())
+            {
+                return;
+            }
+
+            fn = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        fn();
+    }
+}
+
+void BoundedTaskQueue::reject()
+{
+    g_rejecting = true;
+
+    while (true)
+    {
+        std::function<void()> fn;
+
+        {
+            std::unique_lock lock {mutex_};
+            rejectedCv_.wait(lock, [this]() { return shutdown_ || !rejected_.empty(); });
+
+            if (rejected_.empty())
+            {
+                return;
+            }
+
+            fn = std::move(rejected_.front());
+            rejected_.pop_front();
+        }
+
+        fn();
+    }
+}
+
+} // namespace httpserver
@@ -0,0 +1,349 @@
+#include "uring.hpp"
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fmt/format.h>
+
+namespace httpserver::internal
+{
+
+namespace
+{
+
+constexpr uint16_t BUFFER_GROUP {0};
+
+int setup(unsigned entries, io_uring_params& params)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+int enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int registerRing(int fd, unsigned opcode, void* arg, unsigned count)
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+void* map(std::size_t size, int fd, off_t offset)
+{
+    auto* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+void* mapAnonymous(std::size_t size)
+{
+    auto* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+template<typename T>
+T* at(void* base, uint32_t offset)
+{
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+/**
+ * @brief Multishot receive with provided buffer rings is there since Linux 6.0.
+ */
+bool kernelSupported()
+{
+    utsname name {};
+    if (::uname(&name) != 0)
+    {
+        return false;
+    }
+
+    int major {0};
+    int minor {0};
+    if (std::sscanf(name.release, "%d.%d", &major, &minor) != 2)
+    {
+        return false;
+    }
+
+    return major >= 6;
+}
+
+} // namespace
+
+base::RespOrError<std::unique_ptr<Uring>> Uring::create(unsigned entries, unsigned bufferCount, std::size_t bufferSize)
+{
+    if (bufferCount == 0 || bufferCount > 32768 || (bufferCount & (bufferCount - 1)) != 0)
+    {
+        return base::Error {fmt::format("Invalid provided buffer count {}, must be a power of two", bufferCount)};
+    }
+
+    if (!kernelSupported())
+    {
+        return base::Error {"Multishot receive needs Linux 6.0 or newer"};
+    }
+
+    std::unique_ptr<Uring> ring {new Uring()};
+
+    io_uring_params params {};
+    // Every multishot request can post many completions per submission
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = entries * 8;
+
+    ring->fd_ = setup(entries, params);
+    if (ring->fd_ < 0)
+    {
+        return base::Error {fmt::format("io_uring_setup failed: {}", std::strerror(errno))};
+    }
+
+    ring->sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+    {
+        ring->sqRingSize_ = std::max(ring->sqRingSize_, ring->cqRingSize_);
+        ring->sqRing_ = map(ring->sqRingSize_, ring->fd_, IORING_OFF_SQ_RING);
+        ring->cqRing_ = ring->sqRing_;
+        ring->cqRingSize_ = 0;
+    }
+    else
+    {
+        ring->sqRing_ = map(ring->sqRingSize_, ring->fd_, IORING_OFF_SQ_RING);
+        ring->cqRing_ = map(ring->cqRingSize_, ring->fd_, IORING_OFF_CQ_RING);
+    }
+
+    ring->sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes_ = static_cast<io_uring_sqe*>(map(ring->sqesSize_, ring->fd_, IORING_OFF_SQES));
+
+    if (ring->sqRing_ == nullptr || ring->cqRing_ == nullptr || ring->sqes_ == nullptr)
+    {
+        return base::Error {fmt::format("io_uring ring mapping failed: {}", std::strerror(errno))};
+    }
+
+    ring->sqHead_ = at<std::atomic<unsigned>>(ring->sqRing_, params.sq_off.head);
+    ring->sqTail_ = at<std::atomic<unsigned>>(ring->sqRing_, params.sq_off.tail);
+    ring->sqArray_ = at<unsigned>(ring->sqRing_, params.sq_off.array);
+    ring->sqMask_ = *at<unsigned>(ring->sqRing_, params.sq_off.ring_mask);
+    ring->sqEntries_ = params.sq_entries;
+
+    ring->cqHead_ = at<std::atomic<unsigned>>(ring->cqRing_, params.cq_off.head);
+    ring->cqTail_ = at<std::atomic<unsigned>>(ring->cqRing_, params.cq_off.tail);
+    ring->cqes_ = at<io_uring_cqe>(ring->cqRing_, params.cq_off.cqes);
+    ring->cqMask_ = *at<unsigned>(ring->cqRing_, params.cq_off.ring_mask);
+
+    // Provided buffers, handed to the kernel through a ring it picks them from
+    ring->bufRingSize_ = bufferCount * sizeof(io_uring_buf);
+    ring->bufRing_ = static_cast<io_uring_buf*>(mapAnonymous(ring->bufRingSize_));
+    ring->buffersSize_ = bufferCount * bufferSize;
+    ring->buffers_ = static_cast<char*>(mapAnonymous(ring->buffersSize_));
+    ring->bufferSize_ = bufferSize;
+    ring->bufMask_ = static_cast<uint16_t>(bufferCount - 1);
+
+    if (ring->bufRing_ == nullptr || ring->buffers_ == nullptr)
+    {
+        return base::Error {fmt::format("io_uring buffer allocation failed: {}", std::strerror(errno))};
+    }
+
+    io_uring_buf_reg reg {};
+    reg.ring_addr = reinterpret_cast<uint64_t>(ring->bufRing_);
+    reg.ring_entries = bufferCount;
+    reg.bgid = BUFFER_GROUP;
+
+    if (registerRing(ring->fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+    {
+        return base::Error {fmt::format("io_uring provided buffer ring registration failed: {}",
+                                        std::strerror(errno))};
+    }
+
+    for (unsigned bid = 0; bid < bufferCount; ++bid)
+    {
+        ring->addBuffer(static_cast<uint16_t>(bid));
+    }
+
+    return ring;
+}
+
+Uring::~Uring()
+{
+    // Closing the ring cancels its pending requests
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+    }
+
+    if (sqRing_ != nullptr)
+    {
+        ::munmap(sqRing_, sqRingSize_);
+    }
+    if (cqRing_ != nullptr && cqRing_ != sqRing_)
+    {
+        ::munmap(cqRing_, cqRingSize_);
+    }
+    if (sqes_ != nullptr)
+    {
+        ::munmap(sqes_, sqesSize_);
+    }
+    if (bufRing_ != nullptr)
+    {
+        ::munmap(bufRing_, bufRingSize_);
+    }
+    if (buffers_ != nullptr)
+    {
+        ::munmap(buffers_, buffersSize_);
+    }
+}
+
+io_uring_sqe* Uring::nextSqe()
+{
+    auto tail = sqTail_->load(std::memory_order_relaxed);
+
+    if (tail - sqHead_->load(std::memory_order_acquire) >= sqEntries_)
+    {
+        // Full, hand the queued entries to the kernel to make room
+        const auto submitted = enter(fd_, toSubmit_, 0, 0);
+        if (submitted <= 0)
+        {
+            return nullptr;
+        }
+        toSubmit_ -= static_cast<unsigned>(submitted);
+
+        if (tail - sqHead_->load(std::memory_order_acquire) >= sqEntries_)
+        {
+            return nullptr;
+        }
+    }
+
+    const auto index = tail & sqMask_;
+    auto* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray_[index] = index;
+
+    return sqe;
+}
+
+bool Uring::acceptMultishot(int fd, uint64_t userData)
+{
+    auto* sqe = nextSqe();
+    if (sqe == nullptr)
+    {
+        return false;
+    }
+
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->user_data = userData;
+
+    sqTail_->store(sqTail_->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    ++toSubmit_;
+    return true;
+}
+
+bool Uring::recvMultishot(int fd, uint64_t userData)
+{
+    auto* sqe = nextSqe();
+    if (sqe == nullptr)
+    {
+        return false;
+    }
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = userData;
+
+    sqTail_->store(sqTail_->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    ++toSubmit_;
+    return true;
+}
+
+bool Uring::pollIn(int fd, uint64_t userData)
+{
+    auto* sqe = nextSqe();
+    if (sqe == nullptr)
+    {
+        return false;
+    }
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = userData;
+
+    sqTail_->store(sqTail_->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    ++toSubmit_;
+    return true;
+}
+
+bool Uring::cancel(uint64_t target, uint64_t userData)
+{
+    auto* sqe = nextSqe();
+    if (sqe == nullptr)
+    {
+        return false;
+    }
+
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = target;
+    sqe->user_data = userData;
+
+    sqTail_->store(sqTail_->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    ++toSubmit_;
+    return true;
+}
+
+int Uring::submitAndWait()
+{
+    const auto submitted = enter(fd_, toSubmit_, 1, IORING_ENTER_GETEVENTS);
+    if (submitted < 0)
+    {
+        return -errno;
+    }
+
+    toSubmit_ -= std::min(toSubmit_, static_cast<unsigned>(submitted));
+    return 0;
+}
+
+std::string_view Uring::buffer(int32_t res, uint32_t flags) const noexcept
+{
+    if ((flags & IORING_CQE_F_BUFFER) == 0 || res <= 0)
+    {
+        return {};
+    }
+
+    const auto bid = flags >> IORING_CQE_BUFFER_SHIFT;
+    return {buffers_ + static_cast<std::size_t>(bid) * bufferSize_, static_cast<std::size_t>(res)};
+}
+
+void Uring::recycle(uint32_t flags) noexcept
+{
+    if ((flags & IORING_CQE_F_BUFFER) != 0)
+    {
+        addBuffer(static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT));
+    }
+}
+
+void Uring::addBuffer(uint16_t bid) noexcept
+{
+    // Field by field, the resv of the first entry is the tail
+    auto& entry = bufRing_[bufTail_ & bufMask_];
+    entry.addr = reinterpret_cast<uint64_t>(buffers_ + static_cast<std::size_t>(bid) * bufferSize_);
+    entry.len = static_cast<uint32_t>(bufferSize_);
+    entry.bid = bid;
+
+    ++bufTail_;
+    reinterpret_cast<std::atomic<uint16_t>*>(&bufRing_[0].resv)->store(bufTail_, std::memory_order_release);
+}
+
+} // namespace httpserver::internal
@@ -0,0 +1,142 @@
+#ifndef _HTTPSERVER_URING_HPP
+#define _HTTPSERVER_URING_HPP
+
+#include <linux/io_uring.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include <base/error.hpp>
+
+namespace httpserver::internal
+{
+
+/**
+ * @brief Minimal io_uring over the raw system calls, for the receive path of the event listener.
+ *
+ * One submission and one completion ring, plus a ring of provided buffers the kernel picks from for the multishot
+ * receives. Only used from the thread running the loop.
+ */
+class Uring
+{
+public:
+    /**
+     * @brief Set up the rings.
+     *
+     * @param entries Submission queue entries.
+     * @param bufferCount Provided buffers, a power of two up to 32768.
+     * @param bufferSize Bytes of each provided buffer.
+     * @return The ring, or an error if io_uring or one of the features used is not available.
+     */
+    static base::RespOrError<std::unique_ptr<Uring>> create(unsigned entries,
+                                                            unsigned bufferCount,
+                                                            std::size_t bufferSize);
+
+    ~Uring();
+
+    Uring(const Uring&) = delete;
+    Uring& operator=(const Uring&) = delete;
+
+    /**
+     * @brief Queue a multishot accept, one completion per accepted connection, with its descriptor as result.
+     */
+    bool acceptMultishot(int fd, uint64_t userData);
+
+    /**
+     * @brief Queue a multishot receive into the provided buffers, one completion per received chunk.
+     */
+    bool recvMultishot(int fd, uint64_t userData);
+
+    /**
+     * @brief Queue a one shot readiness poll for reading.
+     */
+    bool pollIn(int fd, uint64_t userData);
+
+    /**
+     * @brief Queue the cancellation of the request queued with target as user data.
+     */
+    bool cancel(uint64_t target, uint64_t userData);
+
+    /**
+     * @brief Submit the queued entries and wait for at least one completion.
+     *
+     * @return 0, or the negated errno of io_uring_enter.
+     */
+    int submitAndWait();
+
+    /**
+     * @brief Call fn(userData, res, flags) with each available completion, in order.
+     */
+    template<typename Fn>
+    void forEachCompletion(Fn&& fn)
+    {
+        auto head = cqHead_->load(std::memory_order_relaxed);
+        const auto tail = cqTail_->load(std::memory_order_acquire);
+
+        for (; head != tail; ++head)
+        {
+            const auto& cqe = cqes_[head & cqMask_];
+            // Copied out, fn may queue new entries
+            const auto userData = cqe.user_data;
+            const auto res = cqe.res;
+            const auto flags = cqe.flags;
+
+            // Released before fn so the slot is free even if fn throws
+            cqHead_->store(head + 1, std::memory_order_release);
+            fn(userData, res, flags);
+        }
+    }
+
+    /**
+     * @brief Received bytes of a receive completion, in the provided buffer named by its flags.
+     */
+    std::string_view buffer(int32_t res, uint32_t flags) const noexcept;
+
+    /**
+     * @brief Give the provided buffer of a completion back to the kernel.
+     */
+    void recycle(uint32_t flags) noexcept;
+
+private:
+    Uring() = default;
+
+    io_uring_sqe* nextSqe();
+
+    void addBuffer(uint16_t bid) noexcept;
+
+    int fd_ {-1};
+
+    void* sqRing_ {nullptr};
+    std::size_t sqRingSize_ {0};
+    void* cqRing_ {nullptr};
+    std::size_t cqRingSize_ {0};
+    io_uring_sqe* sqes_ {nullptr};
+    std::size_t sqesSize_ {0};
+
+    std::atomic<unsigned>* sqHead_ {nullptr};
+    std::atomic<unsigned>* sqTail_ {nullptr};
+    unsigned* sqArray_ {nullptr};
+    unsigned sqMask_ {0};
+    unsigned sqEntries_ {0};
+    unsigned toSubmit_ {0};
+
+    std::atomic<unsigned>* cqHead_ {nullptr};
+    std::atomic<unsigned>* cqTail_ {nullptr};
+    io_uring_cqe* cqes_ {nullptr};
+    unsigned cqMask_ {0};
+
+    io_uring_buf* bufRing_ {nullptr}; ///< Its tail is the resv field of the first entry
+    std::size_t bufRingSize_ {0};
+    char* buffers_ {nullptr};
+    std::size_t buffersSize_ {0};
+    std::size_t bufferSize_ {0};
+    uint16_t bufMask_ {0};
+    uint16_t bufTail_ {0};
+};
+
+} // namespace httpserver::internal
+
+#endif // _HTTPSERVER_URING_HPP
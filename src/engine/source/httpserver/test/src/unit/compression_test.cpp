@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <zlib.h>
+#include <zstd.h>
+
+#include <httpserver/compression.hpp>
+
+using namespace httpserver;
+
+namespace
+{
+
+std::string gunzip(const std::string& data)
+{
+    z_stream stream {};
+    EXPECT_EQ(inflateInit2(&stream, 15 + 16), Z_OK);
+
+    std::string out(1024 * 1024, '\0');
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+
+    EXPECT_EQ(inflate(&stream, Z_FINISH), Z_STREAM_END);
+    out.resize(stream.total_out);
+    inflateEnd(&stream);
+
+    return out;
+}
+
+std::string unzstd(const std::string& data)
+{
+    std::string out(ZSTD_getFrameContentSize(data.data(), data.size()), '\0');
+    const auto size = ZSTD_decompress(out.data(), out.size(), data.data(), data.size());
+    EXPECT_FALSE(ZSTD_isError(size));
+    out.resize(size);
+
+    return out;
+}
+
+std::string largeJson()
+{
+    std::string json {"["};
+    for (int i = 0; i < 1000; ++i)
+    {
+        json += R"({"name":"decoder/example/0","enabled":true},)";
+    }
+    json.back() = ']';
+
+    return json;
+}
+
+} // namespace
+
+class NegotiateEncodingTest
+    : public ::testing::TestWithParam<std::tuple<std::string, Encoding>>
+{
+};
+
+TEST_P(NegotiateEncodingTest, Negotiate)
+{
+    const auto& [acceptEncoding, expected] = GetParam();
+    EXPECT_EQ(negotiateEncoding(acceptEncoding), expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Compression,
+    NegotiateEncodingTest,
+    ::testing::Values(std::make_tuple("", Encoding::IDENTITY),
+                      std::make_tuple("identity", Encoding::IDENTITY),
+                      std::make_tuple("br, deflate", Encoding::IDENTITY),
+                      std::make_tuple("gzip", Encoding::GZIP),
+                      std::make_tuple("GZIP", Encoding::GZIP),
+                      std::make_tuple("x-gzip", Encoding::GZIP),
+                      std::make_tuple("zstd", Encoding::ZSTD),
+                      std::make_tuple("gzip, deflate, br, zstd", Encoding::ZSTD),
+                      std::make_tuple("gzip;q=1.0, zstd;q=0.5", Encoding::GZIP),
+                      std::make_tuple("gzip ; q=0.8 , zstd ; q=0.8", Encoding::ZSTD),
+                      std::make_tuple("zstd;q=0, gzip", Encoding::GZIP),
+                      std::make_tuple("zstd;q=0, gzip;q=0", Encoding::IDENTITY),
+                      std::make_tuple("*", Encoding::ZSTD),
+                      std::make_tuple("*;q=0.5, gzip", Encoding::GZIP),
+                      std::make_tuple("zstd;q=0, *", Encoding::GZIP),
+                      std::make_tuple("gzip;q=invalid", Encoding::GZIP)));
+
+TEST(CompressionTest, EncodingName)
+{
+    EXPECT_EQ(encodingName(Encoding::IDENTITY), "");
+    EXPECT_EQ(encodingName(Encoding::GZIP), "gzip");
+    EXPECT_EQ(encodingName(Encoding::ZSTD), "zstd");
+}
+
+TEST(CompressionTest, Identity)
+{
+    auto result = compress("data", Encoding::IDENTITY);
+    ASSERT_FALSE(base::isError(result));
+    EXPECT_EQ(base::getResponse(result), "data");
+}
+
+TEST(CompressionTest, GzipRoundTrip)
+{
+    const auto json = largeJson();
+
+    auto result = compress(json, Encoding::GZIP);
+    ASSERT_FALSE(base::isError(result));
+    EXPECT_LT(base::getResponse(result).size(), json.size());
+    EXPECT_EQ(gunzip(base::getResponse(result)), json);
+}
+
+TEST(CompressionTest, ZstdRoundTrip)
+{
+    const auto json = largeJson();
+
+    auto result = compress(json, Encoding::ZSTD);
+    ASSERT_FALSE(base::isError(result));
+    EXPECT_LT(base::getResponse(result).size(), json.size());
+    EXPECT_EQ(unzstd(base::getResponse(result)), json);
+}
+
+TEST(CompressionTest, Empty)
+{
+    auto gzip = compress("", Encoding::GZIP);
+    ASSERT_FALSE(base::isError(gzip));
+    EXPECT_EQ(gunzip(base::getResponse(gzip)), "");
+
+    auto zstd = compress("", Encoding::ZSTD);
+    ASSERT_FALSE(base::isError(zstd));
+    EXPECT_EQ(unzstd(base::getResponse(zstd)), "");
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <base/logger.hpp>
+#include <httpserver/datagramListener.hpp>
+
+using namespace httpserver;
+
+namespace
+{
+
+std::filesystem::path uniquePath()
+{
+    std::stringstream ss;
+    ss << getpid() << "_" << std::this_thread::get_id() << "_datagrams";
+
+    return std::filesystem::path("/tmp") / ss.str();
+}
+
+/**
+ * @brief Unbound datagram socket sending to the listener.
+ */
+class Sender
+{
+    int fd_;
+    sockaddr_un addr_ {};
+
+public:
+    explicit Sender(const std::filesystem::path& path)
+        : fd_ {::socket(AF_UNIX, SOCK_DGRAM, 0)}
+    {
+        addr_.sun_family = AF_UNIX;
+        std::strncpy(addr_.sun_path, path.c_str(), sizeof(addr_.sun_path) - 1);
+    }
+
+    ~Sender() { ::close(fd_); }
+
+    bool send(std::string_view datagram)
+    {
+        return ::sendto(fd_, datagram.data(), datagram.size(), 0, reinterpret_cast<sockaddr*>(&addr_), sizeof(addr_))
+               == static_cast<ssize_t>(datagram.size());
+    }
+};
+
+} // namespace
+
+class DatagramListenerTest : public ::testing::Test
+{
+protected:
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> messages;
+
+    DatagramListener::Handler handler()
+    {
+        return [this](std::string_view message)
+        {
+            std::lock_guard lock {mutex};
+            messages.emplace_back(message);
+            cv.notify_all();
+        };
+    }
+
+    bool waitMessages(std::size_t count)
+    {
+        std::unique_lock lock {mutex};
+        return cv.wait_for(lock, std::chrono::seconds(5), [&]() { return messages.size() >= count; });
+    }
+
+    std::filesystem::path socketPath() const { return uniquePath() / "datagrams.sock"; }
+
+    void SetUp() override
+    {
+        logger::testInit();
+        std::filesystem::create_directory(uniquePath());
+    }
+
+    void TearDown() override { std::filesystem::remove_all(uniquePath()); }
+};
+
+TEST_F(DatagramListenerTest, InvalidOptions)
+{
+    EXPECT_THROW(DatagramListener("test", nullptr), std::invalid_argument);
+    EXPECT_THROW(DatagramListener("test", handler(), {0, 64, 0}), std::invalid_argument);
+    EXPECT_THROW(DatagramListener("test", handler(), {1024, 0, 0}), std::invalid_argument);
+}
+
+TEST_F(DatagramListenerTest, StartStop)
+{
+    DatagramListener listener("test", handler());
+
+    EXPECT_THROW(listener.start(std::filesystem::path("")), std::runtime_error);
+    EXPECT_THROW(listener.start(uniquePath() / "invalid" / "datagrams.sock"), std::runtime_error);
+
+    EXPECT_NO_THROW(listener.start(socketPath()));
+    EXPECT_TRUE(listener.isRunning());
+    EXPECT_THROW(listener.start(socketPath()), std::runtime_error);
+    EXPECT_NO_THROW(listener.stop());
+    EXPECT_FALSE(listener.isRunning());
+    EXPECT_FALSE(std::filesystem::exists(socketPath()));
+
+    EXPECT_NO_THROW(listener.start(socketPath()));
+    EXPECT_TRUE(listener.isRunning());
+}
+
+TEST_F(DatagramListenerTest, OneMessagePerDatagram)
+{
+    DatagramListener listener("test", handler());
+    listener.start(socketPath());
+
+    Sender sender(socketPath());
+    ASSERT_TRUE(sender.send("first"));
+    ASSERT_TRUE(sender.send("line one\nline two"));
+    ASSERT_TRUE(sender.send(""));
+    ASSERT_TRUE(sender.send("third"));
+
+    ASSERT_TRUE(waitMessages(3));
+    // Empty datagrams are skipped, newlines are part of the message
+    EXPECT_EQ(messages, (std::vector<std::string> {"first", "line one\nline two", "third"}));
+}
+
+TEST_F(DatagramListenerTest, ManyBatches)
+{
+    DatagramListener listener("test", handler(), {256, 8, 1024 * 1024});
+    listener.start(socketPath());
+
+    constexpr int COUNT {1000};
+    Sender sender(socketPath());
+    for (int i = 0; i < COUNT; ++i)
+    {
+        // Blocks while the socket buffer is full, none is lost
+        ASSERT_TRUE(sender.send("event " + std::to_string(i)));
+    }
+
+    ASSERT_TRUE(waitMessages(COUNT));
+    for (int i = 0; i < COUNT; ++i)
+    {
+        EXPECT_EQ(messages[i], "event " + std::to_string(i));
+    }
+}
+
+TEST_F(DatagramListenerTest, OversizedDropped)
+{
+    DatagramListener listener("test", handler(), {16, 4, 0});
+    listener.start(socketPath());
+
+    Sender sender(socketPath());
+    ASSERT_TRUE(sender.send(std::string(64, 'x')));
+    ASSERT_TRUE(sender.send("fits"));
+
+    ASSERT_TRUE(waitMessages(1));
+    EXPECT_EQ(messages, (std::vector<std::string> {"fits"}));
+}
+
+TEST_F(DatagramListenerTest, HandlerException)
+{
+    DatagramListener listener("test",
+                              [this](std::string_view message)
+                              {
+                                  if (message == "throw")
+                                  {
+                                      throw std::runtime_error("handler error");
+                                  }
+                                  handler()(message);
+                              });
+    listener.start(socketPath());
+
+    Sender sender(socketPath());
+    ASSERT_TRUE(sender.send("throw"));
+    ASSERT_TRUE(sender.send("after"));
+
+    ASSERT_TRUE(waitMessages(1));
+    EXPECT_EQ(messages, (std::vector<std::string> {"after"}));
+}
+
+TEST_F(DatagramListenerTest, StopDrainsQueued)
+{
+    constexpr int COUNT {100};
+
+    // The first datagram holds the loop, the others are still queued when stop is called
+    DatagramListener listener("test",
+                              [this](std::string_view message)
+                              {
+                                  if (message == "event 0")
+                                  {
+                                      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                                  }
+                                  handler()(message);
+                              },
+                              {256, 1, 1024 * 1024});
+    listener.start(socketPath());
+
+    Sender sender(socketPath());
+    ASSERT_TRUE(sender.send("event 0"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    for (int i = 1; i < COUNT; ++i)
+    {
+        ASSERT_TRUE(sender.send("event " + std::to_string(i)));
+    }
+
+    listener.stop();
+
+    ASSERT_EQ(messages.size(), COUNT);
+    for (int i = 0; i < COUNT; ++i)
+    {
+        EXPECT_EQ(messages[i], "event " + std::to_string(i));
+    }
+}
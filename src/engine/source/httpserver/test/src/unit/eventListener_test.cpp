@@ -0,0 +1,400 @@
+#include <gtest/gtest.h>
+
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <base/logger.hpp>
+#include <httpserver/eventListener.hpp>
+
+using namespace httpserver;
+
+namespace
+{
+
+std::filesystem::path uniquePath()
+{
+    std::stringstream ss;
+    ss << getpid() << "_" << std::this_thread::get_id() << "_events";
+
+    return std::filesystem::path("/tmp") / ss.str();
+}
+
+int connectTo(const std::filesystem::path& path)
+{
+    const auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Cannot connect to " + path.string());
+    }
+
+    return fd;
+}
+
+void sendAll(int fd, std::string_view data)
+{
+    while (!data.empty())
+    {
+        const auto n = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (n <= 0)
+        {
+            return;
+        }
+        data.remove_prefix(static_cast<std::size_t>(n));
+    }
+}
+
+std::string lengthPrefixed(std::string_view message)
+{
+    const auto size = static_cast<uint32_t>(message.size());
+    std::string frame {static_cast<char>(size >> 24),
+                       static_cast<char>(size >> 16),
+                       static_cast<char>(size >> 8),
+                       static_cast<char>(size)};
+
+    return frame.append(message);
+}
+
+} // namespace
+
+class EventListenerTest : public ::testing::TestWithParam<Backend>
+{
+protected:
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> messages;
+
+    EventListener::Handler handler()
+    {
+        return [this](std::string_view message)
+        {
+            std::lock_guard lock {mutex};
+            messages.emplace_back(message);
+            cv.notify_all();
+        };
+    }
+
+    bool waitMessages(std::size_t count)
+    {
+        std::unique_lock lock {mutex};
+        return cv.wait_for(lock, std::chrono::seconds(5), [&]() { return messages.size() >= count; });
+    }
+
+    std::filesystem::path socketPath() const { return uniquePath() / "events.sock"; }
+
+    EventListenerOptions options(Framing framing = Framing::NEWLINE, std::size_t maxFrameSize = 1024 * 1024) const
+    {
+        return {framing, maxFrameSize, GetParam()};
+    }
+
+    void SetUp() override
+    {
+        logger::testInit();
+        std::filesystem::create_directory(uniquePath());
+    }
+
+    void TearDown() override { std::filesystem::remove_all(uniquePath()); }
+};
+
+TEST_P(EventListenerTest, NullHandler)
+{
+    EXPECT_THROW(EventListener("test", nullptr, options()), std::invalid_argument);
+}
+
+TEST_P(EventListenerTest, Backend)
+{
+    EventListener listener("test", handler(), options());
+    listener.start(socketPath());
+
+    if (GetParam() == Backend::EPOLL)
+    {
+        EXPECT_EQ(listener.backend(), Backend::EPOLL);
+    }
+
+    // IO_URING falls back to EPOLL on kernels without it, either way events are received
+    const auto fd = connectTo(socketPath());
+    sendAll(fd, "event\n");
+
+    ASSERT_TRUE(waitMessages(1));
+    EXPECT_EQ(messages, (std::vector<std::string> {"event"}));
+
+    ::close(fd);
+}
+
+TEST_P(EventListenerTest, StartStop)
+{
+    EventListener listener("test", handler(), options());
+
+    EXPECT_FALSE(listener.isRunning());
+    EXPECT_NO_THROW(listener.start(socketPath()));
+    EXPECT_TRUE(listener.isRunning());
+    EXPECT_THROW(listener.start(socketPath()), std::runtime_error);
+    EXPECT_NO_THROW(listener.stop());
+    EXPECT_FALSE(listener.isRunning());
+    EXPECT_FALSE(std::filesystem::exists(socketPath()));
+
+    // Restart after a stop
+    EXPECT_NO_THROW(listener.start(socketPath()));
+    EXPECT_TRUE(listener.isRunning());
+}
+
+TEST_P(EventListenerTest, StartInvalidSocketPath)
+{
+    EventListener listener("test", handler(), options());
+
+    EXPECT_THROW(listener.start(std::filesystem::path("")), std::runtime_error);
+    EXPECT_THROW(listener.start(uniquePath() / "invalid" / "events.sock"), std::runtime_error);
+    EXPECT_FALSE(listener.isRunning());
+}
+
+TEST_P(EventListenerTest, StopCurrentThread)
+{
+    EventListener listener("test", handler(), options());
+
+    std::thread t([&listener, path = socketPath()]() { listener.start(path, false); });
+
+    while (!listener.isRunning())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    listener.stop();
+    t.join();
+
+    EXPECT_FALSE(listener.isRunning());
+}
+
+TEST_P(EventListenerTest, NewlineFraming)
+{
+    EventListener listener("test", handler(), options());
+    listener.start(socketPath());
+
+    const auto fd = connectTo(socketPath());
+    // Messages split across writes, empty lines and CRLF
+    sendAll(fd, "first\nsec");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sendAll(fd, "ond\r\n\nthird\n");
+
+    ASSERT_TRUE(waitMessages(3));
+    EXPECT_EQ(messages, (std::vector<std::string> {"first", "second", "third"}));
+
+    ::close(fd);
+}
+
+TEST_P(EventListenerTest, LengthPrefixedFraming)
+{
+    EventListener listener("test", handler(), options(Framing::LENGTH_PREFIXED));
+    listener.start(socketPath());
+
+    const std::string large(100 * 1024, 'x');
+    const auto data = lengthPrefixed("a\nb") + lengthPrefixed("") + lengthPrefixed(large);
+
+    const auto fd = connectTo(socketPath());
+    sendAll(fd, data.substr(0, 2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    sendAll(fd, data.substr(2));
+
+    ASSERT_TRUE(waitMessages(3));
+    EXPECT_EQ(messages, (std::vector<std::string> {"a\nb", "", large}));
+
+    ::close(fd);
+}
+
+TEST_P(EventListenerTest, ManyConnections)
+{
+    EventListener listener("test", handler(), options());
+    listener.start(socketPath());
+
+    constexpr int CONNECTIONS {64};
+    std::vector<int> fds;
+    for (int i = 0; i < CONNECTIONS; ++i)
+    {
+        fds.push_back(connectTo(socketPath()));
+    }
+
+    for (int i = 0; i < CONNECTIONS; ++i)
+    {
+        sendAll(fds[i], "event " + std::to_string(i) + "\n");
+    }
+
+    ASSERT_TRUE(waitMessages(CONNECTIONS));
+    EXPECT_EQ(messages.size(), CONNECTIONS);
+
+    for (auto fd : fds)
+    {
+        ::close(fd);
+    }
+}
+
+TEST_P(EventListenerTest, OutOfDescriptorsDropsConnections)
+{
+    EventListener listener("test", handler(), options());
+    listener.start(socketPath());
+
+    // Client sockets are created first, the process then runs out of descriptors before they connect
+    constexpr int CLIENTS {4};
+    std::vector<int> clients;
+    for (int i = 0; i < CLIENTS; ++i)
+    {
+        clients.push_back(::socket(AF_UNIX, SOCK_STREAM, 0));
+    }
+
+    rlimit previous {};
+    ASSERT_EQ(::getrlimit(RLIMIT_NOFILE, &previous), 0);
+    rlimit low = previous;
+    low.rlim_cur = std::min<rlim_t>(previous.rlim_cur, 512);
+    ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &low), 0);
+
+    std::vector<int> filler;
+    for (int fd = ::dup(0); fd >= 0; fd = ::dup(0))
+    {
+        filler.push_back(fd);
+    }
+    ASSERT_EQ(errno, EMFILE);
+
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath().c_str(), sizeof(addr.sun_path) - 1);
+
+    // Dropped instead of left pending, with nothing else waking the listener
+    for (auto fd : clients)
+    {
+        timeval timeout {5, 0};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+
+        char byte;
+        EXPECT_EQ(::recv(fd, &byte, 1, 0), 0);
+    }
+
+    for (auto fd : filler)
+    {
+        ::close(fd);
+    }
+    ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &previous), 0);
+
+    for (auto fd : clients)
+    {
+        ::close(fd);
+    }
+
+    // And accepts again once descriptors are available
+    const auto fd = connectTo(socketPath());
+    sendAll(fd, "after\n");
+    ASSERT_TRUE(waitMessages(1));
+    EXPECT_EQ(messages, (std::vector<std::string> {"after"}));
+
+    ::close(fd);
+}
+
+TEST_P(EventListenerTest, OversizedMessageClosesConnection)
+{
+    EventListener listener("test", handler(), options(Framing::NEWLINE, 16));
+    listener.start(socketPath());
+
+    const auto fd = connectTo(socketPath());
+    sendAll(fd, "short\n" + std::string(64, 'x') + "\nlost\n");
+
+    ASSERT_TRUE(waitMessages(1));
+
+    // The connection is closed by the listener
+    char byte;
+    EXPECT_EQ(::recv(fd, &byte, 1, 0), 0);
+    EXPECT_EQ(messages, (std::vector<std::string> {"short"}));
+
+    ::close(fd);
+
+    // Other connections are unaffected
+    const auto other = connectTo(socketPath());
+    sendAll(other, "next\n");
+    ASSERT_TRUE(waitMessages(2));
+    EXPECT_EQ(messages.back(), "next");
+
+    ::close(other);
+}
+
+TEST_P(EventListenerTest, HandlerException)
+{
+    EventListener listener("test",
+                           [this](std::string_view message)
+                           {
+                               if (message == "throw")
+                               {
+                                   throw std::runtime_error("handler error");
+                               }
+                               handler()(message);
+                           },
+                           options());
+    listener.start(socketPath());
+
+    const auto fd = connectTo(socketPath());
+    sendAll(fd, "throw\nafter\n");
+
+    ASSERT_TRUE(waitMessages(1));
+    EXPECT_EQ(messages, (std::vector<std::string> {"after"}));
+
+    ::close(fd);
+}
+
+TEST_P(EventListenerTest, StopDrainsConnections)
+{
+    constexpr int COUNT {100};
+
+    // The first message holds the loop, the others are still unread when stop is called
+    EventListener listener("test",
+                           [this](std::string_view message)
+                           {
+                               if (message == "event 0")
+                               {
+                                   std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                               }
+                               handler()(message);
+                           },
+                           options());
+    listener.start(socketPath());
+
+    const auto fd = connectTo(socketPath());
+    sendAll(fd, "event 0\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    for (int i = 1; i < COUNT; ++i)
+    {
+        sendAll(fd, "event " + std::to_string(i) + "\n");
+    }
+    sendAll(fd, "incomplete");
+
+    listener.stop();
+
+    ASSERT_EQ(messages.size(), COUNT);
+    for (int i = 0; i < COUNT; ++i)
+    {
+        EXPECT_EQ(messages[i], "event " + std::to_string(i));
+    }
+
+    // The peer cannot send anymore and the socket is gone
+    EXPECT_LT(::send(fd, "late\n", 5, MSG_NOSIGNAL), 0);
+    EXPECT_FALSE(std::filesystem::exists(socketPath()));
+
+    ::close(fd);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends,
+                         EventListenerTest,
+                         ::testing::Values(Backend::EPOLL, Backend::IO_URING),
+                         [](const auto& info) { return info.param == Backend::EPOLL ? "Epoll" : "IoUring"; });
@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <base/logger.hpp>
+#include <httpserver/datagramListener.hpp>
+#include <httpserver/eventListener.hpp>
+#include <httpserver/handoff.hpp>
+
+using namespace httpserver;
+
+namespace
+{
+
+std::filesystem::path uniquePath()
+{
+    std::stringstream ss;
+    ss << getpid() << "_" << std::this_thread::get_id() << "_handoff";
+
+    return std::filesystem::path("/tmp") / ss.str();
+}
+
+int connectTo(const std::filesystem::path& path, int type)
+{
+    const auto fd = ::socket(AF_UNIX, type, 0);
+
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+    {
+        ::close(fd);
+        throw std::runtime_error("Cannot connect to " + path.string());
+    }
+
+    return fd;
+}
+
+bool sendAll(int fd, std::string_view data)
+{
+    return ::send(fd, data.data(), data.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(data.size());
+}
+
+/**
+ * @brief Messages received by one listener.
+ */
+struct Received
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> messages;
+
+    std::function<void(std::string_view)> handler()
+    {
+        return [this](std::string_view message)
+        {
+            std::lock_guard lock {mutex};
+            messages.emplace_back(message);
+            cv.notify_all();
+        };
+    }
+
+    bool wait(std::size_t count)
+    {
+        std::unique_lock lock {mutex};
+        return cv.wait_for(lock, std::chrono::seconds(5), [&]() { return messages.size() >= count; });
+    }
+};
+
+} // namespace
+
+class HandoffTest : public ::testing::Test
+{
+protected:
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool handedOff {false};
+
+    handoff::Provider::HandedOff onHandedOff()
+    {
+        return [this]()
+        {
+            std::lock_guard lock {mutex};
+            handedOff = true;
+            cv.notify_all();
+        };
+    }
+
+    bool waitHandedOff()
+    {
+        std::unique_lock lock {mutex};
+        return cv.wait_for(lock, std::chrono::seconds(5), [&]() { return handedOff; });
+    }
+
+    std::filesystem::path handoffPath() const { return uniquePath() / "handoff.sock"; }
+
+    void SetUp() override
+    {
+        logger::testInit();
+        std::filesystem::create_directory(uniquePath());
+    }
+
+    void TearDown() override { std::filesystem::remove_all(uniquePath()); }
+};
+
+TEST_F(HandoffTest, NoProvider)
+{
+    EXPECT_TRUE(base::isError(handoff::request(handoffPath(), std::chrono::seconds(1))));
+}
+
+TEST_F(HandoffTest, InvalidProvider)
+{
+    EXPECT_THROW(handoff::Provider("test", nullptr, onHandedOff()), std::invalid_argument);
+    EXPECT_THROW(handoff::Provider("test", []() { return std::vector<int> {}; }, nullptr), std::invalid_argument);
+}
+
+TEST_F(HandoffTest, EventListener)
+{
+    const auto path = uniquePath() / "events.sock";
+
+    // The backends share the socket, either may run on each side
+    Received previous;
+    EventListener previousListener("previous", previous.handler(), {Framing::NEWLINE, 1024, Backend::IO_URING});
+    previousListener.start(path);
+
+    handoff::Provider provider(
+        "test", [&]() { return std::vector<int> {previousListener.socketFd()}; }, onHandedOff());
+    provider.start(handoffPath());
+
+    // Connected to the previous process, served by it until it stops
+    const auto before = connectTo(path, SOCK_STREAM);
+    ASSERT_TRUE(sendAll(before, "before\n"));
+    ASSERT_TRUE(previous.wait(1));
+
+    auto inherited = handoff::request(handoffPath(), std::chrono::seconds(5));
+    ASSERT_FALSE(base::isError(inherited));
+    auto& sockets = base::getResponse(inherited);
+
+    EXPECT_EQ(sockets.take(path, SOCK_DGRAM), -1);
+    const auto fd = sockets.take(path, SOCK_STREAM);
+    ASSERT_GE(fd, 0);
+
+    Received next;
+    EventListener nextListener("next", next.handler());
+    nextListener.start(fd);
+    EXPECT_TRUE(nextListener.isRunning());
+
+    sockets.ready();
+    ASSERT_TRUE(waitHandedOff());
+    EXPECT_FALSE(provider.isRunning());
+
+    previousListener.handOff();
+    previousListener.stop();
+
+    // The socket file was kept, new connections reach the new listener
+    EXPECT_TRUE(std::filesystem::exists(path));
+    const auto after = connectTo(path, SOCK_STREAM);
+    ASSERT_TRUE(sendAll(after, "after\n"));
+    ASSERT_TRUE(next.wait(1));
+
+    EXPECT_EQ(previous.messages, (std::vector<std::string> {"before"}));
+    EXPECT_EQ(next.messages, (std::vector<std::string> {"after"}));
+
+    ::close(before);
+    ::close(after);
+}
+
+TEST_F(HandoffTest, DatagramListener)
+{
+    const auto path = uniquePath() / "datagrams.sock";
+
+    Received previous;
+    DatagramListener previousListener("previous", previous.handler());
+    previousListener.start(path);
+
+    handoff::Provider provider(
+        "test", [&]() { return std::vector<int> {previousListener.socketFd()}; }, onHandedOff());
+    provider.start(handoffPath());
+
+    auto inherited = handoff::request(handoffPath(), std::chrono::seconds(5));
+    ASSERT_FALSE(base::isError(inherited));
+    const auto fd = base::getResponse(inherited).take(path, SOCK_DGRAM);
+    ASSERT_GE(fd, 0);
+
+    Received next;
+    DatagramListener nextListener("next", next.handler());
+    nextListener.start(fd);
+
+    base::getResponse(inherited).ready();
+    ASSERT_TRUE(waitHandedOff());
+
+    previousListener.handOff();
+    previousListener.stop();
+
+    EXPECT_TRUE(std::filesystem::exists(path));
+    const auto sender = connectTo(path, SOCK_DGRAM);
+    ASSERT_TRUE(sendAll(sender, "after"));
+    ASSERT_TRUE(next.wait(1));
+    EXPECT_EQ(next.messages, (std::vector<std::string> {"after"}));
+
+    ::close(sender);
+}
+
+TEST_F(HandoffTest, NotReadyKeepsServing)
+{
+    const auto path = uniquePath() / "events.sock";
+
+    Received previous;
+    EventListener previousListener("previous", previous.handler());
+    previousListener.start(path);
+
+    handoff::Provider provider(
+        "test", [&]() { return std::vector<int> {previousListener.socketFd()}; }, onHandedOff());
+    provider.start(handoffPath());
+
+    // The new process gives up before ready
+    {
+        auto inherited = handoff::request(handoffPath(), std::chrono::seconds(5));
+        ASSERT_FALSE(base::isError(inherited));
+    }
+
+    // The provider answers the next one
+    auto inherited = handoff::request(handoffPath(), std::chrono::seconds(5));
+    ASSERT_FALSE(base::isError(inherited));
+    EXPECT_TRUE(provider.isRunning());
+    EXPECT_FALSE(handedOff);
+
+    const auto fd = connectTo(path, SOCK_STREAM);
+    ASSERT_TRUE(sendAll(fd, "still served\n"));
+    ASSERT_TRUE(previous.wait(1));
+
+    ::close(fd);
+}
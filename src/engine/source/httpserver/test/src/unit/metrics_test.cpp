@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <httpserver/metrics.hpp>
+
+using namespace httpserver;
+using std::chrono::microseconds;
+
+TEST(RouteMetricsTest, LatencyBuckets)
+{
+    // Exact below 32 microseconds
+    for (std::uint64_t micros = 0; micros < 32; ++micros)
+    {
+        EXPECT_EQ(RouteMetrics::latencyBucket(micros), micros);
+        EXPECT_EQ(RouteMetrics::latencyUpperBound(micros), micros);
+    }
+
+    // Contiguous past them, every value within its bucket and within 1/16 of its bound
+    std::size_t previous = RouteMetrics::latencyBucket(31);
+    for (std::uint64_t micros = 32; micros < 1 << 20; ++micros)
+    {
+        const auto bucket = RouteMetrics::latencyBucket(micros);
+        ASSERT_TRUE(bucket == previous || bucket == previous + 1) << micros;
+        ASSERT_LE(micros, RouteMetrics::latencyUpperBound(bucket)) << micros;
+        ASSERT_LE(RouteMetrics::latencyUpperBound(bucket) - micros, micros / 16) << micros;
+        if (bucket > 0)
+        {
+            ASSERT_GT(micros, RouteMetrics::latencyUpperBound(bucket - 1)) << micros;
+        }
+        previous = bucket;
+    }
+
+    // Clamped to the last bucket
+    EXPECT_EQ(RouteMetrics::latencyBucket(UINT64_MAX), RouteMetrics::LATENCY_BUCKETS - 1);
+    EXPECT_EQ(RouteMetrics::latencyBucket(1ULL << 36), RouteMetrics::LATENCY_BUCKETS - 1);
+}
+
+TEST(RouteMetricsTest, Snapshot)
+{
+    RouteMetrics metrics;
+    metrics.record(200, 10, 100, microseconds(5));
+    metrics.record(200, 20, 200, microseconds(1000));
+    metrics.record(404, 0, 9, microseconds(3));
+    metrics.record(-1, 0, 0, microseconds(-1));
+
+    const auto snapshot = metrics.snapshot();
+    EXPECT_EQ(snapshot.statuses, (std::map<int, std::uint64_t> {{200, 2}, {404, 1}}));
+    EXPECT_EQ(snapshot.otherStatuses, 1);
+    EXPECT_EQ(snapshot.count(), 4);
+    EXPECT_EQ(snapshot.requestBytes, 30);
+    EXPECT_EQ(snapshot.responseBytes, 309);
+    EXPECT_EQ(snapshot.latencySum, 1008);
+}
+
+TEST(RouteMetricsTest, DistinctStatuses)
+{
+    RouteMetrics metrics;
+    for (int status = 200; status < 200 + static_cast<int>(RouteMetrics::STATUS_SLOTS) + 2; ++status)
+    {
+        metrics.record(status, 0, 0, microseconds(1));
+    }
+
+    const auto snapshot = metrics.snapshot();
+    EXPECT_EQ(snapshot.statuses.size(), RouteMetrics::STATUS_SLOTS);
+    EXPECT_EQ(snapshot.otherStatuses, 2);
+    EXPECT_EQ(snapshot.count(), RouteMetrics::STATUS_SLOTS + 2);
+}
+
+TEST(RouteMetricsTest, Quantiles)
+{
+    RouteMetrics metrics;
+    EXPECT_EQ(metrics.snapshot().quantile(0.5), microseconds(0));
+
+    for (int micros = 1; micros <= 1000; ++micros)
+    {
+        metrics.record(200, 0, 0, microseconds(micros));
+    }
+
+    const auto snapshot = metrics.snapshot();
+    auto near = [](microseconds actual, int expected)
+    {
+        return actual.count() >= expected && actual.count() <= expected + expected / 16;
+    };
+
+    EXPECT_TRUE(near(snapshot.quantile(0.5), 500)) << snapshot.quantile(0.5).count();
+    EXPECT_TRUE(near(snapshot.quantile(0.99), 990)) << snapshot.quantile(0.99).count();
+    EXPECT_TRUE(near(snapshot.quantile(1), 1000)) << snapshot.quantile(1).count();
+    EXPECT_EQ(snapshot.quantile(0), microseconds(1));
+}
+
+TEST(RouteMetricsTest, ConcurrentRecord)
+{
+    constexpr int THREADS = 12;
+    constexpr int REQUESTS = 10000;
+
+    RouteMetrics metrics;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREADS; ++i)
+    {
+        threads.emplace_back(
+            [&metrics, i]()
+            {
+                for (int j = 0; j < REQUESTS; ++j)
+                {
+                    metrics.record(i % 2 == 0 ? 200 : 500, 1, 2, microseconds(j % 100));
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    const auto snapshot = metrics.snapshot();
+    EXPECT_EQ(snapshot.statuses.at(200), THREADS / 2 * REQUESTS);
+    EXPECT_EQ(snapshot.statuses.at(500), THREADS / 2 * REQUESTS);
+    EXPECT_EQ(snapshot.requestBytes, THREADS * REQUESTS);
+    EXPECT_EQ(snapshot.responseBytes, 2 * THREADS * REQUESTS);
+
+    std::uint64_t latencies {0};
+    for (const auto requests : snapshot.latency)
+    {
+        latencies += requests;
+    }
+    EXPECT_EQ(latencies, THREADS * REQUESTS);
+}
+
+TEST(RouteMetricsTest, Prometheus)
+{
+    RouteMetrics metrics;
+    metrics.record(200, 3, 7, microseconds(20));
+
+    const auto text = toPrometheus({{RouteLabels {"api", "GET", R"(/a"\b)"}, metrics.snapshot()}});
+    const std::string labels = R"(server="api",method="GET",route="/a\"\\b")";
+
+    EXPECT_NE(text.find("# TYPE httpserver_requests_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("httpserver_requests_total{" + labels + ",code=\"200\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("httpserver_request_body_bytes_total{" + labels + "} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("httpserver_response_body_bytes_total{" + labels + "} 7\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE httpserver_request_duration_seconds summary\n"), std::string::npos);
+    EXPECT_NE(text.find("httpserver_request_duration_seconds{" + labels + ",quantile=\"0.99\"} 2e-05\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("httpserver_request_duration_seconds_sum{" + labels + "} 2e-05\n"), std::string::npos);
+    EXPECT_NE(text.find("httpserver_request_duration_seconds_count{" + labels + "} 1\n"), std::string::npos);
+    EXPECT_EQ(text.find("code=\"other\""), std::string::npos);
+}
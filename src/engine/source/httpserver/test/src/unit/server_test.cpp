@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <sys/socket.h>
+#include <sys/un.h>
+
 #include <csignal>
+#include <cstring>
+#include <future>
 
 #include <base/logger.hpp>
 #include <httpserver/server.hpp>
@@ -47,6 +52,20 @@ TEST_F(ServerTest, Create)
     EXPECT_NO_THROW(httpserver::Server server("test"));
 }
 
+TEST_F(ServerTest, CreateWithOptions)
+{
+    httpserver::ServerOptions options;
+    options.threads = 2;
+    options.queueSize = 4;
+    options.readTimeout = std::chrono::seconds(1);
+    options.payloadMaxSize = 1024;
+
+    httpserver::Server server("test", options);
+
+    EXPECT_NO_THROW(server.start(getSocketPath("test.sock")));
+    EXPECT_NO_THROW(server.stop());
+}
+
 TEST_F(ServerTest, StartEmptySocketPath)
 {
     httpserver::Server server("test");
@@ -143,3 +162,335 @@ TEST_F(ServerTest, IsRunning)
     EXPECT_NO_THROW(server.stop());
     EXPECT_FALSE(server.isRunning());
 }
+
+TEST_F(ServerTest, RouteDispatch)
+{
+    httpserver::Server server("test");
+    auto route = [](std::string body)
+    {
+        return [body](const httplib::Request&, httplib::Response& res) { res.set_content(body, "text/plain"); };
+    };
+
+    server.addRoute(httpserver::Method::GET, "/api/item", route("exact"));
+    server.addRoute(httpserver::Method::GET, "/api/item/[0-9]+", route("number"));
+    server.addRoute(httpserver::Method::GET, "/api/.*", route("any"));
+    server.addRoute(httpserver::Method::POST, "/api/item", route("post"));
+    server.addRoute(httpserver::Method::POST,
+                    "/api/echo",
+                    [](const httplib::Request& req, httplib::Response& res) { res.set_content(req.body, "text/plain"); });
+    // Replaces the first one
+    server.addRoute(httpserver::Method::GET, "/api/item", route("replaced"));
+
+    auto socketPath = getSocketPath("test.sock");
+    server.start(socketPath);
+
+    httplib::Client client(socketPath.string());
+    client.set_address_family(AF_UNIX);
+
+    auto body = [&](const httplib::Result& result)
+    {
+        EXPECT_TRUE(result);
+        return result ? result->body : std::string {};
+    };
+
+    EXPECT_EQ(body(client.Get("/api/item")), "replaced");
+    EXPECT_EQ(body(client.Get("/api/item/42")), "number");
+    EXPECT_EQ(body(client.Get("/api/item/x")), "any");
+    EXPECT_EQ(body(client.Post("/api/item", "", "text/plain")), "post");
+
+    // Exact routes are served before httplib routing only without a body, the others get it read
+    EXPECT_EQ(body(client.Post("/api/echo", "payload", "text/plain")), "payload");
+    EXPECT_EQ(body(client.Post("/api/echo", "", "text/plain")), "");
+
+    auto missing = client.Get("/other");
+    ASSERT_TRUE(missing);
+    EXPECT_EQ(missing->status, httplib::StatusCode::NotFound_404);
+
+    missing = client.Put("/api/item", "", "text/plain");
+    ASSERT_TRUE(missing);
+    EXPECT_EQ(missing->status, httplib::StatusCode::NotFound_404);
+
+    server.stop();
+}
+
+TEST_F(ServerTest, AddInvalidRoute)
+{
+    httpserver::Server server("test");
+    auto handler = [](const httplib::Request&, httplib::Response&) {};
+
+    EXPECT_THROW(server.addRoute(httpserver::Method::GET, "/api/[", handler), std::runtime_error);
+    EXPECT_THROW(server.addRoute(httpserver::Method::ERROR_METHOD, "/api", handler), std::runtime_error);
+}
+
+TEST_F(ServerTest, ResponseEncoding)
+{
+    httpserver::ServerOptions options;
+    options.compressionMinSize = 64;
+    httpserver::Server server("test", options);
+
+    const std::string large = R"({"item":")" + std::string(256, 'x') + R"("})";
+    server.addRoute(httpserver::Method::GET,
+                    "/large",
+                    [&large](const httplib::Request&, httplib::Response& res)
+                    { res.set_content(large, "application/json"); });
+    server.addRoute(httpserver::Method::GET,
+                    "/small",
+                    [](const httplib::Request&, httplib::Response& res)
+                    { res.set_content(R"({"a":1})", "application/json"); });
+
+    auto socketPath = getSocketPath("test.sock");
+    server.start(socketPath);
+
+    httplib::Client client(socketPath.string());
+    client.set_address_family(AF_UNIX);
+    client.set_decompress(false);
+
+    // Compact and uncompressed unless asked for
+    auto result = client.Get("/large");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->body, large);
+    EXPECT_FALSE(result->has_header("Content-Encoding"));
+
+    result = client.Get("/small?pretty");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->body, "{\n    \"a\": 1\n}");
+
+    result = client.Get("/large", {{"Accept-Encoding", "gzip"}});
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->get_header_value("Content-Encoding"), "gzip");
+    EXPECT_EQ(result->get_header_value("Vary"), "Accept-Encoding");
+    EXPECT_LT(result->body.size(), large.size());
+
+    result = client.Get("/large", {{"Accept-Encoding", "gzip, zstd"}});
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->get_header_value("Content-Encoding"), "zstd");
+
+    // Below the threshold
+    result = client.Get("/small", {{"Accept-Encoding", "gzip"}});
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->body, R"({"a":1})");
+    EXPECT_FALSE(result->has_header("Content-Encoding"));
+
+    server.stop();
+}
+
+TEST_F(ServerTest, Metrics)
+{
+    httpserver::Server server("test");
+    server.addRoute(httpserver::Method::POST,
+                    "/echo",
+                    [](const httplib::Request& req, httplib::Response& res) { res.set_content(req.body, "text/plain"); });
+    server.addRoute(httpserver::Method::GET,
+                    "/item/[0-9]+",
+                    [](const httplib::Request&, httplib::Response& res)
+                    { res.status = httplib::StatusCode::NotFound_404; });
+    server.addRoute(httpserver::Method::GET,
+                    "/fail",
+                    [](const httplib::Request&, httplib::Response&) { throw std::runtime_error("fail"); });
+    server.addMetricsRoute();
+
+    auto socketPath = getSocketPath("test.sock");
+    server.start(socketPath);
+
+    httplib::Client client(socketPath.string());
+    client.set_address_family(AF_UNIX);
+
+    ASSERT_TRUE(client.Post("/echo", "hello", "text/plain"));
+    ASSERT_TRUE(client.Post("/echo", "world", "text/plain"));
+    ASSERT_TRUE(client.Get("/item/1"));
+    ASSERT_TRUE(client.Get("/item/2"));
+    ASSERT_TRUE(client.Get("/fail"));
+    ASSERT_TRUE(client.Get("/unknown"));
+
+    auto result = client.Get("/metrics");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->status, httplib::StatusCode::OK_200);
+    EXPECT_EQ(result->get_header_value("Content-Type"), "text/plain; version=0.0.4; charset=utf-8");
+
+    const auto& text = result->body;
+    EXPECT_NE(text.find(R"(httpserver_requests_total{server="test",method="POST",route="/echo",code="200"} 2)"),
+              std::string::npos);
+    EXPECT_NE(text.find(R"(httpserver_request_body_bytes_total{server="test",method="POST",route="/echo"} 10)"),
+              std::string::npos);
+    EXPECT_NE(text.find(R"(httpserver_response_body_bytes_total{server="test",method="POST",route="/echo"} 10)"),
+              std::string::npos);
+
+    // By route, not by path
+    EXPECT_NE(
+        text.find(R"(httpserver_requests_total{server="test",method="GET",route="/item/[0-9]+",code="404"} 2)"),
+        std::string::npos);
+    EXPECT_NE(text.find(R"(httpserver_requests_total{server="test",method="GET",route="/fail",code="500"} 1)"),
+              std::string::npos);
+    EXPECT_NE(text.find(R"(httpserver_request_duration_seconds_count{server="test",method="GET",route="/fail"} 1)"),
+              std::string::npos);
+    EXPECT_EQ(text.find("/unknown"), std::string::npos);
+
+    server.stop();
+}
+
+TEST_F(ServerTest, StreamingRoute)
+{
+    httpserver::Server server("test");
+
+    std::size_t largestChunk {0};
+    server.addStreamingRoute(httpserver::Method::POST,
+                             "/upload",
+                             [&largestChunk](const httplib::Request& req,
+                                             httplib::Response& res,
+                                             const httplib::ContentReader& content)
+                             {
+                                 std::size_t received {0};
+                                 content(
+                                     [&](const char*, size_t size)
+                                     {
+                                         received += size;
+                                         largestChunk = std::max(largestChunk, size);
+                                         return true;
+                                     });
+
+                                 // Never buffered
+                                 EXPECT_TRUE(req.body.empty());
+                                 res.set_content(std::to_string(received), "text/plain");
+                             });
+
+    EXPECT_THROW(server.addStreamingRoute(httpserver::Method::GET, "/upload", nullptr), std::runtime_error);
+
+    server.addMetricsRoute();
+
+    auto socketPath = getSocketPath("test.sock");
+    server.start(socketPath);
+
+    httplib::Client client(socketPath.string());
+    client.set_address_family(AF_UNIX);
+
+    const std::string body(4 * 1024 * 1024, 'x');
+    auto result = client.Post("/upload", body, "application/x-ndjson");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->body, std::to_string(body.size()));
+    EXPECT_LT(largestChunk, body.size());
+
+    // Without a body, nothing to read
+    result = client.Post("/upload");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->body, "0");
+
+    result = client.Get("/metrics");
+    ASSERT_TRUE(result);
+    EXPECT_NE(result->body.find(R"(httpserver_requests_total{server="test",method="POST",route="/upload",code="200"} 2)"),
+              std::string::npos);
+    EXPECT_NE(result->body.find(fmt::format(
+                  R"(httpserver_request_body_bytes_total{{server="test",method="POST",route="/upload"}} {})", body.size())),
+              std::string::npos);
+
+    server.stop();
+}
+
+TEST_F(ServerTest, StreamingRoutePayloadLimit)
+{
+    httpserver::ServerOptions options;
+    options.payloadMaxSize = 1024;
+    options.streamingPayloadMaxSize = 8192;
+    httpserver::Server server("test", options);
+
+    server.addRoute(httpserver::Method::POST,
+                    "/echo",
+                    [](const httplib::Request& req, httplib::Response& res)
+                    { res.set_content(std::to_string(req.body.size()), "text/plain"); });
+    server.addStreamingRoute(httpserver::Method::POST,
+                             "/upload",
+                             [](const httplib::Request&, httplib::Response& res, const httplib::ContentReader& content)
+                             {
+                                 std::size_t received {0};
+                                 content(
+                                     [&](const char*, size_t size)
+                                     {
+                                         received += size;
+                                         return true;
+                                     });
+                                 res.set_content(std::to_string(received), "text/plain");
+                             });
+
+    auto socketPath = getSocketPath("test.sock");
+    server.start(socketPath);
+
+    httplib::Client client(socketPath.string());
+    client.set_address_family(AF_UNIX);
+
+    auto result = client.Post("/echo", std::string(512, 'x'), "text/plain");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->body, "512");
+
+    // The payload limit still applies to the buffered routes, the streaming one has its own
+    result = client.Post("/echo", std::string(2048, 'x'), "text/plain");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->status, httplib::StatusCode::PayloadTooLarge_413);
+
+    result = client.Post("/upload", std::string(4096, 'x'), "text/plain");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->body, "4096");
+
+    result = client.Post("/upload", std::string(16384, 'x'), "text/plain");
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->status, httplib::StatusCode::PayloadTooLarge_413);
+
+    server.stop();
+}
+
+TEST_F(ServerTest, SilentRejectedClientDoesNotBlockAccept)
+{
+    httpserver::ServerOptions options;
+    options.threads = 1;
+    options.queueSize = 1;
+    options.readTimeout = std::chrono::seconds(5);
+    httpserver::Server server("test", options);
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    server.addRoute(httpserver::Method::GET,
+                    "/slow",
+                    [released](const httplib::Request&, httplib::Response& res)
+                    {
+                        released.wait();
+                        res.set_content("slow", "text/plain");
+                    });
+    server.addRoute(httpserver::Method::GET,
+                    "/fast",
+                    [](const httplib::Request&, httplib::Response& res) { res.set_content("fast", "text/plain"); });
+
+    auto socketPath = getSocketPath("test.sock");
+    server.start(socketPath);
+
+    auto get = [socketPath](const std::string& path)
+    {
+        httplib::Client client(socketPath.string());
+        client.set_address_family(AF_UNIX);
+        auto result = client.Get(path);
+        return result ? result->body : std::string {};
+    };
+
+    // One request holds the worker, one fills the queue
+    auto busy = std::async(std::launch::async, get, "/slow");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto queued = std::async(std::launch::async, get, "/slow");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // Rejected, and never sends its request
+    const auto silent = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    ASSERT_EQ(::connect(silent, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    release.set_value();
+    EXPECT_EQ(busy.get(), "slow");
+    EXPECT_EQ(queued.get(), "slow");
+
+    // Accepted and served while the silent client is still being read
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(get("/fast"), "fast");
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+    ::close(silent);
+    server.stop();
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include <httpserver/taskQueue.hpp>
+
+using namespace httpserver;
+
+namespace
+{
+
+/**
+ * @brief Holds the workers busy until released.
+ */
+struct Gate
+{
+    std::promise<void> promise;
+    std::shared_future<void> future {promise.get_future().share()};
+
+    std::function<void()> task()
+    {
+        return [future = future]() { future.wait(); };
+    }
+
+    void open() { promise.set_value(); }
+};
+
+void waitPending(const BoundedTaskQueue& queue, std::size_t count)
+{
+    for (int i = 0; i < 1000 && queue.pending() != count; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+} // namespace
+
+TEST(BoundedTaskQueueTest, RunsTasks)
+{
+    std::atomic<int> done {0};
+
+    {
+        BoundedTaskQueue queue(4, 0);
+        for (int i = 0; i < 100; ++i)
+        {
+            ASSERT_TRUE(queue.enqueue([&done]() { ++done; }));
+        }
+    }
+
+    // Pending tasks are run before the workers exit
+    EXPECT_EQ(done, 100);
+}
+
+TEST(BoundedTaskQueueTest, FullRejectsOnRejectionThread)
+{
+    BoundedTaskQueue queue(1, 2);
+    Gate gate;
+
+    // One task holds the worker, two more fill the queue
+    ASSERT_TRUE(queue.enqueue(gate.task()));
+    waitPending(queue, 0);
+    ASSERT_TRUE(queue.enqueue(gate.task()));
+    ASSERT_TRUE(queue.enqueue(gate.task()));
+    ASSERT_EQ(queue.pending(), 2);
+
+    std::promise<std::pair<bool, std::thread::id>> rejected;
+    ASSERT_TRUE(queue.enqueue(
+        [&rejected]() { rejected.set_value({BoundedTaskQueue::isRejecting(), std::this_thread::get_id()}); }));
+
+    const auto [rejecting, thread] = rejected.get_future().get();
+    EXPECT_TRUE(rejecting);
+    EXPECT_NE(thread, std::this_thread::get_id());
+    EXPECT_FALSE(BoundedTaskQueue::isRejecting());
+
+    gate.open();
+}
+
+TEST(BoundedTaskQueueTest, SilentRejectedDoesNotBlockEnqueue)
+{
+    BoundedTaskQueue queue(1, 1);
+    Gate workers;
+    Gate silent;
+
+    ASSERT_TRUE(queue.enqueue(workers.task()));
+    waitPending(queue, 0);
+    ASSERT_TRUE(queue.enqueue(workers.task()));
+
+    // A rejected client that never sends its request holds the rejection thread, not the caller
+    const auto start = std::chrono::steady_clock::now();
+    std::promise<void> reading;
+    ASSERT_TRUE(queue.enqueue(
+        [&reading, task = silent.task()]()
+        {
+            reading.set_value();
+            task();
+        }));
+    reading.get_future().wait();
+
+    for (std::size_t i = 0; i < BoundedTaskQueue::MAX_REJECTED; ++i)
+    {
+        ASSERT_TRUE(queue.enqueue([]() {}));
+    }
+
+    // Past the rejection backlog the connection is closed unanswered
+    EXPECT_FALSE(queue.enqueue([]() {}));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+    // Served again once the workers are free
+    workers.open();
+    waitPending(queue, 0);
+    std::promise<bool> served;
+    ASSERT_TRUE(queue.enqueue([&served]() { served.set_value(BoundedTaskQueue::isRejecting()); }));
+    EXPECT_FALSE(served.get_future().get());
+
+    silent.open();
+}
+
+TEST(BoundedTaskQueueTest, QueuedNotRejecting)
+{
+    std::promise<bool> rejecting;
+
+    BoundedTaskQueue queue(1, 1);
+    ASSERT_TRUE(queue.enqueue([&rejecting]() { rejecting.set_value(BoundedTaskQueue::isRejecting()); }));
+
+    EXPECT_FALSE(rejecting.get_future().get());
+}
+
+TEST(BoundedTaskQueueTest, EnqueueAfterShutdown)
+{
+    BoundedTaskQueue queue(2, 0);
+    queue.shutdown();
+
+    bool run {false};
+    EXPECT_FALSE(queue.enqueue([&run]() { run = true; }));
+    EXPECT_FALSE(run);
+
+    EXPECT_NO_THROW(queue.shutdown());
+}
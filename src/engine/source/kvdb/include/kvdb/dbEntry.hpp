@@ -0,0 +1,49 @@
+#ifndef _KVDB_DBENTRY_HPP
+#define _KVDB_DBENTRY_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <utility>
+
+#include <kvdb/dbStats.hpp>
+#include <kvdb/staticTable.hpp>
+
+// Forward declaration for RocksDB types used
+namespace rocksdb
+{
+class ColumnFamilyHandle;
+} // namespace rocksdb
+
+namespace kvdbManager
+{
+
+/**
+ * @brief Class to hold the needed information for a database (column family).
+ */
+class DbEntry
+{
+public:
+    std::shared_ptr<rocksdb::ColumnFamilyHandle> cfHandle; ///< The column family of the database.
+    std::atomic<int64_t> ttl {0}; ///< Default TTL in seconds of new entries, 0 if they never expire.
+    std::atomic<bool> isStatic {false}; ///< Static (read-only) mode, writes are rejected.
+    std::shared_mutex staticMutex; ///< Shared by a write from its isStatic check to its end, exclusive to switch modes.
+    std::shared_ptr<const StaticTable> staticTable; ///< Set in static mode, only accessed with std::atomic_load/store.
+    DbStats stats; ///< Operation counts and latencies of the handlers.
+
+    explicit DbEntry(std::shared_ptr<rocksdb::ColumnFamilyHandle> cfHandle, int64_t ttl = 0)
+        : cfHandle(std::move(cfHandle))
+        , ttl(ttl)
+    {
+    }
+
+    DbEntry(const DbEntry&) = delete;
+    DbEntry& operator=(const DbEntry&) = delete;
+    DbEntry(DbEntry&&) = delete;
+    DbEntry& operator=(DbEntry&&) = delete;
+};
+
+} // namespace kvdbManager
+
+#endif // _KVDB_DBENTRY_HPP
@@ -0,0 +1,113 @@
+#ifndef _KVDB_DBSTATS_HPP
+#define _KVDB_DBSTATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace kvdbManager
+{
+
+/**
+ * @brief Operations timed per DB.
+ */
+enum class DbOp : uint8_t
+{
+    GET = 0, ///< get and contains
+    PUT,     ///< set, add and merges
+    REMOVE,  ///< remove
+    ITERATE, ///< dump, search and export
+};
+
+constexpr std::size_t DB_OP_COUNT {4};
+
+/**
+ * @brief Name of an operation as reported by the stats.
+ */
+const char* dbOpName(DbOp op);
+
+/**
+ * @brief Lock free latency histogram with power of two buckets.
+ *
+ * Bucket 0 counts latencies under 1ns and bucket i latencies in [2^(i-1), 2^i) ns, so percentiles are reported as
+ * the upper bound of their bucket (at most 2x the real value). Recording is a few relaxed atomic increments.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr std::size_t BUCKETS {40}; ///< Up to ~9 minutes, longer latencies go to the last bucket
+
+    /**
+     * @brief Record one operation.
+     */
+    void record(std::chrono::nanoseconds elapsed) noexcept;
+
+    /**
+     * @brief Number of recorded operations.
+     */
+    uint64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Sum of the recorded latencies in nanoseconds.
+     */
+    uint64_t sum() const noexcept { return sum_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Upper bound in nanoseconds of the bucket holding the given percentile, 0 if nothing was recorded.
+     *
+     * @param percentile Value in [0, 100].
+     */
+    uint64_t percentile(double percentile) const noexcept;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_ {};
+    std::atomic<uint64_t> count_ {0};
+    std::atomic<uint64_t> sum_ {0};
+};
+
+/**
+ * @brief Operation counts and latencies of a DB.
+ */
+class DbStats
+{
+public:
+    /**
+     * @brief Times the operation for as long as it is alive.
+     */
+    class Timer
+    {
+    public:
+        Timer(DbStats& stats, DbOp op)
+            : stats_ {stats}
+            , op_ {op}
+            , start_ {std::chrono::steady_clock::now()}
+        {
+        }
+
+        ~Timer() { stats_.record(op_, std::chrono::steady_clock::now() - start_); }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        DbStats& stats_;
+        DbOp op_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    void record(DbOp op, std::chrono::nanoseconds elapsed) noexcept
+    {
+        histograms_[static_cast<std::size_t>(op)].record(elapsed);
+    }
+
+    const LatencyHistogram& histogram(DbOp op) const noexcept { return histograms_[static_cast<std::size_t>(op)]; }
+
+private:
+    std::array<LatencyHistogram, DB_OP_COUNT> histograms_ {};
+};
+
+} // namespace kvdbManager
+
+#endif // _KVDB_DBSTATS_HPP
@@ -1,8 +1,10 @@
 #ifndef _KVDB_HANDLER_HPP
 #define _KVDB_HANDLER_HPP
 
+#include <kvdb/dbEntry.hpp>
 #include <kvdb/ikvdbhandler.hpp>
 #include <kvdb/ikvdbhandlercollection.hpp>
+#include <kvdb/kvdbMerge.hpp>
 
 #include <rocksdb/slice.h>
 
@@ -10,7 +12,6 @@
 namespace rocksdb
 {
 class DB;
-class ColumnFamilyHandle;
 } // namespace rocksdb
 
 namespace kvdbManager
@@ -22,8 +23,9 @@ class KVDBHandler : public IKVDBHandler
 {
 public:
     KVDBHandler(std::weak_ptr<rocksdb::DB> weakDB,
-                std::weak_ptr<rocksdb::ColumnFamilyHandle> weakCFHandle,
+                std::weak_ptr<DbEntry> weakEntry,
                 std::shared_ptr<IKVDBHandlerCollection> collection,
+                RefId refId,
                 const std::string& dbName,
                 const std::string& scopeName);
 
@@ -33,8 +35,16 @@ public:
 
     base::OptError set(const std::string& key, const json::Json& value) override;
 
+    base::OptError set(const std::string& key, const std::string& value, std::chrono::seconds ttl) override;
+
+    base::OptError setBatch(const std::vector<std::pair<std::string, std::string>>& entries) override;
+
     base::OptError add(const std::string& key) override;
 
+    base::OptError increment(const std::string& key, int64_t delta) override;
+
+    base::OptError appendToSet(const std::string& key, const std::string& value) override;
+
     base::OptError remove(const std::string& key) override;
 
     base::RespOrError<bool> contains(const std::string& key) override;
@@ -47,14 +57,21 @@ public:
     base::RespOrError<std::list<std::pair<std::string, std::string>>>
     search(const std::string& prefix, const unsigned int page, const unsigned int records) override;
 
+    base::OptError exportEntries(const EntryVisitor& visitor) override;
+
 protected:
     std::weak_ptr<rocksdb::DB> weakDB_;
-    std::weak_ptr<rocksdb::ColumnFamilyHandle> weakCFHandle_;
+    std::weak_ptr<DbEntry> weakEntry_;
     std::string dbName_;
     std::string scopeName_;
     std::shared_ptr<IKVDBHandlerCollection> spCollection_;
+    RefId refId_; ///< Interned (DB, scope) counter released on destruction
 
 private:
+    base::OptError put(const std::string& key, const std::string& value, int64_t expiresAt);
+
+    base::OptError mergeOperand(const std::string& key, merge::Op op, std::string_view payload);
+
     base::RespOrError<std::list<std::pair<std::string, std::string>>>
     pageContent(const unsigned int page,
                 const unsigned int records);
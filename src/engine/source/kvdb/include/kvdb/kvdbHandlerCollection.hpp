@@ -1,59 +1,104 @@
 #ifndef _KVDB_HANDLER_COLLECTION_HPP
 #define _KVDB_HANDLER_COLLECTION_HPP
 
+#include <array>
+#include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
-#include <set>
 #include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <kvdb/ikvdbhandlercollection.hpp>
-#include <kvdb/kvdbHandler.hpp>
 #include <kvdb/refCounter.hpp>
 
 namespace kvdbManager
 {
 
 /**
- * @brief Helper class to manage the reference counters for a given DB.
- * This is used to track how many scopes are using a given DB.
+ * @brief Tracks how many handlers are alive for every (DB, scope) pair.
+ *
+ * Each pair is interned into a RefCounter slot addressed by a RefId. Slots are stored in fixed
+ * size chunks that are never moved, so addRef/removeRef are a single relaxed atomic operation.
+ * The slots of a DB are released when it is deleted and reused by later pairs, so the number of
+ * slots is bounded by the pairs in use, not by every pair ever seen. The intern index is grouped
+ * by DB, a DB is counted without walking the slots of the others.
  */
-class KVDBHandlerInstance
+class KVDBHandlerCollection : public IKVDBHandlerCollection
 {
 public:
-    void addScope(const std::string& scopeName);
-
-    void removeScope(const std::string& scopeName);
-
-    bool emptyScopes();
-
-    std::vector<std::string> getRefNames();
-
-    std::map<std::string, uint32_t> getRefMap();
+    static constexpr std::size_t CHUNK_BITS = 8;
+    static constexpr std::size_t CHUNK_SIZE = std::size_t{1} << CHUNK_BITS;
+    static constexpr std::size_t MAX_CHUNKS = 1024; ///< Up to 262144 (DB, scope) pairs interned at once
+
+    KVDBHandlerCollection() = default;
+
+    ~KVDBHandlerCollection() override;
+
+    KVDBHandlerCollection(const KVDBHandlerCollection&) = delete;
+    KVDBHandlerCollection& operator=(const KVDBHandlerCollection&) = delete;
+
+    RefId getRefId(const std::string& dbName, const std::string& scopeName) override;
+
+    void addRef(RefId id) override;
+
+    void removeRef(RefId id) override;
+
+    /**
+     * @brief Get the id of a (DB, scope) pair and add a reference to it, as one step.
+     *
+     * Unlike getRefId followed by addRef, the slot cannot be released in between.
+     *
+     * @param dbName DB name.
+     * @param scopeName Scope name.
+     * @return RefId
+     */
+    RefId acquire(const std::string& dbName, const std::string& scopeName);
+
+    /**
+     * @brief Release the slots of a deleted DB that no handler is using, for reuse by other pairs.
+     *
+     * @param dbName DB name.
+     */
+    void release(const std::string& dbName);
+
+    /**
+     * @brief Visit every interned counter. Counters may be updated concurrently while visited.
+     *
+     * @param visitor Function called once per interned (DB, scope) pair.
+     */
+    void visitRefs(const std::function<void(const RefCounter&)>& visitor) const;
+
+    /**
+     * @brief Visit the interned counters of a DB. Counters may be updated concurrently while visited.
+     *
+     * @param dbName DB name.
+     * @param visitor Function called once per interned scope of the DB.
+     */
+    void visitRefs(const std::string& dbName, const std::function<void(const RefCounter&)>& visitor) const;
 
 private:
-    RefCounter scopeCounter_;
-
-    std::shared_mutex mutex_;
-};
-
-class KVDBHandlerCollection : public IKVDBHandlerCollection
-{
-public:
-    ~KVDBHandlerCollection() override = default;
+    struct Chunk
+    {
+        std::array<std::unique_ptr<RefCounter>, CHUNK_SIZE> slots;
+    };
 
-    void addKVDBHandler(const std::string &dbName, const std::string& scopeName) override;
+    const RefId* find(const std::string& dbName, const std::string& scopeName) const;
 
-    void removeKVDBHandler(const std::string& dbName, const std::string& scopeName) override;
+    RefId intern(const std::string& dbName, const std::string& scopeName);
 
-    std::vector<std::string> getDBNames();
+    std::unique_ptr<RefCounter>& slotPtr(RefId id) const;
 
-    std::map<std::string, uint32_t> getRefMap(const std::string& dbName);
+    RefCounter& slot(RefId id) const;
 
-private:
-    
-    std::map<std::string, std::shared_ptr<KVDBHandlerInstance>> mapInstances_;
+    std::array<std::atomic<Chunk*>, MAX_CHUNKS> chunks_{}; ///< Written once under mutex_
+    RefId size_{0};                                        ///< Number of slots ever allocated
+    std::vector<RefId> free_;                              ///< Released slots, reused first
 
-    std::shared_mutex mutex_;
+    std::map<std::string, std::map<std::string, RefId>> index_; ///< Intern table DB -> scope -> id
+    mutable std::shared_mutex mutex_;                            ///< Protects index_, free_ and the slots
 };
 
 } // namespace kvdbManager
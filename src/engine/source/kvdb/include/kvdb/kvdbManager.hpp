@@ -4,20 +4,32 @@
 #include <atomic>
 #include <filesystem>
 #include <map>
+#include <memory>
 #include <mutex>
 
 #include <rocksdb/db.h>
 #include <rocksdb/options.h>
 
 #include <base/error.hpp>
+#include <kvdb/dbEntry.hpp>
 #include <kvdb/ikvdbmanager.hpp>
 #include <kvdb/kvdbHandler.hpp>
 #include <kvdb/kvdbHandlerCollection.hpp>
+#include <kvdb/kvdbMerge.hpp>
+#include <kvdb/kvdbTTL.hpp>
+#include <kvdb/staticKVDBHandler.hpp>
 
 namespace kvdbManager
 {
 
 constexpr static const char* DEFAULT_CF_NAME {"default"};
+constexpr static const char* TTL_META_PREFIX {"ttl/"}; ///< Key prefix of the DB TTLs stored in the default CF
+constexpr static const char* STATIC_META_PREFIX {"static/"}; ///< Key prefix of the DBs in static mode
+
+/**
+ * @brief Immutable snapshot of the DB entries indexed by DB name.
+ */
+using DbEntryMap = std::map<std::string, std::shared_ptr<DbEntry>>;
 
 struct KVDBManagerOptions
 {
@@ -56,12 +68,20 @@ public:
 
     base::OptError createDB(const std::string& name) override;
 
-    base::OptError createDB(const std::string& name, const std::string& path) override;
+    base::OptError createDB(const std::string& name, const std::string& path, std::chrono::seconds ttl) override;
 
     base::OptError loadDBFromJson(const std::string& name, const json::Json& content) override;
 
     bool existsDB(const std::string& name) override;
 
+    base::OptError setDBTTL(const std::string& name, std::chrono::seconds ttl) override;
+
+    base::RespOrError<std::chrono::seconds> getDBTTL(const std::string& name) override;
+
+    base::OptError setStaticMode(const std::string& name, bool enabled) override;
+
+    json::Json getStats() override;
+
 private:
 
     void initializeOptions();
@@ -77,19 +97,72 @@ private:
 
     base::OptError createColumnFamily(const std::string& name);
 
+    /**
+     * @brief Read the default TTL of a DB persisted in the default column family.
+     *
+     * @param name DB name.
+     * @return int64_t TTL in seconds, 0 if not set.
+     */
+    int64_t readDBTTL(const std::string& name);
+
+    /**
+     * @brief Check if a DB is marked as static in the default column family.
+     */
+    bool readStaticMode(const std::string& name);
+
+    /**
+     * @brief Build the static table of a DB from its live entries.
+     *
+     * @param name DB name.
+     * @param entry DB entry.
+     * @return base::RespOrError<std::shared_ptr<const StaticTable>>
+     */
+    base::RespOrError<std::shared_ptr<const StaticTable>> buildStaticTable(const std::string& name,
+                                                                          const DbEntry& entry);
+
+    /**
+     * @brief Get the current snapshot of the DB entries.
+     *
+     * Lock-free, the returned snapshot is never modified once published.
+     *
+     * @return std::shared_ptr<const DbEntryMap>
+     */
+    std::shared_ptr<const DbEntryMap> getDbEntries() const;
+
+    /**
+     * @brief Get the entry of a DB from the current snapshot.
+     *
+     * @param name DB name.
+     * @return std::shared_ptr<DbEntry> nullptr if the DB does not exist.
+     */
+    std::shared_ptr<DbEntry> getDbEntry(const std::string& name) const;
+
+    /**
+     * @brief Publish a new snapshot of the DB entries.
+     *
+     * @note Must be called with mutexDbEntries_ held.
+     *
+     * @param dbEntries New snapshot.
+     */
+    void publishDbEntries(std::shared_ptr<const DbEntryMap> dbEntries);
+
     std::shared_ptr<KVDBHandlerCollection> kvdbHandlerCollection_;
     
     KVDBManagerOptions managerOptions_;
 
     rocksdb::Options rocksDBOptions_;
 
+    rocksdb::ColumnFamilyOptions cfOptions_; ///< Options of every DB column family
+
+    ttl::CompactionFilter ttlCompactionFilter_; ///< Drops expired entries, referenced by cfOptions_
+
     std::shared_ptr<rocksdb::DB> pRocksDB_;
 
-    std::map<std::string, std::shared_ptr<rocksdb::ColumnFamilyHandle>> mapCFHandles_;
+    std::shared_ptr<const DbEntryMap> dbEntries_; ///< RCU snapshot, only accessed with std::atomic_load/store.
 
     std::shared_ptr<rocksdb::ColumnFamilyHandle> pDefaultCFHandle_;
 
-    std::mutex mutexScopes_;
+    std::mutex mutexDbEntries_; ///< Serializes writers of dbEntries_ (copy on write).
 
     std::atomic<bool> isInitialized_{false};
 };
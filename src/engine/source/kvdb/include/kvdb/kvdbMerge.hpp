@@ -0,0 +1,52 @@
+#ifndef _KVDB_MERGE_HPP
+#define _KVDB_MERGE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <rocksdb/merge_operator.h>
+
+namespace kvdbManager::merge
+{
+
+/**
+ * @brief Kind of merge operand.
+ */
+enum class Op : char
+{
+    INCREMENT = 'I', ///< Payload is the decimal delta, the value is a JSON integer
+    APPEND = 'A'     ///< Payload is the element, the value is a JSON array of unique strings
+};
+
+/**
+ * @brief Encode a merge operand.
+ *
+ * Operands are tag + 8 byte big endian expiration time + payload. The expiration is only used when the merge creates
+ * the value (missing or expired), otherwise the expiration of the existing value is kept.
+ *
+ * @param op Kind of operand.
+ * @param payload Operand payload.
+ * @param expiresAt Expiration time in seconds since epoch of a newly created value, 0 if it never expires.
+ * @return std::string
+ */
+std::string encodeOperand(Op op, std::string_view payload, int64_t expiresAt);
+
+/**
+ * @brief Merge operator implementing atomic counters and sets over TTL encoded values.
+ *
+ * A value of the wrong kind (e.g. incrementing a string) is replaced by the result of applying the operand to an
+ * empty value, and a malformed operand is skipped, so a bad write never leaves the key unreadable. Counters saturate
+ * at the int64 limits.
+ */
+class MergeOperator : public rocksdb::MergeOperator
+{
+public:
+    bool FullMergeV2(const MergeOperationInput& mergeIn, MergeOperationOutput* mergeOut) const override;
+
+    const char* Name() const override;
+};
+
+} // namespace kvdbManager::merge
+
+#endif // _KVDB_MERGE_HPP
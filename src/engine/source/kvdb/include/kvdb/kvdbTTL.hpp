@@ -0,0 +1,79 @@
+#ifndef _KVDB_TTL_HPP
+#define _KVDB_TTL_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <rocksdb/compaction_filter.h>
+
+namespace kvdbManager::ttl
+{
+
+/**
+ * @brief Marker prepended to values stored with an expiration time.
+ *
+ * Stored values are either the raw value (never expires) or MAGIC + 8 byte big endian expiration time in seconds
+ * since epoch + raw value. Raw values that happen to start with MAGIC are always stored with a header so decoding is
+ * never ambiguous.
+ */
+constexpr std::string_view MAGIC {"\0TTL\1", 5};
+constexpr std::size_t HEADER_SIZE {MAGIC.size() + sizeof(uint64_t)};
+
+/**
+ * @brief Decoded view of a stored value. Points into the buffer passed to decode().
+ */
+struct Value
+{
+    std::string_view payload; ///< User value
+    int64_t expiresAt;        ///< Expiration time in seconds since epoch, 0 if it never expires
+};
+
+/**
+ * @brief Current time in seconds since epoch.
+ */
+int64_t now();
+
+/**
+ * @brief Encode a value to be stored with an expiration time.
+ *
+ * @param value User value.
+ * @param expiresAt Expiration time in seconds since epoch, 0 if it never expires.
+ * @return std::string The value to store.
+ */
+std::string encode(std::string_view value, int64_t expiresAt);
+
+/**
+ * @brief Decode a stored value.
+ *
+ * @param stored The stored value.
+ * @return Value
+ */
+Value decode(std::string_view stored);
+
+/**
+ * @brief Check if a decoded value is expired at the given time.
+ */
+inline bool isExpired(const Value& value, int64_t at)
+{
+    return value.expiresAt != 0 && value.expiresAt <= at;
+}
+
+/**
+ * @brief Compaction filter that physically drops expired values.
+ */
+class CompactionFilter : public rocksdb::CompactionFilter
+{
+public:
+    bool Filter(int level,
+                const rocksdb::Slice& key,
+                const rocksdb::Slice& existingValue,
+                std::string* newValue,
+                bool* valueChanged) const override;
+
+    const char* Name() const override;
+};
+
+} // namespace kvdbManager::ttl
+
+#endif // _KVDB_TTL_HPP
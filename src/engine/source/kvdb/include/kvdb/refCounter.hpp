@@ -1,36 +1,46 @@
 #ifndef _KVDB_REF_COUNTER_HPP
 #define _KVDB_REF_COUNTER_HPP
 
+#include <atomic>
 #include <cstdint>
-#include <map>
 #include <string>
-#include <vector>
 
 namespace kvdbManager
 {
 
+/**
+ * @brief Reference counter of the handlers in use for a given (DB, scope) pair.
+ *
+ * Counters are allocated per pair by the KVDBHandlerCollection and only freed once their DB is
+ * deleted and no handler uses them, so handlers can update them without taking any lock.
+ */
 class RefCounter
 {
 public:
-    RefCounter() = default;
+    RefCounter(std::string dbName, std::string scopeName)
+        : dbName_{std::move(dbName)}
+        , scopeName_{std::move(scopeName)}
+    {
+    }
 
-    ~RefCounter() { refMap_.clear(); }
+    RefCounter(const RefCounter&) = delete;
+    RefCounter& operator=(const RefCounter&) = delete;
 
-    void addRef(const std::string& name, const uint32_t times = 1);
+    void addRef(const uint32_t times = 1) noexcept;
 
-    void removeRef(const std::string& name);
+    void removeRef() noexcept;
 
-    uint32_t count(const std::string& name) const;
+    uint32_t count() const noexcept;
 
-    bool empty() const;
+    const std::string& dbName() const noexcept { return dbName_; }
 
-    std::vector<std::string> getRefNames() const;
-
-    const std::map<std::string, uint32_t>& getRefMap() const;
+    const std::string& scopeName() const noexcept { return scopeName_; }
 
 private:
-    
-    std::map<std::string, uint32_t> refMap_;
+    const std::string dbName_;
+    const std::string scopeName_;
+
+    std::atomic<uint32_t> count_{0};
 };
 
 } // namespace kvdbManager
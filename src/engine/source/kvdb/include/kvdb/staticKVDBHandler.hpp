@@ -0,0 +1,76 @@
+#ifndef _KVDB_STATIC_HANDLER_HPP
+#define _KVDB_STATIC_HANDLER_HPP
+
+#include <memory>
+
+#include <kvdb/dbEntry.hpp>
+#include <kvdb/ikvdbhandler.hpp>
+#include <kvdb/ikvdbhandlercollection.hpp>
+#include <kvdb/staticTable.hpp>
+
+namespace kvdbManager
+{
+
+/**
+ * @brief Read-only handler of a DB in static mode, served from an in-memory StaticTable without touching RocksDB.
+ *
+ * Every write is rejected. The table of the DB is read again on each lookup, once the static mode is disabled the
+ * lookups fail and a new handler must be taken.
+ */
+class StaticKVDBHandler : public IKVDBHandler
+{
+public:
+    StaticKVDBHandler(std::weak_ptr<DbEntry> weakEntry,
+                      std::shared_ptr<IKVDBHandlerCollection> collection,
+                      RefId refId,
+                      const std::string& dbName,
+                      const std::string& scopeName);
+
+    ~StaticKVDBHandler() override;
+
+    base::OptError set(const std::string& key, const std::string& value) override;
+
+    base::OptError set(const std::string& key, const json::Json& value) override;
+
+    base::OptError set(const std::string& key, const std::string& value, std::chrono::seconds ttl) override;
+
+    base::OptError setBatch(const std::vector<std::pair<std::string, std::string>>& entries) override;
+
+    base::OptError add(const std::string& key) override;
+
+    base::OptError increment(const std::string& key, int64_t delta) override;
+
+    base::OptError appendToSet(const std::string& key, const std::string& value) override;
+
+    base::OptError remove(const std::string& key) override;
+
+    base::RespOrError<bool> contains(const std::string& key) override;
+
+    base::RespOrError<std::string> get(const std::string& key) override;
+
+    base::RespOrError<std::list<std::pair<std::string, std::string>>>
+    dump(const unsigned int page, const unsigned int records) override;
+
+    base::RespOrError<std::list<std::pair<std::string, std::string>>>
+    search(const std::string& prefix, const unsigned int page, const unsigned int records) override;
+
+    base::OptError exportEntries(const EntryVisitor& visitor) override;
+
+private:
+    base::Error readOnlyError(const std::string& key) const;
+
+    base::RespOrError<std::shared_ptr<const StaticTable>> table() const;
+
+    base::RespOrError<std::list<std::pair<std::string, std::string>>>
+    pageContent(const unsigned int page, const unsigned int records, std::string_view prefix) const;
+
+    std::weak_ptr<DbEntry> weakEntry_;
+    std::shared_ptr<IKVDBHandlerCollection> spCollection_;
+    RefId refId_;
+    std::string dbName_;
+    std::string scopeName_;
+};
+
+} // namespace kvdbManager
+
+#endif // _KVDB_STATIC_HANDLER_HPP
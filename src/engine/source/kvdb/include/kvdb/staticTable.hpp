@@ -0,0 +1,92 @@
+#ifndef _KVDB_STATIC_TABLE_HPP
+#define _KVDB_STATIC_TABLE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <base/error.hpp>
+
+namespace kvdbManager
+{
+
+/**
+ * @brief Immutable key-value table indexed by a minimal perfect hash (CHD, hash and displace).
+ *
+ * The whole table is one contiguous buffer, so it can be written to disk and mapped back as is:
+ *
+ *   header | bucket seeds (uint32 x buckets) | slot offsets (uint32 x count) | records
+ *
+ * Records are [keyLen uint32][valueLen uint32][key][value] in key order, so iteration is sequential. A lookup hashes
+ * the key twice (bucket, then slot with the bucket seed) and compares the single candidate record, never probing.
+ * The index costs about 5 bytes per key on top of the raw data.
+ */
+class StaticTable
+{
+public:
+    static constexpr uint32_t MAGIC {0x5453564B}; ///< "KVST"
+    static constexpr uint32_t VERSION {1};
+    static constexpr uint32_t KEYS_PER_BUCKET {4};
+
+    /**
+     * @brief Build a table.
+     *
+     * @param entries Key value pairs with unique keys, sorted by key.
+     * @return base::RespOrError<StaticTable> Error if the keys are not unique or the data exceeds 4 GiB.
+     */
+    static base::RespOrError<StaticTable> build(const std::vector<std::pair<std::string, std::string>>& entries);
+
+    /**
+     * @brief Adopt a buffer produced by buffer(), validating its layout.
+     *
+     * @param buffer Serialized table.
+     * @return base::RespOrError<StaticTable>
+     */
+    static base::RespOrError<StaticTable> fromBuffer(std::string buffer);
+
+    /**
+     * @brief Find the value of a key.
+     *
+     * @param key Key.
+     * @return std::optional<std::string_view> View into the table, valid as long as the table.
+     */
+    std::optional<std::string_view> find(std::string_view key) const;
+
+    /**
+     * @brief Visit every entry in key order.
+     *
+     * @param visitor Returns false to stop.
+     */
+    void forEach(const std::function<bool(std::string_view key, std::string_view value)>& visitor) const;
+
+    /**
+     * @brief Number of entries.
+     */
+    uint32_t size() const { return count_; }
+
+    /**
+     * @brief The serialized table.
+     */
+    std::string_view buffer() const { return buffer_; }
+
+private:
+    explicit StaticTable(std::string buffer);
+
+    std::pair<std::string_view, std::string_view> record(uint32_t offset) const;
+
+    std::string buffer_;
+
+    uint32_t count_ {0};
+    uint32_t buckets_ {0};
+    std::size_t seedsOffset_ {0};
+    std::size_t slotsOffset_ {0};
+    std::size_t recordsOffset_ {0};
+};
+
+} // namespace kvdbManager
+
+#endif // _KVDB_STATIC_TABLE_HPP
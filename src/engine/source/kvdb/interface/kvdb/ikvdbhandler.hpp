@@ -1,11 +1,15 @@
 #ifndef _I_KVDB_HANDLER_HPP
 #define _I_KVDB_HANDLER_HPP
 
+#include <chrono>
+#include <functional>
 #include <list>
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include <base/error.hpp>
 #include <base/json.hpp>
@@ -13,6 +17,11 @@
 namespace kvdbManager
 {
 
+/**
+ * @brief Called once per entry by IKVDBHandler::exportEntries, returns false to stop the export.
+ */
+using EntryVisitor = std::function<bool(std::string_view key, std::string_view value)>;
+
 class IKVDBHandler
 {
 public:
@@ -24,9 +33,55 @@ public:
     virtual base::OptError
     set(const std::string& key, const json::Json& value) = 0;
 
+    /**
+     * @brief Set a value that expires after the given time, overriding the default TTL of the DB.
+     *
+     * Expired entries are reported as missing and are physically removed on compaction.
+     *
+     * @param key Key.
+     * @param value Value.
+     * @param ttl Time to live, 0 if the entry never expires.
+     * @return base::OptError
+     */
+    virtual base::OptError
+    set(const std::string& key, const std::string& value, std::chrono::seconds ttl) = 0;
+
+    /**
+     * @brief Set several values in one atomic write, each with the default TTL of the DB.
+     *
+     * @param entries Keys and values.
+     * @return base::OptError Nothing is written on error.
+     */
+    virtual base::OptError
+    setBatch(const std::vector<std::pair<std::string, std::string>>& entries) = 0;
+
     virtual base::OptError
     add(const std::string& key) = 0;
 
+    /**
+     * @brief Atomically add delta to the integer stored in key, without reading it first.
+     *
+     * A missing, expired or non integer value counts as 0. New values get the default TTL of the DB.
+     *
+     * @param key Key.
+     * @param delta Value to add, may be negative.
+     * @return base::OptError
+     */
+    virtual base::OptError
+    increment(const std::string& key, int64_t delta) = 0;
+
+    /**
+     * @brief Atomically add value to the set (JSON array of unique strings) stored in key, without reading it first.
+     *
+     * A missing, expired or non array value counts as an empty set. New values get the default TTL of the DB.
+     *
+     * @param key Key.
+     * @param value Element to add.
+     * @return base::OptError
+     */
+    virtual base::OptError
+    appendToSet(const std::string& key, const std::string& value) = 0;
+
     virtual base::OptError
     remove(const std::string& key) = 0;
 
@@ -54,6 +109,17 @@ public:
         return search(prefix, 0, 0);
     };
 
+    /**
+     * @brief Visit every live entry of the DB in key order from a pinned snapshot.
+     *
+     * Writes made during the export are not visible, and entries are handed to the visitor one at a time, so the
+     * memory used does not depend on the size of the DB. The views are only valid during the visitor call.
+     *
+     * @param visitor Called for each entry, returning false stops the export.
+     * @return base::OptError
+     */
+    virtual base::OptError exportEntries(const EntryVisitor& visitor) = 0;
+
 };
 
 } // namespace kvdbManager
@@ -1,19 +1,41 @@
 #ifndef _I_KVDB_HANDLER_COLLECTION_HPP
 #define _I_KVDB_HANDLER_COLLECTION_HPP
 
+#include <cstdint>
 #include <string>
 
 namespace kvdbManager
 {
 
+using RefId = uint32_t; ///< Interned id of a (DB, scope) pair
+
 class IKVDBHandlerCollection
 {
 public:
     virtual ~IKVDBHandlerCollection() = default;
 
-    virtual void addKVDBHandler(const std::string& dbName, const std::string& scopeName) = 0;
+    /**
+     * @brief Get the interned id of a (DB, scope) pair, allocating its counter the first time.
+     *
+     * @param dbName DB name.
+     * @param scopeName Scope name.
+     * @return RefId
+     */
+    virtual RefId getRefId(const std::string& dbName, const std::string& scopeName) = 0;
+
+    /**
+     * @brief Increment the handler counter of an interned pair.
+     *
+     * @param id Id returned by getRefId.
+     */
+    virtual void addRef(RefId id) = 0;
 
-    virtual void removeKVDBHandler(const std::string& name, const std::string& scopeName) = 0;
+    /**
+     * @brief Decrement the handler counter of an interned pair.
+     *
+     * @param id Id returned by getRefId.
+     */
+    virtual void removeRef(RefId id) = 0;
 };
 
 } // namepsace kvdbManager
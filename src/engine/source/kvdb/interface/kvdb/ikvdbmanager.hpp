@@ -1,6 +1,7 @@
 #ifndef _I_KVDB_MANAGER_HPP
 #define _I_KVDB_MANAGER_HPP
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <optional>
@@ -30,12 +31,60 @@ public:
 
     virtual base::OptError createDB(const std::string& name) = 0;
 
-    virtual base::OptError createDB(const std::string& name, const std::string& path) = 0;
+    /**
+     * @brief Create a DB and load the entries of a JSON file into it.
+     *
+     * @param name DB name.
+     * @param path Path of the JSON file.
+     * @param ttl Default TTL of the DB, set before loading so the file entries get it. 0 if they never expire.
+     * @return base::OptError The DB is deleted again on failure.
+     */
+    virtual base::OptError createDB(const std::string& name, const std::string& path, std::chrono::seconds ttl) = 0;
 
     virtual base::OptError loadDBFromJson(const std::string& name, const json::Json& content) = 0;
 
     virtual bool existsDB(const std::string& name) = 0;
 
+    /**
+     * @brief Set the default TTL of the entries written to a DB without an explicit TTL. Persisted across restarts.
+     *
+     * @param name DB name.
+     * @param ttl Time to live, 0 if the entries never expire.
+     * @return base::OptError
+     */
+    virtual base::OptError setDBTTL(const std::string& name, std::chrono::seconds ttl) = 0;
+
+    /**
+     * @brief Get the default TTL of a DB.
+     *
+     * @param name DB name.
+     * @return base::RespOrError<std::chrono::seconds> 0 if the entries never expire.
+     */
+    virtual base::RespOrError<std::chrono::seconds> getDBTTL(const std::string& name) = 0;
+
+    /**
+     * @brief Switch a DB to static (read-only) mode or back. Persisted across restarts.
+     *
+     * In static mode the live entries are loaded once into an immutable in-memory table indexed by a perfect hash,
+     * new handlers read from it without touching RocksDB and every write is rejected.
+     *
+     * @param name DB name.
+     * @param enabled True to load the table, false to go back to RocksDB.
+     * @return base::OptError
+     */
+    virtual base::OptError setStaticMode(const std::string& name, bool enabled) = 0;
+
+    /**
+     * @brief Get the RocksDB and per DB statistics.
+     *
+     * "/rocksdb" holds the block cache hits, misses and hit rate, the memtable size and the pending compaction bytes of
+     * the whole instance. "/dbs/<name>" holds the memtable size and pending compaction bytes of each DB and, under
+     * "/ops/<get|put|remove|iterate>", the count and the mean, p50, p90 and p99 latencies in microseconds.
+     *
+     * @return json::Json
+     */
+    virtual json::Json getStats() = 0;
+
     virtual std::map<std::string, RefInfo> getKVDBScopesInfo() = 0;
 
     virtual std::map<std::string, RefInfo> getKVDBHandlersInfo() const = 0;
@@ -0,0 +1,70 @@
+#include <kvdb/dbStats.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace kvdbManager
+{
+
+const char* dbOpName(DbOp op)
+{
+    switch (op)
+    {
+        case DbOp::GET: return "get";
+        case DbOp::PUT: return "put";
+        case DbOp::REMOVE: return "remove";
+        case DbOp::ITERATE: return "iterate";
+    }
+
+    return "unknown";
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds elapsed) noexcept
+{
+    const auto ns = static_cast<uint64_t>(elapsed.count() > 0 ? elapsed.count() : 0);
+
+    // Index of the highest set bit + 1, the bucket whose upper bound is the next power of two
+    std::size_t bucket = ns == 0 ? 0 : 64 - static_cast<std::size_t>(__builtin_clzll(ns));
+    if (bucket >= BUCKETS)
+    {
+        bucket = BUCKETS - 1;
+    }
+
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(ns, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const noexcept
+{
+    // Buckets are read one by one while other threads record, so the total is recomputed from them
+    std::array<uint64_t, BUCKETS> counts {};
+    uint64_t total {0};
+
+    for (std::size_t i = 0; i < BUCKETS; ++i)
+    {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    const auto rank = static_cast<uint64_t>(std::ceil(total * std::clamp(percentile, 0.0, 100.0) / 100.0));
+    uint64_t seen {0};
+
+    for (std::size_t i = 0; i < BUCKETS; ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank && counts[i] != 0)
+        {
+            return uint64_t {1} << i;
+        }
+    }
+
+    return uint64_t {1} << (BUCKETS - 1);
+}
+
+} // namespace kvdbManager
@@ -1,35 +1,69 @@
 #include <kvdb/kvdbHandler.hpp>
 
+#include <chrono>
+#include <shared_mutex>
+
 #include <base/json.hpp>
 #include <base/logger.hpp>
 #include <fmt/format.h>
 
 #include <rocksdb/db.h>
+#include <rocksdb/write_batch.h>
+
+#include <kvdb/kvdbTTL.hpp>
 
 
 namespace kvdbManager
 {
 
 KVDBHandler::KVDBHandler(std::weak_ptr<rocksdb::DB> weakDB,
-            std::weak_ptr<rocksdb::ColumnFamilyHandle> weakCFHandle,
+            std::weak_ptr<DbEntry> weakEntry,
             std::shared_ptr<IKVDBHandlerCollection> collection,
+            RefId refId,
             const std::string& dbName,
             const std::string& scopeName)
     : weakDB_{weakDB}
-    , weakCFHandle_{weakCFHandle}
+    , weakEntry_{weakEntry}
     , dbName_{dbName}
     , scopeName_{scopeName}
     , spCollection_{collection}
+    , refId_{refId}
 {}
 
 
 
 KVDBHandler::~KVDBHandler()
 {
-    spCollection_->removeKVDBHandler(dbName_, scopeName_);
+    spCollection_->removeRef(refId_);
 }
 
 base::OptError KVDBHandler::set(const std::string& key, const std::string& value)
+{
+    auto pEntry = weakEntry_.lock();
+
+    if (!pEntry)
+    {
+        return base::Error{
+            "Cannot access RocksDB Column Family Handle!"
+        };
+    }
+
+    const auto defaultTTL = pEntry->ttl.load(std::memory_order_relaxed);
+
+    return put(key, value, defaultTTL > 0 ? ttl::now() + defaultTTL : 0);
+}
+
+base::OptError KVDBHandler::set(const std::string& key, const std::string& value, std::chrono::seconds ttl)
+{
+    return put(key, value, ttl.count() > 0 ? ttl::now() + ttl.count() : 0);
+}
+
+base::OptError KVDBHandler::set(const std::string& key, const json::Json& value)
+{
+    return set(key, value.toStr());
+}
+
+base::OptError KVDBHandler::put(const std::string& key, const std::string& value, int64_t expiresAt)
 {
     auto pRocksDB = weakDB_.lock();
 
@@ -40,19 +74,35 @@ base::OptError KVDBHandler::set(const std::string& key, const std::string& value
         };
     }
 
-    auto pCFHandle = weakCFHandle_.lock();
+    auto pEntry = weakEntry_.lock();
 
-    if (!pCFHandle)
+    if (!pEntry)
     {
         return base::Error{
             "Cannot access RocksDB Column Family Handle!"
         };
     }
 
+    // Held until the write is done, so the static mode cannot be enabled in between
+    std::shared_lock<std::shared_mutex> staticLock(pEntry->staticMutex);
+
+    if (pEntry->isStatic.load(std::memory_order_relaxed))
+    {
+        return base::Error{
+            fmt::format(
+                "Cannot write key '{}'. Error: The DB '{}' is static (read-only)",
+                key,
+                dbName_
+            )
+        };
+    }
+
+    DbStats::Timer timer {pEntry->stats, DbOp::PUT};
+
     auto status = pRocksDB->Put(rocksdb::WriteOptions(),
-                                pCFHandle.get(), 
+                                pEntry->cfHandle.get(), 
                                 rocksdb::Slice(key),
-                                rocksdb::Slice(value));
+                                rocksdb::Slice(ttl::encode(value, expiresAt)));
 
     if (!status.ok())
     {
@@ -72,9 +122,81 @@ base::OptError KVDBHandler::set(const std::string& key, const std::string& value
     return std::nullopt;
 }
 
-base::OptError KVDBHandler::set(const std::string& key, const json::Json& value)
+base::OptError KVDBHandler::setBatch(const std::vector<std::pair<std::string, std::string>>& entries)
 {
-    return set(key, value.toStr());
+    auto pRocksDB = weakDB_.lock();
+
+    if (!pRocksDB)
+    {
+        return base::Error{
+            "Cannot access RocksDB::DB!"
+        };
+    }
+
+    auto pEntry = weakEntry_.lock();
+
+    if (!pEntry)
+    {
+        return base::Error{
+            "Cannot access RocksDB Column Family Handle!"
+        };
+    }
+
+    if (entries.empty())
+    {
+        return std::nullopt;
+    }
+
+    // Held until the write is done, so the static mode cannot be enabled in between
+    std::shared_lock<std::shared_mutex> staticLock(pEntry->staticMutex);
+
+    if (pEntry->isStatic.load(std::memory_order_relaxed))
+    {
+        return base::Error{
+            fmt::format(
+                "Cannot write key '{}'. Error: The DB '{}' is static (read-only)",
+                entries.front().first,
+                dbName_
+            )
+        };
+    }
+
+    DbStats::Timer timer {pEntry->stats, DbOp::PUT};
+
+    const auto defaultTTL = pEntry->ttl.load(std::memory_order_relaxed);
+    const auto expiresAt = defaultTTL > 0 ? ttl::now() + defaultTTL : 0;
+
+    rocksdb::WriteBatch batch;
+    auto status = rocksdb::Status::OK();
+
+    for (auto it = entries.begin(); status.ok() && it != entries.end(); ++it)
+    {
+        status = batch.Put(pEntry->cfHandle.get(),
+                           rocksdb::Slice(it->first),
+                           rocksdb::Slice(ttl::encode(it->second, expiresAt)));
+    }
+
+    if (status.ok())
+    {
+        status = pRocksDB->Write(rocksdb::WriteOptions(), &batch);
+    }
+
+    if (!status.ok())
+    {
+        std::string_view error
+            = status.getState() != nullptr ? status.getState() : "Unknown";
+
+        return base::Error{
+            fmt::format(
+                "Cannot save {} entries starting at key '{}'. Error: {}",
+                entries.size(),
+                entries.front().first,
+                error
+            )
+        };
+    }
+
+    return std::nullopt;
 }
 
 base::OptError KVDBHandler::add(const std::string& key)
@@ -82,6 +204,77 @@ base::OptError KVDBHandler::add(const std::string& key)
     return set(key, "");
 }
 
+base::OptError KVDBHandler::increment(const std::string& key, int64_t delta)
+{
+    return mergeOperand(key, merge::Op::INCREMENT, std::to_string(delta));
+}
+
+base::OptError KVDBHandler::appendToSet(const std::string& key, const std::string& value)
+{
+    return mergeOperand(key, merge::Op::APPEND, value);
+}
+
+base::OptError KVDBHandler::mergeOperand(const std::string& key, merge::Op op, std::string_view payload)
+{
+    auto pRocksDB = weakDB_.lock();
+
+    if (!pRocksDB)
+    {
+        return base::Error{
+            "Cannot access RocksDB::DB!"
+        };
+    }
+
+    auto pEntry = weakEntry_.lock();
+
+    if (!pEntry)
+    {
+        return base::Error{
+            "Cannot access RocksDB Column Family Handle!"
+        };
+    }
+
+    std::shared_lock<std::shared_mutex> staticLock(pEntry->staticMutex);
+
+    if (pEntry->isStatic.load(std::memory_order_relaxed))
+    {
+        return base::Error{
+            fmt::format(
+                "Cannot write key '{}'. Error: The DB '{}' is static (read-only)",
+                key,
+                dbName_
+            )
+        };
+    }
+
+    DbStats::Timer timer {pEntry->stats, DbOp::PUT};
+
+    const auto defaultTTL = pEntry->ttl.load(std::memory_order_relaxed);
+
+    auto status = pRocksDB->Merge(rocksdb::WriteOptions(),
+                                  pEntry->cfHandle.get(),
+                                  rocksdb::Slice(key),
+                                  rocksdb::Slice(merge::encodeOperand(
+                                      op, payload, defaultTTL > 0 ? ttl::now() + defaultTTL : 0)));
+
+    if (!status.ok())
+    {
+        std::string_view error
+            = status.getState() != nullptr ? status.getState() : "Unknown";
+
+        return base::Error{
+            fmt::format(
+                "Cannot merge '{}' into key '{}'. Error: {}",
+                payload,
+                key,
+                error
+            )
+        };
+    }
+
+    return std::nullopt;
+}
+
 base::OptError KVDBHandler::remove(const std::string& key)
 {
     auto pRocksDB = weakDB_.lock();
@@ -93,17 +286,32 @@ base::OptError KVDBHandler::remove(const std::string& key)
         };
     }
 
-    auto pCFHandle = weakCFHandle_.lock();
+    auto pEntry = weakEntry_.lock();
 
-    if (!pCFHandle)
+    if (!pEntry)
     {
         return base::Error{
             "Cannot access RocksDB Column Family Handle!"
         };
     }
 
+    std::shared_lock<std::shared_mutex> staticLock(pEntry->staticMutex);
+
+    if (pEntry->isStatic.load(std::memory_order_relaxed))
+    {
+        return base::Error{
+            fmt::format(
+                "Cannot write key '{}'. Error: The DB '{}' is static (read-only)",
+                key,
+                dbName_
+            )
+        };
+    }
+
+    DbStats::Timer timer {pEntry->stats, DbOp::REMOVE};
+
     auto status = pRocksDB->Delete(rocksdb::WriteOptions(),
-                                   pCFHandle.get(), 
+                                   pEntry->cfHandle.get(), 
                                    rocksdb::Slice(key));
 
     if (!status.ok())
@@ -134,33 +342,35 @@ base::RespOrError<bool> KVDBHandler::contains(const std::string& key)
         };
     }
 
-    auto pCFHandle = weakCFHandle_.lock();
+    auto pEntry = weakEntry_.lock();
 
-    if (!pCFHandle)
+    if (!pEntry)
     {
         return base::Error{
             "Cannot access RocksDB Column Family Handle!"
         };
     }
 
+    DbStats::Timer timer {pEntry->stats, DbOp::GET};
+
     std::string value{};
     bool valueFound{false};
 
     try {
 
         pRocksDB->KeyMayExist(
-            rocksdb::ReadOptions(), pCFHandle.get(), rocksdb::Slice(key), &value, &valueFound);
+            rocksdb::ReadOptions(), pEntry->cfHandle.get(), rocksdb::Slice(key), &value, &valueFound);
 
         if (valueFound)
         {
             auto status
                 = pRocksDB->Get(
                     rocksdb::ReadOptions(),
-                    pCFHandle.get(),
+                    pEntry->cfHandle.get(),
                     rocksdb::Slice(key),
                     &value);
 
-            if (!status.ok())
+            if (!status.ok() || ttl::isExpired(ttl::decode(value), ttl::now()))
             {
                 valueFound = false;
             }
@@ -191,18 +401,20 @@ base::RespOrError<std::string> KVDBHandler::get(const std::string& key)
         };
     }
 
-    auto pCFHandle = weakCFHandle_.lock();
+    auto pEntry = weakEntry_.lock();
 
-    if (!pCFHandle)
+    if (!pEntry)
     {
         return base::Error{
             "Cannot access RocksDB Column Family Handle!"
         };
     }
 
+    DbStats::Timer timer {pEntry->stats, DbOp::GET};
+
     std::string value{};
 
-    auto status = pRocksDB->Get(rocksdb::ReadOptions(), pCFHandle.get(), rocksdb::Slice(key), &value);
+    auto status = pRocksDB->Get(rocksdb::ReadOptions(), pEntry->cfHandle.get(), rocksdb::Slice(key), &value);
 
     if (!status.ok())
     {
@@ -219,8 +431,19 @@ base::RespOrError<std::string> KVDBHandler::get(const std::string& key)
         };
     }
 
-    return value;
+    const auto decoded = ttl::decode(value);
+
+    if (ttl::isExpired(decoded, ttl::now()))
+    {
+        return base::Error{
+            fmt::format(
+                "Cannot get key '{}'. Error: Key not found",
+                key
+            )
+        };
+    }
 
+    return std::string{decoded.payload};
 }
 
 base::RespOrError<std::list<std::pair<std::string, std::string>>>
@@ -249,6 +472,81 @@ KVDBHandler::search(const std::string& prefix, const unsigned int page, const un
     return pageContent(page, records, filter);
 }
 
+base::OptError KVDBHandler::exportEntries(const EntryVisitor& visitor)
+{
+    auto pRocksDB = weakDB_.lock();
+
+    if (!pRocksDB)
+    {
+        return base::Error{
+            "Cannot access RocksDB::DB!"
+        };
+    }
+
+    auto pEntry = weakEntry_.lock();
+
+    if (!pEntry)
+    {
+        return base::Error{
+            "Cannot access RocksDB Column Family Handle!"
+        };
+    }
+
+    // The time spent in the visitor, e.g. writing to a slow client, is left out of the ITERATE latency
+    const auto start = std::chrono::steady_clock::now();
+    std::chrono::nanoseconds visiting {0};
+
+    // Released once the export ends, after the iterator that reads from it
+    std::unique_ptr<const rocksdb::Snapshot, std::function<void(const rocksdb::Snapshot*)>> snapshot{
+        pRocksDB->GetSnapshot(),
+        [pRocksDB](const rocksdb::Snapshot* pSnapshot) { pRocksDB->ReleaseSnapshot(pSnapshot); }
+    };
+
+    rocksdb::ReadOptions readOptions;
+    readOptions.snapshot = snapshot.get();
+    // A full scan must not evict the working set of the block cache
+    readOptions.fill_cache = false;
+
+    std::unique_ptr<rocksdb::Iterator> iter{
+        pRocksDB->NewIterator(readOptions, pEntry->cfHandle.get())
+    };
+
+    const auto now = ttl::now();
+
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next())
+    {
+        const auto decoded = ttl::decode({iter->value().data(), iter->value().size()});
+        if (ttl::isExpired(decoded, now))
+        {
+            continue;
+        }
+
+        const auto visitStart = std::chrono::steady_clock::now();
+        const auto more = visitor({iter->key().data(), iter->key().size()}, decoded.payload);
+        visiting += std::chrono::steady_clock::now() - visitStart;
+
+        if (!more)
+        {
+            break;
+        }
+    }
+
+    pEntry->stats.record(DbOp::ITERATE, std::chrono::steady_clock::now() - start - visiting);
+
+    if (!iter->status().ok())
+    {
+        return base::Error{
+            fmt::format(
+                "Database '{}': Could not iterate over database: '{}'",
+                dbName_,
+                iter->status().ToString()
+            )
+        };
+    }
+
+    return std::nullopt;
+}
+
 base::RespOrError<std::list<std::pair<std::string, std::string>>>
 KVDBHandler::pageContent(const unsigned int page,
             const unsigned int records)
@@ -270,17 +568,19 @@ KVDBHandler::pageContent(const unsigned int page,
         };
     }
 
-    auto pCFHandle = weakCFHandle_.lock();
+    auto pEntry = weakEntry_.lock();
 
-    if (!pCFHandle)
+    if (!pEntry)
     {
         return base::Error{
             "Cannot access RocksDB Column Family Handle!"
         };
     }
 
+    DbStats::Timer timer {pEntry->stats, DbOp::ITERATE};
+
     std::unique_ptr<rocksdb::Iterator> iter{
-        pRocksDB->NewIterator(rocksdb::ReadOptions(), pCFHandle.get())
+        pRocksDB->NewIterator(rocksdb::ReadOptions(), pEntry->cfHandle.get())
     };
 
     std::list<std::pair<std::string, std::string>> content;
@@ -289,16 +589,24 @@ KVDBHandler::pageContent(const unsigned int page,
     unsigned int toRecords = fromRecords + records;
 
     unsigned int i = 0;
+    const auto now = ttl::now();
 
     for (iter->SeekToFirst(); iter->Valid() && i < toRecords; iter->Next())
     {
         if (!filter || filter(iter->key()))
         {
+            // Expired entries are not visible, they are dropped on compaction
+            const auto decoded = ttl::decode({iter->value().data(), iter->value().size()});
+            if (ttl::isExpired(decoded, now))
+            {
+                continue;
+            }
+
             if (i >= fromRecords)
             {
                 content.emplace_back(
                     iter->key().ToString(),
-                    iter->value().ToString()
+                    std::string{decoded.payload}
                 );
             }
 
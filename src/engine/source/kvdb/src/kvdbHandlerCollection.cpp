@@ -1,3 +1,5 @@
+#include <stdexcept>
+
 #include <fmt/format.h>
 
 #include <base/logger.hpp>
@@ -7,106 +9,183 @@
 namespace kvdbManager
 {
 
-void KVDBHandlerInstance::addScope(const std::string& scopeName)
+KVDBHandlerCollection::~KVDBHandlerCollection()
 {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
-
-    scopeCounter_.addRef(scopeName);
+    for (auto& chunk : chunks_)
+    {
+        delete chunk.load(std::memory_order_relaxed);
+    }
 }
 
-void KVDBHandlerInstance::removeScope(const std::string& scopeName)
+RefId KVDBHandlerCollection::getRefId(const std::string& dbName, const std::string& scopeName)
 {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+    {
+        std::shared_lock<std::shared_mutex> readLock(mutex_);
+        if (const auto* id = find(dbName, scopeName))
+        {
+            return *id;
+        }
+    }
 
-    scopeCounter_.removeRef(scopeName);
+    std::unique_lock<std::shared_mutex> writeLock(mutex_);
+
+    return intern(dbName, scopeName);
 }
 
-bool KVDBHandlerInstance::emptyScopes()
+RefId KVDBHandlerCollection::acquire(const std::string& dbName, const std::string& scopeName)
 {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+    {
+        // Counting under the read lock keeps release() from freeing the slot before it is used
+        std::shared_lock<std::shared_mutex> readLock(mutex_);
+        if (const auto* id = find(dbName, scopeName))
+        {
+            slot(*id).addRef();
+            return *id;
+        }
+    }
 
-    return scopeCounter_.empty();
-}
+    std::unique_lock<std::shared_mutex> writeLock(mutex_);
 
-std::vector<std::string> KVDBHandlerInstance::getRefNames()
-{
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const auto id = intern(dbName, scopeName);
+    slot(id).addRef();
 
-    return scopeCounter_.getRefNames();
+    return id;
 }
 
-std::map<std::string, uint32_t> KVDBHandlerInstance::getRefMap()
+const RefId* KVDBHandlerCollection::find(const std::string& dbName, const std::string& scopeName) const
 {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const auto db = index_.find(dbName);
+    if (db == index_.end())
+    {
+        return nullptr;
+    }
 
-    return scopeCounter_.getRefMap();
+    const auto it = db->second.find(scopeName);
+    return it != db->second.end() ? &it->second : nullptr;
 }
 
-
-void KVDBHandlerCollection::addKVDBHandler(const std::string &dbName, const std::string& scopeName)
+RefId KVDBHandlerCollection::intern(const std::string& dbName, const std::string& scopeName)
 {
+    auto& scopes = index_[dbName];
+
+    const auto found = scopes.find(scopeName);
+    if (found != scopes.end())
     {
-        std::shared_lock<std::shared_mutex> readLock(mutex_);
-        const auto it = mapInstances_.find(dbName);
-        if (it != mapInstances_.end())
-        {
-            it->second->addScope(scopeName);
-            return;
-        }
+        return found->second;
     }
 
+    RefId id {size_};
+    if (!free_.empty())
     {
-        std::unique_lock<std::shared_mutex> writeLock(mutex_);
-        auto [it, inserted]
-            = mapInstances_.try_emplace(dbName, std::make_shared<KVDBHandlerInstance>());
-        it->second->addScope(scopeName);
+        id = free_.back();
+        free_.pop_back();
+    }
+    else
+    {
+        const auto chunkIdx = id >> CHUNK_BITS;
+        if (chunkIdx >= MAX_CHUNKS)
+        {
+            if (scopes.empty())
+            {
+                index_.erase(dbName);
+            }
+            throw std::runtime_error(
+                fmt::format("Cannot track handlers for DB '{}' scope '{}': too many scopes", dbName, scopeName));
+        }
+
+        if (chunks_[chunkIdx].load(std::memory_order_relaxed) == nullptr)
+        {
+            chunks_[chunkIdx].store(new Chunk{}, std::memory_order_release);
+        }
+        ++size_;
     }
+
+    slotPtr(id) = std::make_unique<RefCounter>(dbName, scopeName);
+    scopes.emplace(scopeName, id);
+
+    return id;
 }
 
-void KVDBHandlerCollection::removeKVDBHandler(const std::string& dbName, const std::string& scopeName)
+void KVDBHandlerCollection::release(const std::string& dbName)
 {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+    std::unique_lock<std::shared_mutex> writeLock(mutex_);
 
-    const auto it = mapInstances_.find(dbName);
+    const auto db = index_.find(dbName);
+    if (db == index_.end())
+    {
+        return;
+    }
 
-    if (it != mapInstances_.end())
+    auto& scopes = db->second;
+    for (auto it = scopes.begin(); it != scopes.end();)
     {
-        auto& instance = it->second;
-        instance->removeScope(scopeName);
-        if (instance->emptyScopes())
+        // A slot still counting handlers stays until a later release
+        if (slot(it->second).count() != 0)
         {
-            mapInstances_.erase(it);
+            ++it;
+            continue;
         }
+
+        slotPtr(it->second).reset();
+        free_.push_back(it->second);
+        it = scopes.erase(it);
+    }
+
+    if (scopes.empty())
+    {
+        index_.erase(db);
     }
 }
 
-std::vector<std::string> KVDBHandlerCollection::getDBNames()
+std::unique_ptr<RefCounter>& KVDBHandlerCollection::slotPtr(RefId id) const
+{
+    auto* chunk = chunks_[id >> CHUNK_BITS].load(std::memory_order_acquire);
+    return chunk->slots[id & (CHUNK_SIZE - 1)];
+}
+
+RefCounter& KVDBHandlerCollection::slot(RefId id) const
 {
-    std::shared_lock<std::shared_mutex>lock(mutex_);
+    return *slotPtr(id);
+}
+
+void KVDBHandlerCollection::addRef(RefId id)
+{
+    slot(id).addRef();
+}
+
+void KVDBHandlerCollection::removeRef(RefId id)
+{
+    slot(id).removeRef();
+}
 
-    std::vector<std::string> dbNames;
-    dbNames.reserve(mapInstances_.size());
+void KVDBHandlerCollection::visitRefs(const std::function<void(const RefCounter&)>& visitor) const
+{
+    std::shared_lock<std::shared_mutex> readLock(mutex_);
 
-    for (const auto& instance : mapInstances_)
+    for (const auto& [dbName, scopes] : index_)
     {
-        dbNames.push_back(instance.first);
+        for (const auto& [scopeName, id] : scopes)
+        {
+            visitor(slot(id));
+        }
     }
-
-    return dbNames;
 }
 
-std::map<std::string, uint32_t> KVDBHandlerCollection::getRefMap(const std::string& dbName)
+void KVDBHandlerCollection::visitRefs(const std::string& dbName,
+                                      const std::function<void(const RefCounter&)>& visitor) const
 {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::shared_lock<std::shared_mutex> readLock(mutex_);
 
-    const auto it = mapInstances_.find(dbName);
-
-    if (it != mapInstances_.end())
+    const auto db = index_.find(dbName);
+    if (db == index_.end())
     {
-        return it->second->getRefMap();
+        return;
     }
 
-    return {};
+    for (const auto& [scopeName, id] : db->second)
+    {
+        visitor(slot(id));
+    }
 }
 
 } // namespace kvdbManager
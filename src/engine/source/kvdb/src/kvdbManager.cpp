@@ -1,11 +1,13 @@
 #include <filesystem>
 #include <fstream>
 #include <optional>
+#include <shared_mutex>
 
 #include <fmt/format.h>
 
 #include <rocksdb/db.h>
 #include <rocksdb/options.h>
+#include <rocksdb/statistics.h>
 
 #include <base/logger.hpp>
 #include <kvdb/kvdbManager.hpp>
@@ -16,6 +18,7 @@ namespace kvdbManager
 KVDBManager::KVDBManager(const KVDBManagerOptions& options)
     : kvdbHandlerCollection_{std::make_shared<KVDBHandlerCollection>()}
     , managerOptions_{options}
+    , dbEntries_{std::make_shared<const DbEntryMap>()}
 {}
 
 void KVDBManager::initialize()
@@ -39,39 +42,17 @@ void KVDBManager::finalize()
 
 std::map<std::string, RefInfo> KVDBManager::getKVDBScopesInfo()
 {
-    // List reverse lookup of getKVDBHandlersInfo. List of scopes and DBs that are using them.
+    // Reverse lookup of getKVDBHandlersInfo: scopes and the DBs they are using.
     std::map<std::string, kvdbManager::RefInfo> retValue;
 
-    // Retrieve the list of DBs and scopes that are using them.
-    std::map<std::string, kvdbManager::RefInfo> handlersInfo = getKVDBHandlersInfo();
-
-    // Create a temporal map with the reverse lookup indexed by Scope instead of Database.
-    std::map<std::string, kvdbManager::RefCounter> refCounterMap;
-
-    // Iterate over the map of DBs and scopes that are using them.
-    for (const auto& [dbName, scopesUsingDB] : handlersInfo)
-    {
-        // Iterate over the scopes that are using thisDB.
-        for (const auto& [scopeName, countDBsUsingScope] : scopesUsingDB)
+    kvdbHandlerCollection_->visitRefs(
+        [&retValue](const RefCounter& ref)
         {
-            // Get the current refCounter for this scope.
-            auto& counterMap = refCounterMap[scopeName];
-
-            // Insert number of used DBs in current scope.
-            counterMap.addRef(dbName, countDBsUsingScope);
-
-            // Update the refCounter for this scope.
-            refCounterMap[scopeName] = counterMap;
-        }
-    }
-
-    for (auto& entry : refCounterMap)
-    {
-        const auto& scopeName = entry.first;
-        const auto& refCounter = entry.second;
-        const auto& refInfo = refCounter.getRefMap();
-        retValue.emplace(scopeName, refInfo);
-    }
+            if (const auto count = ref.count())
+            {
+                retValue[ref.scopeName()][ref.dbName()] += count;
+            }
+        });
 
     return retValue;
 }
@@ -79,31 +60,24 @@ std::map<std::string, RefInfo> KVDBManager::getKVDBScopesInfo()
 std::map<std::string, RefInfo> KVDBManager::getKVDBHandlersInfo() const
 {
     std::map<std::string, kvdbManager::RefInfo> retValue;
-    auto dbNames = kvdbHandlerCollection_->getDBNames();
 
-    for (const auto& dbName : dbNames)
-    {
-        auto refInfo = kvdbHandlerCollection_->getRefMap(dbName);
-        retValue.insert({dbName, refInfo});
-    }
+    kvdbHandlerCollection_->visitRefs(
+        [&retValue](const RefCounter& ref)
+        {
+            if (const auto count = ref.count())
+            {
+                retValue[ref.dbName()][ref.scopeName()] += count;
+            }
+        });
 
     return retValue;
 }
 
 uint32_t KVDBManager::getKVDBHandlersCount(const std::string& dbName) const
 {
-    const auto handlersInfo = getKVDBHandlersInfo();
-
     uint32_t retValue{0};
 
-    if (handlersInfo.count(dbName))
-    {
-        auto scopes = handlersInfo.at(dbName);
-        for (const auto& [key, val] : scopes)
-        {
-            retValue += val;
-        }
-    }
+    kvdbHandlerCollection_->visitRefs(dbName, [&retValue](const RefCounter& ref) { retValue += ref.count(); });
 
     return retValue;
 }
@@ -111,13 +85,9 @@ uint32_t KVDBManager::getKVDBHandlersCount(const std::string& dbName) const
 base::RespOrError<std::shared_ptr<IKVDBHandler>>
 KVDBManager::getKVDBHandler(const std::string& dbName, const std::string& scopeName)
 {
-    std::shared_ptr<rocksdb::ColumnFamilyHandle> cfHandle;
+    auto entry = getDbEntry(dbName);
 
-    if (mapCFHandles_.count(dbName))
-    {
-        cfHandle = mapCFHandles_[dbName];
-    }
-    else
+    if (!entry)
     {
         return base::Error{
             fmt::format(
@@ -127,20 +97,28 @@ KVDBManager::getKVDBHandler(const std::string& dbName, const std::string& scopeN
         };
     }
 
-    kvdbHandlerCollection_->addKVDBHandler(dbName, scopeName);
+    const auto refId = kvdbHandlerCollection_->acquire(dbName, scopeName);
+
+    if (std::atomic_load(&entry->staticTable))
+    {
+        return std::make_shared<StaticKVDBHandler>(entry, kvdbHandlerCollection_, refId, dbName, scopeName);
+    }
 
-    auto kvdbHandler = std::make_shared<KVDBHandler>(pRocksDB_, cfHandle, kvdbHandlerCollection_, dbName, scopeName);
+    auto kvdbHandler =
+        std::make_shared<KVDBHandler>(pRocksDB_, entry, kvdbHandlerCollection_, refId, dbName, scopeName);
 
     return kvdbHandler;
 }
 
 std::vector<std::string> KVDBManager::listDBs(const bool loaded)
 {
+    const auto dbEntries = getDbEntries();
+
     std::vector<std::string> spaces;
 
-    spaces.reserve(mapCFHandles_.size());
+    spaces.reserve(dbEntries->size());
 
-    for (const auto& cf : mapCFHandles_)
+    for (const auto& cf : *dbEntries)
     {
         spaces.push_back(cf.first);
     }
@@ -150,6 +128,8 @@ std::vector<std::string> KVDBManager::listDBs(const bool loaded)
 
 base::OptError KVDBManager::deleteDB(const std::string& name)
 {
+    std::lock_guard<std::mutex> lock(mutexDbEntries_);
+
     const auto refCount = getKVDBHandlersCount(name);
 
     if (refCount)
@@ -163,9 +143,11 @@ base::OptError KVDBManager::deleteDB(const std::string& name)
         };
     }
 
-    auto it = mapCFHandles_.find(name);
+    const auto dbEntries = getDbEntries();
 
-    if (it == mapCFHandles_.end())
+    auto it = dbEntries->find(name);
+
+    if (it == dbEntries->end())
     {
         return base::Error{
             fmt::format(
@@ -175,7 +157,7 @@ base::OptError KVDBManager::deleteDB(const std::string& name)
         };
     }
 
-    auto cfHandle = it->second;
+    auto cfHandle = it->second->cfHandle;
 
     try
     {
@@ -191,7 +173,14 @@ base::OptError KVDBManager::deleteDB(const std::string& name)
             };
         }
 
-        mapCFHandles_.erase(it);
+        pRocksDB_->Delete(rocksdb::WriteOptions(), pDefaultCFHandle_.get(), TTL_META_PREFIX + name);
+        pRocksDB_->Delete(rocksdb::WriteOptions(), pDefaultCFHandle_.get(), STATIC_META_PREFIX + name);
+
+        auto newDbEntries = std::make_shared<DbEntryMap>(*dbEntries);
+        newDbEntries->erase(name);
+        publishDbEntries(std::move(newDbEntries));
+
+        kvdbHandlerCollection_->release(name);
     }
     catch (const std::runtime_error& e)
     {
@@ -209,6 +198,8 @@ base::OptError KVDBManager::deleteDB(const std::string& name)
 
 base::OptError KVDBManager::createDB(const std::string& name)
 {
+    std::lock_guard<std::mutex> lock(mutexDbEntries_);
+
     if (existsDB(name))
     {
         return std::nullopt;
@@ -217,7 +208,7 @@ base::OptError KVDBManager::createDB(const std::string& name)
     return createColumnFamily(name);
 }
 
-base::OptError KVDBManager::createDB(const std::string& name, const std::string& path)
+base::OptError KVDBManager::createDB(const std::string& name, const std::string& path, std::chrono::seconds ttl)
 {
     auto result = getContentFromJsonFile(path);
 
@@ -235,7 +226,18 @@ base::OptError KVDBManager::createDB(const std::string& name, const std::string&
         return errorCreate;
     }
 
-    auto errorLoad = loadDBFromJson(name, content);
+    // The entries of the file expire like the ones written later
+    base::OptError errorLoad{};
+
+    if (ttl.count() != 0)
+    {
+        errorLoad = setDBTTL(name, ttl);
+    }
+
+    if (!errorLoad)
+    {
+        errorLoad = loadDBFromJson(name, content);
+    }
 
     if (errorLoad)
     {
@@ -255,18 +257,25 @@ base::OptError KVDBManager::createDB(const std::string& name, const std::string&
 base::OptError KVDBManager::loadDBFromJson(const std::string& name, const json::Json& content)
 {
     std::vector<std::pair<std::string, json::Json>> entries{};
-    std::shared_ptr<rocksdb::ColumnFamilyHandle> cfHandle{};
+    auto entry = getDbEntry(name);
 
-    if (mapCFHandles_.count(name))
+    if (!entry)
     {
-        cfHandle = mapCFHandles_[name];
+        return base::Error{
+            fmt::format(
+                "The DB '{}' does not exist.",
+                name
+            )
+        };
     }
 
-    if (!cfHandle)
+    std::shared_lock<std::shared_mutex> staticLock(entry->staticMutex);
+
+    if (entry->isStatic.load())
     {
         return base::Error{
             fmt::format(
-                "The DB '{}' does not exist.",
+                "The DB '{}' is static (read-only).",
                 name
             )
         };
@@ -274,9 +283,13 @@ base::OptError KVDBManager::loadDBFromJson(const std::string& name, const json::
 
     entries = content.getObject().value();
 
+    const auto defaultTTL = entry->ttl.load(std::memory_order_relaxed);
+    const auto expiresAt = defaultTTL > 0 ? ttl::now() + defaultTTL : 0;
+
     for (const auto& [key, val] : entries)
     {
-        const auto status = pRocksDB_->Put(rocksdb::WriteOptions(), cfHandle.get(), key, val.toStr());
+        const auto status =
+            pRocksDB_->Put(rocksdb::WriteOptions(), entry->cfHandle.get(), key, ttl::encode(val.toStr(), expiresAt));
         
         if (!status.ok())
         {
@@ -296,7 +309,297 @@ base::OptError KVDBManager::loadDBFromJson(const std::string& name, const json::
 
 bool KVDBManager::existsDB(const std::string& name)
 {
-    return mapCFHandles_.count(name) > 0;
+    return getDbEntries()->count(name) > 0;
+}
+
+base::OptError KVDBManager::setDBTTL(const std::string& name, std::chrono::seconds ttl)
+{
+    std::lock_guard<std::mutex> lock(mutexDbEntries_);
+
+    auto entry = getDbEntry(name);
+
+    if (!entry)
+    {
+        return base::Error{
+            fmt::format(
+                "The DB '{}' does not exist.",
+                name
+            )
+        };
+    }
+
+    if (ttl.count() < 0)
+    {
+        return base::Error{
+            fmt::format(
+                "Invalid TTL '{}' for DB '{}'.",
+                ttl.count(),
+                name
+            )
+        };
+    }
+
+    const auto metaKey = TTL_META_PREFIX + name;
+    const auto status = ttl.count() == 0
+        ? pRocksDB_->Delete(rocksdb::WriteOptions(), pDefaultCFHandle_.get(), metaKey)
+        : pRocksDB_->Put(rocksdb::WriteOptions(), pDefaultCFHandle_.get(), metaKey, std::to_string(ttl.count()));
+
+    if (!status.ok())
+    {
+        return base::Error{
+            fmt::format(
+                "Could not set the TTL of DB '{}': {}",
+                name,
+                status.ToString()
+            )
+        };
+    }
+
+    entry->ttl.store(ttl.count(), std::memory_order_relaxed);
+
+    return std::nullopt;
+}
+
+base::RespOrError<std::chrono::seconds> KVDBManager::getDBTTL(const std::string& name)
+{
+    auto entry = getDbEntry(name);
+
+    if (!entry)
+    {
+        return base::Error{
+            fmt::format(
+                "The DB '{}' does not exist.",
+                name
+            )
+        };
+    }
+
+    return std::chrono::seconds{entry->ttl.load(std::memory_order_relaxed)};
+}
+
+base::OptError KVDBManager::setStaticMode(const std::string& name, bool enabled)
+{
+    std::lock_guard<std::mutex> lock(mutexDbEntries_);
+
+    auto entry = getDbEntry(name);
+
+    if (!entry)
+    {
+        return base::Error{
+            fmt::format(
+                "The DB '{}' does not exist.",
+                name
+            )
+        };
+    }
+
+    // Waits for the writes in progress, and holds the new ones until the mode and the table agree
+    std::unique_lock<std::shared_mutex> staticLock(entry->staticMutex);
+
+    if (!enabled)
+    {
+        const auto status =
+            pRocksDB_->Delete(rocksdb::WriteOptions(), pDefaultCFHandle_.get(), STATIC_META_PREFIX + name);
+
+        if (!status.ok())
+        {
+            return base::Error{
+                fmt::format(
+                    "Could not disable the static mode of DB '{}': {}",
+                    name,
+                    status.ToString()
+                )
+            };
+        }
+
+        entry->isStatic.store(false);
+        std::atomic_store(&entry->staticTable, std::shared_ptr<const StaticTable>{});
+
+        return std::nullopt;
+    }
+
+    // No write is in progress, the table holds every one done before the switch
+    entry->isStatic.store(true);
+
+    auto tableResult = buildStaticTable(name, *entry);
+
+    if (base::isError(tableResult))
+    {
+        entry->isStatic.store(false);
+        return base::getError(tableResult);
+    }
+
+    const auto status = pRocksDB_->Put(rocksdb::WriteOptions(), pDefaultCFHandle_.get(), STATIC_META_PREFIX + name, "1");
+
+    if (!status.ok())
+    {
+        entry->isStatic.store(false);
+
+        return base::Error{
+            fmt::format(
+                "Could not enable the static mode of DB '{}': {}",
+                name,
+                status.ToString()
+            )
+        };
+    }
+
+    std::atomic_store(&entry->staticTable, base::getResponse(tableResult));
+
+    return std::nullopt;
+}
+
+json::Json KVDBManager::getStats()
+{
+    json::Json stats;
+    stats.setObject("/rocksdb");
+    stats.setObject("/dbs");
+
+    if (!pRocksDB_)
+    {
+        return stats;
+    }
+
+    const auto& statistics = rocksDBOptions_.statistics;
+    const uint64_t hits = statistics ? statistics->getTickerCount(rocksdb::BLOCK_CACHE_HIT) : 0;
+    const uint64_t misses = statistics ? statistics->getTickerCount(rocksdb::BLOCK_CACHE_MISS) : 0;
+
+    stats.setType("/rocksdb/block_cache_hits", hits);
+    stats.setType("/rocksdb/block_cache_misses", misses);
+    stats.setType("/rocksdb/block_cache_hit_rate",
+                  hits + misses > 0 ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0);
+
+    uint64_t value {0};
+
+    if (pRocksDB_->GetAggregatedIntProperty(rocksdb::DB::Properties::kCurSizeAllMemTables, &value))
+    {
+        stats.setType("/rocksdb/memtable_bytes", value);
+    }
+
+    if (pRocksDB_->GetAggregatedIntProperty(rocksdb::DB::Properties::kEstimatePendingCompactionBytes, &value))
+    {
+        stats.setType("/rocksdb/pending_compaction_bytes", value);
+    }
+
+    const auto dbEntries = getDbEntries();
+
+    for (const auto& [name, entry] : *dbEntries)
+    {
+        const auto dbPath = "/dbs" + json::Json::formatJsonPath(name, true);
+        stats.setObject(dbPath);
+
+        if (pRocksDB_->GetIntProperty(entry->cfHandle.get(), rocksdb::DB::Properties::kCurSizeAllMemTables, &value))
+        {
+            stats.setType(dbPath + "/memtable_bytes", value);
+        }
+
+        if (pRocksDB_->GetIntProperty(
+                entry->cfHandle.get(), rocksdb::DB::Properties::kEstimatePendingCompactionBytes, &value))
+        {
+            stats.setType(dbPath + "/pending_compaction_bytes", value);
+        }
+
+        for (std::size_t i = 0; i < DB_OP_COUNT; ++i)
+        {
+            const auto op = static_cast<DbOp>(i);
+            const auto& histogram = entry->stats.histogram(op);
+            const auto opPath = fmt::format("{}/ops/{}", dbPath, dbOpName(op));
+            const auto count = histogram.count();
+
+            stats.setType(opPath + "/count", count);
+            stats.setType(opPath + "/mean_us", count > 0 ? histogram.sum() / 1000.0 / count : 0.0);
+            stats.setType(opPath + "/p50_us", histogram.percentile(50) / 1000.0);
+            stats.setType(opPath + "/p90_us", histogram.percentile(90) / 1000.0);
+            stats.setType(opPath + "/p99_us", histogram.percentile(99) / 1000.0);
+        }
+    }
+
+    return stats;
+}
+
+bool KVDBManager::readStaticMode(const std::string& name)
+{
+    std::string value;
+    const auto status =
+        pRocksDB_->Get(rocksdb::ReadOptions(), pDefaultCFHandle_.get(), STATIC_META_PREFIX + name, &value);
+
+    return status.ok();
+}
+
+base::RespOrError<std::shared_ptr<const StaticTable>> KVDBManager::buildStaticTable(const std::string& name,
+                                                                                   const DbEntry& entry)
+{
+    rocksdb::ReadOptions readOptions;
+    readOptions.fill_cache = false;
+
+    std::unique_ptr<rocksdb::Iterator> iter{
+        pRocksDB_->NewIterator(readOptions, entry.cfHandle.get())
+    };
+
+    std::vector<std::pair<std::string, std::string>> entries;
+    const auto now = ttl::now();
+
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next())
+    {
+        const auto decoded = ttl::decode({iter->value().data(), iter->value().size()});
+        if (!ttl::isExpired(decoded, now))
+        {
+            entries.emplace_back(iter->key().ToString(), std::string{decoded.payload});
+        }
+    }
+
+    if (!iter->status().ok())
+    {
+        return base::Error{
+            fmt::format(
+                "Could not read DB '{}' to build its static table: {}",
+                name,
+                iter->status().ToString()
+            )
+        };
+    }
+
+    auto tableResult = StaticTable::build(entries);
+
+    if (base::isError(tableResult))
+    {
+        return base::Error{
+            fmt::format(
+                "Could not build the static table of DB '{}': {}",
+                name,
+                base::getError(tableResult).message
+            )
+        };
+    }
+
+    LOG_DEBUG("KVDB '{}' loaded in static mode: {} entries, {} bytes",
+              name,
+              base::getResponse(tableResult).size(),
+              base::getResponse(tableResult).buffer().size());
+
+    return std::make_shared<const StaticTable>(std::move(base::getResponse(tableResult)));
+}
+
+int64_t KVDBManager::readDBTTL(const std::string& name)
+{
+    std::string value;
+    const auto status =
+        pRocksDB_->Get(rocksdb::ReadOptions(), pDefaultCFHandle_.get(), TTL_META_PREFIX + name, &value);
+
+    if (!status.ok())
+    {
+        return 0;
+    }
+
+    try
+    {
+        return std::stoll(value);
+    }
+    catch (const std::exception& e)
+    {
+        LOG_WARNING("Invalid TTL '{}' stored for DB '{}', entries will not expire", value, name);
+        return 0;
+    }
 }
 
 void KVDBManager::initializeOptions()
@@ -305,6 +608,13 @@ void KVDBManager::initializeOptions()
     rocksDBOptions_.IncreaseParallelism();
     rocksDBOptions_.OptimizeLevelStyleCompaction();
     rocksDBOptions_.create_if_missing = true;
+    // Tickers only, timers would add a clock read to every operation
+    rocksDBOptions_.statistics = rocksdb::CreateDBStatistics();
+    rocksDBOptions_.statistics->set_stats_level(rocksdb::StatsLevel::kExceptTimers);
+
+    cfOptions_ = rocksdb::ColumnFamilyOptions(rocksDBOptions_);
+    cfOptions_.compaction_filter = &ttlCompactionFilter_;
+    cfOptions_.merge_operator = std::make_shared<merge::MergeOperator>();
 }
 
 void KVDBManager::initializeMainDB()
@@ -328,7 +638,7 @@ void KVDBManager::initializeMainDB()
     std::vector<std::string> columnNames;
 
     std::vector<rocksdb::ColumnFamilyDescriptor> cfDescriptors;
-    std::vector<rocksdb::ColumnFamilyHandle*> cfHandles;
+    std::vector<rocksdb::ColumnFamilyHandle*> rawCFHandles;
 
     bool hasDefaultCF{false};
 
@@ -343,7 +653,7 @@ void KVDBManager::initializeMainDB()
                 hasDefaultCF = true;
             }
 
-            auto newDescriptor = rocksdb::ColumnFamilyDescriptor(cfName, rocksdb::ColumnFamilyOptions());
+            auto newDescriptor = rocksdb::ColumnFamilyDescriptor(cfName, cfOptions_);
             cfDescriptors.push_back(newDescriptor);
         }
     }
@@ -351,32 +661,62 @@ void KVDBManager::initializeMainDB()
     if (!hasDefaultCF)
     {
         auto newDescriptor =
-            rocksdb::ColumnFamilyDescriptor(rocksdb::kDefaultColumnFamilyName, rocksdb::ColumnFamilyOptions());
+            rocksdb::ColumnFamilyDescriptor(rocksdb::kDefaultColumnFamilyName, cfOptions_);
 
         cfDescriptors.push_back(newDescriptor);
     }
 
     rocksdb::DB* rawRocksDBPtr{nullptr};
 
-    auto statusOpen = rocksdb::DB::Open(rocksDBOptions_, dbNameFullPath, cfDescriptors, &cfHandles, &rawRocksDBPtr);
+    auto statusOpen = rocksdb::DB::Open(rocksDBOptions_, dbNameFullPath, cfDescriptors, &rawCFHandles, &rawRocksDBPtr);
 
     if (statusOpen.ok())
     {
         pRocksDB_ = std::shared_ptr<rocksdb::DB>(rawRocksDBPtr);
 
+        auto dbEntries = std::make_shared<DbEntryMap>();
+
+        for (std::size_t cfDescriptorIndex = 0; cfDescriptorIndex < cfDescriptors.size(); cfDescriptorIndex++)
+        {
+            if (rocksdb::kDefaultColumnFamilyName == cfDescriptors[cfDescriptorIndex].name)
+            {
+                pDefaultCFHandle_ = createSharedCFHandle(rawCFHandles[cfDescriptorIndex]);
+            }
+        }
+
+        // The TTL of each DB is kept in the default CF, so it must be opened first
         for (std::size_t cfDescriptorIndex = 0; cfDescriptorIndex < cfDescriptors.size(); cfDescriptorIndex++)
         {
             const auto& dbName = cfDescriptors[cfDescriptorIndex].name;
 
             if (rocksdb::kDefaultColumnFamilyName != dbName)
             {
-                mapCFHandles_.emplace(dbName, createSharedCFHandle(cfHandles[cfDescriptorIndex]));
-            }
-            else
-            {
-                pDefaultCFHandle_ = createSharedCFHandle(cfHandles[cfDescriptorIndex]);
+                auto entry =
+                    std::make_shared<DbEntry>(createSharedCFHandle(rawCFHandles[cfDescriptorIndex]), readDBTTL(dbName));
+
+                if (readStaticMode(dbName))
+                {
+                    auto tableResult = buildStaticTable(dbName, *entry);
+
+                    if (base::isError(tableResult))
+                    {
+                        LOG_WARNING("KVDB '{}' falls back to dynamic mode: {}",
+                                    dbName,
+                                    base::getError(tableResult).message);
+                    }
+                    else
+                    {
+                        entry->isStatic.store(true);
+                        entry->staticTable = base::getResponse(tableResult);
+                    }
+                }
+
+                dbEntries->emplace(dbName, std::move(entry));
             }
         }
+
+        std::lock_guard<std::mutex> lock(mutexDbEntries_);
+        publishDbEntries(std::move(dbEntries));
     }
     else
     {
@@ -392,7 +732,11 @@ void KVDBManager::initializeMainDB()
 
 void KVDBManager::finalizeMainDB()
 {
-    mapCFHandles_.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutexDbEntries_);
+        publishDbEntries(std::make_shared<const DbEntryMap>());
+    }
+
     pDefaultCFHandle_.reset();
     pRocksDB_.reset();
 }   
@@ -469,7 +813,7 @@ KVDBManager::createSharedCFHandle(rocksdb::ColumnFamilyHandle* cfRawPtr)
 base::OptError KVDBManager::createColumnFamily(const std::string& name)
 {
     rocksdb::ColumnFamilyHandle* cfHandle{nullptr};
-    rocksdb::Status status{pRocksDB_->CreateColumnFamily(rocksdb::ColumnFamilyOptions(), name, &cfHandle)};
+    rocksdb::Status status{pRocksDB_->CreateColumnFamily(cfOptions_, name, &cfHandle)};
 
     if (!status.ok())
     {
@@ -481,10 +825,36 @@ base::OptError KVDBManager::createColumnFamily(const std::string& name)
         };
     }
 
-    mapCFHandles_.emplace(name, createSharedCFHandle(cfHandle));
+    auto newDbEntries = std::make_shared<DbEntryMap>(*getDbEntries());
+    newDbEntries->emplace(name, std::make_shared<DbEntry>(createSharedCFHandle(cfHandle)));
+    publishDbEntries(std::move(newDbEntries));
 
     return std::nullopt;
 }
 
+std::shared_ptr<const DbEntryMap> KVDBManager::getDbEntries() const
+{
+    return std::atomic_load(&dbEntries_);
+}
+
+std::shared_ptr<DbEntry> KVDBManager::getDbEntry(const std::string& name) const
+{
+    const auto dbEntries = getDbEntries();
+
+    const auto it = dbEntries->find(name);
+
+    if (it == dbEntries->end())
+    {
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+void KVDBManager::publishDbEntries(std::shared_ptr<const DbEntryMap> dbEntries)
+{
+    std::atomic_store(&dbEntries_, std::move(dbEntries));
+}
+
 } // namespace kvdbManager
 
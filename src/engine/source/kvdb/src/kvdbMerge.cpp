@@ -0,0 +1,173 @@
+#include <kvdb/kvdbMerge.hpp>
+
+#include <charconv>
+#include <limits>
+
+#include <rapidjson/document.h>
+#include <rapidjson/writer.h>
+
+#include <kvdb/kvdbTTL.hpp>
+
+namespace kvdbManager::merge
+{
+
+namespace
+{
+
+constexpr std::size_t OPERAND_HEADER_SIZE {1 + sizeof(uint64_t)};
+
+struct Operand
+{
+    Op op;
+    std::string_view payload;
+    int64_t expiresAt;
+};
+
+bool decodeOperand(std::string_view raw, Operand& operand)
+{
+    if (raw.size() < OPERAND_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    uint64_t expiration {0};
+    for (std::size_t i = 1; i < OPERAND_HEADER_SIZE; ++i)
+    {
+        expiration = (expiration << 8) | static_cast<unsigned char>(raw[i]);
+    }
+
+    operand.op = static_cast<Op>(raw[0]);
+    operand.payload = raw.substr(OPERAND_HEADER_SIZE);
+    operand.expiresAt = static_cast<int64_t>(expiration);
+
+    return operand.op == Op::INCREMENT || operand.op == Op::APPEND;
+}
+
+bool applyIncrement(rapidjson::Document& value, std::string_view payload)
+{
+    int64_t delta {0};
+    const auto [ptr, ec] = std::from_chars(payload.data(), payload.data() + payload.size(), delta);
+    if (ec != std::errc() || ptr != payload.data() + payload.size())
+    {
+        return false;
+    }
+
+    // Counters saturate instead of wrapping around
+    const int64_t current = value.IsInt64() ? value.GetInt64() : 0;
+    int64_t result {0};
+    if (__builtin_add_overflow(current, delta, &result))
+    {
+        result = delta > 0 ? std::numeric_limits<int64_t>::max() : std::numeric_limits<int64_t>::min();
+    }
+    value.SetInt64(result);
+
+    return true;
+}
+
+void applyAppend(rapidjson::Document& value, std::string_view payload)
+{
+    if (!value.IsArray())
+    {
+        value.SetArray();
+    }
+
+    for (const auto& element : value.GetArray())
+    {
+        if (element.IsString() && std::string_view {element.GetString(), element.GetStringLength()} == payload)
+        {
+            return;
+        }
+    }
+
+    value.PushBack(rapidjson::Value(payload.data(), static_cast<rapidjson::SizeType>(payload.size()),
+                                    value.GetAllocator()),
+                   value.GetAllocator());
+}
+
+} // namespace
+
+std::string encodeOperand(Op op, std::string_view payload, int64_t expiresAt)
+{
+    std::string operand;
+    operand.reserve(OPERAND_HEADER_SIZE + payload.size());
+    operand.push_back(static_cast<char>(op));
+
+    const auto expiration = static_cast<uint64_t>(expiresAt);
+    for (int shift = 56; shift >= 0; shift -= 8)
+    {
+        operand.push_back(static_cast<char>((expiration >> shift) & 0xFF));
+    }
+
+    operand.append(payload);
+
+    return operand;
+}
+
+bool MergeOperator::FullMergeV2(const MergeOperationInput& mergeIn, MergeOperationOutput* mergeOut) const
+{
+    rapidjson::Document value;
+    int64_t expiresAt {0};
+    bool exists {false};
+
+    if (mergeIn.existing_value != nullptr)
+    {
+        const auto decoded =
+            ttl::decode({mergeIn.existing_value->data(), mergeIn.existing_value->size()});
+
+        if (!ttl::isExpired(decoded, ttl::now()))
+        {
+            value.Parse(decoded.payload.data(), decoded.payload.size());
+            if (value.HasParseError())
+            {
+                value.SetNull();
+            }
+
+            expiresAt = decoded.expiresAt;
+            exists = true;
+        }
+    }
+
+    // Returning false would make RocksDB report every read of the key as corrupted, malformed operands are skipped
+    for (const auto& rawOperand : mergeIn.operand_list)
+    {
+        Operand operand;
+        if (!decodeOperand({rawOperand.data(), rawOperand.size()}, operand))
+        {
+            continue;
+        }
+
+        if (operand.op == Op::INCREMENT)
+        {
+            if (!applyIncrement(value, operand.payload))
+            {
+                continue;
+            }
+        }
+        else
+        {
+            applyAppend(value, operand.payload);
+        }
+
+        if (!exists)
+        {
+            // The first operand creates the value, so it decides its expiration
+            expiresAt = operand.expiresAt;
+            exists = true;
+        }
+    }
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    value.Accept(writer);
+
+    mergeOut->new_value = ttl::encode({buffer.GetString(), buffer.GetSize()}, expiresAt);
+
+    return true;
+}
+
+const char* MergeOperator::Name() const
+{
+    return "kvdb.MergeOperator";
+}
+
+} // namespace kvdbManager::merge
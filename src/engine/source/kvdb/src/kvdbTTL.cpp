@@ -0,0 +1,66 @@
+#include <kvdb/kvdbTTL.hpp>
+
+#include <chrono>
+
+namespace kvdbManager::ttl
+{
+
+int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+std::string encode(std::string_view value, int64_t expiresAt)
+{
+    if (expiresAt == 0 && value.substr(0, MAGIC.size()) != MAGIC)
+    {
+        return std::string {value};
+    }
+
+    std::string stored;
+    stored.reserve(HEADER_SIZE + value.size());
+    stored.append(MAGIC);
+
+    const auto expiration = static_cast<uint64_t>(expiresAt);
+    for (int shift = 56; shift >= 0; shift -= 8)
+    {
+        stored.push_back(static_cast<char>((expiration >> shift) & 0xFF));
+    }
+
+    stored.append(value);
+
+    return stored;
+}
+
+Value decode(std::string_view stored)
+{
+    if (stored.size() < HEADER_SIZE || stored.substr(0, MAGIC.size()) != MAGIC)
+    {
+        return {stored, 0};
+    }
+
+    uint64_t expiration {0};
+    for (std::size_t i = MAGIC.size(); i < HEADER_SIZE; ++i)
+    {
+        expiration = (expiration << 8) | static_cast<unsigned char>(stored[i]);
+    }
+
+    return {stored.substr(HEADER_SIZE), static_cast<int64_t>(expiration)};
+}
+
+bool CompactionFilter::Filter(int /*level*/,
+                              const rocksdb::Slice& /*key*/,
+                              const rocksdb::Slice& existingValue,
+                              std::string* /*newValue*/,
+                              bool* /*valueChanged*/) const
+{
+    return isExpired(decode({existingValue.data(), existingValue.size()}), now());
+}
+
+const char* CompactionFilter::Name() const
+{
+    return "kvdb.TTLCompactionFilter";
+}
+
+} // namespace kvdbManager::ttl
@@ -1,61 +1,28 @@
+
 #include <kvdb/refCounter.hpp>
 
 namespace kvdbManager
 {
 
-void RefCounter::addRef(const std::string& name, const uint32_t times)
+void RefCounter::addRef(const uint32_t times) noexcept
 {
-    refMap_[name] += times;
-}
-
-void RefCounter::removeRef(const std::string& name)
-{
-    auto it = refMap_.find(name);
-
-    if (it != refMap_.end())
-    {
-        auto& [key, val] = *it;
-        val--;
-        if (0 == val)
-        {
-            refMap_.erase(it);
-        }
-    }
+    count_.fetch_add(times, std::memory_order_relaxed);
 }
 
-uint32_t RefCounter::count(const std::string& name) const
+void RefCounter::removeRef() noexcept
 {
-    auto it = refMap_.find(name);
+    auto current = count_.load(std::memory_order_relaxed);
 
-    if (it != refMap_.end())
+    // Never go below zero, an unbalanced remove must not wrap the counter
+    while (current > 0
+           && !count_.compare_exchange_weak(current, current - 1, std::memory_order_relaxed))
     {
-        return it->second;
     }
-
-    return 0;
 }
 
-bool RefCounter::empty() const
+uint32_t RefCounter::count() const noexcept
 {
-    return refMap_.empty();
+    return count_.load(std::memory_order_relaxed);
 }
 
-std::vector<std::string> RefCounter::getRefNames() const
-{
-    std::vector<std::string> names;
-
-    for (const auto& [name, count] : refMap_)
-    {
-        names.push_back(name);
-    }
-
-    return names;
-}
-
-const std::map<std::string, uint32_t>& RefCounter::getRefMap() const
-{
-    return refMap_;
-}
-
-
 } // namespace kvdbManager
@@ -0,0 +1,211 @@
+#include <kvdb/staticKVDBHandler.hpp>
+
+#include <fmt/format.h>
+
+namespace kvdbManager
+{
+
+StaticKVDBHandler::StaticKVDBHandler(std::weak_ptr<DbEntry> weakEntry,
+                                     std::shared_ptr<IKVDBHandlerCollection> collection,
+                                     RefId refId,
+                                     const std::string& dbName,
+                                     const std::string& scopeName)
+    : weakEntry_{std::move(weakEntry)}
+    , spCollection_{std::move(collection)}
+    , refId_{refId}
+    , dbName_{dbName}
+    , scopeName_{scopeName}
+{}
+
+StaticKVDBHandler::~StaticKVDBHandler()
+{
+    spCollection_->removeRef(refId_);
+}
+
+base::Error StaticKVDBHandler::readOnlyError(const std::string& key) const
+{
+    return base::Error{
+        fmt::format(
+            "Cannot write key '{}'. Error: The DB '{}' is static (read-only)",
+            key,
+            dbName_
+        )
+    };
+}
+
+base::RespOrError<std::shared_ptr<const StaticTable>> StaticKVDBHandler::table() const
+{
+    auto pEntry = weakEntry_.lock();
+
+    if (!pEntry)
+    {
+        return base::Error{
+            "Cannot access RocksDB Column Family Handle!"
+        };
+    }
+
+    auto table = std::atomic_load(&pEntry->staticTable);
+
+    if (!table)
+    {
+        return base::Error{
+            fmt::format(
+                "The static mode of DB '{}' was disabled, the handler must be taken again",
+                dbName_
+            )
+        };
+    }
+
+    return table;
+}
+
+base::OptError StaticKVDBHandler::set(const std::string& key, const std::string& value)
+{
+    return readOnlyError(key);
+}
+
+base::OptError StaticKVDBHandler::set(const std::string& key, const json::Json& value)
+{
+    return readOnlyError(key);
+}
+
+base::OptError StaticKVDBHandler::set(const std::string& key, const std::string& value, std::chrono::seconds ttl)
+{
+    return readOnlyError(key);
+}
+
+base::OptError StaticKVDBHandler::setBatch(const std::vector<std::pair<std::string, std::string>>& entries)
+{
+    if (entries.empty())
+    {
+        return std::nullopt;
+    }
+
+    return readOnlyError(entries.front().first);
+}
+
+base::OptError StaticKVDBHandler::add(const std::string& key)
+{
+    return readOnlyError(key);
+}
+
+base::OptError StaticKVDBHandler::increment(const std::string& key, int64_t delta)
+{
+    return readOnlyError(key);
+}
+
+base::OptError StaticKVDBHandler::appendToSet(const std::string& key, const std::string& value)
+{
+    return readOnlyError(key);
+}
+
+base::OptError StaticKVDBHandler::remove(const std::string& key)
+{
+    return readOnlyError(key);
+}
+
+base::RespOrError<bool> StaticKVDBHandler::contains(const std::string& key)
+{
+    const auto table = this->table();
+
+    if (base::isError(table))
+    {
+        return base::getError(table);
+    }
+
+    return base::getResponse(table)->find(key).has_value();
+}
+
+base::RespOrError<std::string> StaticKVDBHandler::get(const std::string& key)
+{
+    const auto table = this->table();
+
+    if (base::isError(table))
+    {
+        return base::getError(table);
+    }
+
+    const auto value = base::getResponse(table)->find(key);
+
+    if (!value)
+    {
+        return base::Error{
+            fmt::format(
+                "Cannot get key '{}'. Error: Key not found",
+                key
+            )
+        };
+    }
+
+    return std::string{*value};
+}
+
+base::RespOrError<std::list<std::pair<std::string, std::string>>>
+StaticKVDBHandler::dump(const unsigned int page, const unsigned int records)
+{
+    return pageContent(page, records, {});
+}
+
+base::RespOrError<std::list<std::pair<std::string, std::string>>>
+StaticKVDBHandler::search(const std::string& prefix, const unsigned int page, const unsigned int records)
+{
+    return pageContent(page, records, prefix);
+}
+
+base::OptError StaticKVDBHandler::exportEntries(const EntryVisitor& visitor)
+{
+    const auto table = this->table();
+
+    if (base::isError(table))
+    {
+        return base::getError(table);
+    }
+
+    base::getResponse(table)->forEach(visitor);
+
+    return std::nullopt;
+}
+
+base::RespOrError<std::list<std::pair<std::string, std::string>>>
+StaticKVDBHandler::pageContent(const unsigned int page, const unsigned int records, std::string_view prefix) const
+{
+    const auto table = this->table();
+
+    if (base::isError(table))
+    {
+        return base::getError(table);
+    }
+
+    // Same paging as KVDBHandler, over the key ordered records of the table
+    std::list<std::pair<std::string, std::string>> content;
+
+    const unsigned int fromRecords = (page - 1) * records;
+    const unsigned int toRecords = fromRecords + records;
+
+    unsigned int i = 0;
+
+    base::getResponse(table)->forEach(
+        [&](std::string_view key, std::string_view value)
+        {
+            if (i >= toRecords)
+            {
+                return false;
+            }
+
+            if (key.substr(0, prefix.size()) == prefix)
+            {
+                if (i >= fromRecords)
+                {
+                    content.emplace_back(key, value);
+                }
+
+                ++i;
+            }
+
+            return true;
+        });
+
+    return content;
+}
+
+} // namespace kvdbManager
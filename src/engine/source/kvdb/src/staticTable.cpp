@@ -0,0 +1,314 @@
+#include <kvdb/staticTable.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <fmt/format.h>
+
+namespace kvdbManager
+{
+
+namespace
+{
+
+constexpr std::size_t HEADER_SIZE {4 * sizeof(uint32_t) + sizeof(uint64_t)};
+constexpr std::size_t RECORD_HEADER_SIZE {2 * sizeof(uint32_t)};
+constexpr uint32_t MAX_SEED_TRIALS {1U << 26};
+
+uint64_t fmix64(uint64_t hash)
+{
+    // murmur3 finalizer
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+uint64_t hashKey(std::string_view key)
+{
+    // FNV-1a, finalized because its high bits are poorly distributed for similar keys
+    uint64_t hash {0xcbf29ce484222325ULL};
+    for (const unsigned char c : key)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+
+    return fmix64(hash);
+}
+
+uint64_t mix(uint64_t hash, uint32_t seed)
+{
+    return fmix64(hash + (static_cast<uint64_t>(seed) + 1) * 0x9E3779B97F4A7C15ULL);
+}
+
+inline uint32_t bucketOf(uint64_t hash, uint32_t buckets)
+{
+    return static_cast<uint32_t>((hash >> 32) % buckets);
+}
+
+inline uint32_t slotOf(uint64_t hash, uint32_t seed, uint32_t count)
+{
+    return static_cast<uint32_t>(mix(hash, seed) % count);
+}
+
+inline uint32_t readU32(const char* ptr)
+{
+    uint32_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+inline void appendU32(std::string& buffer, uint32_t value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+inline void writeU32(std::string& buffer, std::size_t offset, uint32_t value)
+{
+    std::memcpy(buffer.data() + offset, &value, sizeof(value));
+}
+
+} // namespace
+
+base::RespOrError<StaticTable> StaticTable::build(const std::vector<std::pair<std::string, std::string>>& entries)
+{
+    if (entries.size() > std::numeric_limits<uint32_t>::max())
+    {
+        return base::Error {"Too many entries for a static table"};
+    }
+
+    const auto count = static_cast<uint32_t>(entries.size());
+    const uint32_t buckets = (count + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET;
+
+    uint64_t recordsSize {0};
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (i > 0 && entries[i - 1].first >= entries[i].first)
+        {
+            return base::Error {
+                fmt::format("Static table keys must be unique and sorted, found '{}' after '{}'",
+                            entries[i].first,
+                            entries[i - 1].first)};
+        }
+
+        recordsSize += RECORD_HEADER_SIZE + entries[i].first.size() + entries[i].second.size();
+    }
+
+    if (recordsSize > std::numeric_limits<uint32_t>::max())
+    {
+        return base::Error {"Static table data exceeds 4 GiB"};
+    }
+
+    // Place the keys: buckets from largest to smallest, each gets the first seed that sends all its keys to free
+    // slots.
+    std::vector<uint64_t> hashes(count);
+    std::vector<std::vector<uint32_t>> bucketKeys(buckets);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        hashes[i] = hashKey(entries[i].first);
+        bucketKeys[bucketOf(hashes[i], buckets)].push_back(i);
+    }
+
+    std::vector<uint32_t> bucketOrder(buckets);
+    for (uint32_t b = 0; b < buckets; ++b)
+    {
+        bucketOrder[b] = b;
+    }
+    std::stable_sort(bucketOrder.begin(),
+                     bucketOrder.end(),
+                     [&bucketKeys](uint32_t lhs, uint32_t rhs)
+                     { return bucketKeys[lhs].size() > bucketKeys[rhs].size(); });
+
+    std::vector<uint32_t> seeds(buckets, 0);
+    std::vector<uint32_t> slotEntry(count);
+    std::vector<bool> taken(count, false);
+    std::vector<uint32_t> candidate;
+
+    for (const auto b : bucketOrder)
+    {
+        const auto& keys = bucketKeys[b];
+        if (keys.empty())
+        {
+            break;
+        }
+
+        bool placed {false};
+        for (uint32_t seed = 0; seed < MAX_SEED_TRIALS && !placed; ++seed)
+        {
+            candidate.clear();
+            placed = true;
+
+            for (const auto key : keys)
+            {
+                const auto slot = slotOf(hashes[key], seed, count);
+                if (taken[slot] || std::find(candidate.begin(), candidate.end(), slot) != candidate.end())
+                {
+                    placed = false;
+                    break;
+                }
+                candidate.push_back(slot);
+            }
+
+            if (placed)
+            {
+                seeds[b] = seed;
+                for (std::size_t k = 0; k < keys.size(); ++k)
+                {
+                    taken[candidate[k]] = true;
+                    slotEntry[candidate[k]] = keys[k];
+                }
+            }
+        }
+
+        if (!placed)
+        {
+            return base::Error {"Could not build the perfect hash of the static table"};
+        }
+    }
+
+    // Serialize
+    std::string buffer;
+    buffer.reserve(HEADER_SIZE + (buckets + count) * sizeof(uint32_t) + recordsSize);
+
+    appendU32(buffer, MAGIC);
+    appendU32(buffer, VERSION);
+    appendU32(buffer, count);
+    appendU32(buffer, buckets);
+    buffer.append(reinterpret_cast<const char*>(&recordsSize), sizeof(recordsSize));
+
+    for (const auto seed : seeds)
+    {
+        appendU32(buffer, seed);
+    }
+
+    const auto slotsOffset = buffer.size();
+    buffer.append(count * sizeof(uint32_t), '\0');
+
+    const auto recordsOffset = buffer.size();
+    std::vector<uint32_t> entryOffset(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const auto& [key, value] = entries[i];
+        entryOffset[i] = static_cast<uint32_t>(buffer.size() - recordsOffset);
+        appendU32(buffer, static_cast<uint32_t>(key.size()));
+        appendU32(buffer, static_cast<uint32_t>(value.size()));
+        buffer.append(key);
+        buffer.append(value);
+    }
+
+    for (uint32_t slot = 0; slot < count; ++slot)
+    {
+        writeU32(buffer, slotsOffset + slot * sizeof(uint32_t), entryOffset[slotEntry[slot]]);
+    }
+
+    return StaticTable {std::move(buffer)};
+}
+
+base::RespOrError<StaticTable> StaticTable::fromBuffer(std::string buffer)
+{
+    if (buffer.size() < HEADER_SIZE || readU32(buffer.data()) != MAGIC)
+    {
+        return base::Error {"Invalid static table: bad header"};
+    }
+
+    if (readU32(buffer.data() + 4) != VERSION)
+    {
+        return base::Error {fmt::format("Invalid static table: unsupported version {}", readU32(buffer.data() + 4))};
+    }
+
+    const auto count = readU32(buffer.data() + 8);
+    const auto buckets = readU32(buffer.data() + 12);
+    uint64_t recordsSize;
+    std::memcpy(&recordsSize, buffer.data() + 16, sizeof(recordsSize));
+
+    const auto recordsOffset = HEADER_SIZE + (static_cast<uint64_t>(buckets) + count) * sizeof(uint32_t);
+    if (buckets != (static_cast<uint64_t>(count) + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET
+        || recordsOffset + recordsSize != buffer.size())
+    {
+        return base::Error {"Invalid static table: inconsistent sizes"};
+    }
+
+    StaticTable table {std::move(buffer)};
+
+    // Every slot must point to a record fully inside the buffer
+    for (uint32_t slot = 0; slot < count; ++slot)
+    {
+        const auto offset =
+            static_cast<uint64_t>(readU32(table.buffer_.data() + table.slotsOffset_ + slot * sizeof(uint32_t)));
+        if (offset + RECORD_HEADER_SIZE > recordsSize)
+        {
+            return base::Error {"Invalid static table: slot out of bounds"};
+        }
+
+        const auto* record = table.buffer_.data() + table.recordsOffset_ + offset;
+        if (offset + RECORD_HEADER_SIZE + readU32(record) + readU32(record + 4) > recordsSize)
+        {
+            return base::Error {"Invalid static table: record out of bounds"};
+        }
+    }
+
+    return table;
+}
+
+StaticTable::StaticTable(std::string buffer)
+    : buffer_ {std::move(buffer)}
+{
+    count_ = readU32(buffer_.data() + 8);
+    buckets_ = readU32(buffer_.data() + 12);
+    seedsOffset_ = HEADER_SIZE;
+    slotsOffset_ = seedsOffset_ + buckets_ * sizeof(uint32_t);
+    recordsOffset_ = slotsOffset_ + count_ * sizeof(uint32_t);
+}
+
+std::pair<std::string_view, std::string_view> StaticTable::record(uint32_t offset) const
+{
+    const auto* ptr = buffer_.data() + recordsOffset_ + offset;
+    const auto keyLen = readU32(ptr);
+    const auto valueLen = readU32(ptr + 4);
+
+    return {{ptr + RECORD_HEADER_SIZE, keyLen}, {ptr + RECORD_HEADER_SIZE + keyLen, valueLen}};
+}
+
+std::optional<std::string_view> StaticTable::find(std::string_view key) const
+{
+    if (count_ == 0)
+    {
+        return std::nullopt;
+    }
+
+    const auto hash = hashKey(key);
+    const auto seed = readU32(buffer_.data() + seedsOffset_ + bucketOf(hash, buckets_) * sizeof(uint32_t));
+    const auto slot = slotOf(hash, seed, count_);
+    const auto [storedKey, value] = record(readU32(buffer_.data() + slotsOffset_ + slot * sizeof(uint32_t)));
+
+    if (storedKey != key)
+    {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+void StaticTable::forEach(const std::function<bool(std::string_view key, std::string_view value)>& visitor) const
+{
+    std::size_t offset {0};
+    const auto recordsSize = buffer_.size() - recordsOffset_;
+
+    for (uint32_t i = 0; i < count_ && offset < recordsSize; ++i)
+    {
+        const auto [key, value] = record(static_cast<uint32_t>(offset));
+        if (!visitor(key, value))
+        {
+            return;
+        }
+
+        offset += RECORD_HEADER_SIZE + key.size() + value.size();
+    }
+}
+
+} // namespace kvdbManager
@@ -59,7 +59,17 @@ public:
 
     MOCK_METHOD((base::OptError), set, (const std::string& key, const std::string& value), (override));
     MOCK_METHOD((base::OptError), set, (const std::string& key, const json::Json& value), (override));
+    MOCK_METHOD((base::OptError),
+                set,
+                (const std::string& key, const std::string& value, std::chrono::seconds ttl),
+                (override));
+    MOCK_METHOD((base::OptError),
+                setBatch,
+                ((const std::vector<std::pair<std::string, std::string>>& entries)),
+                (override));
     MOCK_METHOD((base::OptError), add, (const std::string& key), (override));
+    MOCK_METHOD((base::OptError), increment, (const std::string& key, int64_t delta), (override));
+    MOCK_METHOD((base::OptError), appendToSet, (const std::string& key, const std::string& value), (override));
     MOCK_METHOD((base::OptError), remove, (const std::string& key), (override));
     MOCK_METHOD((base::RespOrError<bool>), contains, (const std::string& key), (override));
     MOCK_METHOD((base::RespOrError<std::string>), get, (const std::string& key), (override));
@@ -76,6 +86,7 @@ public:
                 search,
                 (const std::string& prefix),
                 ());
+    MOCK_METHOD((base::OptError), exportEntries, (const kvdbManager::EntryVisitor& visitor), (override));
 };
 
 
@@ -16,8 +16,9 @@ class MockKVDBHandlerCollection : public kvdbManager::IKVDBHandlerCollection
 {
 public:
     virtual ~MockKVDBHandlerCollection() = default;
-    MOCK_METHOD((void), addKVDBHandler, (const std::string& dbName, const std::string& scopeName), (override));
-    MOCK_METHOD((void), removeKVDBHandler, (const std::string& dbName, const std::string& scopeName), (override));
+    MOCK_METHOD((kvdbManager::RefId), getRefId, (const std::string& dbName, const std::string& scopeName), (override));
+    MOCK_METHOD((void), addRef, (kvdbManager::RefId id), (override));
+    MOCK_METHOD((void), removeRef, (kvdbManager::RefId id), (override));
 };
 
 } // namespace kvdb::mocks
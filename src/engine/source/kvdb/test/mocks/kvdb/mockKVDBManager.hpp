@@ -49,9 +49,16 @@ public:
     MOCK_METHOD((std::vector<std::string>), listDBs, (const bool loaded), (override));
     MOCK_METHOD((base::OptError), deleteDB, (const std::string& name), (override));
     MOCK_METHOD((base::OptError), createDB, (const std::string& name), (override));
-    MOCK_METHOD((base::OptError), createDB, (const std::string& name, const std::string& path), (override));
+    MOCK_METHOD((base::OptError),
+                createDB,
+                (const std::string& name, const std::string& path, std::chrono::seconds ttl),
+                (override));
     MOCK_METHOD((base::OptError), loadDBFromJson, (const std::string& name, const json::Json& content), (override));
     MOCK_METHOD((bool), existsDB, (const std::string& name), (override));
+    MOCK_METHOD((base::OptError), setDBTTL, (const std::string& name, std::chrono::seconds ttl), (override));
+    MOCK_METHOD((base::RespOrError<std::chrono::seconds>), getDBTTL, (const std::string& name), (override));
+    MOCK_METHOD((base::OptError), setStaticMode, (const std::string& name, bool enabled), (override));
+    MOCK_METHOD((json::Json), getStats, (), (override));
     MOCK_METHOD((std::map<std::string, kvdbManager::RefInfo>), getKVDBScopesInfo, (), ());
     MOCK_METHOD((std::map<std::string, kvdbManager::RefInfo>), getKVDBHandlersInfo, (), (const));
     MOCK_METHOD((base::RespOrError<std::shared_ptr<kvdbManager::IKVDBHandler>>),
@@ -1,4 +1,5 @@
 #include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
 #include <iostream>
 #include <random>
@@ -289,6 +290,188 @@ TEST_F(KVDBHandlerTest, DumpWihoutKeys)
     ASSERT_EQ(result.size(), 0);
 }
 
+TEST_F(KVDBHandlerTest, ExpiredEntriesAreMissing)
+{
+    ASSERT_FALSE(m_kvdbManager->createDB("ExpiredEntriesAreMissing"));
+    ASSERT_FALSE(m_kvdbManager->createDB("ExpiredEntriesDefaultTTL"));
+    ASSERT_FALSE(m_kvdbManager->setDBTTL("ExpiredEntriesDefaultTTL", std::chrono::seconds(1)));
+
+    auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("ExpiredEntriesAreMissing", "scope1"));
+    auto defaultTTLHandler = base::getResponse(m_kvdbManager->getKVDBHandler("ExpiredEntriesDefaultTTL", "scope1"));
+
+    ASSERT_FALSE(handler->set("short", "\"value\"", std::chrono::seconds(1)));
+    ASSERT_FALSE(handler->set("long", "\"value\"", std::chrono::seconds(3600)));
+    ASSERT_FALSE(handler->set("forever", "\"value\""));
+    ASSERT_FALSE(defaultTTLHandler->set("short", "\"value\""));
+    ASSERT_FALSE(defaultTTLHandler->set("forever", "\"value\"", std::chrono::seconds(0)));
+
+    ASSERT_EQ(base::getResponse(handler->get("short")), "\"value\"");
+    ASSERT_EQ(base::getResponse(defaultTTLHandler->get("short")), "\"value\"");
+
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+
+    auto resultGet = handler->get("short");
+    ASSERT_TRUE(base::isError(resultGet));
+    ASSERT_EQ(base::getError(resultGet).message, "Cannot get key 'short'. Error: Key not found");
+    ASSERT_FALSE(base::getResponse(handler->contains("short")));
+    ASSERT_TRUE(base::getResponse(handler->contains("long")));
+    ASSERT_EQ(base::getResponse(handler->get("long")), "\"value\"");
+    ASSERT_EQ(base::getResponse(handler->get("forever")), "\"value\"");
+
+    const auto dump = base::getResponse(handler->dump(1, 100));
+    ASSERT_EQ(dump.size(), 2);
+    ASSERT_EQ(dump.front().first, "forever");
+    ASSERT_EQ(dump.back().first, "long");
+    ASSERT_EQ(dump.back().second, "\"value\"");
+
+    ASSERT_FALSE(base::getResponse(defaultTTLHandler->contains("short")));
+    ASSERT_TRUE(base::getResponse(defaultTTLHandler->contains("forever")));
+}
+
+TEST_F(KVDBHandlerTest, EntriesLoadedFromFileGetDefaultTTL)
+{
+    const auto path = std::filesystem::temp_directory_path() / "EntriesLoadedFromFileGetDefaultTTL.json";
+    std::ofstream(path) << R"({"key": "value"})";
+
+    ASSERT_FALSE(m_kvdbManager->createDB("EntriesLoadedFromFileGetDefaultTTL", path.string(), std::chrono::seconds(1)));
+    std::filesystem::remove(path);
+
+    auto handler =
+        base::getResponse(m_kvdbManager->getKVDBHandler("EntriesLoadedFromFileGetDefaultTTL", "scope1"));
+    ASSERT_TRUE(base::getResponse(handler->contains("key")));
+
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+
+    ASSERT_FALSE(base::getResponse(handler->contains("key")));
+}
+
+TEST_F(KVDBHandlerTest, SetBatch)
+{
+    ASSERT_FALSE(m_kvdbManager->createDB("SetBatch"));
+    auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("SetBatch", "scope1"));
+
+    ASSERT_FALSE(handler->setBatch({{"key1", "\"value1\""}, {"key2", "2"}}));
+    ASSERT_FALSE(handler->setBatch({}));
+
+    ASSERT_EQ(base::getResponse(handler->get("key1")), "\"value1\"");
+    ASSERT_EQ(base::getResponse(handler->get("key2")), "2");
+}
+
+TEST_F(KVDBHandlerTest, IncrementCounter)
+{
+    ASSERT_FALSE(m_kvdbManager->createDB("IncrementCounter"));
+    auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("IncrementCounter", "scope1"));
+
+    ASSERT_FALSE(handler->increment("counter", 1));
+    ASSERT_EQ(base::getResponse(handler->get("counter")), "1");
+
+    ASSERT_FALSE(handler->increment("counter", 41));
+    ASSERT_FALSE(handler->increment("counter", -2));
+    ASSERT_EQ(base::getResponse(handler->get("counter")), "40");
+
+    // A non integer value is replaced
+    ASSERT_FALSE(handler->set("counter", "\"value\""));
+    ASSERT_FALSE(handler->increment("counter", 3));
+    ASSERT_EQ(base::getResponse(handler->get("counter")), "3");
+}
+
+TEST_F(KVDBHandlerTest, ConcurrentIncrement)
+{
+    ASSERT_FALSE(m_kvdbManager->createDB("ConcurrentIncrement"));
+
+    std::vector<std::thread> workers;
+    for (auto i = 0; i < 4; ++i)
+    {
+        workers.emplace_back(
+            [this]()
+            {
+                auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("ConcurrentIncrement", "scope1"));
+                for (auto j = 0; j < 1000; ++j)
+                {
+                    ASSERT_FALSE(handler->increment("counter", 1));
+                }
+            });
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("ConcurrentIncrement", "scope1"));
+    ASSERT_EQ(base::getResponse(handler->get("counter")), "4000");
+}
+
+TEST_F(KVDBHandlerTest, AppendToSet)
+{
+    ASSERT_FALSE(m_kvdbManager->createDB("AppendToSet"));
+    auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("AppendToSet", "scope1"));
+
+    ASSERT_FALSE(handler->appendToSet("ips", "1.2.3.4"));
+    ASSERT_FALSE(handler->appendToSet("ips", "5.6.7.8"));
+    ASSERT_FALSE(handler->appendToSet("ips", "1.2.3.4"));
+    ASSERT_EQ(base::getResponse(handler->get("ips")), R"(["1.2.3.4","5.6.7.8"])");
+
+    ASSERT_FALSE(handler->set("ips", "{}"));
+    ASSERT_FALSE(handler->appendToSet("ips", "9.9.9.9"));
+    ASSERT_EQ(base::getResponse(handler->get("ips")), R"(["9.9.9.9"])");
+}
+
+TEST_F(KVDBHandlerTest, MergeKeepsTTL)
+{
+    ASSERT_FALSE(m_kvdbManager->createDB("MergeKeepsTTL"));
+    auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("MergeKeepsTTL", "scope1"));
+
+    ASSERT_FALSE(handler->set("counter", "10", std::chrono::seconds(1)));
+    ASSERT_FALSE(handler->increment("counter", 1));
+    ASSERT_EQ(base::getResponse(handler->get("counter")), "11");
+
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+
+    ASSERT_TRUE(base::isError(handler->get("counter")));
+
+    // Expired values count as missing
+    ASSERT_FALSE(handler->increment("counter", 1));
+    ASSERT_EQ(base::getResponse(handler->get("counter")), "1");
+}
+
+TEST_F(KVDBHandlerTest, ExportEntriesFromSnapshot)
+{
+    ASSERT_FALSE(m_kvdbManager->createDB("ExportEntries"));
+    auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("ExportEntries", "scope1"));
+
+    for (auto i = 0; i < 10; ++i)
+    {
+        ASSERT_FALSE(handler->set(fmt::format("key{}", i), fmt::format("{}", i)));
+    }
+
+    std::vector<std::pair<std::string, std::string>> exported;
+    auto error = handler->exportEntries(
+        [&](std::string_view key, std::string_view value)
+        {
+            if (exported.empty())
+            {
+                // Writes made during the export are not visible
+                EXPECT_FALSE(handler->remove("key9"));
+                EXPECT_FALSE(handler->set("key99", "99"));
+            }
+
+            exported.emplace_back(key, value);
+            return true;
+        });
+
+    ASSERT_FALSE(error);
+    ASSERT_EQ(exported.size(), 10);
+    ASSERT_EQ(exported.front(), std::make_pair(std::string("key0"), std::string("0")));
+    ASSERT_EQ(exported.back(), std::make_pair(std::string("key9"), std::string("9")));
+
+    std::size_t visited {0};
+    error = handler->exportEntries([&](std::string_view, std::string_view) { return ++visited < 3; });
+
+    ASSERT_FALSE(error);
+    ASSERT_EQ(visited, 3);
+}
+
 TEST_P(DumpWithMultiplePages, Dump)
 {
     auto [inserts, page, records, expected] = GetParam();
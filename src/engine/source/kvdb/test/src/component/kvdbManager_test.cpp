@@ -1,9 +1,13 @@
+#include <atomic>
 #include <filesystem>
 #include <gtest/gtest.h>
 #include <iostream>
 #include <random>
 #include <thread>
 #include <unistd.h>
+#include <vector>
+
+#include <fmt/format.h>
 
 #include <base/json.hpp>
 #include <base/logger.hpp>
@@ -182,4 +186,315 @@ TEST_F(KVDBManagerTest, DeleteDataBaseWithRestart)
     dbList = m_kvdbManager->listDBs(true);
     ASSERT_EQ(dbList.size(), 0);
 }
+
+TEST_F(KVDBManagerTest, ConcurrentLookupWhileCreatingAndDeleting)
+{
+    ASSERT_EQ(m_kvdbManager->createDB("ConcurrentLookupStable"), std::nullopt);
+
+    std::atomic<bool> stop {false};
+    std::atomic<std::size_t> lookupErrors {0};
+
+    auto reader = [&]()
+    {
+        while (!stop)
+        {
+            if (!m_kvdbManager->existsDB("ConcurrentLookupStable"))
+            {
+                ++lookupErrors;
+            }
+
+            auto result = m_kvdbManager->getKVDBHandler("ConcurrentLookupStable", "ut");
+            if (base::isError(result))
+            {
+                ++lookupErrors;
+            }
+
+            m_kvdbManager->listDBs(true);
+        }
+    };
+
+    std::vector<std::thread> readers;
+    for (auto i = 0; i < 4; ++i)
+    {
+        readers.emplace_back(reader);
+    }
+
+    for (auto i = 0; i < 50; ++i)
+    {
+        const auto name = fmt::format("ConcurrentLookup{}", i);
+        ASSERT_EQ(m_kvdbManager->createDB(name), std::nullopt);
+        ASSERT_EQ(m_kvdbManager->deleteDB(name), std::nullopt);
+    }
+
+    stop = true;
+    for (auto& thread : readers)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(lookupErrors, 0);
+    ASSERT_EQ(m_kvdbManager->listDBs(true).size(), 1);
+}
+
+TEST_F(KVDBManagerTest, HandlersAndScopesInfo)
+{
+    ASSERT_EQ(m_kvdbManager->createDB("RefInfoDB1"), std::nullopt);
+    ASSERT_EQ(m_kvdbManager->createDB("RefInfoDB2"), std::nullopt);
+
+    {
+        auto handler1 = base::getResponse(m_kvdbManager->getKVDBHandler("RefInfoDB1", "scope1"));
+        auto handler2 = base::getResponse(m_kvdbManager->getKVDBHandler("RefInfoDB1", "scope1"));
+        auto handler3 = base::getResponse(m_kvdbManager->getKVDBHandler("RefInfoDB1", "scope2"));
+        auto handler4 = base::getResponse(m_kvdbManager->getKVDBHandler("RefInfoDB2", "scope2"));
+
+        ASSERT_EQ(m_kvdbManager->getKVDBHandlersCount("RefInfoDB1"), 3);
+        ASSERT_EQ(m_kvdbManager->getKVDBHandlersCount("RefInfoDB2"), 1);
+
+        const auto handlersInfo = m_kvdbManager->getKVDBHandlersInfo();
+        ASSERT_EQ(handlersInfo.size(), 2);
+        ASSERT_EQ(handlersInfo.at("RefInfoDB1").at("scope1"), 2);
+        ASSERT_EQ(handlersInfo.at("RefInfoDB1").at("scope2"), 1);
+        ASSERT_EQ(handlersInfo.at("RefInfoDB2").at("scope2"), 1);
+
+        const auto scopesInfo = m_kvdbManager->getKVDBScopesInfo();
+        ASSERT_EQ(scopesInfo.size(), 2);
+        ASSERT_EQ(scopesInfo.at("scope1").size(), 1);
+        ASSERT_EQ(scopesInfo.at("scope1").at("RefInfoDB1"), 2);
+        ASSERT_EQ(scopesInfo.at("scope2").at("RefInfoDB1"), 1);
+        ASSERT_EQ(scopesInfo.at("scope2").at("RefInfoDB2"), 1);
+
+        auto result = m_kvdbManager->deleteDB("RefInfoDB1");
+        ASSERT_NE(result, std::nullopt);
+    }
+
+    ASSERT_EQ(m_kvdbManager->getKVDBHandlersCount("RefInfoDB1"), 0);
+    ASSERT_TRUE(m_kvdbManager->getKVDBHandlersInfo().empty());
+    ASSERT_TRUE(m_kvdbManager->getKVDBScopesInfo().empty());
+    ASSERT_EQ(m_kvdbManager->deleteDB("RefInfoDB1"), std::nullopt);
+}
+
+TEST_F(KVDBManagerTest, ConcurrentHandlerRefCount)
+{
+    ASSERT_EQ(m_kvdbManager->createDB("ConcurrentRefCount"), std::nullopt);
+
+    std::vector<std::thread> workers;
+    for (auto i = 0; i < 4; ++i)
+    {
+        workers.emplace_back(
+            [this, i]()
+            {
+                const auto scope = fmt::format("scope{}", i % 2);
+                for (auto j = 0; j < 1000; ++j)
+                {
+                    auto result = m_kvdbManager->getKVDBHandler("ConcurrentRefCount", scope);
+                    ASSERT_FALSE(base::isError(result));
+                }
+            });
+    }
+
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(m_kvdbManager->getKVDBHandlersCount("ConcurrentRefCount"), 0);
+    ASSERT_EQ(m_kvdbManager->deleteDB("ConcurrentRefCount"), std::nullopt);
+}
+
+TEST_F(KVDBManagerTest, DBTTLPersistsAcrossRestart)
+{
+    ASSERT_EQ(m_kvdbManager->createDB("DBTTL"), std::nullopt);
+    ASSERT_EQ(base::getResponse(m_kvdbManager->getDBTTL("DBTTL")), std::chrono::seconds(0));
+
+    ASSERT_EQ(m_kvdbManager->setDBTTL("DBTTL", std::chrono::seconds(60)), std::nullopt);
+    ASSERT_EQ(base::getResponse(m_kvdbManager->getDBTTL("DBTTL")), std::chrono::seconds(60));
+
+    ASSERT_NE(m_kvdbManager->setDBTTL("DBTTL", std::chrono::seconds(-1)), std::nullopt);
+    ASSERT_NE(m_kvdbManager->setDBTTL("NotExists", std::chrono::seconds(60)), std::nullopt);
+    ASSERT_TRUE(base::isError(m_kvdbManager->getDBTTL("NotExists")));
+
+    m_kvdbManager->finalize();
+    m_kvdbManager->initialize();
+
+    ASSERT_EQ(base::getResponse(m_kvdbManager->getDBTTL("DBTTL")), std::chrono::seconds(60));
+
+    // The TTL does not survive the DB
+    ASSERT_EQ(m_kvdbManager->deleteDB("DBTTL"), std::nullopt);
+    ASSERT_EQ(m_kvdbManager->createDB("DBTTL"), std::nullopt);
+    ASSERT_EQ(base::getResponse(m_kvdbManager->getDBTTL("DBTTL")), std::chrono::seconds(0));
+}
+
+TEST_F(KVDBManagerTest, StaticModePersistsAcrossRestart)
+{
+    ASSERT_EQ(m_kvdbManager->createDB("StaticDB"), std::nullopt);
+
+    {
+        auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("StaticDB", "test"));
+        ASSERT_EQ(handler->set("key1", "value1"), std::nullopt);
+        ASSERT_EQ(handler->set("key2", "value2"), std::nullopt);
+
+        ASSERT_EQ(m_kvdbManager->setStaticMode("StaticDB", true), std::nullopt);
+
+        // Handlers taken before the switch cannot write either
+        ASSERT_NE(handler->set("key3", "value3"), std::nullopt);
+    }
+
+    ASSERT_NE(m_kvdbManager->setStaticMode("NotExists", true), std::nullopt);
+
+    m_kvdbManager->finalize();
+    m_kvdbManager->initialize();
+
+    {
+        auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("StaticDB", "test"));
+        ASSERT_EQ(base::getResponse(handler->get("key1")), "value1");
+        ASSERT_EQ(base::getResponse(handler->contains("key2")), true);
+        ASSERT_EQ(base::getResponse(handler->contains("key3")), false);
+        ASSERT_NE(handler->set("key3", "value3"), std::nullopt);
+        ASSERT_NE(handler->remove("key1"), std::nullopt);
+    }
+
+    ASSERT_EQ(m_kvdbManager->setStaticMode("StaticDB", false), std::nullopt);
+
+    {
+        auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("StaticDB", "test"));
+        ASSERT_EQ(handler->set("key3", "value3"), std::nullopt);
+        ASSERT_EQ(base::getResponse(handler->get("key3")), "value3");
+    }
+
+    ASSERT_EQ(m_kvdbManager->deleteDB("StaticDB"), std::nullopt);
+}
+
+TEST_F(KVDBManagerTest, StaticModeKeepsConcurrentWrites)
+{
+    constexpr int THREADS = 4;
+
+    ASSERT_EQ(m_kvdbManager->createDB("StaticDB"), std::nullopt);
+
+    // Each writer stops at its first rejected write, every write done before it must be in the table
+    std::atomic<bool> started {false};
+    std::vector<int> written(THREADS, 0);
+    std::vector<std::thread> writers;
+    for (int i = 0; i < THREADS; ++i)
+    {
+        writers.emplace_back(
+            [this, i, &started, &written]()
+            {
+                auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("StaticDB", "test"));
+                while (!handler->set(fmt::format("key_{}_{}", i, written[i]), "value"))
+                {
+                    ++written[i];
+                    started = true;
+                }
+            });
+    }
+
+    while (!started)
+    {
+        std::this_thread::yield();
+    }
+    ASSERT_EQ(m_kvdbManager->setStaticMode("StaticDB", true), std::nullopt);
+
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+
+    auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("StaticDB", "test"));
+    for (int i = 0; i < THREADS; ++i)
+    {
+        for (int j = 0; j < written[i]; ++j)
+        {
+            ASSERT_TRUE(base::getResponse(handler->contains(fmt::format("key_{}_{}", i, j)))) << i << " " << j;
+        }
+    }
+
+    handler.reset();
+    ASSERT_EQ(m_kvdbManager->deleteDB("StaticDB"), std::nullopt);
+}
+
+TEST_F(KVDBManagerTest, StaticHandlerFailsOnceDisabled)
+{
+    ASSERT_EQ(m_kvdbManager->createDB("StaticDB"), std::nullopt);
+
+    {
+        auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("StaticDB", "test"));
+        ASSERT_EQ(handler->set("key1", "value1"), std::nullopt);
+    }
+
+    ASSERT_EQ(m_kvdbManager->setStaticMode("StaticDB", true), std::nullopt);
+
+    {
+        auto staticHandler = base::getResponse(m_kvdbManager->getKVDBHandler("StaticDB", "test"));
+        ASSERT_EQ(base::getResponse(staticHandler->get("key1")), "value1");
+
+        ASSERT_EQ(m_kvdbManager->setStaticMode("StaticDB", false), std::nullopt);
+
+        auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("StaticDB", "test"));
+        ASSERT_EQ(handler->set("key1", "value2"), std::nullopt);
+
+        // The old table is not served once the mode is disabled
+        ASSERT_TRUE(base::isError(staticHandler->get("key1")));
+        ASSERT_TRUE(base::isError(staticHandler->contains("key1")));
+        ASSERT_TRUE(base::isError(staticHandler->dump(1, 10)));
+        ASSERT_EQ(base::getResponse(handler->get("key1")), "value2");
+    }
+
+    ASSERT_EQ(m_kvdbManager->deleteDB("StaticDB"), std::nullopt);
+}
+
+TEST_F(KVDBManagerTest, Stats)
+{
+    ASSERT_EQ(m_kvdbManager->createDB("StatsDB"), std::nullopt);
+
+    {
+        auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("StatsDB", "test"));
+        ASSERT_EQ(handler->set("key1", "value1"), std::nullopt);
+        ASSERT_EQ(handler->set("key2", "value2"), std::nullopt);
+        ASSERT_FALSE(base::isError(handler->get("key1")));
+        ASSERT_FALSE(base::isError(handler->dump(1, 10)));
+    }
+
+    const auto stats = m_kvdbManager->getStats();
+
+    ASSERT_TRUE(stats.exists("/rocksdb/block_cache_hit_rate"));
+    ASSERT_TRUE(stats.exists("/rocksdb/memtable_bytes"));
+    ASSERT_TRUE(stats.exists("/rocksdb/pending_compaction_bytes"));
+
+    ASSERT_GT(stats.getInt64("/dbs/StatsDB/memtable_bytes").value(), 0);
+    ASSERT_EQ(stats.getInt64("/dbs/StatsDB/ops/put/count").value(), 2);
+    ASSERT_EQ(stats.getInt64("/dbs/StatsDB/ops/get/count").value(), 1);
+    ASSERT_EQ(stats.getInt64("/dbs/StatsDB/ops/iterate/count").value(), 1);
+    ASSERT_EQ(stats.getInt64("/dbs/StatsDB/ops/remove/count").value(), 0);
+    ASSERT_GT(stats.getDouble("/dbs/StatsDB/ops/put/p99_us").value(), 0.0);
+
+    ASSERT_EQ(m_kvdbManager->deleteDB("StatsDB"), std::nullopt);
+}
+
+TEST_F(KVDBManagerTest, ExportLatencyExcludesVisitor)
+{
+    ASSERT_EQ(m_kvdbManager->createDB("ExportDB"), std::nullopt);
+
+    {
+        auto handler = base::getResponse(m_kvdbManager->getKVDBHandler("ExportDB", "test"));
+        ASSERT_EQ(handler->set("key1", "value1"), std::nullopt);
+        ASSERT_EQ(handler->set("key2", "value2"), std::nullopt);
+
+        // A slow consumer, e.g. a client reading the export, is not DB latency
+        ASSERT_EQ(handler->exportEntries(
+                      [](std::string_view, std::string_view)
+                      {
+                          std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                          return true;
+                      }),
+                  std::nullopt);
+    }
+
+    const auto stats = m_kvdbManager->getStats();
+
+    ASSERT_EQ(stats.getInt64("/dbs/ExportDB/ops/iterate/count").value(), 1);
+    ASSERT_LT(stats.getDouble("/dbs/ExportDB/ops/iterate/p99_us").value(), 100000.0);
+
+    ASSERT_EQ(m_kvdbManager->deleteDB("ExportDB"), std::nullopt);
+}
+
 } // namespace
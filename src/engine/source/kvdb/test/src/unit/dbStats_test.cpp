@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include <kvdb/dbStats.hpp>
+
+using namespace kvdbManager;
+
+TEST(DbStatsTest, EmptyHistogram)
+{
+    LatencyHistogram histogram;
+    ASSERT_EQ(histogram.count(), 0);
+    ASSERT_EQ(histogram.sum(), 0);
+    ASSERT_EQ(histogram.percentile(50), 0);
+    ASSERT_EQ(histogram.percentile(99), 0);
+}
+
+TEST(DbStatsTest, PercentilesAreBucketUpperBounds)
+{
+    LatencyHistogram histogram;
+
+    for (int i = 0; i < 90; ++i)
+    {
+        histogram.record(std::chrono::nanoseconds(100));
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        histogram.record(std::chrono::microseconds(100));
+    }
+
+    ASSERT_EQ(histogram.count(), 100);
+    ASSERT_EQ(histogram.sum(), 90 * 100 + 10 * 100000);
+
+    // 100ns is in [64, 128), 100us in [65536, 131072)
+    ASSERT_EQ(histogram.percentile(50), 128);
+    ASSERT_EQ(histogram.percentile(90), 128);
+    ASSERT_EQ(histogram.percentile(91), 131072);
+    ASSERT_EQ(histogram.percentile(100), 131072);
+}
+
+TEST(DbStatsTest, OutOfRangeLatencies)
+{
+    LatencyHistogram histogram;
+    histogram.record(std::chrono::nanoseconds(0));
+    histogram.record(std::chrono::nanoseconds(-5));
+    ASSERT_EQ(histogram.percentile(100), 1);
+
+    histogram.record(std::chrono::hours(1));
+    ASSERT_EQ(histogram.percentile(100), uint64_t {1} << (LatencyHistogram::BUCKETS - 1));
+}
+
+TEST(DbStatsTest, ConcurrentRecords)
+{
+    DbStats stats;
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            [&stats]()
+            {
+                for (int i = 0; i < 10000; ++i)
+                {
+                    DbStats::Timer timer {stats, DbOp::GET};
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(stats.histogram(DbOp::GET).count(), 40000);
+    ASSERT_EQ(stats.histogram(DbOp::PUT).count(), 0);
+    ASSERT_STREQ(dbOpName(DbOp::ITERATE), "iterate");
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include <kvdb/kvdbHandlerCollection.hpp>
+
+using namespace kvdbManager;
+
+namespace
+{
+
+std::map<std::string, uint32_t> scopes(const KVDBHandlerCollection& collection, const std::string& dbName)
+{
+    std::map<std::string, uint32_t> counts;
+    collection.visitRefs(dbName, [&counts](const RefCounter& ref) { counts[ref.scopeName()] = ref.count(); });
+
+    return counts;
+}
+
+} // namespace
+
+TEST(KVDBHandlerCollectionTest, AcquireAndVisitByDB)
+{
+    KVDBHandlerCollection collection;
+
+    const auto id = collection.acquire("db1", "scope1");
+    ASSERT_EQ(collection.acquire("db1", "scope1"), id);
+    ASSERT_EQ(collection.getRefId("db1", "scope1"), id);
+    collection.acquire("db1", "scope2");
+    collection.acquire("db2", "scope1");
+    collection.removeRef(id);
+
+    ASSERT_EQ(scopes(collection, "db1"), (std::map<std::string, uint32_t> {{"scope1", 1}, {"scope2", 1}}));
+    ASSERT_EQ(scopes(collection, "db2"), (std::map<std::string, uint32_t> {{"scope1", 1}}));
+    ASSERT_TRUE(scopes(collection, "db3").empty());
+}
+
+TEST(KVDBHandlerCollectionTest, ReleaseFreesUnusedSlots)
+{
+    KVDBHandlerCollection collection;
+
+    const auto unused = collection.getRefId("db1", "scope1");
+    const auto used = collection.acquire("db1", "scope2");
+
+    collection.release("db1");
+    ASSERT_EQ(scopes(collection, "db1"), (std::map<std::string, uint32_t> {{"scope2", 1}}));
+
+    // The free slot is reused before a new one is allocated
+    ASSERT_EQ(collection.getRefId("db2", "scope1"), unused);
+
+    collection.removeRef(used);
+    collection.release("db1");
+    ASSERT_TRUE(scopes(collection, "db1").empty());
+    ASSERT_EQ(collection.getRefId("db3", "scope1"), used);
+}
+
+TEST(KVDBHandlerCollectionTest, SlotsAreBoundedByPairsInUse)
+{
+    KVDBHandlerCollection collection;
+
+    // Far more pairs than the collection can hold at once, as long as their DBs are deleted
+    const auto total = KVDBHandlerCollection::MAX_CHUNKS * KVDBHandlerCollection::CHUNK_SIZE * 2;
+    for (std::size_t i = 0; i < total; ++i)
+    {
+        const auto dbName = "db" + std::to_string(i);
+        collection.removeRef(collection.acquire(dbName, "scope"));
+        collection.release(dbName);
+    }
+
+    std::size_t visited {0};
+    collection.visitRefs([&visited](const RefCounter&) { ++visited; });
+    ASSERT_EQ(visited, 0);
+}
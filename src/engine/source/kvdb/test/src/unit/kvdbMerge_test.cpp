@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <unistd.h>
+
+#include <rocksdb/db.h>
+
+#include <kvdb/kvdbMerge.hpp>
+#include <kvdb/kvdbTTL.hpp>
+
+using namespace kvdbManager;
+
+namespace
+{
+
+class KVDBMergeTest : public ::testing::Test
+{
+protected:
+    std::filesystem::path path;
+    std::unique_ptr<rocksdb::DB> db;
+
+    void SetUp() override
+    {
+        path = std::filesystem::temp_directory_path() / ("kvdb_merge_test_" + std::to_string(getpid()));
+        std::filesystem::remove_all(path);
+
+        rocksdb::Options options;
+        options.create_if_missing = true;
+        options.merge_operator = std::make_shared<merge::MergeOperator>();
+
+        rocksdb::DB* raw {nullptr};
+        ASSERT_TRUE(rocksdb::DB::Open(options, path.string(), &raw).ok());
+        db.reset(raw);
+    }
+
+    void TearDown() override
+    {
+        db.reset();
+        std::filesystem::remove_all(path);
+    }
+
+    void merge(const std::string& key, const std::string& operand)
+    {
+        ASSERT_TRUE(db->Merge(rocksdb::WriteOptions(), key, operand).ok());
+    }
+
+    std::string get(const std::string& key)
+    {
+        std::string value;
+        const auto status = db->Get(rocksdb::ReadOptions(), key, &value);
+        EXPECT_TRUE(status.ok()) << status.ToString();
+
+        return std::string {ttl::decode(value).payload};
+    }
+};
+
+} // namespace
+
+TEST_F(KVDBMergeTest, MalformedOperandIsSkipped)
+{
+    merge("counter", merge::encodeOperand(merge::Op::INCREMENT, "5", 0));
+    merge("counter", "X");
+    merge("counter", merge::encodeOperand(merge::Op::INCREMENT, "not a number", 0));
+    merge("counter", merge::encodeOperand(merge::Op::INCREMENT, "2", 0));
+
+    ASSERT_EQ(get("counter"), "7");
+
+    // Also once the operands are merged with a stored value
+    ASSERT_TRUE(db->Flush(rocksdb::FlushOptions()).ok());
+    merge("counter", "X");
+    ASSERT_EQ(get("counter"), "7");
+}
+
+TEST_F(KVDBMergeTest, IncrementSaturates)
+{
+    const auto max = std::to_string(std::numeric_limits<int64_t>::max());
+    const auto min = std::to_string(std::numeric_limits<int64_t>::min());
+
+    merge("counter", merge::encodeOperand(merge::Op::INCREMENT, max, 0));
+    merge("counter", merge::encodeOperand(merge::Op::INCREMENT, "1", 0));
+    ASSERT_EQ(get("counter"), max);
+
+    merge("counter", merge::encodeOperand(merge::Op::INCREMENT, min, 0));
+    merge("counter", merge::encodeOperand(merge::Op::INCREMENT, min, 0));
+    ASSERT_EQ(get("counter"), min);
+}
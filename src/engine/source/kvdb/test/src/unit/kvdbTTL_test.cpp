@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <kvdb/kvdbTTL.hpp>
+
+using namespace kvdbManager;
+
+TEST(KVDBTTLTest, EncodeWithoutExpirationIsRaw)
+{
+    ASSERT_EQ(ttl::encode("value", 0), "value");
+    ASSERT_EQ(ttl::encode("", 0), "");
+}
+
+TEST(KVDBTTLTest, DecodeRawValue)
+{
+    auto decoded = ttl::decode("\"value\"");
+    ASSERT_EQ(decoded.payload, "\"value\"");
+    ASSERT_EQ(decoded.expiresAt, 0);
+    ASSERT_FALSE(ttl::isExpired(decoded, ttl::now()));
+}
+
+TEST(KVDBTTLTest, RoundTrip)
+{
+    const auto stored = ttl::encode("{\"a\":1}", 1700000000);
+    ASSERT_EQ(stored.size(), ttl::HEADER_SIZE + 7);
+
+    auto decoded = ttl::decode(stored);
+    ASSERT_EQ(decoded.payload, "{\"a\":1}");
+    ASSERT_EQ(decoded.expiresAt, 1700000000);
+}
+
+TEST(KVDBTTLTest, RoundTripEmptyValue)
+{
+    const auto stored = ttl::encode("", 42);
+
+    auto decoded = ttl::decode(stored);
+    ASSERT_EQ(decoded.payload, "");
+    ASSERT_EQ(decoded.expiresAt, 42);
+}
+
+TEST(KVDBTTLTest, RawValueStartingWithMagicIsNotAmbiguous)
+{
+    const std::string value = std::string {ttl::MAGIC} + "12345678payload";
+    const auto stored = ttl::encode(value, 0);
+    ASSERT_NE(stored, value);
+
+    auto decoded = ttl::decode(stored);
+    ASSERT_EQ(decoded.payload, value);
+    ASSERT_EQ(decoded.expiresAt, 0);
+}
+
+TEST(KVDBTTLTest, IsExpired)
+{
+    ASSERT_FALSE(ttl::isExpired({"", 0}, 100));
+    ASSERT_FALSE(ttl::isExpired({"", 101}, 100));
+    ASSERT_TRUE(ttl::isExpired({"", 100}, 100));
+    ASSERT_TRUE(ttl::isExpired({"", 99}, 100));
+}
+
+TEST(KVDBTTLTest, CompactionFilterDropsExpired)
+{
+    ttl::CompactionFilter filter;
+    std::string newValue;
+    bool valueChanged {false};
+
+    const auto expired = ttl::encode("value", ttl::now() - 1);
+    const auto alive = ttl::encode("value", ttl::now() + 3600);
+
+    ASSERT_TRUE(filter.Filter(0, "key", expired, &newValue, &valueChanged));
+    ASSERT_FALSE(filter.Filter(0, "key", alive, &newValue, &valueChanged));
+    ASSERT_FALSE(filter.Filter(0, "key", "value", &newValue, &valueChanged));
+    ASSERT_FALSE(valueChanged);
+}
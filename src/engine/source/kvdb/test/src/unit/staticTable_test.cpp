@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include <kvdb/staticTable.hpp>
+
+using namespace kvdbManager;
+
+namespace
+{
+std::vector<std::pair<std::string, std::string>> makeEntries(std::size_t count)
+{
+    std::vector<std::pair<std::string, std::string>> entries;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        entries.emplace_back(fmt::format("key{:08}", i), fmt::format("\"value {}\"", i));
+    }
+
+    return entries;
+}
+} // namespace
+
+TEST(StaticTableTest, Empty)
+{
+    auto result = StaticTable::build({});
+    ASSERT_FALSE(base::isError(result));
+
+    const auto& table = base::getResponse(result);
+    ASSERT_EQ(table.size(), 0);
+    ASSERT_FALSE(table.find("key"));
+    ASSERT_FALSE(table.find(""));
+}
+
+TEST(StaticTableTest, FindsEveryKey)
+{
+    for (const auto count : {1, 2, 3, 4, 5, 17, 1000, 20000})
+    {
+        const auto entries = makeEntries(count);
+        auto result = StaticTable::build(entries);
+        ASSERT_FALSE(base::isError(result)) << base::getError(result).message;
+
+        const auto& table = base::getResponse(result);
+        ASSERT_EQ(table.size(), count);
+
+        for (const auto& [key, value] : entries)
+        {
+            auto found = table.find(key);
+            ASSERT_TRUE(found) << key;
+            ASSERT_EQ(*found, value);
+        }
+
+        ASSERT_FALSE(table.find("missing"));
+        ASSERT_FALSE(table.find(""));
+        ASSERT_FALSE(table.find(entries.front().first + "x"));
+    }
+}
+
+TEST(StaticTableTest, EmptyKeysAndValues)
+{
+    auto result = StaticTable::build({{"", "empty key"}, {"a", ""}});
+    ASSERT_FALSE(base::isError(result));
+
+    const auto& table = base::getResponse(result);
+    ASSERT_EQ(table.find("").value(), "empty key");
+    ASSERT_EQ(table.find("a").value(), "");
+}
+
+TEST(StaticTableTest, RejectsUnsortedOrDuplicatedKeys)
+{
+    ASSERT_TRUE(base::isError(StaticTable::build({{"b", "1"}, {"a", "2"}})));
+    ASSERT_TRUE(base::isError(StaticTable::build({{"a", "1"}, {"a", "2"}})));
+}
+
+TEST(StaticTableTest, ForEachInKeyOrder)
+{
+    const auto entries = makeEntries(100);
+    auto table = base::getResponse(StaticTable::build(entries));
+
+    std::vector<std::pair<std::string, std::string>> visited;
+    table.forEach(
+        [&visited](std::string_view key, std::string_view value)
+        {
+            visited.emplace_back(key, value);
+            return true;
+        });
+    ASSERT_EQ(visited, entries);
+
+    std::size_t count {0};
+    table.forEach([&count](std::string_view, std::string_view) { return ++count < 10; });
+    ASSERT_EQ(count, 10);
+}
+
+TEST(StaticTableTest, BufferRoundTrip)
+{
+    const auto entries = makeEntries(500);
+    auto table = base::getResponse(StaticTable::build(entries));
+
+    auto result = StaticTable::fromBuffer(std::string {table.buffer()});
+    ASSERT_FALSE(base::isError(result)) << base::getError(result).message;
+
+    const auto& loaded = base::getResponse(result);
+    ASSERT_EQ(loaded.size(), entries.size());
+    for (const auto& [key, value] : entries)
+    {
+        ASSERT_EQ(loaded.find(key).value(), value);
+    }
+}
+
+TEST(StaticTableTest, RejectsInvalidBuffer)
+{
+    ASSERT_TRUE(base::isError(StaticTable::fromBuffer("")));
+    ASSERT_TRUE(base::isError(StaticTable::fromBuffer(std::string(64, 'x'))));
+
+    auto table = base::getResponse(StaticTable::build(makeEntries(10)));
+
+    auto truncated = std::string {table.buffer()};
+    truncated.pop_back();
+    ASSERT_TRUE(base::isError(StaticTable::fromBuffer(truncated)));
+}
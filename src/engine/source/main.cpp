@@ -1,5 +1,15 @@
 #include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <thread>
+
+#include <httpserver/datagramListener.hpp>
+#include <httpserver/eventListener.hpp>
+#include <httpserver/handoff.hpp>
 #include <httpserver/server.hpp>
 #include <base/logger.hpp>
 #include <base/utils/singletonLocator.hpp>
@@ -13,28 +23,90 @@
 #include <api/handlers.hpp>
 #include <api/catalog/catalog.hpp>
 
+#include "SignalWaiter.hpp"
 #include "StackExecutor.hpp"
 
 std::shared_ptr<httpserver::Server> g_engineServer{nullptr};
+std::shared_ptr<httpserver::EventListener> g_eventListener{nullptr};
 
 cmd::details::StackExecutor g_exitHandler{};
 
-void sigintHandler(const int signum)
+/**
+ * @brief Configuration keys of the tuning of one server.
+ */
+struct ServerOptionKeys
+{
+    std::string_view threads;
+    std::string_view queueSize;
+    std::string_view keepAliveMaxCount;
+    std::string_view keepAliveTimeout;
+    std::string_view readTimeout;
+    std::string_view writeTimeout;
+    std::string_view payloadMaxSize;
+};
+
+httpserver::ServerOptions getServerOptions(const conf::Conf& confManager, const ServerOptionKeys& keys)
 {
-    if (g_engineServer)
+    auto positive = [&confManager](std::string_view key) -> std::size_t
+    {
+        const auto value = confManager.get<int>(key);
+        if (value < 0)
+        {
+            throw std::runtime_error(fmt::format("Configuration '{}' cannot be negative: {}", key, value));
+        }
+        return static_cast<std::size_t>(value);
+    };
+
+    httpserver::ServerOptions options;
+    options.threads = positive(keys.threads);
+    options.queueSize = positive(keys.queueSize);
+    options.keepAliveMaxCount = positive(keys.keepAliveMaxCount);
+    options.keepAliveTimeout = std::chrono::seconds(positive(keys.keepAliveTimeout));
+    options.readTimeout = std::chrono::seconds(positive(keys.readTimeout));
+    options.writeTimeout = std::chrono::seconds(positive(keys.writeTimeout));
+
+    const auto payloadMaxSize = confManager.get<int64_t>(keys.payloadMaxSize);
+    if (payloadMaxSize <= 0)
     {
-        g_engineServer.reset();
+        throw std::runtime_error(
+            fmt::format("Configuration '{}' must be positive: {}", keys.payloadMaxSize, payloadMaxSize));
     }
+    options.payloadMaxSize = static_cast<std::size_t>(payloadMaxSize);
+
+    return options;
 }
 
-void sigtermHandler(const int signum)
+/**
+ * @brief Open the KVDB, retrying until the deadline while another process holds it.
+ *
+ * On a hot restart the previous process releases it when it exits, after its drain.
+ */
+void initializeKVDB(kvdbManager::KVDBManager& kvdb, std::chrono::steady_clock::time_point deadline)
 {
-    g_exitHandler.execute(); 
+    while (true)
+    {
+        try
+        {
+            kvdb.initialize();
+            return;
+        }
+        catch (const std::exception& e)
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                throw;
+            }
+            LOG_DEBUG("KVDB not available yet, retrying: {}", e.what());
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
 }
 
 int main(int argc, char* argv[]) {
-    
-    // exit handler
+
+    // Shutdown signals [SIGINT, SIGTERM]: blocked before any thread starts, read from a signalfd below
+    cmd::details::SignalWaiter shutdownSignals{SIGINT, SIGTERM};
 
 
     // Initialize Logger
@@ -62,25 +134,7 @@ int main(int argc, char* argv[]) {
         exit(EXIT_FAILURE);
     }
 
-    // Set signal [SIGINT]: Ctrl+C handler
-    {
-        struct sigaction sigIntHandler = {};
-        sigIntHandler.sa_handler = sigintHandler;
-        sigemptyset(&sigIntHandler.sa_mask);
-        sigIntHandler.sa_flags = 0;
-        sigaction(SIGINT, &sigIntHandler, nullptr);
-    }
-
-    // Set signal [SIGINT]: SIGTERM (kill <pid>)
-    {
-        struct sigaction sigTermHandler = {};
-        sigTermHandler.sa_handler = sigtermHandler;
-        sigemptyset(&sigTermHandler.sa_mask);
-        sigTermHandler.sa_flags = 0;
-        sigaction(SIGTERM, &sigTermHandler, nullptr);
-    }
-
-    // Set signal [SIGINT]: Broken pipe handler
+    // Set signal [SIGPIPE]: Broken pipe handler
     {
         struct sigaction sigPipeHandler = {};
         sigPipeHandler.sa_handler = SIG_IGN;
@@ -109,7 +163,40 @@ int main(int argc, char* argv[]) {
         LOG_ERROR("Error setting log level from config:\n{}", e.what());
     }
 
+    // Hot restart: take over the listening sockets of the engine serving the handoff socket, if any
+    const auto handoffSocket = confManager.get<std::string>(conf::key::SERVER_HANDOFF_SOCKET);
+    httpserver::handoff::Inherited inherited;
+    bool hotRestart{false};
+
+    // httplib cannot listen on a received socket, the HTTP event server would bind a new one and the connections
+    // queued on the previous one would be reset when it exits. Refused before the running engine is asked
+    if (!handoffSocket.empty() && confManager.get<std::string>(conf::key::SERVER_EVENT_PROTOCOL) == "http")
+    {
+        LOG_ERROR("Configuration '{}' requires a framed event protocol, the 'http' event server cannot take over "
+                  "the socket of the running engine. Set '{}' to 'newline' or 'length_prefixed'",
+                  conf::key::SERVER_HANDOFF_SOCKET,
+                  conf::key::SERVER_EVENT_PROTOCOL);
+        g_exitHandler.execute();
+        exit(EXIT_FAILURE);
+    }
+
+    if (!handoffSocket.empty())
+    {
+        auto result = httpserver::handoff::request(handoffSocket, std::chrono::seconds(5));
+        if (base::isError(result))
+        {
+            LOG_DEBUG("No engine to take over from: {}", base::getError(result).message);
+        }
+        else
+        {
+            inherited = std::move(base::getResponse(result));
+            hotRestart = true;
+            LOG_INFO("Taking over the listening sockets of the running engine.");
+        }
+    }
+
     std::shared_ptr<httpserver::Server> apiServer{nullptr};
+    std::shared_ptr<httpserver::DatagramListener> datagramListener{nullptr};
     std::shared_ptr<kvdbManager::KVDBManager> kvdbManager{nullptr};
     std::shared_ptr<store::Store> store;
     std::shared_ptr<api::catalog::Catalog> catalog;
@@ -123,8 +210,6 @@ int main(int argc, char* argv[]) {
 
         kvdbManager = std::make_shared<kvdbManager::KVDBManager>(kvdbOptions);
 
-        kvdbManager->initialize();
-
         g_exitHandler.add(
             [kvdbManager]()
             {
@@ -133,7 +218,12 @@ int main(int argc, char* argv[]) {
             }
         );
 
-        LOG_INFO("KVDB initialized.");
+        // Held by the previous process until it exits, opened once the listeners are taken over
+        if (!hotRestart)
+        {
+            kvdbManager->initialize();
+            LOG_INFO("KVDB initialized.");
+        }
     }
     catch (const std::exception& ex)
     {
@@ -166,10 +256,54 @@ int main(int argc, char* argv[]) {
         LOG_INFO("Catalog Initialized.");
     }
 
+    std::chrono::seconds shutdownTimeout{0};
+
     try {
+        // Shutdown deadline
+        {
+            const auto timeout = confManager.get<int>(conf::key::SERVER_SHUTDOWN_TIMEOUT);
+            if (timeout <= 0)
+            {
+                throw std::runtime_error(
+                    fmt::format("Configuration '{}' must be positive: {}", conf::key::SERVER_SHUTDOWN_TIMEOUT, timeout));
+            }
+            shutdownTimeout = std::chrono::seconds(timeout);
+        }
+
         // API SERVER
         {
-            apiServer = std::make_shared<httpserver::Server>("API_SERVER");
+            auto apiOptions = getServerOptions(
+                confManager,
+                {conf::key::SERVER_API_THREADS,
+                 conf::key::SERVER_API_QUEUE_SIZE,
+                 conf::key::SERVER_API_KEEP_ALIVE_MAX_COUNT,
+                 conf::key::SERVER_API_KEEP_ALIVE_TIMEOUT,
+                 conf::key::SERVER_API_READ_TIMEOUT,
+                 conf::key::SERVER_API_WRITE_TIMEOUT,
+                 conf::key::SERVER_API_PAYLOAD_MAX_SIZE}
+            );
+
+            apiOptions.compression = confManager.get<bool>(conf::key::SERVER_API_COMPRESSION);
+            const auto compressionMinSize = confManager.get<int>(conf::key::SERVER_API_COMPRESSION_MIN_SIZE);
+            if (compressionMinSize < 0)
+            {
+                throw std::runtime_error(fmt::format("Configuration '{}' cannot be negative: {}",
+                                                     conf::key::SERVER_API_COMPRESSION_MIN_SIZE,
+                                                     compressionMinSize));
+            }
+            apiOptions.compressionMinSize = static_cast<std::size_t>(compressionMinSize);
+
+            const auto streamingPayloadMaxSize =
+                confManager.get<int64_t>(conf::key::SERVER_API_STREAMING_PAYLOAD_MAX_SIZE);
+            if (streamingPayloadMaxSize < 0)
+            {
+                throw std::runtime_error(fmt::format("Configuration '{}' cannot be negative: {}",
+                                                     conf::key::SERVER_API_STREAMING_PAYLOAD_MAX_SIZE,
+                                                     streamingPayloadMaxSize));
+            }
+            apiOptions.streamingPayloadMaxSize = static_cast<std::size_t>(streamingPayloadMaxSize);
+
+            apiServer = std::make_shared<httpserver::Server>("API_SERVER", apiOptions);
 
             g_exitHandler.add(
                 [apiServer]()
@@ -182,6 +316,8 @@ int main(int argc, char* argv[]) {
             // Catalog
             api::catalog::handlers::registerHandlers(catalog, apiServer);
             LOG_DEBUG("Catalog API registered.");
+
+            apiServer->addMetricsRoute("/metrics");
             
             auto testRoute = "/test/api";
 
@@ -202,9 +338,64 @@ int main(int argc, char* argv[]) {
 
         }
 
+        // DATAGRAM LISTENER
+        if (const auto datagramSocket = confManager.get<std::string>(conf::key::SERVER_DATAGRAM_SOCKET);
+            !datagramSocket.empty())
+        {
+            httpserver::DatagramListenerOptions datagramOptions;
+            datagramOptions.maxDatagramSize =
+                static_cast<std::size_t>(confManager.get<int>(conf::key::SERVER_DATAGRAM_MAX_SIZE));
+            datagramOptions.batchSize =
+                static_cast<std::size_t>(confManager.get<int>(conf::key::SERVER_DATAGRAM_BATCH_SIZE));
+            datagramOptions.receiveBufferSize = confManager.get<int>(conf::key::SERVER_DATAGRAM_RECEIVE_BUFFER);
+
+            datagramListener = std::make_shared<httpserver::DatagramListener>(
+                "DATAGRAM_LISTENER",
+                [](std::string_view event)
+                {
+                    LOG_TRACE("Datagram event received: {}", event);
+                },
+                datagramOptions
+            );
+
+            g_exitHandler.add(
+                [datagramListener]()
+                {
+                    datagramListener->stop();
+                    LOG_INFO("Datagram listener shut down.");
+                }
+            );
+
+            if (const auto fd = inherited.take(datagramSocket, SOCK_DGRAM); fd >= 0)
+            {
+                datagramListener->start(fd);
+            }
+            else
+            {
+                datagramListener->start(datagramSocket);
+            }
+        }
+
         // EVENT SERVER
+        const auto eventProtocol = confManager.get<std::string>(conf::key::SERVER_EVENT_PROTOCOL);
+
+        if (eventProtocol == "http")
         {
-            g_engineServer = std::make_shared<httpserver::Server>("EVENT_SERVER");
+            auto eventOptions = getServerOptions(
+                confManager,
+                {conf::key::SERVER_EVENT_THREADS,
+                 conf::key::SERVER_EVENT_QUEUE_SIZE,
+                 conf::key::SERVER_EVENT_KEEP_ALIVE_MAX_COUNT,
+                 conf::key::SERVER_EVENT_KEEP_ALIVE_TIMEOUT,
+                 conf::key::SERVER_EVENT_READ_TIMEOUT,
+                 conf::key::SERVER_EVENT_WRITE_TIMEOUT,
+                 conf::key::SERVER_EVENT_PAYLOAD_MAX_SIZE}
+            );
+
+            // Event responses are acknowledgements, not worth compressing
+            eventOptions.compression = false;
+
+            g_engineServer = std::make_shared<httpserver::Server>("EVENT_SERVER", eventOptions);
 
             auto testRoute = "/test/engine";
 
@@ -224,6 +415,46 @@ int main(int argc, char* argv[]) {
                 )
             );
         }
+        else if (eventProtocol == "newline" || eventProtocol == "length_prefixed")
+        {
+            httpserver::EventListenerOptions listenerOptions;
+            listenerOptions.framing = eventProtocol == "newline" ? httpserver::Framing::NEWLINE
+                                                                 : httpserver::Framing::LENGTH_PREFIXED;
+            listenerOptions.maxFrameSize =
+                static_cast<std::size_t>(confManager.get<int64_t>(conf::key::SERVER_EVENT_PAYLOAD_MAX_SIZE));
+
+            const auto eventBackend = confManager.get<std::string>(conf::key::SERVER_EVENT_BACKEND);
+            if (eventBackend == "io_uring")
+            {
+                listenerOptions.backend = httpserver::Backend::IO_URING;
+            }
+            else if (eventBackend != "epoll")
+            {
+                throw std::runtime_error(
+                    fmt::format("Invalid event backend '{}', expected 'epoll' or 'io_uring'", eventBackend)
+                );
+            }
+
+            g_eventListener = std::make_shared<httpserver::EventListener>(
+                "EVENT_LISTENER",
+                [](std::string_view event)
+                {
+                    LOG_TRACE("Event received: {}", event);
+                },
+                listenerOptions
+            );
+
+            LOG_DEBUG("EVENT LISTENER REGISTERED ({} framing)", eventProtocol);
+        }
+        else
+        {
+            throw std::runtime_error(
+                fmt::format(
+                    "Invalid event protocol '{}', expected 'http', 'newline' or 'length_prefixed'",
+                    eventProtocol
+                )
+            );
+        }
     }
     catch (const std::exception& e)
     {
@@ -232,20 +463,125 @@ int main(int argc, char* argv[]) {
         exit(EXIT_FAILURE);
     }
 
+    // Stopped first on exit, ingest ends before what it feeds
+    g_exitHandler.add(
+        []()
+        {
+            if (g_eventListener)
+            {
+                g_eventListener->stop();
+            }
+            if (g_engineServer)
+            {
+                g_engineServer->stop();
+            }
+            LOG_INFO("Event server shut down.");
+        }
+    );
+
+    auto eventServerRunning = []()
+    {
+        return g_eventListener ? g_eventListener->isRunning() : g_engineServer->isRunning();
+    };
+
     try
     {
-        g_engineServer->start(
-            confManager.get<std::string>(conf::key::SERVER_EVENT_SOCKET),
-            false
-        );
+        const auto eventSocket = confManager.get<std::string>(conf::key::SERVER_EVENT_SOCKET);
+
+        if (!g_eventListener)
+        {
+            g_engineServer->start(eventSocket);
+        }
+        else if (const auto fd = inherited.take(eventSocket, SOCK_STREAM); fd >= 0)
+        {
+            g_eventListener->start(fd);
+        }
+        else
+        {
+            g_eventListener->start(eventSocket);
+        }
+
+        if (hotRestart)
+        {
+            // The previous process drains and exits, releasing the KVDB within its shutdown timeout
+            inherited.ready();
+            initializeKVDB(*kvdbManager, std::chrono::steady_clock::now() + shutdownTimeout);
+            LOG_INFO("KVDB initialized.");
+        }
+
+        // Hand the listeners over to the next engine that asks, then shut down as on SIGTERM
+        if (!handoffSocket.empty())
+        {
+            auto provider = std::make_shared<httpserver::handoff::Provider>(
+                "HANDOFF",
+                [datagramListener]()
+                {
+                    std::vector<int> sockets;
+                    if (g_eventListener)
+                    {
+                        sockets.push_back(g_eventListener->socketFd());
+                    }
+                    if (datagramListener)
+                    {
+                        sockets.push_back(datagramListener->socketFd());
+                    }
+                    return sockets;
+                },
+                [datagramListener]()
+                {
+                    if (g_eventListener)
+                    {
+                        g_eventListener->handOff();
+                    }
+                    if (datagramListener)
+                    {
+                        datagramListener->handOff();
+                    }
+                    LOG_INFO("Listening sockets handed over to the new engine.");
+                    ::kill(::getpid(), SIGTERM);
+                }
+            );
+
+            g_exitHandler.add([provider]() { provider->stop(); });
+
+            provider->start(handoffSocket);
+        }
+
+        // Run until a shutdown signal, or until the event server stops on its own
+        while (eventServerRunning())
+        {
+            if (const auto signum = shutdownSignals.wait(std::chrono::seconds(1)); signum != 0)
+            {
+                LOG_INFO("Received signal {} ({}), shutting down.", signum, strsignal(signum));
+                break;
+            }
+        }
     }
     catch (const std::exception& e)
     {
         LOG_ERROR("An error occurred while running the server: {}.", e.what());
     }
 
-    // Clean exit
-    g_exitHandler.execute();
+    // Clean exit: stop accepting, drain what was received, then the modules in reverse order of initialization.
+    // Bounded by the shutdown timeout, a second signal skips the rest of it.
+    const auto deadline = std::chrono::steady_clock::now() + shutdownTimeout;
+
+    auto exited = std::async(std::launch::async, []() { g_exitHandler.execute(); });
+
+    while (exited.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            LOG_ERROR("Shutdown did not complete within {} seconds, exiting.", shutdownTimeout.count());
+            std::_Exit(EXIT_FAILURE);
+        }
+
+        if (const auto signum = shutdownSignals.wait(std::chrono::milliseconds(100)); signum != 0)
+        {
+            LOG_ERROR("Received signal {} ({}) during shutdown, exiting.", signum, strsignal(signum));
+            std::_Exit(EXIT_FAILURE);
+        }
+    }
 
     return 0;
 }
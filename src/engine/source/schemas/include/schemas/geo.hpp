@@ -34,6 +34,14 @@ constexpr std::string_view DB_REMOTE_UPSERT_REQUEST_SCHEMA {R"({
     }
 })"};
 
+constexpr std::string_view CIDR_LOAD_REQUEST_SCHEMA {R"({
+    "type": "object",
+    "required": ["name"],
+    "properties": {
+        "name": { "type": "string" }
+    }
+})"};
+
 inline const json::Json& getDBPostRequestSchema()
 {
     static const json::Json schema(DB_POST_REQUEST_SCHEMA.data());
@@ -58,6 +66,12 @@ inline const json::Json& getDBRemoteUpsertRequestSchema()
     return schema;
 }
 
+inline const json::Json& getCidrLoadRequestSchema()
+{
+    static const json::Json schema(CIDR_LOAD_REQUEST_SCHEMA.data());
+    return schema;
+}
+
 } // namespace schemas::geo
 
 #endif // _SCHEMAS_GEO_HPP
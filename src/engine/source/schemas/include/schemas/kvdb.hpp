@@ -37,6 +37,7 @@ constexpr std::string_view DB_DELETE_REQUEST_SCHEMA = R"({
 })";
 
 // INSERT A NEW ENTRY IN A DB
+// "ttl" overrides the default TTL of the DB for this entry, 0 stores it without expiration
 constexpr std::string_view DB_PUT_REQUEST_SCHEMA = R"({
     "type": "object",
     "required": ["name", "entry"],
@@ -49,7 +50,20 @@ constexpr std::string_view DB_PUT_REQUEST_SCHEMA = R"({
                 "key": { "type": "string" },
                 "value": {}
             }
-        }
+        },
+        "ttl": { "type": "integer", "minimum": 0 }
+    }
+})";
+
+// ATOMICALLY UPDATE AN ENTRY IN A DB (COUNTER INCREMENT OR SET APPEND)
+constexpr std::string_view DB_MERGE_REQUEST_SCHEMA = R"({
+    "type": "object",
+    "required": ["name", "key", "op"],
+    "properties": {
+        "name": { "type": "string" },
+        "key": { "type": "string" },
+        "op": { "type": "string", "enum": ["increment", "append"] },
+        "value": { "type": ["integer", "string"] }
     }
 })";
 
@@ -68,7 +82,9 @@ constexpr std::string_view MANAGER_POST_REQUEST_SCHEMA = R"({
     "required": ["name"],
     "properties": {
         "name": { "type": "string" },
-        "path": { "type": "string" }
+        "path": { "type": "string" },
+        "ttl": { "type": "integer", "minimum": 0 },
+        "static": { "type": "boolean" }
     }
 })";
 
@@ -92,6 +108,21 @@ constexpr std::string_view MANAGER_DUMP_REQUEST_SCHEMA = R"({
     }
 })";
 
+// EXPORT ALL ENTRIES FROM A DB AS NDJSON
+constexpr std::string_view MANAGER_EXPORT_REQUEST_SCHEMA = R"({
+    "type": "object",
+    "required": ["name"],
+    "properties": {
+        "name": { "type": "string" }
+    }
+})";
+
+// GET THE ROCKSDB AND PER DB STATISTICS
+constexpr std::string_view MANAGER_STATS_REQUEST_SCHEMA = R"({
+    "type": "object",
+    "properties": {}
+})";
+
 inline const json::Json& getDBGetRequestSchema()
 {
     static const json::Json schema(DB_GET_REQUEST_SCHEMA.data());
@@ -116,6 +147,12 @@ inline const json::Json& getDBPutRequestSchema()
     return schema;
 }
 
+inline const json::Json& getDBMergeRequestSchema()
+{
+    static const json::Json schema(DB_MERGE_REQUEST_SCHEMA.data());
+    return schema;
+}
+
 inline const json::Json& getManagerGetRequestSchema()
 {
     static const json::Json schema(MANAGER_GET_REQUEST_SCHEMA.data());
@@ -128,6 +165,12 @@ inline const json::Json& getManagerPostRequestSchema()
     return schema;
 }
 
+inline const json::Json& getManagerStatsRequestSchema()
+{
+    static const json::Json schema(MANAGER_STATS_REQUEST_SCHEMA.data());
+    return schema;
+}
+
 inline const json::Json& getManagerDeleteRequestSchema()
 {
     static const json::Json schema(MANAGER_DELETE_REQUEST_SCHEMA.data());
@@ -140,6 +183,12 @@ inline const json::Json& getManagerDumpRequestSchema()
     return schema;
 }
 
+inline const json::Json& getManagerExportRequestSchema()
+{
+    static const json::Json schema(MANAGER_EXPORT_REQUEST_SCHEMA.data());
+    return schema;
+}
+
 } // namespace schemas::kvdb
 
 #endif // _SCHEMAS_KVDB_HPP